@@ -0,0 +1,561 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "CubeAndConquer.h"
+
+#include "LogicFactory.h"
+#include "LookaheadCuber.h"
+#include "OsmtApiException.h"
+#include "TreeOps.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <unordered_set>
+
+CubeAndConquer::CubeAndConquer(Logic & logic, SMTConfig & config, opensmt::ResourceLimits & limits)
+    : logic(logic), config(config), limits(limits) {}
+
+CubeAndConquer::~CubeAndConquer() = default;
+
+sstat CubeAndConquer::solve(vec<PTRef> const & assertions) {
+    sstat res = split(assertions);
+    if (res != s_Undef or cubes.empty()) { return res; }
+
+    int threads = config.sat_split_threads();
+    for (int i = 0; i < threads; ++i) {
+        createWorker(i, assertions);
+    }
+    // Contiguous blocks of cubes, the neighbouring cubes differ only in the last decisions
+    for (std::size_t i = 0; i < cubes.size(); ++i) {
+        workers[i * threads / cubes.size()]->queue.push_back(static_cast<int>(i));
+    }
+
+    if (config.sat_split_sync_conflicts() > 0) {
+        runRounds(config.sat_split_sync_conflicts());
+    } else {
+        std::vector<std::thread> pool;
+        for (auto & worker : workers) {
+            pool.emplace_back([this, &worker]() { run(*worker); });
+        }
+        for (auto & thread : pool) {
+            thread.join();
+        }
+    }
+    if (failure) { std::rethrow_exception(failure); }
+    if (unknownReason != opensmt::UnknownReason::None) { limits.giveUp(unknownReason); }
+
+    if (result == s_Undef and refutedCubes == cubes.size()) {
+        result = s_False;
+    }
+    if (config.verbosity() > 0) {
+        std::cerr << "; Cube-and-conquer: " << cubes.size() << " cubes (" << blockedCubes.size() << " scattered) on "
+                  << threads << " threads";
+        if (rounds > 0) { std::cerr << " in " << rounds << " rounds"; }
+        std::cerr << ", " << refutedCubes << " refuted, " << sharedClauses.size() << " clauses shared" << std::endl;
+    }
+    if (result == s_True) {
+        translateModel(assertions);
+    }
+    return result;
+}
+
+// Runs the lookahead solver on the assertions, which either decides them or produces the cubes.  Scattering starts
+// from the single empty cube.
+sstat CubeAndConquer::split(vec<PTRef> const & assertions) {
+    std::unordered_map<PTRef, int, PTRefHash> atomIndices;
+    if (config.sat_split_type() == spt_scatter) {
+        cubes.emplace_back();
+        collectAtoms(assertions, atomIndices);
+        return s_Undef;
+    }
+
+    cuberConfig.copyOptionsFrom(config);
+    const char* msg;
+    cuberConfig.setOption(SMTConfig::o_sat_split_threads, SMTOption(0), msg);
+    dropLimits(cuberConfig);
+    auto theory = MainSolver::createTheory(logic, cuberConfig);
+    auto termMapper = std::make_unique<TermMapper>(logic);
+    auto thandler = std::make_unique<THandler>(*theory, *termMapper);
+    auto solver = std::make_unique<LookaheadCuber>(cuberConfig, *thandler);
+    cuberSolver = solver.get();
+    cuber = std::make_unique<MainSolver>(std::move(theory), std::move(termMapper), std::move(thandler),
+                                         std::move(solver), logic, cuberConfig, "cuber");
+    cuber->getResourceLimits().setParent(&limits);
+    for (PTRef tr : assertions) {
+        cuber->insertFormula(tr);
+    }
+    sstat res = cuber->check();
+    if (res != s_Undef) {
+        result = res;
+        return res;
+    }
+    if (giveUp(*cuber, -1)) {
+        // No cubes were produced
+        limits.giveUp(unknownReason);
+        return s_Undef;
+    }
+
+    for (vec<Lit> const & cube : cuberSolver->getCubes()) {
+        std::vector<CubeLit> lits;
+        for (Lit l : cube) {
+            PTRef atom = cuber->getTHandler().varToTerm(var(l));
+            auto [it, inserted] = atomIndices.emplace(atom, cubeAtoms.size());
+            if (inserted) { cubeAtoms.push(atom); }
+            lits.emplace_back(it->second, sign(l));
+        }
+        cubes.push_back(std::move(lits));
+    }
+    collectAtoms(assertions, atomIndices);
+    return s_Undef;
+}
+
+// Adds the atoms of the assertions to cubeAtoms, a busy worker scatters its cube by them
+void CubeAndConquer::collectAtoms(vec<PTRef> const & assertions, std::unordered_map<PTRef, int, PTRefHash> & atomIndices) {
+    class AtomCollector : public DefaultVisitorConfig {
+        Logic const & logic;
+        std::unordered_map<PTRef, int, PTRefHash> & atomIndices;
+        vec<PTRef> & atoms;
+    public:
+        AtomCollector(Logic const & logic, std::unordered_map<PTRef, int, PTRefHash> & atomIndices, vec<PTRef> & atoms)
+            : logic(logic), atomIndices(atomIndices), atoms(atoms) {}
+        void visit(PTRef tr) override {
+            if (logic.isAtom(tr) and not logic.isConstant(tr) and atomIndices.emplace(tr, atoms.size()).second) {
+                atoms.push(tr);
+            }
+        }
+    } collector(logic, atomIndices, cubeAtoms);
+    for (PTRef tr : assertions) {
+        TermVisitor<AtomCollector>(logic, collector).visit(tr);
+    }
+}
+
+void CubeAndConquer::createWorker(int index, vec<PTRef> const & assertions) {
+    auto worker = std::make_unique<Worker>();
+    worker->index = index;
+    worker->logic.reset(opensmt::LogicFactory::getInstance(logic.getLogic()));
+    SMTConfig & workerConfig = worker->config;
+    workerConfig.copyOptionsFrom(config);
+    const char* msg;
+    workerConfig.setOption(SMTConfig::o_sat_split_threads, SMTOption(0), msg);
+    workerConfig.setOption(SMTConfig::o_incremental, SMTOption(1), msg);
+    workerConfig.setOption(SMTConfig::o_produce_models, SMTOption(1), msg);
+    // Symmetry breaking would forbid the learnt clauses coming from the other workers
+    workerConfig.setOption(SMTConfig::o_sat_remove_symmetries, SMTOption(0), msg);
+    workerConfig.setOption(SMTConfig::o_verbosity, SMTOption(0), msg);
+    workerConfig.setOption(SMTConfig::o_random_seed, SMTOption(config.getRandomSeed() + index), msg);
+    dropLimits(workerConfig);
+
+    worker->translator = std::make_unique<TermTranslator>(logic, *worker->logic);
+    worker->solver = std::make_unique<MainSolver>(*worker->logic, workerConfig,
+                                                  "cube-and-conquer worker " + std::to_string(index));
+    worker->solver->getResourceLimits().setParent(&limits);
+    for (PTRef tr : assertions) {
+        worker->solver->insertFormula(worker->translator->translate(tr));
+    }
+    for (PTRef atom : cubeAtoms) {
+        worker->atoms.push(worker->translator->translate(atom));
+    }
+    // The atom definitions and the learnt clauses go to their own frame, so that adding them does not simplify the
+    // assertions again
+    worker->solver->push();
+    workers.push_back(std::move(worker));
+}
+
+void CubeAndConquer::run(Worker & worker) {
+    try {
+        int cube;
+        while (nextCube(worker, cube)) {
+            vec<PTRef> assumptions;
+            std::vector<CubeLit> lits;
+            sstat res;
+            do {
+                lits = startCheck(worker, cube, assumptions);
+                res = worker.solver->checkAssuming(assumptions);
+            } while (res == s_Undef and scatter(worker, cube));
+            if (res == s_Undef and giveUp(*worker.solver, worker.index)) { return; }
+            record(worker, lits, assumptions, res);
+        }
+    } catch (...) {
+        fail(worker);
+    }
+}
+
+// Deterministic search: the workers check their cubes for the given number of conflicts at a time.  In between, at the
+// barrier, the cubes are handed out and scattered and the clauses are shared in the order of the workers, so that the
+// result does not depend on the timing of the threads.
+void CubeAndConquer::runRounds(int conflicts) {
+    struct Check {
+        std::vector<CubeLit> lits;
+        vec<PTRef> assumptions;
+        sstat res = s_Undef;
+        bool exhausted = false;                 // The check ran out of conflicts rather than giving up
+    };
+    std::vector<Check> checks(workers.size());
+    while (not ended) {
+        assignCubes();
+        std::vector<std::thread> pool;
+        for (auto & worker : workers) {
+            if (worker->cube < 0) { continue; }
+            pool.emplace_back([this, &worker, &check = checks[worker->index], conflicts]() {
+                try {
+                    check.lits = startCheck(*worker, worker->cube, check.assumptions);
+                    SimpSMTSolver & solver = worker->solver->getSMTSolver();
+                    uint64_t const budget = solver.conflicts + conflicts;
+                    solver.setConfBudget(conflicts);
+                    check.res = worker->solver->checkAssuming(check.assumptions);
+                    check.exhausted = solver.conflicts >= budget;
+                } catch (...) {
+                    fail(*worker);
+                }
+            });
+        }
+        if (pool.empty()) { return; }
+        for (auto & thread : pool) {
+            thread.join();
+        }
+        ++rounds;
+        for (auto & worker : workers) {
+            Check & check = checks[worker->index];
+            if (worker->cube >= 0 and check.res == s_Undef and giveUp(*worker->solver, worker->index)) { return; }
+            if (worker->cube < 0 or (check.res == s_Undef and check.exhausted)) { continue; }
+            record(*worker, check.lits, check.assumptions, check.res);
+            worker->cube = -1;
+            check.res = s_Undef;
+        }
+    }
+}
+
+// Gives a cube to every idle worker in their order, scattering the cubes of the workers that have been busy the longest
+// if there are no more cubes left
+void CubeAndConquer::assignCubes() {
+    while (true) {
+        int idle = 0;
+        for (auto & worker : workers) {
+            if (worker->cube >= 0) { continue; }
+            int cube;
+            std::lock_guard<std::mutex> guard(lock);
+            if (takeCube(*worker, cube)) {
+                worker->cube = cube;
+                worker->started = ++takenCubes;
+                worker->scatterRequested = false;
+                worker->scatteredAt = worker->solver->getSMTSolver().conflicts;
+            } else {
+                ++idle;
+            }
+        }
+        if (idle == 0) { return; }
+        std::vector<Worker *> busy;
+        for (auto & worker : workers) {
+            if (worker->cube >= 0 and not worker->scatterRequested
+                and worker->solver->getSMTSolver().conflicts >= worker->scatteredAt + scatterConflicts) {
+                busy.push_back(worker.get());
+            }
+        }
+        std::sort(busy.begin(), busy.end(), [](Worker * w, Worker * v) { return w->started < v->started; });
+        auto scattered = std::find_if(busy.begin(), busy.end(), [this, idle](Worker * w) {
+            return splitCube(*w, w->cube, idle);
+        });
+        if (scattered == busy.end()) { return; }
+    }
+}
+
+// Shares the result of the check of the cube
+void CubeAndConquer::record(Worker & worker, std::vector<CubeLit> const & lits, vec<PTRef> const & assumptions,
+                            sstat res) {
+    if (res == s_True) {
+        finish(s_True, worker.index);
+    } else if (res == s_False) {
+        vec<PTRef> const & core = worker.solver->getUnsatCore();
+        if (core.size() == 0) {
+            finish(s_False, worker.index);
+            return;
+        }
+        std::unordered_set<PTRef, PTRefHash> coreTerms(core.begin(), core.end());
+        std::vector<CubeLit> clause;
+        for (std::size_t i = 0; i < assumptions.size_(); ++i) {
+            if (coreTerms.find(assumptions[i]) != coreTerms.end()) {
+                clause.emplace_back(lits[i].first, not lits[i].second);
+            }
+        }
+        std::lock_guard<std::mutex> guard(lock);
+        ++refutedCubes;
+        sharedClauses.push_back(std::move(clause));
+    }
+}
+
+void CubeAndConquer::fail(Worker & worker) {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (not failure) { failure = std::current_exception(); }
+    }
+    finish(s_Error, worker.index);
+}
+
+// Takes the next cube of the worker or of another worker.  If there is none, the worker waits until the worker that
+// has been busy the longest scatters its cube; it returns false once no worker is busy.
+bool CubeAndConquer::nextCube(Worker & worker, int & cube) {
+    std::unique_lock<std::mutex> guard(lock);
+    worker.cube = -1;
+    wake.notify_all();
+    while (not ended) {
+        if (takeCube(worker, cube)) {
+            worker.cube = cube;
+            worker.started = ++takenCubes;
+            worker.scatterRequested = false;
+            worker.scatteredAt = worker.solver->getSMTSolver().conflicts;
+            // The stop may be left from a request that came after the last check
+            worker.solver->getSMTSolver().stopAtConflicts = UINT64_MAX;
+            return true;
+        }
+        Worker * busiest = nullptr;
+        bool busy = false;
+        for (auto & other : workers) {
+            if (other->cube < 0) { continue; }
+            busy = true;
+            if (not other->scatterRequested and (busiest == nullptr or other->started < busiest->started)) {
+                busiest = other.get();
+            }
+        }
+        if (not busy) { return false; }
+        if (busiest) {
+            // The worker scatters its cube once it has searched it for long enough
+            busiest->scatterRequested = true;
+            busiest->solver->getSMTSolver().stopAtConflicts = busiest->scatteredAt + scatterConflicts;
+        }
+        wake.wait(guard);
+    }
+    return false;
+}
+
+bool CubeAndConquer::takeCube(Worker & worker, int & cube) {
+    if (not worker.queue.empty()) {
+        cube = worker.queue.front();
+        worker.queue.pop_front();
+        return true;
+    }
+    for (std::size_t i = 1; i < workers.size(); ++i) {
+        Worker & victim = *workers[(worker.index + i) % workers.size()];
+        if (not victim.queue.empty()) {
+            cube = victim.queue.back();
+            victim.queue.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+// Imports the clauses shared since the last check and returns the cube, whose literals are the assumptions
+std::vector<CubeAndConquer::CubeLit> CubeAndConquer::startCheck(Worker & worker, int cube, vec<PTRef> & assumptions) {
+    std::lock_guard<std::mutex> guard(lock);
+    Logic & workerLogic = *worker.logic;
+    for (; worker.importedClauses < sharedClauses.size(); ++worker.importedClauses) {
+        vec<PTRef> lits;
+        for (auto [atom, negated] : sharedClauses[worker.importedClauses]) {
+            PTRef atomVar = getAtomVar(worker, atom);
+            lits.push(negated ? workerLogic.mkNot(atomVar) : atomVar);
+        }
+        worker.solver->insertFormula(workerLogic.mkOr(std::move(lits)));
+    }
+    assumptions.clear();
+    for (auto [atom, negated] : cubes[cube]) {
+        PTRef atomVar = getAtomVar(worker, atom);
+        assumptions.push(negated ? workerLogic.mkNot(atomVar) : atomVar);
+    }
+    return cubes[cube];
+}
+
+// Defines the variable of the atom in the worker the first time it is used; the caller holds the lock
+PTRef CubeAndConquer::getAtomVar(Worker & worker, int atom) {
+    if (worker.atomVars.size() <= atom) { worker.atomVars.growTo(atom + 1, PTRef_Undef); }
+    if (worker.atomVars[atom] != PTRef_Undef) { return worker.atomVars[atom]; }
+    Logic & workerLogic = *worker.logic;
+    PTRef atomVar;
+    if (atom >= cubeAtoms.size()) {
+        int blocked = atom - cubeAtoms.size();
+        atomVar = workerLogic.mkBoolVar((".blocked" + std::to_string(blocked)).c_str());
+        vec<PTRef> negatedCube;
+        for (auto [cubeAtom, negated] : blockedCubes[blocked]) {
+            PTRef cubeAtomVar = getAtomVar(worker, cubeAtom);
+            negatedCube.push(negated ? cubeAtomVar : workerLogic.mkNot(cubeAtomVar));
+        }
+        worker.solver->insertFormula(workerLogic.mkImpl(atomVar, workerLogic.mkOr(std::move(negatedCube))));
+    } else if (workerLogic.isBoolAtom(worker.atoms[atom])) {
+        atomVar = worker.atoms[atom];
+    } else {
+        // The assumptions must be variables, the same name denotes the same atom in every worker
+        atomVar = workerLogic.mkBoolVar((".cube" + std::to_string(atom)).c_str());
+        worker.solver->insertFormula(workerLogic.mkEq(atomVar, worker.atoms[atom]));
+    }
+    worker.atomVars[atom] = atomVar;
+    return atomVar;
+}
+
+// Splits the cube of the worker if another worker asked for it while the check was running.  Returns false if the check
+// ended for another reason.
+bool CubeAndConquer::scatter(Worker & worker, int cube) {
+    int idle = 0;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (ended or not worker.scatterRequested) { return false; }
+        SimpSMTSolver & solver = worker.solver->getSMTSolver();
+        solver.stopAtConflicts = UINT64_MAX;
+        if (solver.conflicts < worker.scatteredAt + scatterConflicts) {
+            // The check ended early for another reason; the idle workers ask again
+            worker.scatterRequested = false;
+            wake.notify_all();
+            return true;
+        }
+        for (auto & other : workers) {
+            if (other->cube < 0) { ++idle; }
+        }
+    }
+    splitCube(worker, cube, idle);
+    return true;
+}
+
+// The most active atoms of the solver of the worker form a new cube; it is handed out, and the worker goes on with its
+// cube with the new one blocked.  The new cube has about one part in (1 + the number of idle workers) of the search
+// space of the old one.  Returns false if every atom is already decided in the cube.
+bool CubeAndConquer::splitCube(Worker & worker, int cube, int idle) {
+    std::vector<CubeLit> lits;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        lits = cubes[cube];
+    }
+    std::vector<bool> inCube(cubeAtoms.size(), false);
+    for (auto [atom, negated] : lits) {
+        if (atom < cubeAtoms.size()) { inCube[atom] = true; }
+    }
+    TermMapper const & termMapper = worker.solver->getTHandler().getTMap();
+    vec<Var> candidates;
+    std::unordered_map<Var, int> atomOfVar;
+    for (int i = 0; i < worker.atoms.size(); ++i) {
+        if (not inCube[i] and termMapper.hasLit(worker.atoms[i])) {
+            Var v = termMapper.getVar(worker.atoms[i]);
+            candidates.push(v);
+            atomOfVar.emplace(v, i);
+        }
+    }
+    int depth = std::max(1, static_cast<int>(std::lround(std::log2(idle + 1))));
+    std::vector<CubeLit> split;
+    for (Lit l : worker.solver->getSMTSolver().getActiveLits(candidates, depth)) {
+        int atom = atomOfVar.at(var(l));
+        split.emplace_back(atom, sign(l) != sign(termMapper.getLit(worker.atoms[atom])));
+    }
+
+    std::lock_guard<std::mutex> guard(lock);
+    wake.notify_all();
+    if (split.empty()) {
+        // No other worker asks again for this cube
+        worker.scatterRequested = true;
+        return false;
+    }
+    lits.insert(lits.end(), split.begin(), split.end());
+    blockedCubes.push_back(std::move(split));
+    cubes[cube].emplace_back(cubeAtoms.size() + blockedCubes.size() - 1, false);
+    cubes.push_back(std::move(lits));
+    worker.queue.push_back(cubes.size() - 1);
+    worker.scatterRequested = false;
+    worker.scatteredAt = worker.solver->getSMTSolver().conflicts;
+    return true;
+}
+
+// Ends the query without an answer if the check of the solver gave up on the exhausted resource limits
+bool CubeAndConquer::giveUp(MainSolver & solver, int workerIndex) {
+    opensmt::UnknownReason reason = solver.getResourceLimits().getReason();
+    if (reason == opensmt::UnknownReason::None) { return false; }
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (unknownReason == opensmt::UnknownReason::None) { unknownReason = reason; }
+    }
+    finish(s_Undef, workerIndex);
+    return true;
+}
+
+// The cuber and the workers are bounded by the limits of the query, which they inherit
+void CubeAndConquer::dropLimits(SMTConfig & solverConfig) {
+    const char* msg;
+    solverConfig.setOption(SMTConfig::o_time_limit, SMTOption(0), msg);
+    solverConfig.setOption(SMTConfig::o_conflict_limit, SMTOption(0), msg);
+    solverConfig.setOption(SMTConfig::o_memory_limit, SMTOption(0), msg);
+}
+
+void CubeAndConquer::finish(sstat res, int workerIndex) {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (ended) { return; }
+        ended = true;
+        result = res;
+        winner = workerIndex;
+    }
+    wake.notify_all();
+    for (auto & worker : workers) {
+        worker->solver->stop();
+    }
+}
+
+void CubeAndConquer::collectStatistics(opensmt::Statistics & stats) const {
+    stats.addCounter("cube-and-conquer.queries", 1);
+    stats.addCounter("cube-and-conquer.cubes", cubes.size());
+    stats.addCounter("cube-and-conquer.scattered-cubes", blockedCubes.size());
+    stats.addCounter("cube-and-conquer.refuted-cubes", refutedCubes);
+    stats.addCounter("cube-and-conquer.shared-clauses", sharedClauses.size());
+    stats.addCounter("cube-and-conquer.rounds", rounds);
+    auto addSearch = [&stats](MainSolver const & solver) {
+        solver.getSMTSolver().collectStatistics(stats);
+        solver.getTHandler().getSolverHandler().collectStatistics(stats);
+    };
+    if (cuber) { addSearch(*cuber); }
+    for (auto const & worker : workers) {
+        addSearch(*worker->solver);
+    }
+}
+
+// Evaluates the variables and the uninterpreted functions of the assertions in the model of the winning worker
+void CubeAndConquer::translateModel(vec<PTRef> const & assertions) {
+    assert(winner >= 0);
+    Worker & worker = *workers[winner];
+    auto model = worker.solver->getModel();
+    TermTranslator back(*worker.logic, logic);
+
+    class SymbolCollector : public DefaultVisitorConfig {
+        Logic const & logic;
+    public:
+        std::unordered_set<PTRef, PTRefHash> vars;
+        std::unordered_set<SymRef, SymRefHash> functions;
+        explicit SymbolCollector(Logic const & logic) : logic(logic) {}
+        void visit(PTRef tr) override {
+            if (logic.isVar(tr) and not logic.isConstant(tr)) {
+                vars.insert(tr);
+            } else if (logic.isUF(tr)) {
+                functions.insert(logic.getSymRef(tr));
+            }
+        }
+    } collector(logic);
+    for (PTRef tr : assertions) {
+        TermVisitor<SymbolCollector>(logic, collector).visit(tr);
+    }
+
+    for (PTRef var : collector.vars) {
+        evaluation.emplace(var, back.translate(model->evaluate(worker.translator->translate(var))));
+    }
+    for (SymRef sym : collector.functions) {
+        char const * name = logic.getSymName(sym);
+        TemplateFunction definition = model->getDefinition(worker.logic->symNameToRef(name)[0]);
+        vec<PTRef> args;
+        for (PTRef arg : definition.getArgs()) {
+            args.push(back.translate(arg));
+        }
+        definitions.emplace(sym, TemplateFunction(name, args, logic.getSortRef(sym), back.translate(definition.getBody())));
+    }
+}
+
+std::unique_ptr<Model> CubeAndConquer::getModel() {
+    if (result != s_True) { throw OsmtApiException("Model cannot be created if solver is not in SAT state"); }
+    if (winner < 0) {
+        return cuber->getModel();
+    }
+    return std::make_unique<Model>(logic, evaluation, definitions);
+}
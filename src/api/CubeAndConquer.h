@@ -0,0 +1,135 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef OPENSMT_CUBEANDCONQUER_H
+#define OPENSMT_CUBEANDCONQUER_H
+
+#include "MainSolver.h"
+#include "Model.h"
+#include "SMTConfig.h"
+#include "TermTranslator.h"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class LookaheadCuber;
+
+/**
+ * Local cube-and-conquer: the assertions are split into partitions, and a pool of sat_split_threads() incremental
+ * solvers checks the assertions under the partitions as assumptions.
+ *
+ * With the lookahead split type, a lookahead solver splits the assertions into sat_split_num() cubes up front.  With
+ * the scatter split type, the first worker starts on the whole search space and the partitions come from scattering:
+ * a worker splits its partition P by the cube C of its most active atoms into P and C, which it hands out, and P and
+ * not C, which it keeps searching.  A blocked cube is assumed through a guard atom that implies its negation.
+ *
+ * Every worker owns a copy of the assertions in its own logic, so the workers share no terms.  The partitions are
+ * handed out in blocks, a worker that runs out of them steals from the end of the block of another worker, and when
+ * there is nothing left to steal, it asks the worker that has been busy the longest to scatter its partition.  The
+ * unsat core of a refuted partition is a conflict of the assertions, its negation is passed to the other workers as a
+ * learnt clause.  The first satisfiable partition stops the pool.
+ *
+ * With sat_split_sync_conflicts() set, the workers synchronize after every that many conflicts and the cubes and the
+ * clauses are exchanged only at these barriers, in the order of the workers.  The same input and options then give
+ * the same cubes, answer and model in every run.
+ *
+ * The cuber and the workers inherit the resource limits of the query: once they are exhausted, the checks give up and
+ * the query ends with s_Undef.  The conflict limit of the query does not apply to the workers.
+ */
+class CubeAndConquer {
+public:
+    CubeAndConquer(Logic & logic, SMTConfig & config, opensmt::ResourceLimits & limits);
+    ~CubeAndConquer();
+
+    sstat solve(vec<PTRef> const & assertions);
+
+    // Returns the model of the assertions in the original logic (the last query must have been satisfiable)
+    std::unique_ptr<Model> getModel();
+
+    std::size_t getCubeCount() const { return cubes.size(); }
+    std::size_t getSharedClauseCount() const { return sharedClauses.size(); }
+    std::size_t getRoundCount() const { return rounds; }
+
+    // Adds the statistics of the engine and the summed up search statistics of the cuber and the workers
+    void collectStatistics(opensmt::Statistics & stats) const;
+
+private:
+    // The index of the atom in cubeAtoms and the sign; the indices past cubeAtoms are the guards of blockedCubes
+    using CubeLit = std::pair<int, bool>;
+
+    // A cube is scattered only after this many conflicts, so that the activities are informed and that the split off
+    // cubes are not refuted right away
+    static constexpr uint64_t scatterConflicts = 1000;
+
+    struct Worker {
+        int index;
+        std::unique_ptr<Logic> logic;
+        SMTConfig config;
+        std::unique_ptr<TermTranslator> translator;
+        std::unique_ptr<MainSolver> solver;
+        vec<PTRef> atoms;                       // cubeAtoms in the logic of the worker
+        vec<PTRef> atomVars;                    // The Boolean variables standing for the atoms, PTRef_Undef until used
+        // Guarded by the lock of the engine
+        std::deque<int> queue;                  // The indices of the cubes to solve
+        int cube = -1;                          // The cube being solved, -1 if the worker is idle
+        std::size_t started = 0;                // When the cube was taken, in the number of cubes taken overall
+        bool scatterRequested = false;          // Set also once the cube turned out not to be splittable
+        uint64_t scatteredAt = 0;               // The conflicts of the solver when the cube was taken or scattered
+        std::size_t importedClauses = 0;
+    };
+
+    Logic & logic;
+    SMTConfig & config;
+    opensmt::ResourceLimits & limits;
+
+    SMTConfig cuberConfig;
+    std::unique_ptr<MainSolver> cuber;
+    LookaheadCuber * cuberSolver = nullptr;
+
+    vec<PTRef> cubeAtoms;                       // The atoms of the cubes and of the assertions in the original logic
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    std::mutex lock;                            // Guards the members below
+    std::condition_variable wake;               // Notified when a cube is added, a worker gets idle or the query ends
+    std::vector<std::vector<CubeLit>> cubes;
+    std::vector<std::vector<CubeLit>> blockedCubes;
+    std::vector<std::vector<CubeLit>> sharedClauses;
+    std::size_t takenCubes = 0;
+    std::size_t rounds = 0;                     // The rounds of the deterministic search
+    sstat result = s_Undef;
+    bool ended = false;                         // Set by finish, also when the query is given up with s_Undef
+    opensmt::UnknownReason unknownReason = opensmt::UnknownReason::None;
+    int winner = -1;                            // The worker that decided the query, -1 if the cuber did
+    std::size_t refutedCubes = 0;
+    std::exception_ptr failure;
+
+    Model::Evaluation evaluation;
+    Model::SymbolDefinition definitions;
+
+    sstat split(vec<PTRef> const & assertions);
+    void collectAtoms(vec<PTRef> const & assertions, std::unordered_map<PTRef, int, PTRefHash> & atomIndices);
+    void createWorker(int index, vec<PTRef> const & assertions);
+    void run(Worker & worker);
+    bool nextCube(Worker & worker, int & cube);
+    bool takeCube(Worker & worker, int & cube);
+    std::vector<CubeLit> startCheck(Worker & worker, int cube, vec<PTRef> & assumptions);
+    PTRef getAtomVar(Worker & worker, int atom);
+    bool scatter(Worker & worker, int cube);
+    bool splitCube(Worker & worker, int cube, int idle);
+    void runRounds(int conflicts);
+    void assignCubes();
+    void record(Worker & worker, std::vector<CubeLit> const & lits, vec<PTRef> const & assumptions, sstat res);
+    void fail(Worker & worker);
+    bool giveUp(MainSolver & solver, int workerIndex);
+    static void dropLimits(SMTConfig & solverConfig);
+    void finish(sstat res, int workerIndex);
+    void translateModel(vec<PTRef> const & assertions);
+};
+
+#endif //OPENSMT_CUBEANDCONQUER_H
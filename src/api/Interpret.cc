@@ -32,6 +32,7 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <string>
 #include <sstream>
+#include <algorithm>
 #include <cstdarg>
 #include <unistd.h>
 
@@ -82,6 +83,23 @@ void Interpret::getInfo(ASTNode& n) {
         name = (**(n.children->begin())).getValue();
     }
 
+    if (strcmp(name, ":reason-unknown") == 0 and main_solver
+        and main_solver->getUnknownReason() != opensmt::UnknownReason::None) {
+        notify_formatted(false, "%s %s", name, opensmt::reasonUnknownName(main_solver->getUnknownReason()));
+        return;
+    }
+
+    if (strcmp(name, ":all-statistics") == 0 and main_solver) {
+        opensmt::Statistics stats = main_solver->getStatistics();
+        if (config.statistics_json()) {
+            stats.printJson(std::cout);
+        } else {
+            stats.printSmtLib(std::cout);
+        }
+        std::cout << std::endl;
+        return;
+    }
+
     const Info& value = config.getInfo(name);
 
     if (value.isEmpty())
@@ -225,6 +243,14 @@ void Interpret::interp(ASTNode& n) {
                     else {
                         assertions.push(tr);
                         try {
+                            if (asrt.getType() == BANG_T and termToNames.has(tr) and config.produce_unsat_cores()
+                                and not config.produce_inter()) {
+                                // The assertion is guarded by a fresh literal which is assumed in the queries
+                                std::string name = ".named_" + std::to_string(tr.x);
+                                PTRef activation = logic->mkBoolVar(name.c_str());
+                                namedAssertions.push({activation, tr});
+                                tr = logic->mkImpl(activation, tr);
+                            }
                             main_solver->insertFormula(tr);
                             notify_success();
                         } catch (OsmtApiException const & e) {
@@ -262,6 +288,46 @@ void Interpret::interp(ASTNode& n) {
                 }
                 break;
             }
+            case t_checksatassuming: {
+                if (isInitialized()) {
+                    vec<PTRef> assumptions;
+                    for (ASTNode * child : *n.children) {
+                        LetRecords letRecords;
+                        PTRef tr = parseTerm(*child, letRecords);
+                        if (tr == PTRef_Undef) {
+                            notify_formatted(true, "assumption returns an unknown sort");
+                            return;
+                        }
+                        assumptions.push(tr);
+                    }
+                    checkSatAssuming(assumptions);
+                } else {
+                    notify_formatted(true, "Illegal command before set-logic: check-sat-assuming");
+                }
+                break;
+            }
+            case t_getunsatcore: {
+                if (not isInitialized()) {
+                    notify_formatted(true, "Illegal command before set-logic: get-unsat-core");
+                } else if (not config.produce_unsat_cores()) {
+                    notify_formatted(true, "Option to produce unsat cores has not been set");
+                } else if (main_solver->getStatus() != s_False) {
+                    notify_formatted(true, "Command get-unsat-core called, but solver is not in UNSAT state");
+                } else {
+                    getUnsatCore();
+                }
+                break;
+            }
+            case t_getunsatassumptions: {
+                if (not isInitialized()) {
+                    notify_formatted(true, "Illegal command before set-logic: get-unsat-assumptions");
+                } else if (main_solver->getStatus() != s_False) {
+                    notify_formatted(true, "Command get-unsat-assumptions called, but solver is not in UNSAT state");
+                } else {
+                    getUnsatAssumptions();
+                }
+                break;
+            }
             case t_getinterpolants: {
                 if (config.produce_inter()) {
                     if (isInitialized()) {
@@ -526,8 +592,26 @@ PTRef Interpret::parseTerm(const ASTNode& term, LetRecords& letRecords) {
 }
 
 sstat Interpret::checkSat() {
+    return checkSatAssuming({});
+}
+
+sstat Interpret::checkSatAssuming(vec<PTRef> const & assumptions) {
+    assumptions.copyTo(lastAssumptions);
+    vec<PTRef> literals;
+    for (auto const & [activation, tr] : namedAssertions) {
+        literals.push(activation);
+    }
+    for (PTRef tr : assumptions) {
+        literals.push(tr);
+    }
     sstat res;
-    res = main_solver->check();
+    try {
+        res = literals.size() > 0 ? main_solver->checkAssuming(literals) : main_solver->check();
+    } catch (OsmtApiException const & e) {
+        // An assumption that is not a literal, or assumptions together with interpolation
+        notify_formatted(true, e.what());
+        return s_Error;
+    }
 
     if (res == s_True) {
         notify_formatted(false, "sat");
@@ -552,6 +636,36 @@ sstat Interpret::checkSat() {
     return res;
 }
 
+void Interpret::getUnsatCore() {
+    vec<PTRef> const & core = main_solver->getUnsatCore();
+    std::stringstream ss;
+    ss << '(';
+    bool first = true;
+    for (auto const & [activation, tr] : namedAssertions) {
+        if (std::find(core.begin(), core.end(), activation) == core.end()) { continue; }
+        for (const char * name : termToNames[tr]) {
+            ss << (first ? "" : " ") << name;
+            first = false;
+        }
+    }
+    ss << ')';
+    notify_formatted(false, "%s", ss.str().c_str());
+}
+
+void Interpret::getUnsatAssumptions() {
+    vec<PTRef> const & core = main_solver->getUnsatCore();
+    std::stringstream ss;
+    ss << '(';
+    bool first = true;
+    for (PTRef tr : lastAssumptions) {
+        if (std::find(core.begin(), core.end(), tr) == core.end()) { continue; }
+        ss << (first ? "" : " ") << logic->printTerm(tr);
+        first = false;
+    }
+    ss << ')';
+    notify_formatted(false, "%s", ss.str().c_str());
+}
+
 void Interpret::push(int n) {
     if (not config.isIncremental()) {
         notify_formatted(true, "push encountered but solver not in incremental mode");
@@ -561,6 +675,7 @@ void Interpret::push(int n) {
         } else {
             while (n--) {
                 defined_functions.pushScope();
+                namedAssertions.pushScope();
                 main_solver->push();
             }
             notify_success();
@@ -576,7 +691,10 @@ void Interpret::pop(int n) {
             bool success = true;
             while (n-- and success) {
                 success = main_solver->pop();
-                if (success) { defined_functions.popScope(); }
+                if (success) {
+                    defined_functions.popScope();
+                    namedAssertions.popScope();
+                }
             }
             if (success) {
                 notify_success();
@@ -1070,9 +1188,14 @@ void Interpret::execute(const ASTNode* r) {
     }
 }
 
+int Interpret::parse(Smt2newContext & context) {
+    opensmt::PhaseTimer::Scope scope(config.getPhaseTimer(), config.getPhaseTimer().getPhase("parse"));
+    return smt2newparse(&context);
+}
+
 int Interpret::interpFile(FILE* in) {
     Smt2newContext context(in);
-    int rval = smt2newparse(&context);
+    int rval = parse(context);
 
     if (rval != 0) return rval;
 
@@ -1083,7 +1206,7 @@ int Interpret::interpFile(FILE* in) {
 
 int Interpret::interpFile(char *content){
     Smt2newContext context(content);
-    int rval = smt2newparse(&context);
+    int rval = parse(context);
 
     if (rval != 0) return rval;
     const ASTNode* r = context.getRoot();
@@ -1185,7 +1308,7 @@ int Interpret::interpPipe() {
 
                     i = -1; // will be incremented to 0 by the loop condition.
                     Smt2newContext context(buf_out);
-                    int rval = smt2newparse(&context);
+                    int rval = parse(context);
                     if (rval != 0)
                         notify_formatted(true, "scanner");
                     else {
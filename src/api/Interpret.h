@@ -142,6 +142,9 @@ class Interpret {
     vec<char*>      term_names; // For (! <t> :named <n>) constructs.  if Itp is enabled, this maps a
                                             // partition to it name.
     vec<PTRef>      assertions;
+    opensmt::ScopedVector<std::pair<PTRef,PTRef>> namedAssertions; // Activation literal and term of the named assertions
+                                                                   // when unsat cores are produced
+    vec<PTRef>      lastAssumptions; // The assumptions of the last check-sat-assuming
     vec<SymRef>     user_declarations;
     DefinedFunctions defined_functions;
 
@@ -158,6 +161,9 @@ class Interpret {
     bool                        declareConst(ASTNode& n); //(const char* fname, const SRef ret_sort);
     bool                        defineFun(const ASTNode& n);
     virtual sstat               checkSat();
+    sstat                       checkSatAssuming(vec<PTRef> const & assumptions);
+    void                        getUnsatCore();
+    void                        getUnsatAssumptions();
     void                        getValue(std::vector<ASTNode*> const & terms);
     void                        getModel();
     std::string                 printDefinitionSmtlib(PTRef tr, PTRef val);
@@ -172,6 +178,7 @@ class Interpret {
     virtual void                exit();
     void                        getInterpolants(const ASTNode& n);
     void                        interp (ASTNode& n);
+    int                         parse(Smt2newContext & context);
 
     void                        notify_formatted(bool error, const char* s, ...);
     void                        notify_success();
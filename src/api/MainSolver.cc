@@ -26,6 +26,7 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "MainSolver.h"
 #include "BoolRewriting.h"
+#include "CubeAndConquer.h"
 #include "LookaheadSMTSolver.h"
 #include "GhostSMTSolver.h"
 #include "UFLATheory.h"
@@ -35,17 +36,71 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "OsmtApiException.h"
 #include "ModelBuilder.h"
 #include "IteHandler.h"
+#include "Symmetry.h"
 #include "RDLTHandler.h"
 #include "IDLTHandler.h"
 #include <thread>
+#include <unordered_set>
 #include <fcntl.h>
 
 namespace opensmt { bool stop; }
 
+MainSolver::MainSolver(Logic& logic, SMTConfig& conf, std::string name)
+        :
+        theory(createTheory(logic, conf)),
+        term_mapper(new TermMapper(logic)),
+        thandler(new THandler(getTheory(), *term_mapper)),
+        smt_solver(createInnerSolver(conf, *thandler)),
+        logic(thandler->getLogic()),
+        pmanager(logic),
+        config(conf),
+        pfstore(getTheory().pfstore),
+        ts( config, logic, pmanager, *term_mapper, *smt_solver ),
+        solver_name {std::move(name)},
+        check_called(0),
+        status(s_Undef),
+        root_instance(logic.getTerm_true())
+{
+    conf.setUsedForInitiliazation();
+    smt_solver->setResourceLimits(&limits);
+    thandler->getSolverHandler().setResourceLimits(&limits);
+    frames.push(pfstore.alloc());
+    PushFrame& last = pfstore[frames.last()];
+    last.push(logic.getTerm_true());
+}
+
+MainSolver::MainSolver(std::unique_ptr<Theory> th, std::unique_ptr<TermMapper> tm, std::unique_ptr<THandler> thd,
+                       std::unique_ptr<SimpSMTSolver> ss, Logic & logic, SMTConfig & conf, std::string name)
+        :
+        theory(std::move(th)),
+        term_mapper(std::move(tm)),
+        thandler(std::move(thd)),
+        smt_solver(std::move(ss)),
+        logic(thandler->getLogic()),
+        pmanager(logic),
+        config(conf),
+        pfstore(getTheory().pfstore),
+        ts( config, logic, pmanager, *term_mapper, *smt_solver ),
+        solver_name {std::move(name)},
+        check_called(0),
+        status(s_Undef),
+        root_instance(logic.getTerm_true())
+{
+    conf.setUsedForInitiliazation();
+    smt_solver->setResourceLimits(&limits);
+    thandler->getSolverHandler().setResourceLimits(&limits);
+    frames.push(pfstore.alloc());
+    PushFrame& last = pfstore[frames.last()];
+    last.push(logic.getTerm_true());
+}
+
+MainSolver::~MainSolver() = default;
+
 void
 MainSolver::push()
 {
     bool alreadyUnsat = isLastFrameUnsat();
+    symmetryFrame = FrameId_Undef; // The symmetry breaking predicates do not hold for the assertions of the new frame
     frames.push(pfstore.alloc());
     if (alreadyUnsat) { rememberLastFrameUnsat(); }
 }
@@ -81,9 +136,11 @@ void MainSolver::insertFormula(PTRef root)
     if (logic.getSortRef(root) != logic.getSort_bool()) {
         throw OsmtApiException("Top-level assertion sort must be Bool, got " + logic.printSort(logic.getSortRef(root)));
     }
+    // The symmetry breaking predicates are only valid for the formulas they were computed from
+    symmetryFrame = FrameId_Undef;
 
     root = logic.conjoinExtras(root);
-    root = IteHandler(logic, getPartitionManager().getNofPartitions()).rewrite(root);
+    root = IteHandler(logic, getPartitionManager().getNofPartitions(), config.ite_lifting()).rewrite(root);
 
     if (getConfig().produce_inter()) {
         // MB: Important for HiFrog! partition index is the index of the formula in an virtual array of inserted formulas,
@@ -105,6 +162,7 @@ void MainSolver::insertFormula(PTRef root)
 
 sstat MainSolver::simplifyFormulas()
 {
+    opensmt::PhaseTimer::Scope scope(config.getPhaseTimer(), config.getPhaseTimer().getPhase("preprocess"));
     status = s_Undef;
 
     vec<PTRef> coll_f;
@@ -149,6 +207,10 @@ sstat MainSolver::simplifyFormulas()
             }
             root_instance.setRoot(root);
             status = giveToSolver(root, frame.getId());
+            // Allocates a frame, so the reference to the current frame is not valid afterwards
+            if (config.remove_symmetries() and not symmetries_searched and i == 0 and frames.size() == 1) {
+                breakSymmetries(root);
+            }
         }
     }
     if (status == s_False) {
@@ -158,6 +220,33 @@ sstat MainSolver::simplifyFormulas()
 }
 
 
+// Give the lex-leader symmetry breaking predicates of the root of the single frame to the solver.  The predicates
+// preserve satisfiability of the current assertions only, so they get a frame of their own, which stays enabled until
+// the assertions change.  The search is done once, since the root of a frame simplified again need not carry all its
+// assertions.
+void MainSolver::breakSymmetries(PTRef root)
+{
+    symmetries_searched = true;
+    auto logicType = logic.getLogic();
+    if (logicType != opensmt::Logic_t::QF_UF and logicType != opensmt::Logic_t::QF_LRA) {
+        return;
+    }
+    symmetry::Detector detector(logic, root);
+    detector.setTimeLimit(config.symmetry_time_limit() / 1000.0);
+    detector.findSBPs();
+    if (config.verbosity() > 0) {
+        std::cerr << "; Symmetry detection found " << detector.getNumberOfGenerators() << " generators"
+                  << (detector.isSearchAborted() ? " before running out of time" : "") << std::endl;
+    }
+    PTRef sbps = detector.getSBPs();
+    if (sbps == logic.getTerm_true()) {
+        return;
+    }
+    symmetryFrame = pfstore[pfstore.alloc()].getId();
+    [[maybe_unused]] sstat res = giveToSolver(logic.isBooleanOperator(sbps) ? rewriteMaxArity(sbps) : sbps, symmetryFrame);
+    assert(res != s_False); // The clauses of a frame above the bottom one are guarded by its enabling literal
+}
+
 // Replace subtrees consisting only of ands / ors with a single and / or term.
 // Search a maximal section of the tree consisting solely of ands / ors.  The
 // root of this subtree is called and / or root.  Collect the subtrees rooted at
@@ -175,18 +264,27 @@ PTRef MainSolver::rewriteMaxArity(PTRef root)
 
 std::unique_ptr<Model> MainSolver::getModel() {
     if (status != s_True) { throw OsmtApiException("Model cannot be created if solver is not in SAT state"); }
+    if (cubeAndConquer) { return cubeAndConquer->getModel(); }
 
     ModelBuilder modelBuilder {logic};
     ts.solver.fillBooleanVars(modelBuilder);
     thandler->fillTheoryFunctions(modelBuilder);
+    auto model = modelBuilder.build();
 
-    return modelBuilder.build();
+    if (getTheory().hasEliminatedFunctions()) {
+        // The functions removed by the simplifications are interpreted using the model of the simplified formula
+        ModelBuilder eliminatedBuilder {logic};
+        getTheory().fillEliminatedFunctions(eliminatedBuilder, *model);
+        model->addDefinitions(eliminatedBuilder.buildDefinitions());
+    }
+    return model;
 }
 
 std::unique_ptr<InterpolationContext> MainSolver::getInterpolationContext() {
     if (status != s_False) { throw OsmtApiException("Interpolation context cannot be created if solver is not in UNSAT state"); }
+    limits.startQuery(config.time_limit(), config.memory_limit());
     return std::make_unique<InterpolationContext>(
-            config, *theory, *term_mapper, getSMTSolver().getProof(), pmanager
+            config, *theory, *term_mapper, getSMTSolver().getProof(), pmanager, &limits
     );
 }
 
@@ -210,14 +308,27 @@ void MainSolver::printFramesAsQuery() const
 
 sstat MainSolver::check()
 {
+    opensmt::PhaseTimer::Check timedCheck(config.getPhaseTimer());
     check_called ++;
+    unsatCore.clear();
+    cubeAndConquer.reset();
+    unknownReason = opensmt::UnknownReason::None;
+    limits.startQuery(config.time_limit(), config.memory_limit());
+    if (limits.exhausted()) {
+        // Interrupted before the query started
+        status = s_Undef;
+        return recordUnknownReason(status);
+    }
     if (config.timeQueries()) {
         printf("; %s query time so far: %f\n", solver_name.c_str(), query_timer.getTime());
-        opensmt::StopWatch sw(query_timer);
     }
+    opensmt::StopWatch sw(query_timer);
     if (isLastFrameUnsat()) {
         return s_False;
     }
+    if (usesCubeAndConquer()) {
+        return recordUnknownReason(checkCubeAndConquer());
+    }
     initialize();
     sstat rval = simplifyFormulas();
 
@@ -225,31 +336,195 @@ sstat MainSolver::check()
         printFramesAsQuery();
 
     if (rval == s_Undef) {
+        // A budget set by the caller of check, as local cube-and-conquer does, is kept
+        uint64_t const conflictLimit = config.conflict_limit();
+        uint64_t const conflictBudget = smt_solver->conflicts + conflictLimit;
+        if (conflictLimit > 0) { smt_solver->setConfBudget(conflictLimit); }
         try {
             rval = solve();
         } catch (std::overflow_error const& error) {
             rval = s_Error;
         }
+        if (conflictLimit > 0) {
+            smt_solver->budgetOff();
+            if (rval == s_Undef and smt_solver->conflicts >= conflictBudget) {
+                limits.giveUp(opensmt::UnknownReason::ConflictLimit);
+            }
+        }
         if (rval == s_False) {
             assert(not smt_solver->isOK());
-            rememberUnsatFrame(smt_solver->getConflictFrame());
+            extractUnsatCore();
+            if (unsatCore.size() > 0) {
+                // Unsatisfiable only under the assumptions, the frames stay usable
+                smt_solver->restoreOK();
+            } else {
+                // The frame of the symmetry breaking predicates comes last; they preserve satisfiability of all frames
+                std::size_t conflictFrame = smt_solver->getConflictFrame();
+                rememberUnsatFrame(std::min(conflictFrame, frames.size() - 1));
+            }
         }
     }
 
+    return recordUnknownReason(rval);
+}
+
+opensmt::Statistics MainSolver::getStatistics() const {
+    opensmt::Statistics stats;
+    stats.addCounter("solver.checks", check_called);
+    stats.addTime("solver.query-time", query_timer.getTime());
+    smt_solver->collectStatistics(stats);
+    thandler->getSolverHandler().collectStatistics(stats);
+    stats.add(parallelStatistics);
+    config.getPhaseTimer().collectStatistics(stats);
+    return stats;
+}
+
+sstat MainSolver::recordUnknownReason(sstat rval) {
+    if (rval == s_Undef) {
+        opensmt::UnknownReason reason = limits.getReason();
+        unknownReason = reason != opensmt::UnknownReason::None ? reason : opensmt::UnknownReason::Incomplete;
+    }
     return rval;
 }
 
+// The splits of the lookahead solver or of scattering are solved by local threads unless the query needs the state of
+// this solver
+bool MainSolver::usesCubeAndConquer() const {
+    if (config.sat_split_threads() <= 0 or assumptions.size() > 0 or config.produce_inter()) { return false; }
+    return (config.sat_split_type() == spt_lookahead and config.sat_split_num() > 1)
+           or (config.sat_split_type() == spt_scatter and config.sat_split_threads() > 1);
+}
+
+sstat MainSolver::checkCubeAndConquer() {
+    vec<PTRef> assertions;
+    for (PFRef frame : frames.getFrameReferences()) {
+        for (PTRef tr : pfstore[frame].formulas) {
+            if (tr != logic.getTerm_true()) { assertions.push(tr); }
+        }
+    }
+    opensmt::PhaseTimer::Scope scope(config.getPhaseTimer(), config.getPhaseTimer().getPhase("cube-and-conquer"));
+    cubeAndConquer = std::make_unique<CubeAndConquer>(logic, config, limits);
+    try {
+        status = cubeAndConquer->solve(assertions);
+    } catch (std::overflow_error const &) {
+        status = s_Error;
+    }
+    cubeAndConquer->collectStatistics(parallelStatistics);
+    if (status == s_False) {
+        rememberLastFrameUnsat();
+    }
+    if (status != s_True) {
+        cubeAndConquer.reset();
+    }
+    return status;
+}
+
+sstat MainSolver::checkAssuming(vec<PTRef> const & assumps)
+{
+    if (config.produce_inter()) {
+        throw OsmtApiException("Assumptions are not supported together with interpolation");
+    }
+    for (PTRef assumption : assumps) {
+        PTRef atom = logic.isNot(assumption) ? logic.getPterm(assumption)[0] : assumption;
+        if (not logic.isBoolAtom(atom)) {
+            throw OsmtApiException("Assumption is not a Boolean variable or its negation: " + logic.printTerm(assumption));
+        }
+    }
+    assumps.copyTo(assumptions);
+    sstat rval;
+    try {
+        rval = check();
+        if (rval == s_False and unsatCore.size() > 1 and config.minimize_unsat_cores()) {
+            minimizeUnsatCore();
+        }
+    } catch (...) {
+        assumptions.clear();
+        assumptionLits.clear();
+        throw;
+    }
+    assumptions.clear();
+    assumptionLits.clear();
+    return rval;
+}
+
+vec<PTRef> const & MainSolver::getUnsatCore() const {
+    if (status != s_False) { throw OsmtApiException("Unsat core cannot be extracted if solver is not in UNSAT state"); }
+    return unsatCore;
+}
+
+void MainSolver::mapAssumptionsToLits() {
+    assumptionLits.clear();
+    for (PTRef assumption : assumptions) {
+        Lit l = term_mapper->getOrCreateLit(assumption);
+        if (var(l) < smt_solver->nVars() and smt_solver->isEliminated(var(l))) {
+            throw OsmtApiException("Assumption " + logic.printTerm(assumption) + " has been eliminated by the preprocessing; use incremental mode");
+        }
+        assumptionLits.push(l);
+    }
+}
+
+void MainSolver::extractUnsatCore() {
+    unsatCore.clear();
+    // If the solver was already unsatisfiable, solve() returned before mapping the assumptions to literals
+    if (assumptions.size() == 0 or assumptionLits.size() != assumptions.size()) { return; }
+    // The final conflict consists of the negations of the failed assumptions
+    std::unordered_set<int> failed;
+    for (Lit l : smt_solver->conflict) {
+        failed.insert(toInt(~l));
+    }
+    for (int i = 0; i < assumptions.size(); ++i) {
+        if (failed.find(toInt(assumptionLits[i])) != failed.end()) {
+            unsatCore.push(assumptions[i]);
+        }
+    }
+}
+
+// Deletion-based minimization: an assumption is dropped for good if the query stays unsatisfiable without it, in which
+// case the core of that query also replaces the remaining candidates
+void MainSolver::minimizeUnsatCore() {
+    vec<PTRef> candidates;
+    vec<PTRef> necessary;
+    unsatCore.copyTo(candidates);
+    while (candidates.size() > 0) {
+        PTRef candidate = candidates.last();
+        candidates.pop();
+        necessary.copyTo(assumptions);
+        for (PTRef tr : candidates) { assumptions.push(tr); }
+        sstat rval = check();
+        if (rval == s_False) {
+            if (unsatCore.size() == 0) { // The assertions are unsatisfiable on their own
+                status = s_False;
+                return;
+            }
+            std::unordered_set<PTRef, PTRefHash> kept(necessary.begin(), necessary.end());
+            candidates.clear();
+            for (PTRef tr : unsatCore) {
+                if (kept.find(tr) == kept.end()) { candidates.push(tr); }
+            }
+        } else {
+            necessary.push(candidate);
+        }
+    }
+    necessary.copyTo(unsatCore);
+    status = s_False;
+}
+
 sstat MainSolver::solve()
 {
     if (!smt_solver->isOK()){
+        assumptionLits.clear(); // No assumption takes part in the conflict
         return s_False;
     }
 
+    mapAssumptionsToLits();
     vec<FrameId> en_frames;
     for (std::size_t i = 0; i < frames.size(); i++) {
         const PushFrame& frame = pfstore[frames.getFrameReference(i)];
         en_frames.push(frame.getId());
     }
+    if (symmetryFrame != FrameId_Undef) {
+        en_frames.push(symmetryFrame);
+    }
     status = sstat(solve_(en_frames));
 
     if (status == s_True && config.produce_models())
@@ -32,11 +32,14 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Model.h"
 #include "PartitionManager.h"
 #include "InterpolationContext.h"
+#include "ResourceLimits.h"
+#include "Statistics.h"
 
 #include <memory>
 
 
 class Logic;
+class CubeAndConquer;
 
 class sstat {
     char value;
@@ -114,6 +117,15 @@ class MainSolver
     int            check_called;     // A counter on how many times check was called.
     sstat          status;           // The status of the last solver call (initially s_Undef)
     unsigned int   inserted_formulas_count = 0; // Number of formulas that has been inserted to this solver
+    bool           symmetries_searched = false; // Symmetry breaking has been tried on the first assertions
+    FrameId        symmetryFrame = FrameId_Undef; // The frame of the symmetry breaking predicates while they are valid
+    vec<PTRef>     assumptions;                 // The assumptions of the query in progress
+    vec<Lit>       assumptionLits;              // The literals of the assumptions of the query in progress
+    vec<PTRef>     unsatCore;                   // The assumptions responsible for the unsatisfiability of the last query
+    std::unique_ptr<CubeAndConquer> cubeAndConquer; // The engine that solved the last query if it was solved in parallel
+    opensmt::ResourceLimits limits;             // The limits of the query in progress
+    opensmt::UnknownReason unknownReason = opensmt::UnknownReason::None; // Why the last query is unknown
+    opensmt::Statistics parallelStatistics;     // The statistics of the queries solved by cube-and-conquer
 
     class FContainer {
         PTRef   root;
@@ -129,14 +141,23 @@ class MainSolver
     sstat solve           ();
 
     virtual sstat solve_(vec<FrameId> & enabledFrames) {
-        return ts.solve(enabledFrames);
+        return ts.solve(enabledFrames, assumptionLits);
     }
 
+    bool  usesCubeAndConquer() const;
+    sstat checkCubeAndConquer();
+    sstat recordUnknownReason(sstat rval);
+
+    void mapAssumptionsToLits();
+    void extractUnsatCore();
+    void minimizeUnsatCore();
+
     sstat giveToSolver(PTRef root, FrameId push_id) {
         if (ts.cnfizeAndGiveToSolver(root, push_id) == l_False) return s_False;
         return s_Undef; }
 
     PTRef rewriteMaxArity(PTRef);
+    void breakSymmetries(PTRef root);
 
     // helper private methods
     PushFrame& getLastFrame() const { return pfstore[frames.last()]; }
@@ -154,58 +175,19 @@ class MainSolver
 
   public:
 
-    MainSolver(Logic& logic, SMTConfig& conf, std::string name)
-            :
-            theory(createTheory(logic, conf)),
-            term_mapper(new TermMapper(logic)),
-            thandler(new THandler(getTheory(), *term_mapper)),
-            smt_solver(createInnerSolver(conf, *thandler)),
-            logic(thandler->getLogic()),
-            pmanager(logic),
-            config(conf),
-            pfstore(getTheory().pfstore),
-            ts( config, logic, pmanager, *term_mapper, *smt_solver ),
-            solver_name {std::move(name)},
-            check_called(0),
-            status(s_Undef),
-            root_instance(logic.getTerm_true())
-    {
-        conf.setUsedForInitiliazation();
-        frames.push(pfstore.alloc());
-        PushFrame& last = pfstore[frames.last()];
-        last.push(logic.getTerm_true());
-    }
+    MainSolver(Logic& logic, SMTConfig& conf, std::string name);
 
     MainSolver(std::unique_ptr<Theory> th, std::unique_ptr<TermMapper> tm, std::unique_ptr<THandler> thd,
-               std::unique_ptr<SimpSMTSolver> ss, Logic & logic, SMTConfig & conf, std::string name)
-            :
-            theory(std::move(th)),
-            term_mapper(std::move(tm)),
-            thandler(std::move(thd)),
-            smt_solver(std::move(ss)),
-            logic(thandler->getLogic()),
-            pmanager(logic),
-            config(conf),
-            pfstore(getTheory().pfstore),
-            ts( config, logic, pmanager, *term_mapper, *smt_solver ),
-            solver_name {std::move(name)},
-            check_called(0),
-            status(s_Undef),
-            root_instance(logic.getTerm_true())
-    {
-        conf.setUsedForInitiliazation();
-        frames.push(pfstore.alloc());
-        PushFrame& last = pfstore[frames.last()];
-        last.push(logic.getTerm_true());
-    }
+               std::unique_ptr<SimpSMTSolver> ss, Logic & logic, SMTConfig & conf, std::string name);
 
-    virtual ~MainSolver() = default;
+    virtual ~MainSolver();
 
     SMTConfig& getConfig() { return config; }
     SimpSMTSolver& getSMTSolver() { return *smt_solver; }
     SimpSMTSolver const & getSMTSolver() const { return *smt_solver; }
 
     THandler &getTHandler() { return *thandler; }
+    THandler const & getTHandler() const { return *thandler; }
     Logic    &getLogic()    { return logic; }
     Theory   &getTheory()   { return *theory; }
     const Theory &getTheory() const { return *theory; }
@@ -217,6 +199,10 @@ class MainSolver
     void      initialize() { ts.solver.initialize(); ts.initialize(); }
 
     virtual sstat check();      // A wrapper for solve which simplifies the loaded formulas and initializes the solvers
+    // Checks the assertions under the given assumptions, Boolean variables or their negations.  Unlike a push, the
+    // assumptions need no pop afterwards, so the learnt clauses and the theory state are kept for the next query.
+    // Without incremental mode, a variable eliminated by the preprocessing of an earlier query cannot be assumed.
+    sstat checkAssuming(vec<PTRef> const & assumptions);
     // Simplify frames (not yet simplified) until all are simplified or the instance is detected unsatisfiable.
     sstat simplifyFormulas();
 
@@ -230,9 +216,27 @@ class MainSolver
     // Returns model of the last query (must be in satisfiable state)
     std::unique_ptr<Model> getModel();
 
+    // Returns the assumptions of the last query that suffice for unsatisfiability (must be in UNSAT state); the core is
+    // empty if the assertions are unsatisfiable on their own
+    vec<PTRef> const & getUnsatCore() const;
+
     void stop() { ts.solver.stop = true; }
 
-    // Returns interpolation context for the last query (must be in UNSAT state)
+    // Gives up the query in progress, or the next one if none is running, which then returns s_Undef; may be called
+    // from any thread.  The time, conflict and memory limits of a query are the options :time-limit, :conflict-limit
+    // and :memory-limit.
+    void interrupt() { limits.interrupt(); }
+    // Why the last query returned s_Undef
+    opensmt::UnknownReason getUnknownReason() const { return unknownReason; }
+    opensmt::ResourceLimits & getResourceLimits() { return limits; }
+
+    // The statistics of the queries so far: the queries (solver.*), the SAT search (sat.*), each theory solver,
+    // cube-and-conquer and the times of the phases of the config (phases.*).  The counters are kept by the subsystems
+    // anyway, so the snapshot costs nothing until taken.
+    opensmt::Statistics getStatistics() const;
+
+    // Returns interpolation context for the last query (must be in UNSAT state); the time and memory limits and
+    // interrupt() bound the reduction of the proof
     std::unique_ptr<InterpolationContext> getInterpolationContext();
 
     static std::unique_ptr<Theory> createTheory(Logic & logic, SMTConfig & config);
@@ -11,7 +11,8 @@
 #include "OsmtInternalException.h"
 
 void PartitionManager::propagatePartitionMask(PTRef root) {
-    ipartitions_t& p = getIPartitions(root);
+    // Copy, adding partitions to new terms may grow the table
+    ipartitions_t const p = getIPartitions(root);
     std::vector<bool> seen;
     // MB: Relies on invariant: Every subterm was created before its parent, so it has lower id
     auto size = Idx(logic.getPterm(root).getId()) + 1;
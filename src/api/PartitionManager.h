@@ -17,7 +17,7 @@ class PartitionManager {
     Logic & logic;
 
 public:
-    PartitionManager(Logic & l) : logic(l) {
+    PartitionManager(Logic & l) : partitionInfo(l), logic(l) {
         // MB: TODO: Is this necessary?
         ipartitions_t mask = 0;
         mask = ~mask;
@@ -46,6 +46,7 @@ namespace osmttokens {
         t_forall,
         t_assert,
         t_checksat,
+        t_checksatassuming,
         t_declaresort,
         t_definesort,
         t_declarefun,
@@ -60,6 +61,7 @@ namespace osmttokens {
         t_setoption,
         t_getproof,
         t_getunsatcore,
+        t_getunsatassumptions,
         t_getvalue,
         t_getmodel,
         t_pop,
@@ -82,6 +84,7 @@ namespace osmttokens {
         "forall",
         "assert",
         "check-sat",
+        "check-sat-assuming",
         "declare-sort",
         "define-sort",
         "declare-fun",
@@ -96,6 +99,7 @@ namespace osmttokens {
         "set-option",
         "get-proof",
         "get-unsat-core",
+        "get-unsat-assumptions",
         "get-value",
         "get-model",
         "pop",
@@ -121,6 +125,7 @@ namespace osmttokens {
         {t_forall, "forall"},
         {t_assert, "assert"},
         {t_checksat, "check-sat"},
+        {t_checksatassuming, "check-sat-assuming"},
         {t_declaresort, "declare-sort"},
         {t_definesort, "define-sort"},
         {t_declarefun, "declare-fun"},
@@ -135,6 +140,7 @@ namespace osmttokens {
         {t_setoption, "set-option"},
         {t_getproof, "get-proof"},
         {t_getunsatcore, "get-unsat-core"},
+        {t_getunsatassumptions, "get-unsat-assumptions"},
         {t_getvalue, "get-value"},
         {t_getmodel, "get-model"},
         {t_pop, "pop"},
@@ -30,6 +30,7 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "OsmtInternalException.h"
 
 #include <queue>
+#include <vector>
 
 #ifdef PEDANTIC_DEBUG
 #define TRACE(x) std::cerr << x << std::endl;
@@ -77,6 +78,12 @@ void Cnfizer::initialize()
 
 lbool
 Cnfizer::solve(vec<FrameId>& en_frames)
+{
+    return solve(en_frames, vec<Lit>{});
+}
+
+lbool
+Cnfizer::solve(vec<FrameId>& en_frames, vec<Lit> const & assumptions)
 {
     vec<Lit> assumps;
     // Initialize so that by default frames are disabled
@@ -102,7 +109,13 @@ Cnfizer::solve(vec<FrameId>& en_frames)
             assumps[j++] = assumps[i];
     }
     assumps.shrink(i-j);
-    return solver.solve(assumps, !config.isIncremental(), config.isIncremental());
+    for (Lit l : assumptions) {
+        solver.addVar(var(l)); // The variable need not occur in any clause
+        assumps.push(l);
+    }
+    solver.setUserAssumptions(assumptions);
+    // Unlike solve, keeps the conflict budget set on the solver
+    return solver.solveLimited(assumps, !config.isIncremental(), config.isIncremental());
 
 }
 
@@ -128,6 +141,7 @@ void Cnfizer::setFrameTerm(FrameId frame_id)
 //
 lbool Cnfizer::cnfizeAndGiveToSolver(PTRef formula, FrameId frame_id)
 {
+    opensmt::PhaseTimer::Scope scope(config.getPhaseTimer(), config.getPhaseTimer().getPhase("cnfize"));
     // Get the variable for the incrementality.
     setFrameTerm(frame_id);
 
@@ -470,6 +484,10 @@ void Cnfizer::retrieveConjuncts ( PTRef f, vec<PTRef> &conjuncts )
 lbool Cnfizer::getTermValue (PTRef tr) const
 {
     assert (solver.isOK());
+    if (config.cnf_polarity() and isBooleanConnective(tr)) {
+        // With the polarity-aware encoding the value of a Tseitin variable need not agree with its definition
+        return evaluateConnective(tr);
+    }
     if (tmap.hasLit(tr)) {
         Lit l = tmap.getLit(tr);
         lbool val = solver.modelValue(l);
@@ -479,6 +497,72 @@ lbool Cnfizer::getTermValue (PTRef tr) const
     else return l_Undef;
 }
 
+bool Cnfizer::isBooleanConnective(PTRef tr) const {
+    return logic.isAnd(tr) or logic.isOr(tr) or logic.isNot(tr) or logic.isIff(tr) or logic.isXor(tr) or logic.isImplies(tr);
+}
+
+lbool Cnfizer::evaluateConnective(PTRef root) const
+{
+    // The values computed for an earlier model are stale
+    if (connectiveValuesSolve != solver.solves) {
+        connectiveValues.clear();
+        connectiveValuesSolve = solver.solves;
+    }
+    auto valueOf = [this](PTRef tr) {
+        if (isBooleanConnective(tr)) { return connectiveValues.at(tr); }
+        return tmap.hasLit(tr) ? solver.modelValue(tmap.getLit(tr)) : l_Undef;
+    };
+    auto isEvaluated = [this](PTRef tr) {
+        return not isBooleanConnective(tr) or connectiveValues.find(tr) != connectiveValues.end();
+    };
+
+    // A connective is evaluated once all its arguments have been
+    struct Entry { PTRef tr; bool argsPushed; };
+    std::vector<Entry> stack{{root, false}};
+    while (not stack.empty()) {
+        Entry const entry = stack.back();
+        if (isEvaluated(entry.tr)) {
+            stack.pop_back();
+            continue;
+        }
+        Pterm const & pt = logic.getPterm(entry.tr);
+        if (not entry.argsPushed) {
+            stack.back().argsPushed = true;
+            for (PTRef arg : pt) {
+                if (not isEvaluated(arg)) { stack.push_back({arg, false}); }
+            }
+            continue;
+        }
+        stack.pop_back();
+        PTRef tr = entry.tr;
+        lbool val;
+        if (logic.isNot(tr)) {
+            val = valueOf(pt[0]) ^ true;
+        } else if (logic.isAnd(tr) or logic.isOr(tr)) {
+            bool isAnd = logic.isAnd(tr);
+            val = isAnd ? l_True : l_False;
+            for (PTRef arg : pt) {
+                lbool argVal = valueOf(arg);
+                val = isAnd ? (val && argVal) : (val || argVal);
+            }
+        } else {
+            assert(pt.size() == 2);
+            lbool lhs = valueOf(pt[0]);
+            lbool rhs = valueOf(pt[1]);
+            if (lhs == l_Undef or rhs == l_Undef) {
+                val = l_Undef;
+            } else if (logic.isImplies(tr)) {
+                val = (lhs ^ true) || rhs;
+            } else {
+                // iff and xor
+                val = lbool((lhs == l_True) == (rhs == l_True)) ^ logic.isXor(tr);
+            }
+        }
+        connectiveValues.emplace(tr, val);
+    }
+    return valueOf(root);
+}
+
 bool Cnfizer::Cache::contains(PTRef term, PTRef frame_term) {
     return cache.find(std::make_pair<>(term, frame_term)) != cache.end()
         || ( frame_term != zeroLevelTerm && cache.find(std::make_pair<>(term, zeroLevelTerm)) != cache.end());
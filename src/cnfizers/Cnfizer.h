@@ -32,6 +32,7 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "PartitionManager.h"
 #include "TermMapper.h"
 
+#include <unordered_map>
 #include <unordered_set>
 
 class SimpSMTSolver;
@@ -82,6 +83,7 @@ public:
 
     void   initialize      ();
     lbool  solve           (vec<FrameId>& en_frames);
+    lbool  solve           (vec<FrameId>& en_frames, vec<Lit> const & assumptions); // Assumes the literals on top of the frames
 
     bool  solverEmpty      ()                     const { return s_empty; }
 
@@ -113,6 +115,8 @@ private:
 
 protected:
     bool isLiteral(PTRef ptr) const;
+    bool isBooleanConnective(PTRef ptr) const;
+    lbool evaluateConnective(PTRef ptr) const; // Value of ptr computed from the values of its atoms
     inline Lit getOrCreateLiteralFor(PTRef ptr) {return this->tmap.getOrCreateLit(ptr);}
     inline vec<PTRef> getNestedBoolRoots(PTRef ptr) { return logic.getNestedBoolRoots(ptr); }
 
@@ -123,6 +127,11 @@ protected:
     vec<PTRef> frame_terms;
     PTRef current_frame_term;
     void setFrameTerm(FrameId frame_id);
+
+private:
+    // The values of the connectives in the model of the solve counted by connectiveValuesSolve
+    mutable std::unordered_map<PTRef, lbool, PTRefHash> connectiveValues;
+    mutable uint64_t connectiveValuesSolve = 0;
 };
 
 #endif
@@ -26,28 +26,53 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "Cnfizer.h"
 #include "Tseitin.h"
+#include "SimpSMTSolver.h"
 
 
-//
-// Performs the actual cnfization
-//
+bool Tseitin::cnfizeAndAssert(PTRef formula) {
+    assert(formula != PTRef_Undef);
+    // Top level formula must not be and anymore
+    assert(!logic.isAnd(formula));
+    bool res = true;
+    // Add the top level literal as a unit to solver.
+    vec<Lit> clause;
+    clause.push(this->getOrCreateLiteralFor(formula));
+    res &= addClause(clause);
 
+    // The asserted formula occurs only positively
+    res &= cnfize(formula, usePolarity() ? pol_pos : pol_both);
+    return res;
+}
 
 bool Tseitin::cnfize(PTRef term) {
+    // The literal of the term is used elsewhere (e.g., as an argument of an uninterpreted function) and must be
+    // equivalent to the term
+    return cnfize(term, pol_both);
+}
+
+//
+// Performs the actual cnfization
+//
+// Only the directions of the definitions required by the polarity of the subformula are emitted
+// (Plaisted-Greenbaum encoding). A term cnfized earlier receives the directions it is still missing in the current
+// frame, so that the definitions remain complete when the frame the term was first cnfized in is popped.
+//
+bool Tseitin::cnfize(PTRef term, Polarity polarity) {
     bool res = true;
-    vec<PTRef> unprocessed_terms {term};
+    std::vector<std::pair<PTRef, Polarity>> unprocessed_terms {{term, polarity}};
 
     //
     // Visit the DAG of the formula
     //
-    while (unprocessed_terms.size() != 0) {
+    while (not unprocessed_terms.empty()) {
 
-        PTRef ptr = unprocessed_terms.last();
-        unprocessed_terms.pop();
+        auto [ptr, pol] = unprocessed_terms.back();
+        unprocessed_terms.pop_back();
         //
-        // Skip if the node has already been processed before
+        // Skip the directions that have already been processed before
         //
-        if (alreadyCnfized.contains(ptr, current_frame_term)){
+        pol &= ~alreadyCnfized.emitted(ptr, current_frame_term);
+        if (pol == pol_none) {
             continue;
         }
 
@@ -55,15 +80,15 @@ bool Tseitin::cnfize(PTRef term) {
         // by calling findLit
         int sz = logic.getPterm(ptr).size();
         if (logic.isAnd(ptr))
-            res &= cnfizeAnd(ptr);
+            res &= cnfizeAnd(ptr, pol);
         else if (logic.isOr(ptr))
-            res &= cnfizeOr(ptr);
+            res &= cnfizeOr(ptr, pol);
         else if (logic.isXor(ptr))
-            res &= cnfizeXor(ptr);
+            res &= cnfizeXor(ptr, pol);
         else if (logic.isIff(ptr))
-            res &= cnfizeIff(ptr);
+            res &= cnfizeIff(ptr, pol);
         else if (logic.isImplies(ptr))
-            res &= cnfizeImplies(ptr);
+            res &= cnfizeImplies(ptr, pol);
         // Ites are handled through the ite manager system and treated here as variables
 //        else if (logic.isIte(ptr))
 //            res &= cnfizeIfthenelse(ptr);
@@ -71,20 +96,31 @@ bool Tseitin::cnfize(PTRef term) {
             goto tseitin_end;
         }
         {
+            // The arguments of and, or occur with the polarity of the term, the argument of not and the antecedent
+            // of an implication with the opposite one, and the arguments of iff and xor with both
+            Polarity arg_pol = pol;
+            if (logic.isNot(ptr))
+                arg_pol = flip(pol);
+            else if (logic.isXor(ptr) or logic.isIff(ptr))
+                arg_pol = pol_both;
             Pterm const& pt = logic.getPterm(ptr);
             for (int i = 0; i < pt.size(); i++) {
-                unprocessed_terms.push(pt[i]); // Using the PTRef is safe if a reallocation happened
+                bool antecedent = i == 0 and logic.isImplies(ptr);
+                unprocessed_terms.emplace_back(pt[i], antecedent ? flip(pol) : arg_pol); // Using the PTRef is safe if a reallocation happened
             }
         }
 tseitin_end:
-        alreadyCnfized.insert(ptr, current_frame_term);
+        alreadyCnfized.insert(ptr, current_frame_term, pol);
+        if (current_frame_term == logic.getTerm_true() and alreadyCnfized.emitted(ptr, current_frame_term) == pol_both) {
+            declareGate(ptr);
+        }
     }
 
     return res;
 }
 
 
-bool Tseitin::cnfizeAnd(PTRef and_term)
+bool Tseitin::cnfizeAnd(PTRef and_term, Polarity pol)
 {
 //  assert( list );
 //  assert( list->isList( ) );
@@ -107,16 +143,18 @@ bool Tseitin::cnfizeAnd(PTRef and_term)
         PTRef arg = logic.getPterm(and_term)[i];
         little_clause.push( this->getOrCreateLiteralFor(arg) );
         big_clause   .push(~this->getOrCreateLiteralFor(arg));
-        res &= addClause(little_clause);        // Adds a little clause to the solver
+        if (pol & pol_pos)
+            res &= addClause(little_clause);        // Adds a little clause to the solver
         little_clause.pop();
     }
-    res &= addClause(big_clause);                    // Adds a big clause to the solver
+    if (pol & pol_neg)
+        res &= addClause(big_clause);                    // Adds a big clause to the solver
     return res;
 }
 
 
 
-bool Tseitin::cnfizeOr(PTRef or_term)
+bool Tseitin::cnfizeOr(PTRef or_term, Polarity pol)
 {
     //
     // ( a_0 | ... | a_{n-1} )
@@ -136,16 +174,18 @@ bool Tseitin::cnfizeOr(PTRef or_term)
         little_clause.push(~arg);
         big_clause   .push( arg);
 
-        res &= addClause(little_clause);        // Adds a little clause to the solver
+        if (pol & pol_neg)
+            res &= addClause(little_clause);        // Adds a little clause to the solver
 
         little_clause.pop();
     }
-    res &= addClause(big_clause);                    // Adds a big clause to the solver
+    if (pol & pol_pos)
+        res &= addClause(big_clause);                    // Adds a big clause to the solver
     return res;
 }
 
 
-bool Tseitin::cnfizeXor(PTRef xor_term)
+bool Tseitin::cnfizeXor(PTRef xor_term, Polarity pol)
 {
     //
     // ( a_0 xor a_1 )
@@ -163,45 +203,47 @@ bool Tseitin::cnfizeXor(PTRef xor_term)
     vec<Lit> clause;
     bool res = true;
 
-    clause.push(~v);
+    if (pol & pol_pos) {
+        clause.push(~v);
 
-    // First clause
-    clause.push(arg0);
-    clause.push(arg1);
+        // First clause
+        clause.push(arg0);
+        clause.push(arg1);
 
-    res &= addClause(clause);
-    clause.pop();
-    clause.pop();
+        res &= addClause(clause);
+        clause.pop();
+        clause.pop();
 
-    // Second clause
-    clause.push(~arg0);
-    clause.push(~arg1);
+        // Second clause
+        clause.push(~arg0);
+        clause.push(~arg1);
 
-    res &= addClause(clause);
-    clause.pop();
-    clause.pop();
+        res &= addClause(clause);
+        clause.clear();
+    }
 
-    clause.pop();
-    clause.push(v);
+    if (pol & pol_neg) {
+        clause.push(v);
 
-    // Third clause
-    clause.push(~arg0);
-    clause.push( arg1);
+        // Third clause
+        clause.push(~arg0);
+        clause.push( arg1);
 
-    res &= addClause(clause);
+        res &= addClause(clause);
 
-    clause.pop();
-    clause.pop();
+        clause.pop();
+        clause.pop();
 
-    // Fourth clause
-    clause.push( arg0);
-    clause.push(~arg1);
+        // Fourth clause
+        clause.push( arg0);
+        clause.push(~arg1);
 
-    res &= addClause(clause);
+        res &= addClause(clause);
+    }
     return res;
 }
 
-bool Tseitin::cnfizeIff(PTRef eq_term)
+bool Tseitin::cnfizeIff(PTRef eq_term, Polarity pol)
 {
 
     //
@@ -219,43 +261,45 @@ bool Tseitin::cnfizeIff(PTRef eq_term)
     vec<Lit> clause;
     bool res = true;
 
-    clause.push(~v);
+    if (pol & pol_pos) {
+        clause.push(~v);
 
-    // First clause
-    clause.push( arg0);
-    clause.push(~arg1);
+        // First clause
+        clause.push( arg0);
+        clause.push(~arg1);
 
-    res &= addClause(clause);
+        res &= addClause(clause);
 
-    clause.pop();
-    clause.pop();
+        clause.pop();
+        clause.pop();
 
-    // Second clause
-    clause.push(~arg0);
-    clause.push( arg1);
+        // Second clause
+        clause.push(~arg0);
+        clause.push( arg1);
 
-    res &= addClause(clause);
+        res &= addClause(clause);
 
-    clause.pop();
-    clause.pop();
+        clause.clear();
+    }
 
-    clause.pop();
-    clause.push(v);
+    if (pol & pol_neg) {
+        clause.push(v);
 
-    // Third clause
-    clause.push(arg0);
-    clause.push(arg1);
+        // Third clause
+        clause.push(arg0);
+        clause.push(arg1);
 
-    res &= addClause(clause);
+        res &= addClause(clause);
 
-    clause.pop();
-    clause.pop();
+        clause.pop();
+        clause.pop();
 
-    // Fourth clause
-    clause.push(~arg0);
-    clause.push(~arg1);
+        // Fourth clause
+        clause.push(~arg0);
+        clause.push(~arg1);
 
-    res &= addClause(clause);
+        res &= addClause(clause);
+    }
     return res;
 }
 
@@ -304,7 +348,7 @@ bool Tseitin::cnfizeIfthenelse(PTRef ite_term)
 }
 
 
-bool Tseitin::cnfizeImplies(PTRef impl_term)
+bool Tseitin::cnfizeImplies(PTRef impl_term, Polarity pol)
 {
     // ( a_0 => a_1 )
     //
@@ -325,26 +369,80 @@ bool Tseitin::cnfizeImplies(PTRef impl_term)
     vec<Lit> clause;
     bool res = true;
 
-    clause.push(v);
+    if (pol & pol_neg) {
+        clause.push(v);
 
-    clause.push(a0);
+        clause.push(a0);
 
-    res &= addClause(clause);
+        res &= addClause(clause);
 
-    clause.pop();
+        clause.pop();
 
-    clause.push(~a1);
+        clause.push(~a1);
 
-    res &= addClause(clause);
+        res &= addClause(clause);
 
-    clause.clear();
+        clause.clear();
+    }
 
-    clause.push(~v); clause.push(~a0); clause.push(a1);
+    if (pol & pol_pos) {
+        clause.push(~v); clause.push(~a0); clause.push(a1);
 
-    res &= addClause(clause);
+        res &= addClause(clause);
+    }
     return res;
 }
 
+// Gives the definition of a term cnfized on the bottom level to the solver, which can use it in the simplifications.
+// The clauses emitted for the term are exactly the clauses of the gate.
+void Tseitin::declareGate(PTRef tr) {
+    using GateType = SimpSMTSolver::GateType;
+    if (not (logic.isAnd(tr) or logic.isOr(tr) or logic.isImplies(tr) or logic.isXor(tr) or logic.isIff(tr))) {
+        return;
+    }
+    Lit v = this->getOrCreateLiteralFor(tr);
+    vec<Lit> inputs;
+    for (int i = 0; i < logic.getPterm(tr).size(); i++) {
+        inputs.push(this->getOrCreateLiteralFor(logic.getPterm(tr)[i]));
+    }
+    if (logic.isAnd(tr)) {
+        solver.addGate(GateType::And, v, inputs);
+    } else if (logic.isOr(tr)) {
+        // ~v <-> and(~a_0, ..., ~a_{n-1})
+        for (Lit & l : inputs) { l = ~l; }
+        solver.addGate(GateType::And, ~v, inputs);
+    } else if (logic.isImplies(tr)) {
+        // ~v <-> and(a_0, ~a_1)
+        inputs[1] = ~inputs[1];
+        solver.addGate(GateType::And, ~v, inputs);
+    } else if (logic.isXor(tr)) {
+        solver.addGate(GateType::Xor, v, inputs);
+    } else {
+        // ~v <-> xor(a_0, a_1)
+        solver.addGate(GateType::Xor, ~v, inputs);
+    }
+}
+
+bool Tseitin::usePolarity() const {
+    return config.cnf_polarity() and not keepPartitionInfo();
+}
+
+Tseitin::Polarity Tseitin::PolarityCache::emitted(PTRef term, PTRef frame_term) const {
+    Polarity pol = pol_none;
+    auto it = cache.find(std::make_pair(term, frame_term));
+    if (it != cache.end()) { pol |= it->second; }
+    if (frame_term != zeroLevelTerm) {
+        it = cache.find(std::make_pair(term, zeroLevelTerm));
+        if (it != cache.end()) { pol |= it->second; }
+    }
+    return pol;
+}
+
+void Tseitin::PolarityCache::insert(PTRef term, PTRef frame_term, Polarity pol) {
+    assert((emitted(term, frame_term) & pol) == pol_none);
+    cache[std::make_pair(term, frame_term)] |= pol;
+}
+
 //void Tseitin::copyArgsWithCache(PTRef tr, vec<PTRef>& args, Map<PTRef, PTRef, PTRefHash>& cache)
 //{
 //    Pterm& t = logic.getPterm(tr);
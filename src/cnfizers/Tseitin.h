@@ -30,6 +30,8 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "PTRef.h"
 #include "Cnfizer.h"
 
+#include <unordered_map>
+
 class Tseitin : public Cnfizer
 {
 public:
@@ -53,16 +55,42 @@ public:
 
 private:
 
+    // Directions of the definition of a Tseitin variable v: pos stands for the clauses containing ~v, needed when v
+    // occurs positively, and neg for the clauses containing v, needed when v occurs negatively
+    using Polarity = uint8_t;
+    static constexpr Polarity pol_none = 0;
+    static constexpr Polarity pol_pos  = 1;
+    static constexpr Polarity pol_neg  = 2;
+    static constexpr Polarity pol_both = pol_pos | pol_neg;
+    static Polarity flip(Polarity pol) { return ((pol & pol_pos) << 1) | ((pol & pol_neg) >> 1); }
+
+    // Directions of the definitions already emitted for a term in a frame. Directions emitted on the zero level
+    // hold in every frame.
+    class PolarityCache {
+        PTRef zeroLevelTerm;
+        std::unordered_map<std::pair<PTRef, PTRef>, Polarity, PTRefPairHash> cache;
+    public:
+        PolarityCache(PTRef zeroLevelTerm): zeroLevelTerm(zeroLevelTerm) {}
+        Polarity emitted(PTRef term, PTRef frame_term) const;
+        void insert(PTRef term, PTRef frame_term, Polarity pol);
+    };
+
     // Cache of already cnfized terms. Note that this is different from Cnfizer cache of already processed top-level flas
-    Cache alreadyCnfized;
+    PolarityCache alreadyCnfized;
+
+    // Interpolation needs the full definitions, since the clauses are labelled by the partition of the formula
+    bool usePolarity() const;
 
-    bool cnfize             (PTRef);                          // Cnfize the given term
-    bool cnfizeAnd          (PTRef);                          // Cnfize conjunctions
-    bool cnfizeOr           (PTRef);                          // Cnfize disjunctions
-    bool cnfizeIff          (PTRef);                          // Cnfize iffs
-    bool cnfizeXor          (PTRef);                          // Cnfize xors
+    bool cnfizeAndAssert    (PTRef) override;                 // Cnfize the top level with positive polarity only
+    bool cnfize             (PTRef) override;                 // Cnfize the given term with both polarities
+    bool cnfize             (PTRef, Polarity);                // Cnfize the given term with the given polarity
+    bool cnfizeAnd          (PTRef, Polarity);                // Cnfize conjunctions
+    bool cnfizeOr           (PTRef, Polarity);                // Cnfize disjunctions
+    bool cnfizeIff          (PTRef, Polarity);                // Cnfize iffs
+    bool cnfizeXor          (PTRef, Polarity);                // Cnfize xors
     bool cnfizeIfthenelse   (PTRef);                          // Cnfize if then elses
-    bool cnfizeImplies      (PTRef);                          // Cnfize if then elses
+    bool cnfizeImplies      (PTRef, Polarity);                // Cnfize implications
+    void declareGate        (PTRef);                          // Pass the definition of a fully cnfized term to the solver
 //    void copyArgsWithCache(PTRef, vec<PTRef>&, Map<PTRef, PTRef, PTRefHash>&);
 };
 
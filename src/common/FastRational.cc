@@ -8,6 +8,15 @@ Copyright (c) 2008, 2009 Centre national de la recherche scientifique (CNRS)
 #include <sstream>
 #include <algorithm>
 
+FastRational::mpqPool::~mpqPool()
+{
+    while (!pool.empty()) {
+        mpq_clear(pool.top());
+        delete pool.top();
+        pool.pop();
+    }
+}
+
 mpq_ptr FastRational::mpqPool::alloc()
 {
     mpq_ptr r;
@@ -15,7 +24,8 @@ mpq_ptr FastRational::mpqPool::alloc()
         r = pool.top();
         pool.pop();
     } else {
-        r = store.emplace().get_mpq_t();
+        r = new __mpq_struct;
+        mpq_init(r);
     }
     return r;
 }
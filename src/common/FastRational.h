@@ -69,11 +69,17 @@ inline ulword absVal(lword x) {
 
 class FastRational
 {
+    // Each thread reuses the numbers released in it.  A number may be released in another thread than the one that
+    // allocated it, so the numbers are not owned by the pool that handed them out: only the released ones are freed
+    // with the pool.
     class mpqPool
     {
-        std::stack<mpq_class> store; // uses deque as storage to avoid realloc
         std::stack<mpq_ptr, std::vector<mpq_ptr>> pool;
     public:
+        mpqPool() = default;
+        mpqPool(mpqPool const &) = delete;
+        mpqPool & operator=(mpqPool const &) = delete;
+        ~mpqPool();
         mpq_ptr alloc();
         void release(mpq_ptr);
     };
@@ -82,7 +88,7 @@ class FastRational
     uword den{1};
     mpq_ptr mpq{nullptr};
 
-    inline static mpqPool pool;
+    inline static thread_local mpqPool pool;
     inline static thread_local mpz_class temp;
     inline static mpz_ptr mpz() { return temp.get_mpz_t(); }
 
@@ -13,14 +13,23 @@ PartitionInfo::assignTopLevelPartitionIndex(unsigned int n, PTRef tr) {
 
 ipartitions_t&
 PartitionInfo::getIPartitions(PTRef _t) {
-    // MB: // this default construct the value if the key was not present and it is default constructed to 0
-    return term_partitions[_t];
+    // Terms without partitions have the empty mask
+    auto index = termIndex(_t);
+    if (index >= term_partitions.size()) { term_partitions.resize(index + 1); }
+    return term_partitions[index];
 }
 
 void
 PartitionInfo::addIPartitions(PTRef _t, const ipartitions_t& _p) {
-    // MB: // this default construct the value if the key was not present and it is default constructed to 0
-    term_partitions[_t] |= _p;
+    auto index = termIndex(_t);
+    if (index >= term_partitions.size()) {
+        // _p may be an element of the table
+        ipartitions_t toAdd = _p;
+        term_partitions.resize(index + 1);
+        term_partitions[index] |= toAdd;
+        return;
+    }
+    term_partitions[index] |= _p;
 }
 
 ipartitions_t&
@@ -46,15 +55,8 @@ void PartitionInfo::addClausePartition(CRef c, const ipartitions_t & p) {
 
 void PartitionInfo::invalidatePartitions(const ipartitions_t& toinvalidate) {
     auto negated = ~toinvalidate;
-    for (auto it = term_partitions.begin(); it != term_partitions.end(); /* deliberately empty */) {
-        auto& current_info = it->second;
+    for (auto & current_info : term_partitions) {
         opensmt::andbit(current_info, current_info, negated);
-        if (current_info == 0) {
-            it = term_partitions.erase(it);
-        }
-        else {
-            ++it;
-        }
     }
     for (auto & sym_info : sym_partitions) {
         auto& current_info = sym_info.second;
@@ -6,8 +6,10 @@
 #define OPENSMT_PARTITIONINFO_H
 
 #include <unordered_map>
+#include <vector>
 
 #include "InterpolationUtils.h"
+#include "Logic.h"
 #include "PTRef.h"
 #include "SymRef.h"
 #include "SolverTypes.h"
@@ -15,12 +17,17 @@
 
 
 class PartitionInfo {
+    Logic const & logic;
     std::unordered_map<SymRef, ipartitions_t, SymRefHash> sym_partitions;
-    std::unordered_map<PTRef, ipartitions_t, PTRefHash> term_partitions;
+    std::vector<ipartitions_t> term_partitions; // Indexed by the term id
     std::unordered_map<CRef, ipartitions_t> clause_class;
     FlaPartitionMap flaPartitionMap;
 
+    uint32_t termIndex(PTRef t) const { return Idx(logic.getPterm(t).getId()); }
+
 public:
+    explicit PartitionInfo(Logic const & logic) : logic(logic) {}
+
     void assignTopLevelPartitionIndex(unsigned int n, PTRef tr); // The new partition system
     ipartitions_t& getIPartitions(PTRef t);
     void addIPartitions(PTRef t, const ipartitions_t& p);
@@ -0,0 +1,137 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "PhaseTimer.h"
+
+#include "Statistics.h"
+
+#include <cassert>
+#include <iomanip>
+#include <ostream>
+
+namespace opensmt {
+
+namespace {
+double toSeconds(std::chrono::steady_clock::duration d) {
+    return std::chrono::duration<double>(d).count();
+}
+
+double toMicroseconds(std::chrono::steady_clock::duration d) {
+    return std::chrono::duration<double, std::micro>(d).count();
+}
+}
+
+PhaseTimer::PhaseId PhaseTimer::getPhase(std::string const & name) {
+    auto [it, inserted] = ids.emplace(name, static_cast<PhaseId>(names.size()));
+    if (inserted) {
+        names.push_back(name);
+        times.emplace_back();
+    }
+    return it->second;
+}
+
+void PhaseTimer::enter(PhaseId phase) {
+    assert(phase < times.size());
+    ++times[phase].calls;
+    ++times[phase].active;
+    stack.push_back(Frame{phase, Clock::now(), Clock::duration::zero()});
+}
+
+void PhaseTimer::leave() {
+    assert(not stack.empty());
+    Frame const frame = stack.back();
+    stack.pop_back();
+    Clock::duration const duration = Clock::now() - frame.start;
+    Times & t = times[frame.phase];
+    t.self += duration - frame.nested;
+    if (--t.active == 0) {
+        t.total += duration;
+    }
+    if (not stack.empty()) {
+        stack.back().nested += duration;
+    }
+    if (traceOut and duration >= traceThreshold) {
+        trace(frame, duration);
+    }
+}
+
+void PhaseTimer::startCheck() {
+    if (checkDepth++ > 0) { return; }
+    atCheckStart = times;
+}
+
+void PhaseTimer::endCheck() {
+    assert(checkDepth > 0);
+    if (--checkDepth > 0) { return; }
+    ++checks;
+    // The phases registered during the check started from zero
+    atCheckStart.resize(times.size());
+    lastCheck.resize(times.size());
+    for (std::size_t i = 0; i < times.size(); ++i) {
+        lastCheck[i].self = times[i].self - atCheckStart[i].self;
+        lastCheck[i].total = times[i].total - atCheckStart[i].total;
+        lastCheck[i].calls = times[i].calls - atCheckStart[i].calls;
+    }
+    if (reportOut) {
+        printReport(*reportOut, Span::LastCheck);
+    }
+}
+
+void PhaseTimer::setTraceOut(std::ostream * out) {
+    if (traceOut) {
+        *traceOut << "\n]\n" << std::flush;
+    }
+    traceOut = out;
+    firstTraceEvent = true;
+    if (traceOut) {
+        *traceOut << '[';
+    }
+}
+
+void PhaseTimer::trace(Frame const & frame, Clock::duration duration) {
+    std::ostream & out = *traceOut;
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << (firstTraceEvent ? "\n" : ",\n") << std::fixed << std::setprecision(3)
+        << "{\"name\": \"" << names[frame.phase] << "\", \"cat\": \"opensmt\", \"ph\": \"X\", \"ts\": "
+        << toMicroseconds(frame.start - origin) << ", \"dur\": " << toMicroseconds(duration)
+        << ", \"pid\": 1, \"tid\": 1}";
+    firstTraceEvent = false;
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void PhaseTimer::collectStatistics(Statistics & stats, Span span) const {
+    std::vector<Times> const & ts = timesOf(span);
+    for (std::size_t i = 0; i < ts.size(); ++i) {
+        if (ts[i].calls == 0) { continue; }
+        stats.addTime("phases." + names[i], toSeconds(ts[i].self));
+        stats.addTime("phases." + names[i] + "-total", toSeconds(ts[i].total));
+        stats.addCounter("phases." + names[i] + "-calls", ts[i].calls);
+    }
+}
+
+void PhaseTimer::printReport(std::ostream & out, Span span) const {
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    if (span == Span::LastCheck) {
+        out << "; Phase times of check " << checks << '\n';
+    } else {
+        out << "; Phase times of all checks\n";
+    }
+    out << "; " << std::left << std::setw(24) << "phase" << std::right << std::setw(12) << "self (s)"
+        << std::setw(12) << "total (s)" << std::setw(12) << "calls" << '\n';
+    out << std::fixed << std::setprecision(3);
+    std::vector<Times> const & ts = timesOf(span);
+    for (std::size_t i = 0; i < ts.size(); ++i) {
+        if (ts[i].calls == 0) { continue; }
+        out << "; " << std::left << std::setw(24) << names[i] << std::right << std::setw(12) << toSeconds(ts[i].self)
+            << std::setw(12) << toSeconds(ts[i].total) << std::setw(12) << ts[i].calls << '\n';
+    }
+    out << std::flush;
+    out.flags(flags);
+    out.precision(precision);
+}
+
+}
@@ -0,0 +1,122 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef OPENSMT_PHASETIMER_H
+#define OPENSMT_PHASETIMER_H
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace opensmt {
+
+class Statistics;
+
+/**
+ * The wall time spent in the phases of the solver (parsing, preprocessing, cnfization, search, the checks of each
+ * theory solver).  A phase entered within another one is attributed to the inner phase only: the self time of a phase
+ * excludes the phases nested in it, while its total time includes them.
+ *
+ * Coarse phases run a few times per query and are always timed.  Fine phases run in the hot loops of the search and
+ * are timed only in the detailed mode, where a timed scope costs two reads of the clock.  The times are kept both in
+ * aggregate and for the last check of a query, and the timed scopes can be written as Chrome trace events to be
+ * inspected in a timeline viewer (chrome://tracing, Perfetto).
+ *
+ * A timer is used by a single thread.
+ */
+class PhaseTimer {
+public:
+    using PhaseId = uint32_t;
+    enum class Detail : char { Coarse, Fine };
+    enum class Span : char { All, LastCheck };
+
+    // Times the phase for the lifetime of the scope
+    class Scope {
+    public:
+        Scope(PhaseTimer & t, PhaseId phase, Detail detail = Detail::Coarse)
+            : timer(detail == Detail::Coarse or t.detailed ? &t : nullptr) {
+            if (timer) { timer->enter(phase); }
+        }
+        ~Scope() { if (timer) { timer->leave(); } }
+        Scope(Scope const &) = delete;
+        Scope & operator=(Scope const &) = delete;
+    private:
+        PhaseTimer * timer;
+    };
+
+    // Delimits the check of a query; the times of a check nested in another one are part of the outer check
+    class Check {
+    public:
+        explicit Check(PhaseTimer & t) : timer(t) { timer.startCheck(); }
+        ~Check() { timer.endCheck(); }
+        Check(Check const &) = delete;
+        Check & operator=(Check const &) = delete;
+    private:
+        PhaseTimer & timer;
+    };
+
+    PhaseTimer() = default;
+    PhaseTimer(PhaseTimer const &) = delete;
+    PhaseTimer & operator=(PhaseTimer const &) = delete;
+
+    // Returns the phase of the name, registering it on first use; the hot paths look their phases up once
+    PhaseId getPhase(std::string const & name);
+
+    void setDetailed(bool d) { detailed = d; }
+    bool isDetailed() const { return detailed; }
+    // The stream receiving the report of every check, nullptr for none
+    void setReportOut(std::ostream * out) { reportOut = out; }
+    // Starts writing the trace events to the stream, or ends the trace on nullptr
+    void setTraceOut(std::ostream * out);
+
+    // Adds the self time, the total time and the number of calls of each phase under phases.*
+    void collectStatistics(Statistics & stats, Span span = Span::All) const;
+    void printReport(std::ostream & out, Span span) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Shorter scopes are not traced, so that the trace of a long search stays readable
+    static constexpr std::chrono::microseconds traceThreshold{10};
+
+    struct Times {
+        Clock::duration self{};
+        Clock::duration total{};
+        uint64_t calls = 0;
+        unsigned active = 0;        // The phase is in the stack this many times; only the outermost adds to total
+    };
+    struct Frame {
+        PhaseId phase;
+        Clock::time_point start;
+        Clock::duration nested;     // The time of the phases entered within this one
+    };
+
+    std::vector<std::string> names;
+    std::unordered_map<std::string, PhaseId> ids;
+    std::vector<Times> times;
+    std::vector<Times> atCheckStart;
+    std::vector<Times> lastCheck;
+    std::vector<Frame> stack;
+    bool detailed = false;
+    unsigned checkDepth = 0;
+    uint64_t checks = 0;
+    std::ostream * reportOut = nullptr;
+    std::ostream * traceOut = nullptr;
+    bool firstTraceEvent = true;
+    Clock::time_point origin = Clock::now();
+
+    void enter(PhaseId phase);
+    void leave();
+    void startCheck();
+    void endCheck();
+    void trace(Frame const & frame, Clock::duration duration);
+    std::vector<Times> const & timesOf(Span span) const { return span == Span::All ? times : lastCheck; }
+};
+
+}
+
+#endif // OPENSMT_PHASETIMER_H
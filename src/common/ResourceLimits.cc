@@ -0,0 +1,63 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "ResourceLimits.h"
+
+#include "SystemQueries.h"
+
+#include <algorithm>
+
+namespace opensmt {
+
+char const * reasonUnknownName(UnknownReason reason) {
+    switch (reason) {
+        case UnknownReason::Interrupted:
+            return "interrupted";
+        case UnknownReason::TimeLimit:
+            return "timeout";
+        case UnknownReason::ConflictLimit:
+            return "conflict-limit";
+        case UnknownReason::MemoryLimit:
+            return "memout";
+        case UnknownReason::None:
+        case UnknownReason::Incomplete:
+        default:
+            return "incomplete";
+    }
+}
+
+void ResourceLimits::startQuery(uint64_t timeLimit, uint64_t memoryLimitMB) {
+    handledInterrupts = givenUpInterrupts;
+    reason = UnknownReason::None;
+    polls = 0;
+    Clock::time_point now = Clock::now();
+    deadline = timeLimit > 0 ? now + std::chrono::milliseconds(timeLimit) : Clock::time_point::max();
+    memoryLimit = memoryLimitMB * 1024 * 1024;
+    if (parent) {
+        deadline = std::min(deadline, parent->deadline);
+        if (parent->memoryLimit > 0 and (memoryLimit == 0 or parent->memoryLimit < memoryLimit)) {
+            memoryLimit = parent->memoryLimit;
+        }
+    }
+    nextMemoryCheck = now;
+    limited = deadline != Clock::time_point::max() or memoryLimit > 0;
+}
+
+bool ResourceLimits::readLimits() {
+    Clock::time_point now = Clock::now();
+    if (now >= deadline) {
+        reason = UnknownReason::TimeLimit;
+        return true;
+    }
+    if (memoryLimit > 0 and now >= nextMemoryCheck) {
+        nextMemoryCheck = now + memoryInterval;
+        if (memResident() > memoryLimit) {
+            reason = UnknownReason::MemoryLimit;
+            return true;
+        }
+    }
+    return false;
+}
+
+}
@@ -0,0 +1,86 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef OPENSMT_RESOURCELIMITS_H
+#define OPENSMT_RESOURCELIMITS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace opensmt {
+
+// Why a query ended without an answer
+enum class UnknownReason : char { None, Interrupted, TimeLimit, ConflictLimit, MemoryLimit, Incomplete };
+
+// The value of :reason-unknown for the reason
+char const * reasonUnknownName(UnknownReason reason);
+
+/**
+ * The resources of a query: the solver polls exhausted() in its loops, and interrupt() may be called from any thread
+ * to give up the query in progress.  An interrupt that comes between two queries is kept until the next query gives up
+ * on it, so that an interrupt racing with the start of a query is not lost.  Once a limit has been hit, exhausted()
+ * keeps returning true until the next query starts.
+ *
+ * The limits of a solver working for another one (a cuber or a worker of cube-and-conquer) have the limits of the
+ * other solver as their parent: the interrupt of the parent is seen by its children, and the queries of the children
+ * end no later than the query of the parent.  The children must start their queries while the parent's query runs.
+ */
+class ResourceLimits {
+public:
+    /**
+     * Starts a query; the interrupts not yet given up on end it at the first poll.
+     * @param timeLimit the wall time of the query in milliseconds, 0 for no limit
+     * @param memoryLimit the resident memory of the whole process in megabytes, 0 for no limit
+     */
+    void startQuery(uint64_t timeLimit, uint64_t memoryLimit);
+
+    void interrupt() { interrupts.fetch_add(1, std::memory_order_relaxed); }
+
+    void setParent(ResourceLimits const * p) { parent = p; }
+
+    // Checks the limits; the clock and the memory are only read on every pollInterval-th call
+    bool exhausted() {
+        if (reason != UnknownReason::None) { return true; }
+        if (interruptedSinceQueryStart() or (parent and parent->interruptedSinceQueryStart())) {
+            giveUp(UnknownReason::Interrupted);
+            return true;
+        }
+        return limited and ++polls % pollInterval == 0 and readLimits();
+    }
+
+    // Gives up the query for a limit watched by the caller
+    void giveUp(UnknownReason r) {
+        if (reason != UnknownReason::None) { return; }
+        reason = r;
+        if (r == UnknownReason::Interrupted) { givenUpInterrupts = interrupts.load(std::memory_order_relaxed); }
+    }
+
+    UnknownReason getReason() const { return reason; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr unsigned pollInterval = 64;
+    static constexpr std::chrono::milliseconds memoryInterval{10};
+
+    std::atomic<uint64_t> interrupts = 0;           // The calls to interrupt()
+    uint64_t givenUpInterrupts = 0;                 // The interrupts a query has given up on
+    uint64_t handledInterrupts = 0;                 // givenUpInterrupts when the query started
+    ResourceLimits const * parent = nullptr;
+    UnknownReason reason = UnknownReason::None;
+    bool limited = false;
+    unsigned polls = 0;
+    Clock::time_point deadline = Clock::time_point::max();
+    uint64_t memoryLimit = 0;                       // In bytes
+    Clock::time_point nextMemoryCheck;
+
+    bool readLimits();
+    // Read by the children as well, handledInterrupts does not change while the query runs
+    bool interruptedSinceQueryStart() const { return interrupts.load(std::memory_order_relaxed) > handledInterrupts; }
+};
+
+}
+
+#endif // OPENSMT_RESOURCELIMITS_H
@@ -20,6 +20,10 @@ class ScopedVector {
 public:
     void push(T const & element) { return elements.push_back(element); }
 
+    std::size_t size() const { return elements.size(); }
+    typename std::vector<T>::const_iterator begin() const { return elements.begin(); }
+    typename std::vector<T>::const_iterator end() const { return elements.end(); }
+
     void pushScope() { limits.push_back(elements.size()); }
 
     void popScope();
@@ -30,7 +34,7 @@ public:
 
 template<typename T>
 void ScopedVector<T>::popScope() {
-    popScope([](){});
+    popScope([](T const &) {});
 }
 
 template<typename T>
@@ -0,0 +1,157 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "Statistics.h"
+
+#include <cassert>
+#include <cctype>
+#include <iomanip>
+#include <ostream>
+
+namespace opensmt {
+
+void Histogram::merge(Histogram const & other) {
+    for (std::size_t i = 0; i < bucketCount; ++i) {
+        buckets[i] += other.buckets[i];
+    }
+    count += other.count;
+    total += other.total;
+    if (other.max > max) { max = other.max; }
+}
+
+std::size_t Histogram::usedBuckets() const {
+    std::size_t used = bucketCount;
+    while (used > 0 and buckets[used - 1] == 0) { --used; }
+    return used;
+}
+
+Statistics::Entry & Statistics::entry(std::string const & name, Kind kind) {
+    assert(name.find('.') != std::string::npos);
+    auto [it, inserted] = indices.emplace(name, entries.size());
+    if (inserted) {
+        entries.emplace_back(name, kind);
+    }
+    assert(entries[it->second].kind == kind);
+    return entries[it->second];
+}
+
+void Statistics::addCounter(std::string const & name, uint64_t value) {
+    entry(name, Kind::Counter).counter += value;
+}
+
+void Statistics::addTime(std::string const & name, double seconds) {
+    entry(name, Kind::Time).seconds += seconds;
+}
+
+void Statistics::addHistogram(std::string const & name, Histogram const & histogram) {
+    entry(name, Kind::Histogram).histogram.merge(histogram);
+}
+
+void Statistics::add(Statistics const & other) {
+    for (Entry const & e : other.entries) {
+        switch (e.kind) {
+            case Kind::Counter:
+                addCounter(e.name, e.counter);
+                break;
+            case Kind::Time:
+                addTime(e.name, e.seconds);
+                break;
+            case Kind::Histogram:
+                addHistogram(e.name, e.histogram);
+                break;
+        }
+    }
+}
+
+Statistics::Entry const * Statistics::find(std::string const & name) const {
+    auto it = indices.find(name);
+    return it == indices.end() ? nullptr : &entries[it->second];
+}
+
+std::string Statistics::keyOf(std::string const & displayName) {
+    std::string key;
+    for (char c : displayName) {
+        key.push_back(c == ' ' ? '-' : static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+    }
+    return key;
+}
+
+namespace {
+void printBuckets(std::ostream & out, Histogram const & histogram, char const * separator) {
+    for (std::size_t i = 0; i < histogram.usedBuckets(); ++i) {
+        out << (i == 0 ? "" : separator) << histogram.getBuckets()[i];
+    }
+}
+}
+
+void Statistics::printJson(std::ostream & out) const {
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(6);
+    // The subsystems in the order of their first statistic, each with the indices of its statistics
+    std::vector<std::pair<std::string, std::vector<std::size_t>>> sections;
+    std::unordered_map<std::string, std::size_t> sectionIndices;
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        std::string section = entries[i].name.substr(0, entries[i].name.find('.'));
+        auto [it, inserted] = sectionIndices.emplace(section, sections.size());
+        if (inserted) { sections.emplace_back(section, std::vector<std::size_t>{}); }
+        sections[it->second].second.push_back(i);
+    }
+    out << '{';
+    for (std::size_t s = 0; s < sections.size(); ++s) {
+        out << (s == 0 ? "" : ", ") << '"' << sections[s].first << "\": {";
+        bool first = true;
+        for (std::size_t i : sections[s].second) {
+            Entry const & e = entries[i];
+            out << (first ? "" : ", ") << '"' << e.name.substr(sections[s].first.size() + 1) << "\": ";
+            first = false;
+            switch (e.kind) {
+                case Kind::Counter:
+                    out << e.counter;
+                    break;
+                case Kind::Time:
+                    out << e.seconds;
+                    break;
+                case Kind::Histogram:
+                    out << "{\"count\": " << e.histogram.getCount() << ", \"total\": " << e.histogram.getTotal()
+                        << ", \"max\": " << e.histogram.getMax() << ", \"buckets\": [";
+                    printBuckets(out, e.histogram, ", ");
+                    out << "]}";
+                    break;
+            }
+        }
+        out << '}';
+    }
+    out << '}';
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void Statistics::printSmtLib(std::ostream & out) const {
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(3) << '(';
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        Entry const & e = entries[i];
+        out << (i == 0 ? ":" : "\n :") << e.name << ' ';
+        switch (e.kind) {
+            case Kind::Counter:
+                out << e.counter;
+                break;
+            case Kind::Time:
+                out << e.seconds;
+                break;
+            case Kind::Histogram:
+                out << '(';
+                printBuckets(out, e.histogram, " ");
+                out << ')';
+                break;
+        }
+    }
+    out << ')';
+    out.flags(flags);
+    out.precision(precision);
+}
+
+}
@@ -0,0 +1,94 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef OPENSMT_STATISTICS_H
+#define OPENSMT_STATISTICS_H
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace opensmt {
+
+/**
+ * Counts of values in buckets of powers of two: bucket 0 holds the value 0 and bucket i > 0 the values in
+ * [2^(i-1), 2^i).  Adding a value costs a bit scan and a few increments, so it can be done in the hot paths.
+ */
+class Histogram {
+public:
+    static constexpr std::size_t bucketCount = 65;
+
+    void add(uint64_t value) {
+        ++buckets[value == 0 ? 0 : 64 - __builtin_clzll(value)];
+        ++count;
+        total += value;
+        if (value > max) { max = value; }
+    }
+
+    void merge(Histogram const & other);
+
+    uint64_t getCount() const { return count; }
+    uint64_t getTotal() const { return total; }
+    uint64_t getMax() const { return max; }
+    std::array<uint64_t, bucketCount> const & getBuckets() const { return buckets; }
+    // The number of buckets up to the last non-empty one
+    std::size_t usedBuckets() const;
+
+private:
+    std::array<uint64_t, bucketCount> buckets{};
+    uint64_t count = 0;
+    uint64_t total = 0;
+    uint64_t max = 0;
+};
+
+/**
+ * A snapshot of the statistics of a solver.  The subsystems keep their own counters, timers and histograms and add
+ * them on request under dotted names, the subsystem first (sat.conflicts, la-solver.pivots).  A statistic added again
+ * under the same name is accumulated, so that the statistics of several solvers can be summed up.
+ */
+class Statistics {
+public:
+    enum class Kind : char { Counter, Time, Histogram };
+
+    struct Entry {
+        Entry(std::string name, Kind kind) : name(std::move(name)), kind(kind) {}
+        std::string name;
+        Kind kind;
+        uint64_t counter = 0;
+        double seconds = 0;
+        Histogram histogram;
+    };
+
+    void addCounter(std::string const & name, uint64_t value);
+    void addTime(std::string const & name, double seconds);
+    void addHistogram(std::string const & name, Histogram const & histogram);
+    // Adds all statistics of the other snapshot
+    void add(Statistics const & other);
+
+    std::vector<Entry> const & getEntries() const { return entries; }
+    // Returns nullptr if there is no statistic of the name
+    Entry const * find(std::string const & name) const;
+
+    // A JSON object with an object for every subsystem, in the order of the first statistic of each subsystem
+    void printJson(std::ostream & out) const;
+    // The SMT-LIB response to (get-info :all-statistics)
+    void printSmtLib(std::ostream & out) const;
+
+    // The key of the statistics of a subsystem from its display name: "LA Solver" becomes "la-solver"
+    static std::string keyOf(std::string const & displayName);
+
+private:
+    std::vector<Entry> entries;
+    std::unordered_map<std::string, std::size_t> indices;
+
+    Entry & entry(std::string const & name, Kind kind);
+};
+
+}
+
+#endif // OPENSMT_STATISTICS_H
@@ -45,6 +45,8 @@ namespace opensmt {
 }
 
 static inline uint64_t memUsed() { return (uint64_t)memReadStat(0) * (uint64_t)getpagesize(); }
+// The resident set size, i.e., the memory actually backed by RAM
+static inline uint64_t memResident() { return (uint64_t)memReadStat(1) * (uint64_t)getpagesize(); }
 
 #elif defined(__FreeBSD__) || defined(__OSX__) || defined(__APPLE__)
     static inline uint64_t memUsed()
@@ -65,8 +67,11 @@ static inline uint64_t memUsed() { return (uint64_t)memReadStat(0) * (uint64_t)g
         }
         return value;
     }
+    // ps reports the resident set size already
+    static inline uint64_t memResident() { return memUsed(); }
 #else // stub to support every platform
     static inline uint64_t memUsed() {return 0; }
+    static inline uint64_t memResident() {return 0; }
 #endif
 
 
@@ -75,5 +80,6 @@ static inline uint64_t memUsed() { return (uint64_t)memReadStat(0) * (uint64_t)g
 
 using opensmt::cpuTime;
 using opensmt::memUsed;
+using opensmt::memResident;
 
 #endif // SYSTEMQUERIES_H
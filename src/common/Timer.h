@@ -66,7 +66,7 @@ public:
         tv_usec += other.tv_usec;
         return *this;
     }
-    double getTime()
+    double getTime() const
     {
         return tv_sec + tv_usec/(double)1000000;
     }
@@ -96,7 +96,7 @@ public:
         systime += from.systime;
         return *this;
     }
-    double getTime()
+    double getTime() const
     {
         return usrtime.getTime() + systime.getTime();
     }
@@ -7,10 +7,12 @@
 #ifndef OPENSMT_INTERPOLATIONUTILS_H
 #define OPENSMT_INTERPOLATIONUTILS_H
 
-#include <gmpxx.h>
+#include "PartitionMask.h"
 
 #include <cassert>
 #include <set>
+#include <stdexcept>
+#include <string>
 
 namespace opensmt {
 enum class icolor_t : char {
@@ -42,26 +44,28 @@ inline std::string colorToString(icolor_t c) {
     }
 }
 
-using ipartitions_t = mpz_class;
+using ipartitions_t = PartitionMask;
 
-inline void setbit(ipartitions_t & p, const unsigned b) { mpz_setbit(p.get_mpz_t(), b); }
+inline void setbit(ipartitions_t & p, const unsigned b) { p.set(b); }
 
-inline void clrbit(ipartitions_t & p, const unsigned b) { mpz_clrbit(p.get_mpz_t(), b); }
+inline void clrbit(ipartitions_t & p, const unsigned b) { p.reset(b); }
 
-inline int tstbit(const ipartitions_t & p, const unsigned b) { return mpz_tstbit(p.get_mpz_t(), b); }
+inline int tstbit(const ipartitions_t & p, const unsigned b) { return p.test(b); }
 
 // Set rop to op1 bitwise-and op2.
 inline void andbit(ipartitions_t & ipres, const ipartitions_t & ip1, const ipartitions_t & ip2) {
-    mpz_and(ipres.get_mpz_t(), ip1.get_mpz_t(), ip2.get_mpz_t());
+    if (&ipres != &ip1) { ipres = ip1; }
+    ipres &= ip2;
 }
 
 // Set rop to op1 bitwise inclusive-or op2.
 inline void orbit(ipartitions_t & ipres, const ipartitions_t & ip1, const ipartitions_t & ip2) {
-    mpz_ior(ipres.get_mpz_t(), ip1.get_mpz_t(), ip2.get_mpz_t());
+    if (&ipres != &ip1) { ipres = ip1; }
+    ipres |= ip2;
 }
 
-inline bool isAlocal (const ipartitions_t & p, const ipartitions_t & mask) { return (p & mask) != 0; }
-inline bool isBlocal (const ipartitions_t & p, const ipartitions_t & mask) { return (p & ~mask) != 0; }
+inline bool isAlocal (const ipartitions_t & p, const ipartitions_t & mask) { return p.intersects(mask); }
+inline bool isBlocal (const ipartitions_t & p, const ipartitions_t & mask) { return p.intersectsComplement(mask); }
 inline bool isAstrict(const ipartitions_t & p, const ipartitions_t & mask) { return isAlocal(p, mask) and not isBlocal(p, mask); }
 inline bool isBstrict(const ipartitions_t & p, const ipartitions_t & mask) { return isBlocal( p, mask ) and not isAlocal(p, mask); }
 inline bool isAB     (const ipartitions_t & p, const ipartitions_t & mask) { return isAlocal( p, mask ) and isBlocal(p, mask); }
@@ -0,0 +1,197 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef OPENSMT_PARTITIONMASK_H
+#define OPENSMT_PARTITIONMASK_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <utility>
+
+namespace opensmt {
+/**
+ * Set of partition indices stored as a bit vector.
+ *
+ * The bits beyond the stored words all have the value of the fill bit, so that the complement of a mask is again
+ * a mask (as with two's complement integers). Masks of up to 128 partitions are stored inline; larger masks spill
+ * to the heap. Trailing words equal to the fill are never stored, which keeps the representation canonical.
+ */
+class PartitionMask {
+    using word_t = std::uint64_t;
+    static constexpr unsigned wordBits = 64;
+    static constexpr std::uint32_t inlineWords = 2;
+
+    union {
+        word_t local[inlineWords];
+        word_t * heap;
+    };
+    std::uint32_t sz = 0;
+    std::uint32_t cap = inlineWords;
+    bool fill = false;
+
+    bool onHeap() const { return cap > inlineWords; }
+    word_t * data() { return onHeap() ? heap : local; }
+    word_t const * data() const { return onHeap() ? heap : local; }
+    word_t fillWord() const { return fill ? ~word_t(0) : word_t(0); }
+    word_t wordAt(std::uint32_t i) const { return i < sz ? data()[i] : fillWord(); }
+
+    void grow(std::uint32_t n) {
+        if (n <= sz) { return; }
+        if (n > cap) {
+            std::uint32_t newCap = std::max(n, 2 * cap);
+            auto * newData = new word_t[newCap];
+            std::memcpy(newData, data(), sz * sizeof(word_t));
+            if (onHeap()) { delete[] heap; }
+            heap = newData;
+            cap = newCap;
+        }
+        std::fill(data() + sz, data() + n, fillWord());
+        sz = n;
+    }
+
+    void normalize() {
+        word_t const * d = data();
+        while (sz > 0 and d[sz - 1] == fillWord()) { --sz; }
+    }
+
+    template<typename TOp>
+    PartitionMask & combine(PartitionMask const & other, TOp op) {
+        // If other is this, its size cannot grow and its words are not moved
+        grow(other.sz);
+        word_t * d = data();
+        for (std::uint32_t i = 0; i < sz; ++i) { d[i] = op(d[i], other.wordAt(i)); }
+        fill = op(fillWord(), other.fillWord()) != 0;
+        normalize();
+        return *this;
+    }
+
+    void copyFrom(PartitionMask const & other) {
+        sz = 0;
+        fill = other.fill;
+        grow(other.sz);
+        std::memcpy(data(), other.data(), other.sz * sizeof(word_t));
+    }
+
+public:
+    PartitionMask() = default;
+
+    PartitionMask(unsigned long value) {
+        local[0] = value;
+        sz = value == 0 ? 0 : 1;
+    }
+
+    PartitionMask(PartitionMask const & other) { copyFrom(other); }
+
+    PartitionMask(PartitionMask && other) noexcept : sz(other.sz), cap(other.cap), fill(other.fill) {
+        if (other.onHeap()) {
+            heap = other.heap;
+            other.cap = inlineWords;
+        } else {
+            std::memcpy(local, other.local, sz * sizeof(word_t));
+        }
+        other.sz = 0;
+        other.fill = false;
+    }
+
+    PartitionMask & operator=(PartitionMask const & other) {
+        if (this != &other) { copyFrom(other); }
+        return *this;
+    }
+
+    PartitionMask & operator=(PartitionMask && other) noexcept {
+        if (this == &other) { return *this; }
+        if (other.onHeap()) {
+            if (onHeap()) { delete[] heap; }
+            heap = other.heap;
+            cap = other.cap;
+            sz = other.sz;
+            fill = other.fill;
+            other.cap = inlineWords;
+        } else {
+            copyFrom(other);
+        }
+        other.sz = 0;
+        other.fill = false;
+        return *this;
+    }
+
+    ~PartitionMask() { if (onHeap()) { delete[] heap; } }
+
+    bool test(unsigned b) const { return (wordAt(b / wordBits) >> (b % wordBits)) & 1; }
+
+    void set(unsigned b) {
+        if (test(b)) { return; }
+        grow(b / wordBits + 1);
+        data()[b / wordBits] |= word_t(1) << (b % wordBits);
+        normalize();
+    }
+
+    void reset(unsigned b) {
+        if (not test(b)) { return; }
+        grow(b / wordBits + 1);
+        data()[b / wordBits] &= ~(word_t(1) << (b % wordBits));
+        normalize();
+    }
+
+    bool none() const { return sz == 0 and not fill; }
+
+    // Whether the two masks have a common partition, i.e., (*this & other) != 0, without building the intersection
+    bool intersects(PartitionMask const & other) const {
+        std::uint32_t n = std::max(sz, other.sz);
+        for (std::uint32_t i = 0; i < n; ++i) {
+            if (wordAt(i) & other.wordAt(i)) { return true; }
+        }
+        return fill and other.fill;
+    }
+
+    // Whether some partition of this mask is missing in other, i.e., (*this & ~other) != 0
+    bool intersectsComplement(PartitionMask const & other) const {
+        std::uint32_t n = std::max(sz, other.sz);
+        for (std::uint32_t i = 0; i < n; ++i) {
+            if (wordAt(i) & ~other.wordAt(i)) { return true; }
+        }
+        return fill and not other.fill;
+    }
+
+    PartitionMask & operator&=(PartitionMask const & other) { return combine(other, [](word_t a, word_t b) { return a & b; }); }
+    PartitionMask & operator|=(PartitionMask const & other) { return combine(other, [](word_t a, word_t b) { return a | b; }); }
+    PartitionMask & operator^=(PartitionMask const & other) { return combine(other, [](word_t a, word_t b) { return a ^ b; }); }
+
+    friend PartitionMask operator&(PartitionMask a, PartitionMask const & b) { return std::move(a &= b); }
+    friend PartitionMask operator|(PartitionMask a, PartitionMask const & b) { return std::move(a |= b); }
+    friend PartitionMask operator^(PartitionMask a, PartitionMask const & b) { return std::move(a ^= b); }
+
+    friend PartitionMask operator~(PartitionMask a) {
+        word_t * d = a.data();
+        for (std::uint32_t i = 0; i < a.sz; ++i) { d[i] = ~d[i]; }
+        a.fill = not a.fill;
+        return a;
+    }
+
+    friend bool operator==(PartitionMask const & a, PartitionMask const & b) {
+        return a.fill == b.fill and a.sz == b.sz and std::equal(a.data(), a.data() + a.sz, b.data());
+    }
+
+    friend bool operator!=(PartitionMask const & a, PartitionMask const & b) { return not(a == b); }
+
+    // Prints the indices of the partitions; the complement of a finite set is printed as ~{...}
+    friend std::ostream & operator<<(std::ostream & out, PartitionMask const & mask) {
+        if (mask.fill) { out << '~'; }
+        out << '{';
+        bool first = true;
+        for (unsigned b = 0; b < mask.sz * wordBits; ++b) {
+            if (mask.test(b) != mask.fill) {
+                out << (first ? "" : ",") << b;
+                first = false;
+            }
+        }
+        return out << '}';
+    }
+};
+}
+
+#endif //OPENSMT_PARTITIONMASK_H
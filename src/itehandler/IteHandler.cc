@@ -3,11 +3,15 @@
 //
 
 #include "IteHandler.h"
+#include "IteLifter.h"
 #include "IteToSwitch.h"
 
 #include "OsmtInternalException.h"
 
 PTRef IteHandler::rewrite(PTRef root) {
+    if (liftItes) {
+        root = IteLifter(logic).lift(root);
+    }
     IteToSwitch switches(logic, root);
     PTRef new_root = switches.conjoin(root);
     return new_root == root ? root : replaceItes(new_root);
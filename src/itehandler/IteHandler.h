@@ -16,6 +16,8 @@ private:
 
     std::string suffix;
 
+    bool liftItes = false;
+
     PTRef getAuxVarFor(PTRef ite);
 
     PTRef replaceItes(PTRef root);
@@ -26,6 +28,10 @@ public:
 
     IteHandler(Logic & logic, unsigned long partitionNumber) : logic(logic), suffix('_' + std::to_string(partitionNumber)) {}
 
+    // With liftItes, the ites with a single use are first lifted out of the sums and atoms (see IteLifter)
+    IteHandler(Logic & logic, unsigned long partitionNumber, bool liftItes)
+        : logic(logic), suffix('_' + std::to_string(partitionNumber)), liftItes(liftItes) {}
+
     PTRef rewrite(PTRef root);
 
     static PTRef getIteTermFor(Logic const & logic, PTRef auxVar); // The inverse of getAuxVarFor
@@ -0,0 +1,307 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "IteLifter.h"
+
+#include "ArithLogic.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+IteLifter::IteLifter(Logic & logic) : logic(logic), arithLogic(dynamic_cast<ArithLogic *>(&logic)) {}
+
+PTRef IteLifter::substituted(Substitutions const & substitutions, PTRef tr) {
+    auto it = substitutions.find(tr);
+    return it == substitutions.end() ? tr : it->second;
+}
+
+PTRef IteLifter::lift(PTRef root) {
+    countUses(root);
+    // MB: Relies on an invariant that id of a child is lower than id of a parent.
+    auto size = Idx(logic.getPterm(root).getId()) + 1;
+    std::vector<char> done(size, 0);
+    Substitutions substitutions;
+    struct DFSEntry {
+        DFSEntry(PTRef term) : term(term) {}
+        PTRef term;
+        unsigned int nextChild = 0;
+    };
+    std::vector<DFSEntry> toProcess;
+    toProcess.emplace_back(root);
+    while (not toProcess.empty()) {
+        auto & currentEntry = toProcess.back();
+        PTRef currentRef = currentEntry.term;
+        Pterm const & term = logic.getPterm(currentRef);
+        unsigned childrenCount = term.size();
+        if (currentEntry.nextChild < childrenCount) {
+            PTRef nextChild = term[currentEntry.nextChild];
+            ++currentEntry.nextChild;
+            if (not done[Idx(logic.getPterm(nextChild).getId())]) {
+                toProcess.push_back(DFSEntry(nextChild));
+            }
+            continue;
+        }
+        auto currentId = Idx(term.getId());
+        vec<PTRef> newArgs(childrenCount);
+        bool needsChange = false;
+        for (unsigned i = 0; i < childrenCount; ++i) {
+            newArgs[i] = substituted(substitutions, term[i]);
+            needsChange |= newArgs[i] != term[i];
+        }
+        SymRef symb = term.symb();
+        PTRef newTerm = needsChange ? logic.insertTerm(symb, std::move(newArgs)) : currentRef;
+        // The reference "term" has now been possibly invalidated! Do not access it anymore!
+        if (arithLogic and arithLogic->isPlus(currentRef)) {
+            newTerm = rewriteSum(currentRef, newTerm, substitutions);
+        } else if ((logic.isEquality(currentRef) and not logic.hasSortBool(logic.getPterm(currentRef)[0]))
+                   or (arithLogic and arithLogic->isLeq(currentRef))) {
+            newTerm = rewriteAtom(currentRef, newTerm, substitutions);
+        }
+        if (newTerm != currentRef) {
+            substitutions.insert({currentRef, newTerm});
+        }
+        done[currentId] = 1;
+        toProcess.pop_back();
+    }
+    return substituted(substitutions, root);
+}
+
+void IteLifter::countUses(PTRef root) {
+    auto termMarks = logic.getTermMarks(logic.getPterm(root).getId());
+    std::vector<PTRef> queue{root};
+    termMarks.mark(logic.getPterm(root).getId());
+    while (not queue.empty()) {
+        PTRef tr = queue.back();
+        queue.pop_back();
+        Pterm const & term = logic.getPterm(tr);
+        for (int i = 0; i < term.size(); ++i) {
+            PTRef child = term[i];
+            // A use of an ite inside another ite does not need a variable, the ites form a single switch
+            bool repeated = std::find(term.begin(), term.begin() + i, child) != term.begin() + i;
+            if (not logic.isIte(tr) and not repeated) {
+                ++uses[child];
+            }
+            if (not termMarks.isMarked(logic.getPterm(child).getId())) {
+                termMarks.mark(logic.getPterm(child).getId());
+                queue.push_back(child);
+            }
+        }
+    }
+}
+
+PTRef IteLifter::rewriteSum(PTRef sum, PTRef newSum, Substitutions const & substitutions) {
+    PTRef one = arithLogic->getOneForSort(logic.getSortRef(sum));
+    std::vector<PTRef> coeffs;
+    State ites;
+    vec<PTRef> rest;
+    Pterm const & term = logic.getPterm(sum);
+    for (PTRef summand : term) {
+        PTRef coeff = PTRef_Undef;
+        PTRef ite = PTRef_Undef;
+        if (isLiftableIte(summand) and hasSingleUse(summand)) {
+            coeff = one;
+            ite = summand;
+        } else if (arithLogic->isTimes(summand) and hasSingleUse(summand)) {
+            auto [var, constant] = arithLogic->splitTermToVarAndConst(summand);
+            if (isLiftableIte(var) and hasSingleUse(var)) {
+                coeff = constant;
+                ite = var;
+            }
+        }
+        PTRef newIte = ite == PTRef_Undef ? PTRef_Undef : substituted(substitutions, ite);
+        if (newIte != PTRef_Undef and isLiftableIte(newIte)) {
+            coeffs.push_back(coeff);
+            ites.push_back(newIte);
+        } else {
+            rest.push(substituted(substitutions, summand));
+        }
+    }
+    if (ites.empty()) { return newSum; }
+
+    PTRef restSum = rest.size() == 0 ? PTRef_Undef : arithLogic->mkPlus(std::move(rest));
+    if (ites.size() == 1) {
+        liftableSums.insert({newSum, {restSum, coeffs[0], ites[0]}});
+        return newSum;
+    }
+    // Merge the ites only if the result is not larger than the ites themselves
+    std::size_t limit = 0;
+    for (PTRef ite : ites) { limit += treeSize(ite); }
+    std::map<State, PTRef> states;
+    if (not exploreStates(ites, states, limit)) { return newSum; }
+
+    PTRef merged = mergeItes(ites, coeffs, states);
+    mergedItes += ites.size() - 1;
+    PTRef res = restSum == PTRef_Undef ? merged : arithLogic->mkPlus(restSum, merged);
+    if (isLiftableIte(merged)) {
+        liftableSums.insert({res, {restSum, one, merged}});
+    }
+    return res;
+}
+
+PTRef IteLifter::rewriteAtom(PTRef atom, PTRef newAtom, Substitutions const & substitutions) {
+    int argCount = logic.getPterm(atom).size();
+    for (int i = 0; i < argCount; ++i) {
+        PTRef arg = logic.getPterm(atom)[i];
+        if (not hasSingleUse(arg)) { continue; }
+        PTRef newArg = substituted(substitutions, arg);
+        if (logic.isIte(arg) and isLiftableIte(newArg)) {
+            return liftIntoAtom(atom, i, {PTRef_Undef, PTRef_Undef, newArg}, substitutions);
+        }
+        auto it = liftableSums.find(newArg);
+        if (it != liftableSums.end()) {
+            return liftIntoAtom(atom, i, it->second, substitutions);
+        }
+    }
+    return newAtom;
+}
+
+// Replaces the atom by (and (or (not c) atom[then/ite]) (or c atom[else/ite])) recursively over the ite
+PTRef IteLifter::liftIntoAtom(PTRef atom, int argIndex, LinearIte const & arg, Substitutions const & substitutions) {
+    ++liftedAtoms;
+    SymRef symb = logic.getSymRef(atom);
+    vec<PTRef> args;
+    for (PTRef child : logic.getPterm(atom)) {
+        args.push(substituted(substitutions, child));
+    }
+    auto mkLeafAtom = [&](PTRef leaf) {
+        PTRef value = leaf;
+        if (arg.coeff != PTRef_Undef) {
+            value = arithLogic->mkTimes(arg.coeff, leaf);
+            value = arg.rest == PTRef_Undef ? value : arithLogic->mkPlus(arg.rest, value);
+        }
+        vec<PTRef> leafArgs;
+        args.copyTo(leafArgs);
+        leafArgs[argIndex] = value;
+        return logic.insertTerm(symb, std::move(leafArgs));
+    };
+
+    std::unordered_map<PTRef, PTRef, PTRefHash> lifted;
+    std::vector<PTRef> toProcess{arg.ite};
+    while (not toProcess.empty()) {
+        PTRef node = toProcess.back();
+        if (lifted.find(node) != lifted.end()) {
+            toProcess.pop_back();
+            continue;
+        }
+        if (not logic.isIte(node)) {
+            lifted.insert({node, mkLeafAtom(node)});
+            toProcess.pop_back();
+            continue;
+        }
+        PTRef cond = logic.getPterm(node)[0];
+        PTRef thenNode = logic.getPterm(node)[1];
+        PTRef elseNode = logic.getPterm(node)[2];
+        auto thenIt = lifted.find(thenNode);
+        auto elseIt = lifted.find(elseNode);
+        if (thenIt == lifted.end() or elseIt == lifted.end()) {
+            if (thenIt == lifted.end()) { toProcess.push_back(thenNode); }
+            if (elseIt == lifted.end()) { toProcess.push_back(elseNode); }
+            continue;
+        }
+        PTRef thenAtom = thenIt->second;
+        PTRef elseAtom = elseIt->second;
+        lifted.insert({node, logic.mkAnd(logic.mkOr(logic.mkNot(cond), thenAtom), logic.mkOr(cond, elseAtom))});
+        toProcess.pop_back();
+    }
+    return lifted.at(arg.ite);
+}
+
+// Number of distinct nodes, including the leaves, of the ite tree
+unsigned IteLifter::treeSize(PTRef ite) const {
+    std::unordered_set<PTRef, PTRefHash> seen{ite};
+    std::vector<PTRef> queue{ite};
+    while (not queue.empty()) {
+        PTRef node = queue.back();
+        queue.pop_back();
+        if (not logic.isIte(node)) { continue; }
+        for (int i = 1; i <= 2; ++i) {
+            PTRef child = logic.getPterm(node)[i];
+            if (seen.insert(child).second) { queue.push_back(child); }
+        }
+    }
+    return seen.size();
+}
+
+// The node under the assumption that cond has the given value, if the node branches on cond or its negation
+PTRef IteLifter::cofactor(PTRef node, PTRef cond, bool value) const {
+    if (not logic.isIte(node)) { return node; }
+    Pterm const & term = logic.getPterm(node);
+    PTRef nodeCond = term[0];
+    if (nodeCond == cond) {
+        return value ? term[1] : term[2];
+    }
+    if ((logic.isNot(nodeCond) and logic.getPterm(nodeCond)[0] == cond) or (logic.isNot(cond) and logic.getPterm(cond)[0] == nodeCond)) {
+        return value ? term[2] : term[1];
+    }
+    return node;
+}
+
+// The condition of the first ite of the state; false if the state consists of leaves only
+bool IteLifter::splitCondition(State const & state, PTRef & cond) const {
+    for (PTRef node : state) {
+        if (logic.isIte(node)) {
+            cond = logic.getPterm(node)[0];
+            return true;
+        }
+    }
+    return false;
+}
+
+// Collects the states of the merged ite; false if there are more than the limit
+bool IteLifter::exploreStates(State const & initial, std::map<State, PTRef> & states, std::size_t limit) const {
+    std::vector<State> queue{initial};
+    states.insert({initial, PTRef_Undef});
+    while (not queue.empty()) {
+        State state = std::move(queue.back());
+        queue.pop_back();
+        PTRef cond;
+        if (not splitCondition(state, cond)) { continue; }
+        for (bool value : {true, false}) {
+            State child;
+            for (PTRef node : state) { child.push_back(cofactor(node, cond, value)); }
+            if (states.insert({child, PTRef_Undef}).second) {
+                if (states.size() > limit) { return false; }
+                queue.push_back(std::move(child));
+            }
+        }
+    }
+    return true;
+}
+
+PTRef IteLifter::mergeItes(State const & initial, std::vector<PTRef> const & coeffs, std::map<State, PTRef> & states) {
+    std::vector<State> toProcess{initial};
+    while (not toProcess.empty()) {
+        State const & state = toProcess.back();
+        if (states.at(state) != PTRef_Undef) {
+            toProcess.pop_back();
+            continue;
+        }
+        PTRef cond;
+        if (not splitCondition(state, cond)) {
+            vec<PTRef> summands;
+            for (std::size_t i = 0; i < state.size(); ++i) {
+                summands.push(arithLogic->mkTimes(coeffs[i], state[i]));
+            }
+            states[state] = arithLogic->mkPlus(std::move(summands));
+            toProcess.pop_back();
+            continue;
+        }
+        State thenState;
+        State elseState;
+        for (PTRef node : state) {
+            thenState.push_back(cofactor(node, cond, true));
+            elseState.push_back(cofactor(node, cond, false));
+        }
+        PTRef thenTerm = states.at(thenState);
+        PTRef elseTerm = states.at(elseState);
+        if (thenTerm == PTRef_Undef or elseTerm == PTRef_Undef) {
+            if (thenTerm == PTRef_Undef) { toProcess.push_back(std::move(thenState)); }
+            if (elseTerm == PTRef_Undef) { toProcess.push_back(std::move(elseState)); }
+            continue;
+        }
+        states[state] = logic.mkIte(cond, thenTerm, elseTerm);
+        toProcess.pop_back();
+    }
+    return states.at(initial);
+}
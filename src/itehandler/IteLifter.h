@@ -0,0 +1,70 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef OPENSMT_ITELIFTER_H
+#define OPENSMT_ITELIFTER_H
+
+#include "PTRef.h"
+#include "Logic.h"
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+class ArithLogic;
+
+/**
+ * Lifts the non-Boolean ites with a single use out of the terms before IteHandler names the remaining ites with
+ * auxiliary variables.
+ *
+ * The ites summed up in one linear term are merged into a single ite, splitting on a condition shared by several of
+ * them only once. An ite occurring in a single (in)equality, either directly or as the merged ite of a sum, is pushed
+ * into the atom, which then becomes a Boolean combination of the atoms over the leaves of the ite and needs no
+ * auxiliary variable at all. Ites used in several places are kept, lifting them would duplicate the terms without
+ * saving the variable.
+ */
+class IteLifter {
+public:
+    explicit IteLifter(Logic & logic);
+
+    PTRef lift(PTRef root);
+
+    int getMergedItes() const { return mergedItes; }
+    int getLiftedAtoms() const { return liftedAtoms; }
+
+private:
+    using Substitutions = std::unordered_map<PTRef, PTRef, PTRefHash>;
+    using State = std::vector<PTRef>; // One node per merged ite
+
+    // The term rest + coeff * ite; rest and coeff are PTRef_Undef if the term is the ite itself
+    struct LinearIte {
+        PTRef rest;
+        PTRef coeff;
+        PTRef ite;
+    };
+
+    Logic & logic;
+    ArithLogic * arithLogic; // nullptr in logics without arithmetic
+    std::unordered_map<PTRef, unsigned, PTRefHash> uses; // Number of parents of a term that are not ites
+    std::unordered_map<PTRef, LinearIte, PTRefHash> liftableSums; // Rewritten sums with an ite that has no other use
+    int mergedItes = 0;
+    int liftedAtoms = 0;
+
+    bool isLiftableIte(PTRef tr) const { return logic.isIte(tr) and not logic.hasSortBool(tr); }
+    bool hasSingleUse(PTRef tr) const { auto it = uses.find(tr); return it != uses.end() and it->second == 1; }
+    static PTRef substituted(Substitutions const & substitutions, PTRef tr);
+
+    void countUses(PTRef root);
+    PTRef rewriteSum(PTRef sum, PTRef newSum, Substitutions const & substitutions);
+    PTRef rewriteAtom(PTRef atom, PTRef newAtom, Substitutions const & substitutions);
+    PTRef liftIntoAtom(PTRef atom, int argIndex, LinearIte const & arg, Substitutions const & substitutions);
+
+    unsigned treeSize(PTRef ite) const;
+    PTRef cofactor(PTRef node, PTRef cond, bool value) const;
+    bool splitCondition(State const & state, PTRef & cond) const;
+    bool exploreStates(State const & initial, std::map<State, PTRef> & states, std::size_t limit) const;
+    PTRef mergeItes(State const & initial, std::vector<PTRef> const & coeffs, std::map<State, PTRef> & states);
+};
+
+#endif //OPENSMT_ITELIFTER_H
@@ -10,8 +10,10 @@
 #include "StringConv.h"
 #include "TreeOps.h"
 
+#include <limits>
 #include <map>
 #include <memory>
+#include <set>
 #include <sstream>
 #include <variant>
 
@@ -382,6 +384,150 @@ Logic::SubstMap collectSingleEqualitySubstitutions(ArithLogic & logic, std::vect
     eraseIndices(zeroPolynomials, indicesToRemove);
     return substitutions;
 }
+
+PTRef solveFor(ArithLogic & logic, poly_t poly, PTRef var) {
+    auto coeff = poly.removeVar(var);
+    coeff.negate();
+    if (not coeff.isOne()) {
+        poly.divideBy(coeff);
+    }
+    SRef sortRef = logic.getSortRef(var);
+    if (poly.size() == 0) { return logic.getZeroForSort(sortRef); }
+    if (poly.begin()->var == PTRef_Undef) { return logic.mkConst(sortRef, poly.begin()->coeff); }
+    return polyToPTRef(logic, poly);
+}
+
+// Upper bound on the fill-in (number of new row entries) the elimination of a single pivot may create
+constexpr std::size_t maxMarkowitzCost = 64;
+
+/*
+ * Sparse Gaussian elimination over the equalities that share their variables. Each step picks the pivot with the
+ * minimal Markowitz cost (r - 1) * (c - 1), where r is the number of variables in the pivot row and c the number of
+ * rows containing the pivot variable, eliminates the variable from the other rows and records the solved pivot row as
+ * its substitution. Since a pivot never occurs in the later rows, the substitutions are triangular and the transitive
+ * closure resolves them without cycles. The rows are kept in buckets by the cost of their cheapest pivot, and after a
+ * step only the rows sharing a column whose occurrence count changed are re-costed.
+ *
+ * Only rows consisting of variables not substituted yet are pivoted, a variable inside another term could otherwise
+ * end up substituted by an expression containing that term. An integer variable is only a pivot with a unit coefficient
+ * in an integral row, so the substitution and the updated rows stay integral.
+ *
+ * The rows that cannot be pivoted are left in zeroPolynomials; the rows whose pivots were all too costly are dropped
+ * and remain as equalities in the formula.
+ */
+Logic::SubstMap collectGaussianSubstitutions(ArithLogic & logic, std::vector<poly_t> & zeroPolynomials, Logic::SubstMap const & existing) {
+    Logic::SubstMap substitutions;
+    std::unordered_map<PTRef, std::unordered_set<std::size_t>, PTRefHash> varToPolyIndices;
+    std::vector<char> active(zeroPolynomials.size(), true);
+    std::vector<char> pivotable(zeroPolynomials.size(), false);
+    for (std::size_t i = 0; i < zeroPolynomials.size(); ++i) {
+        auto const & poly = zeroPolynomials[i];
+        for (auto const & term : poly) {
+            if (term.var != PTRef_Undef) { varToPolyIndices[term.var].insert(i); }
+        }
+        pivotable[i] = std::all_of(poly.begin(), poly.end(), [&](auto const & term) {
+            return term.var == PTRef_Undef or (logic.isVar(term.var) and not existing.has(term.var));
+        });
+    }
+
+    auto isCandidate = [&logic](poly_t const & poly, PTRef var, opensmt::Real const & coeff) {
+        if (var == PTRef_Undef) { return false; }
+        if (not logic.yieldsSortInt(var)) { return true; }
+        return (coeff.isOne() or (-coeff).isOne())
+            and std::all_of(poly.begin(), poly.end(), [](auto const & term) { return term.coeff.isInteger(); });
+    };
+
+    // The cheapest pivot of each row; the rows are bucketed by its cost, those without a pivot cheap enough are in none
+    constexpr std::size_t noCost = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> rowCost(zeroPolynomials.size(), noCost);
+    std::vector<PTRef> rowPivot(zeroPolynomials.size(), PTRef_Undef);
+    std::vector<std::set<std::size_t>> rowsByCost(maxMarkowitzCost + 1);
+    auto updateCost = [&](std::size_t i) {
+        if (rowCost[i] != noCost) { rowsByCost[rowCost[i]].erase(i); }
+        rowCost[i] = noCost;
+        rowPivot[i] = PTRef_Undef;
+        if (not active[i] or not pivotable[i]) { return; }
+        auto const & poly = zeroPolynomials[i];
+        std::size_t rowCount = std::count_if(poly.begin(), poly.end(), [](auto const & term) { return term.var != PTRef_Undef; });
+        for (auto const & term : poly) {
+            if (not isCandidate(poly, term.var, term.coeff)) { continue; }
+            std::size_t cost = (rowCount - 1) * (varToPolyIndices.at(term.var).size() - 1);
+            if (cost < rowCost[i]) {
+                rowCost[i] = cost;
+                rowPivot[i] = term.var;
+            }
+        }
+        if (rowCost[i] > maxMarkowitzCost) {
+            rowCost[i] = noCost;
+            rowPivot[i] = PTRef_Undef;
+            return;
+        }
+        rowsByCost[rowCost[i]].insert(i);
+    };
+    for (std::size_t i = 0; i < zeroPolynomials.size(); ++i) {
+        updateCost(i);
+    }
+
+    poly_t::poly_t tmpStorage;
+    std::unordered_set<PTRef, PTRefHash> changedColumns;
+    std::unordered_set<std::size_t> changedRows;
+    while (true) {
+        // The cheapest row, and the first of those in case of a tie
+        auto bucket = std::find_if(rowsByCost.begin(), rowsByCost.end(), [](auto const & rows) { return not rows.empty(); });
+        if (bucket == rowsByCost.end()) { break; }
+        std::size_t const pivotIndex = *bucket->begin();
+        PTRef const pivot = rowPivot[pivotIndex];
+
+        auto const & pivotRow = zeroPolynomials[pivotIndex];
+        opensmt::Real pivotCoeff = pivotRow.getCoeff(pivot);
+        std::vector<std::size_t> rowsToUpdate;
+        for (std::size_t index : varToPolyIndices.at(pivot)) {
+            if (index != pivotIndex) { rowsToUpdate.push_back(index); }
+        }
+        changedColumns.clear();
+        changedRows.clear();
+        for (std::size_t index : rowsToUpdate) {
+            auto & poly = zeroPolynomials[index];
+            opensmt::Real factor = poly.getCoeff(pivot) / pivotCoeff;
+            factor.negate();
+            poly.merge(pivotRow, factor, tmpStorage,
+                [&](PTRef var) { if (var != PTRef_Undef) { varToPolyIndices[var].insert(index); changedColumns.insert(var); } },
+                [&](PTRef var) { if (var != PTRef_Undef) { varToPolyIndices[var].erase(index); changedColumns.insert(var); } });
+            // 'c = 0' for some constant c is left to the main loop, like in the other substitutions
+            if (poly.size() == 0 or poly.begin()->var == PTRef_Undef) { active[index] = false; }
+            changedRows.insert(index);
+        }
+        for (auto const & term : pivotRow) {
+            if (term.var != PTRef_Undef) {
+                varToPolyIndices[term.var].erase(pivotIndex);
+                changedColumns.insert(term.var);
+            }
+        }
+        active[pivotIndex] = false;
+        changedRows.insert(pivotIndex);
+        substitutions.insert(pivot, solveFor(logic, pivotRow, pivot));
+
+        // Only the rows that changed or share a column whose count changed have a new cost
+        for (PTRef var : changedColumns) {
+            for (std::size_t index : varToPolyIndices.at(var)) { changedRows.insert(index); }
+        }
+        for (std::size_t index : changedRows) {
+            updateCost(index);
+        }
+    }
+
+    // Keep only the rows the elimination had no candidate for
+    std::vector<std::size_t> indicesToRemove;
+    for (std::size_t i = 0; i < zeroPolynomials.size(); ++i) {
+        auto const & poly = zeroPolynomials[i];
+        if (active[i] and not (pivotable[i] and std::any_of(poly.begin(), poly.end(), [&](auto const & term) {
+                return isCandidate(poly, term.var, term.coeff);
+            }))) { continue; }
+        indicesToRemove.push_back(i);
+    }
+    eraseIndices(zeroPolynomials, indicesToRemove);
+    return substitutions;
+}
 }
 
 lbool ArithLogic::arithmeticElimination(const vec<PTRef> & top_level_arith, SubstMap & out_substitutions)
@@ -424,6 +570,12 @@ lbool ArithLogic::arithmeticElimination(const vec<PTRef> & top_level_arith, Subs
         out_substitutions.insert(key, singleEqSubstitutions[key]);
     }
 
+    auto gaussianSubstitutions = collectGaussianSubstitutions(logic, polynomials, out_substitutions);
+    for (PTRef key : gaussianSubstitutions.getKeys()) {
+        assert(not out_substitutions.has(key));
+        out_substitutions.insert(key, gaussianSubstitutions[key]);
+    }
+
     for (auto & poly : polynomials) {
         // solve polynomial with respect to its first variable
         assert(poly.size() > 0);
@@ -441,14 +593,8 @@ lbool ArithLogic::arithmeticElimination(const vec<PTRef> & top_level_arith, Subs
                 })) { continue; }
         }
 
-        auto coeff = poly.removeVar(var);
-        coeff.negate();
-        if (not coeff.isOne()) {
-            poly.divideBy(coeff);
-        }
-        PTRef val = polyToPTRef(logic, poly);
         assert(not out_substitutions.has(var));
-        out_substitutions.insert(var, val);
+        out_substitutions.insert(var, solveFor(logic, std::move(poly), var));
     }
     // To simplify this method, we do not try to detect a conflict here, so result is always l_Undef
     return l_Undef;
@@ -541,19 +687,26 @@ PTRef ArithLogic::mkNeg(PTRef tr)
 
 PTRef ArithLogic::mkConst(SRef sort, opensmt::Number const & c)
 {
+    auto & numerals = getNumerals(sort);
+    auto it = numerals.find(c);
+    if (it != numerals.end()) { return it->second; }
     std::string str = c.get_str(); // MB: I cannot store c.get_str().c_str() directly, since that is a pointer inside temporary object -> crash.
-    const char * val = str.c_str();
-    PTRef ptr = PTRef_Undef;
-    ptr = mkVar(sort, val, true);
-    // Store the value of the number as a real
-    SymId id = sym_store[getPterm(ptr).symb()].getId();
-    for (auto i = numbers.size(); i <= id; i++) { numbers.emplace_back(); }
-    if (numbers[id] == nullptr) { numbers[id] = new opensmt::Number(val); }
-    assert(c == *numbers[id]);
-    markConstant(id);
+    PTRef ptr = mkVar(sort, str.c_str(), true);
+    registerNumeral(ptr, c);
     return ptr;
 }
 
+// Store the value of the numeral constant and make it known to mkConst
+void ArithLogic::registerNumeral(PTRef tr, FastRational const & value)
+{
+    SymId id = sym_store[getPterm(tr).symb()].getId();
+    for (auto i = numbers.size(); i <= id; i++) { numbers.emplace_back(nullptr); }
+    if (numbers[id] == nullptr) { numbers[id] = new FastRational(value); }
+    assert(value == *numbers[id]);
+    markConstant(id);
+    getNumerals(getSortRef(tr)).emplace(value, tr);
+}
+
 PTRef ArithLogic::mkMinus(vec<PTRef> && args)
 {
     assert(args.size() > 0);
@@ -912,14 +1065,8 @@ PTRef ArithLogic::mkConst(SRef s, const char* name)
             rat = strdup(name);
         }
         ptr = mkVar(s, rat, true);
-        // Store the value of the number as a real
-        SymId id = sym_store[getPterm(ptr).symb()].getId();
-        for (auto i = numbers.size(); i <= id; i++)
-            numbers.emplace_back(nullptr);
-        if (numbers[id] != nullptr) { delete numbers[id]; }
-        numbers[id] = new FastRational(rat);
+        registerNumeral(ptr, FastRational(rat));
         free(rat);
-        markConstant(id);
     } else
         ptr = Logic::mkConst(s, name);
     return ptr;
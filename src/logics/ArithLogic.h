@@ -28,6 +28,9 @@ class ArithLogic: public Logic
     friend class LessThan_deepPTRef;
 protected:
     std::vector<FastRational*> numbers;
+    // Numeral constants by their value, so that known numerals are found without building their names
+    std::unordered_map<FastRational, PTRef, FastRationalHash> intNumerals;
+    std::unordered_map<FastRational, PTRef, FastRationalHash> realNumerals;
 
     static const std::string e_nonlinear_term;
 
@@ -397,6 +400,9 @@ protected:
     opensmt::pair<FastRational, PTRef> sumToNormalizedRealPair(PTRef sum);
 
     bool hasNegativeLeadingVariable(PTRef poly) const;
+
+    std::unordered_map<FastRational, PTRef, FastRationalHash> & getNumerals(SRef sort) { return sort == sort_INT ? intNumerals : realNumerals; }
+    void registerNumeral(PTRef tr, FastRational const & value);
 };
 
 // Determine for two multiplicative terms (* k1 v1) and (* k2 v2), v1 !=
@@ -0,0 +1,70 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "FrameSubstitutions.h"
+
+#include "Substitutor.h"
+#include "TreeOps.h"
+
+void FrameSubstitutions::startLevel(int level) {
+    assert(level >= 0);
+    while (levels.size() > static_cast<std::size_t>(level)) {
+        Level const & last = levels.back();
+        while (changes.size() > last.changes) {
+            Change const & change = changes.back();
+            if (change.oldTarget == PTRef_Undef) {
+                assert(substitutions.getKeys().last() == change.key);
+                substitutions.removeLast();
+            } else {
+                substitutions[change.key] = change.oldTarget;
+            }
+            changes.pop_back();
+        }
+        while (addedDependents.size() > last.dependents) {
+            dependents[addedDependents.back()].pop_back();
+            addedDependents.pop_back();
+        }
+        levels.pop_back();
+    }
+    while (levels.size() <= static_cast<std::size_t>(level)) {
+        levels.push_back({changes.size(), addedDependents.size()});
+    }
+}
+
+void FrameSubstitutions::add(Logic & logic, Logic::SubstMap const & substs) {
+    assert(not levels.empty());
+    // The older targets with a newly substituted variable are rewritten to keep the store closed
+    Substitutor substitutor(logic, substs);
+    for (PTRef var : substs.getKeys()) {
+        assert(not substitutions.has(var));
+        auto it = dependents.find(var);
+        if (it == dependents.end()) { continue; }
+        std::vector<PTRef> keys = it->second;
+        for (PTRef key : keys) {
+            PTRef oldTarget = substitutions[key];
+            PTRef newTarget = substitutor.rewrite(oldTarget);
+            if (newTarget == oldTarget) { continue; }
+            changes.push_back({key, oldTarget});
+            substitutions[key] = newTarget;
+            addDependents(logic, key, newTarget);
+        }
+    }
+    for (PTRef key : substs.getKeys()) {
+        PTRef target = substs[key];
+        changes.push_back({key, PTRef_Undef});
+        substitutions.insert(key, target);
+        addDependents(logic, key, target);
+    }
+}
+
+PTRef FrameSubstitutions::apply(Logic & logic, PTRef fla) const {
+    return substitutions.getSize() == 0 ? fla : Substitutor(logic, substitutions).rewrite(fla);
+}
+
+void FrameSubstitutions::addDependents(Logic & logic, PTRef key, PTRef target) {
+    for (PTRef var : variables(logic, target)) {
+        dependents[var].push_back(key);
+        addedDependents.push_back(var);
+    }
+}
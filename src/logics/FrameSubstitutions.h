@@ -0,0 +1,54 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef OPENSMT_FRAMESUBSTITUTIONS_H
+#define OPENSMT_FRAMESUBSTITUTIONS_H
+
+#include "Logic.h"
+
+#include <unordered_map>
+#include <vector>
+
+/**
+ * The substitutions learnt from the push frames simplified so far, closed under transitivity.
+ *
+ * The substitutions of the frame at position i of the frame stack live on level i.  A frame only needs to be
+ * rewritten with the store and to have the substitutions of its own formulas added, the frames below are not
+ * simplified again.  When a frame at level i is simplified (again, after a pop), the levels from i up are undone.
+ */
+class FrameSubstitutions {
+public:
+    // Undoes the levels from level up and opens level as the current one
+    void startLevel(int level);
+
+    /**
+     * Adds the substitutions to the current level.  The substitutions must be closed under transitivity, their keys
+     * must not be substituted yet, and their targets must have been rewritten with the store.
+     */
+    void add(Logic & logic, Logic::SubstMap const & substs);
+
+    PTRef apply(Logic & logic, PTRef fla) const;
+
+    Logic::SubstMap const & getSubstitutions() const { return substitutions; }
+
+private:
+    struct Change {
+        PTRef key;
+        PTRef oldTarget; // PTRef_Undef if the key was added
+    };
+    struct Level {
+        std::size_t changes;
+        std::size_t dependents;
+    };
+
+    Logic::SubstMap substitutions;
+    std::unordered_map<PTRef, std::vector<PTRef>, PTRefHash> dependents; // The keys with the variable in their target
+    std::vector<Change> changes;
+    std::vector<PTRef> addedDependents;                                   // The variables in the order of additions
+    std::vector<Level> levels;
+
+    void addDependents(Logic & logic, PTRef key, PTRef target);
+};
+
+#endif // OPENSMT_FRAMESUBSTITUTIONS_H
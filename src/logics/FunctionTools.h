@@ -11,6 +11,8 @@
 #include "PTRef.h"
 #include "SSort.h"
 
+#include <atomic>
+
 class FunctionSignature {
     friend class TemplateFunction;
     SRef ret_sort;
@@ -34,7 +36,7 @@ class TemplateFunction {
     PTRef tr_body;
 
     inline static constexpr std::string_view template_arg_prefix = ".arg";
-    inline static std::size_t template_arg_counter = 0;
+    inline static std::atomic<std::size_t> template_arg_counter = 0;
 public:
     static std::string nextFreeArgumentName() { return std::string(template_arg_prefix) + std::to_string(template_arg_counter++); }
 
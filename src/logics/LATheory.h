@@ -44,7 +44,8 @@ PTRef rewriteDivMod<ArithLogic>(ArithLogic & logic, PTRef fla) {
 }
 
 //
-// Unit propagate with simplifications and split equalities into
+// Unit propagate the formulas of the frame with simplifications, using
+// the substitutions of the frames below, and split equalities into
 // inequalities.  If partitions cannot mix, only do the splitting to
 // inequalities.
 //
@@ -64,8 +65,8 @@ bool LATheory<LinAlgLogic,LinAlgTSHandler>::simplify(const vec<PFRef>& formulas,
         }
         currentFrame.root = getLogic().mkAnd(flas);
     } else {
-        PTRef coll_f = getCollateFunction(formulas, curr);
-        PTRef finalFla = applySubstitutionBasedSimplificationIfEnabled(coll_f);
+        PTRef frameFla = getLogic().mkAnd(currentFrame.formulas);
+        PTRef finalFla = applyFrameSubstitutionsIfEnabled(frameFla, curr);
         finalFla = rewriteDistincts(getLogic(), finalFla);
         finalFla = rewriteDivMod<LinAlgLogic>(lalogic, finalFla);
         currentFrame.root = equalityRewriter.rewrite(finalFla);
@@ -152,6 +152,8 @@ class Logic {
 
     bool isArraySort(SRef sref) const { return sort_store[sref].getSymRef() == sym_ArraySort; }
     SRef getArraySort(SRef domain, SRef codomain);
+    Sort const & getSortDefinition(SRef sref) const { return sort_store[sref]; }
+    SortSymbol const & getSortSymbol(SSymRef ssref) const { return sort_store[ssref]; }
 
     bool hasArrays() const { return opensmt::QFLogicToProperties.at(logicType).ufProperty.hasArrays; }
     bool isArrayStore(SymRef) const;
@@ -0,0 +1,71 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "TermTranslator.h"
+
+#include "ArithLogic.h"
+#include "OsmtApiException.h"
+#include "TreeOps.h"
+
+TermTranslator::TermTranslator(Logic const & from, Logic & to)
+    : from(from)
+    , to(to)
+    , fromArith(dynamic_cast<ArithLogic const *>(&from))
+    , toArith(dynamic_cast<ArithLogic *>(&to))
+{
+    if (from.getLogic() != to.getLogic() or (fromArith == nullptr) != (toArith == nullptr)) {
+        throw OsmtApiException("Terms can only be translated between logics of the same type");
+    }
+}
+
+PTRef TermTranslator::translate(PTRef root) {
+    class TranslationConfig : public DefaultVisitorConfig {
+        TermTranslator & translator;
+    public:
+        explicit TranslationConfig(TermTranslator & translator) : translator(translator) {}
+        bool previsit(PTRef tr) override { return translator.translated.find(tr) == translator.translated.end(); }
+        void visit(PTRef tr) override { translator.translated.emplace(tr, translator.translateNode(tr)); }
+    } config(*this);
+    TermVisitor<TranslationConfig>(from, config).visit(root);
+    return translated.at(root);
+}
+
+SRef TermTranslator::translateSort(SRef sr) {
+    auto it = translatedSorts.find(sr);
+    if (it != translatedSorts.end()) { return it->second; }
+    Sort const & sort = from.getSortDefinition(sr);
+    vec<SRef> args;
+    for (uint32_t i = 0; i < sort.getSize(); ++i) {
+        args.push(translateSort(sort[i]));
+    }
+    SSymRef symbol = to.declareSortSymbol(from.getSortSymbol(sort.getSymRef()));
+    SRef res = to.getSort(symbol, std::move(args));
+    translatedSorts.emplace(sr, res);
+    return res;
+}
+
+// The children of the term have already been translated
+PTRef TermTranslator::translateNode(PTRef tr) {
+    SymRef sym = from.getSymRef(tr);
+    SRef sort = translateSort(from.getSortRef(sym));
+    char const * name = from.getSymName(sym);
+    if (from.isTrue(tr)) { return to.getTerm_true(); }
+    if (from.isFalse(tr)) { return to.getTerm_false(); }
+    if (fromArith and fromArith->isNumConst(tr)) { return toArith->mkConst(sort, fromArith->getNumConst(tr)); }
+    if (from.isConstant(sym)) { return to.mkConst(sort, name); }
+    if (from.isVar(sym)) { return to.mkVar(sort, name, from.isInterpreted(sym)); }
+
+    vec<PTRef> args;
+    for (PTRef child : from.getPterm(tr)) {
+        args.push(translated.at(child));
+    }
+    if (from.isUF(sym) and not to.hasSym(name)) {
+        vec<SRef> argSorts;
+        for (PTRef arg : args) {
+            argSorts.push(to.getSortRef(arg));
+        }
+        to.declareFun(name, sort, argSorts);
+    }
+    return to.resolveTerm(name, std::move(args), sort);
+}
@@ -0,0 +1,41 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef OPENSMT_TERMTRANSLATOR_H
+#define OPENSMT_TERMTRANSLATOR_H
+
+#include "Logic.h"
+#include "PTRef.h"
+#include "SSort.h"
+
+#include <unordered_map>
+
+class ArithLogic;
+
+/**
+ * Copies terms from one logic to another logic of the same type, so that solvers that must not share a logic, such as
+ * solvers running in different threads, can work on the same formula.
+ *
+ * Symbols are matched by their names.  The uninterpreted sorts and functions missing in the target logic are declared
+ * on the way.  The translations are cached, translating a term again only costs a lookup.
+ */
+class TermTranslator {
+public:
+    TermTranslator(Logic const & from, Logic & to);
+
+    PTRef translate(PTRef tr);
+    SRef translateSort(SRef sr);
+
+private:
+    Logic const & from;
+    Logic & to;
+    ArithLogic const * fromArith; // nullptr in logics without arithmetic
+    ArithLogic * toArith;
+    std::unordered_map<PTRef, PTRef, PTRefHash> translated;
+    std::unordered_map<SRef, SRef, SRefHash> translatedSorts;
+
+    PTRef translateNode(PTRef tr);
+};
+
+#endif //OPENSMT_TERMTRANSLATOR_H
@@ -6,7 +6,9 @@
 
 // The Collate function is constructed from all frames up to the current
 // one and will be used to simplify the formulas in the current frame
-// formulas[curr].
+// formulas[curr].  It is used by the theories whose preprocessing needs
+// the terms of all frames at once, the others simplify only formulas[curr]
+// with applyFrameSubstitutionsIfEnabled.
 // (1) Construct the collate function as a conjunction of formulas up to curr.
 // (2) From the coll function compute units_{curr}
 // (3) Use units_1 /\ ... /\ units_{curr} to simplify formulas[curr]
@@ -122,3 +124,16 @@ PTRef Theory::flaFromSubstitutionResult(const Theory::SubstitutionResult & sr) {
 PTRef Theory::applySubstitutionBasedSimplificationIfEnabled(PTRef root) {
     return config.do_substitutions() ? flaFromSubstitutionResult(computeSubstitutions(root)) : root;
 }
+
+PTRef Theory::applyFrameSubstitutionsIfEnabled(PTRef fla, int curr) {
+    if (not config.do_substitutions()) { return fla; }
+    Logic & logic = getLogic();
+    frameSubstitutions.startLevel(curr);
+    SubstitutionResult sr = computeSubstitutions(frameSubstitutions.apply(logic, fla));
+    // The substitutions found in later rounds of computeSubstitutions are not applied to the earlier ones
+    Logic::SubstMap closed;
+    sr.usedSubstitution.copyTo(closed);
+    logic.substitutionsTransitiveClosure(closed);
+    frameSubstitutions.add(logic, closed);
+    return flaFromSubstitutionResult(sr);
+}
@@ -34,8 +34,13 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "UFTHandler.h"
 #include "Alloc.h"
 
+#include "FrameSubstitutions.h"
 #include "PartitionManager.h"
 
+class Ackermanize;
+class Model;
+class ModelBuilder;
+
 // Simplification in frames:
 // A frame F_i consists of:
 //  P_i : a list of asserts given on this frame
@@ -151,6 +156,7 @@ class Theory
 
 
     SMTConfig &         config;
+    FrameSubstitutions  frameSubstitutions;
     PTRef getCollateFunction(const vec<PFRef> & formulas, int curr);
     Theory(SMTConfig &c) : config(c) { }
 
@@ -161,6 +167,10 @@ class Theory
      */
     PTRef flaFromSubstitutionResult(const SubstitutionResult & sr);
     PTRef applySubstitutionBasedSimplificationIfEnabled(PTRef);
+    /* Simplifies the formula of the frame at position curr with the substitutions of the frames below and learns the
+     * substitutions of the formula.  Only the new substitutions are conjoined as equalities.
+     */
+    PTRef applyFrameSubstitutionsIfEnabled(PTRef fla, int curr);
   public:
 
     PushFrameAllocator      pfstore {1024};
@@ -171,6 +181,8 @@ class Theory
     SubstitutionResult      computeSubstitutions(PTRef fla);
     void                    printFramesAsQuery(const vec<PFRef> & frames, std::ostream & s) const;
     virtual bool            okToPartition(PTRef) const { return true; }
+    virtual bool            hasEliminatedFunctions() const { return false; } // Were some functions removed from the formula by simplifications?
+    virtual void            fillEliminatedFunctions(ModelBuilder &, Model &) const {} // Interpret the removed functions in terms of the given model
     virtual                ~Theory() {};
 };
 
@@ -179,18 +191,17 @@ class UFTheory : public Theory
   private:
     Logic &    uflogic;
     UFTHandler tshandler;
+    std::unique_ptr<Ackermanize> ackermanize;
   public:
-    UFTheory(SMTConfig & c, Logic & logic )
-        : Theory(c)
-        , uflogic(logic)
-        , tshandler(c, uflogic)
-    { }
-    ~UFTheory() {}
+    UFTheory(SMTConfig & c, Logic & logic);
+    ~UFTheory();
     virtual Logic&            getLogic() override { return uflogic; }
     virtual const Logic&      getLogic() const override { return uflogic; }
     virtual UFTHandler&       getTSolverHandler() override  { return tshandler; }
     virtual const UFTHandler& getTSolverHandler() const { return tshandler; }
     virtual bool simplify(const vec<PFRef>&, PartitionManager& pmanager, int) override;
+    virtual bool hasEliminatedFunctions() const override;
+    virtual void fillEliminatedFunctions(ModelBuilder & builder, Model & model) const override;
 };
 
 #endif
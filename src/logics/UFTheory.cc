@@ -1,8 +1,23 @@
 #include "Theory.h"
 #include "TreeOps.h"
 #include "DistinctRewriter.h"
+#include "Ackermanize.h"
+
+UFTheory::UFTheory(SMTConfig & c, Logic & logic)
+    : Theory(c)
+    , uflogic(logic)
+    , tshandler(c, uflogic)
+{
+    if (config.ackermannize() and not keepPartitions()) {
+        ackermanize = std::make_unique<Ackermanize>(uflogic, config.ackermann_max_arity(), config.ackermann_max_occurrences());
+    }
+}
+
+UFTheory::~UFTheory() = default;
+
 //
-// Simplify with unit propagation, add the diamond equalities if
+// Simplify the formulas of the frame with unit propagation and the
+// substitutions of the frames below, add the diamond equalities if
 // present.  If partitions cannot mix, do no simplifications but just
 // update the root.
 //
@@ -13,10 +28,16 @@ bool UFTheory::simplify(const vec<PFRef>& formulas, PartitionManager &, int curr
         currentFrame.root = getLogic().mkAnd(currentFrame.formulas);
     }
     else {
-        PTRef coll_f = getCollateFunction(formulas, curr);
-        PTRef trans = getLogic().learnEqTransitivity(coll_f);
-        coll_f = getLogic().mkAnd(coll_f, trans);
-        currentFrame.root = applySubstitutionBasedSimplificationIfEnabled(coll_f);
+        PTRef frameFla = getLogic().mkAnd(currentFrame.formulas);
+        // The diamonds are matched within a single term, so those of the frames below were learnt with their frames,
+        // whose roots keep the implications; only the new frame needs to be searched.  As before, a diamond that
+        // appears only after the substitutions is not matched.
+        PTRef trans = getLogic().learnEqTransitivity(frameFla);
+        frameFla = getLogic().mkAnd(frameFla, trans);
+        currentFrame.root = applyFrameSubstitutionsIfEnabled(frameFla, curr);
+        if (ackermanize) {
+            currentFrame.root = ackermanize->rewrite(currentFrame.root, curr, currentFrame.getId().id);
+        }
     }
     currentFrame.root = curr == 0 ? rewriteDistinctsKeepTopLevel(getLogic(), currentFrame.root)
         : rewriteDistincts(getLogic(), currentFrame.root);
@@ -24,3 +45,13 @@ bool UFTheory::simplify(const vec<PFRef>& formulas, PartitionManager &, int curr
     return true;
 }
 
+
+bool UFTheory::hasEliminatedFunctions() const {
+    return ackermanize and ackermanize->hasEliminatedFunctions();
+}
+
+void UFTheory::fillEliminatedFunctions(ModelBuilder & builder, Model & model) const {
+    if (ackermanize) {
+        ackermanize->fillEliminatedFunctions(builder, model);
+    }
+}
@@ -42,6 +42,9 @@ public:
         return map.peek(k, d);
     }
 
+    // PRECONDITION: the map must not be empty.
+    void removeLast() { map.remove(keys.last()); keys.pop(); }
+
     bool has   (const K& k) const {
         return map.has(k);
     }
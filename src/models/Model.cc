@@ -3,6 +3,7 @@
 //
 
 #include "Model.h"
+#include "ArithLogic.h"
 #include "Substitutor.h"
 
 #include <sstream>
@@ -26,48 +27,258 @@ Model::Model(Logic& logic, Evaluation basicEval, SymbolDefinition symbolDef)
     : varEval(std::move(basicEval))
     , symDef(std::move(symbolDef))
     , logic(logic)
+    , arithLogic(dynamic_cast<ArithLogic *>(&logic))
     , formalArgDefaultPrefix("x")
 {
     assert(isCorrect(symbolDef));
 }
 
+void Model::addDefinitions(SymbolDefinition definitions) {
+    assert(isCorrect(definitions));
+    for (auto & [sym, definition] : definitions) {
+        assert(symDef.find(sym) == symDef.end());
+        symDef.emplace(sym, std::move(definition));
+    }
+    values.clear(); // The values computed so far may depend on the new symbols
+}
+
 PTRef Model::evaluate(PTRef term) {
-    if (logic.isConstant(term)) {
-        return term;
+    computeValues(term);
+    return toTerm(term);
+}
+
+vec<PTRef> Model::evaluate(opensmt::span<PTRef const> terms) {
+    for (PTRef term : terms) {
+        computeValues(term);
+    }
+    vec<PTRef> res;
+    res.capacity(terms.size());
+    for (PTRef term : terms) {
+        res.push(toTerm(term));
+    }
+    return res;
+}
+
+void Model::computeValues(PTRef root) {
+    if (values.size() < logic.getNumberOfTerms()) {
+        values.resize(logic.getNumberOfTerms());
+    }
+    struct DFSEntry {
+        DFSEntry(PTRef term) : term(term) {}
+        PTRef term;
+        unsigned int nextChild = 0;
+    };
+    std::vector<DFSEntry> toProcess;
+    toProcess.emplace_back(root);
+    while (not toProcess.empty()) {
+        auto & currentEntry = toProcess.back();
+        PTRef currentRef = currentEntry.term;
+        if (isEvaluated(currentRef)) {
+            toProcess.pop_back();
+            continue;
+        }
+        Pterm const & term = logic.getPterm(currentRef);
+        unsigned childrenCount = term.size();
+        if (currentEntry.nextChild == 1 and logic.isIte(term.symb()) and valueOf(term[0]).kind == Value::Kind::Bool) {
+            // Only the branch selected by the condition is needed
+            PTRef branch = valueOf(term[0]).boolean ? term[1] : term[2];
+            currentEntry.nextChild = childrenCount;
+            if (not isEvaluated(branch)) { toProcess.push_back(DFSEntry(branch)); }
+            continue;
+        }
+        if (currentEntry.nextChild < childrenCount) {
+            PTRef nextChild = term[currentEntry.nextChild];
+            ++currentEntry.nextChild;
+            if (not isEvaluated(nextChild)) { toProcess.push_back(DFSEntry(nextChild)); }
+            continue;
+        }
+        // If we are here, we have already processed all children
+        Value value = computeValue(currentRef);
+        valueOf(currentRef) = std::move(value);
+        toProcess.pop_back();
+    }
+}
+
+Model::Value Model::computeValue(PTRef tr) {
+    if (logic.isConstant(tr)) {
+        return fromTerm(tr);
+    }
+    if (logic.isVar(tr)) {
+        auto it = varEval.find(tr);
+        // A variable without a value gets the default value
+        return fromTerm(it != varEval.end() ? it->second : logic.getDefaultValuePTRef(tr));
+    }
+    SymRef symbol = logic.getPterm(tr).symb();
+    auto definition = symDef.find(symbol);
+    if (definition == symDef.end()) {
+        Value value;
+        if (computeNativeValue(tr, value)) { return value; }
+    }
+    // Defined and uninterpreted functions, and the operators without a native evaluation, are evaluated in the logic
+    vec<PTRef> args;
+    for (PTRef child : logic.getPterm(tr)) {
+        args.push(child);
+    }
+    for (PTRef & arg : args) {
+        arg = toTerm(arg);
+    }
+    PTRef val = definition != symDef.end() ? logic.instantiateFunctionTemplate(definition->second, args)
+                                           : logic.insertTerm(symbol, std::move(args));
+    assert(val != PTRef_Undef);
+    return fromTerm(val);
+}
+
+bool Model::computeNativeValue(PTRef tr, Value & value) {
+    Pterm const & term = logic.getPterm(tr);
+    SymRef symbol = term.symb();
+    auto hasArgsOfKind = [&](Value::Kind kind) {
+        return std::all_of(term.begin(), term.end(), [&](PTRef arg) { return valueOf(arg).kind == kind; });
+    };
+    auto setBool = [&value](bool b) {
+        value.kind = Value::Kind::Bool;
+        value.boolean = b;
+        return true;
+    };
+    auto setNumber = [&value](opensmt::Number && n) {
+        value.kind = Value::Kind::Number;
+        value.number = std::move(n);
+        return true;
+    };
+
+    if (logic.isIte(symbol)) {
+        Value const & condition = valueOf(term[0]);
+        if (condition.kind != Value::Kind::Bool) { return false; }
+        value = valueOf(condition.boolean ? term[1] : term[2]);
+        return true;
+    }
+    if (logic.isEquality(symbol) or logic.isDisequality(symbol)) {
+        if (not std::all_of(term.begin(), term.end(), [&](PTRef arg) { return isComparable(valueOf(arg)); })) { return false; }
+        bool distinct = logic.isDisequality(symbol);
+        for (int i = 0; i < term.size(); ++i) {
+            for (int j = i + 1; j < term.size(); ++j) {
+                if (sameValue(valueOf(term[i]), valueOf(term[j])) == distinct) { return setBool(false); }
+            }
+        }
+        return setBool(true);
+    }
+    if (logic.isBooleanOperator(symbol)) {
+        if (not hasArgsOfKind(Value::Kind::Bool)) { return false; }
+        auto argValue = [&](int i) { return valueOf(term[i]).boolean; };
+        if (logic.isNot(symbol)) { return setBool(not argValue(0)); }
+        if (logic.isAnd(symbol) or logic.isOr(symbol)) {
+            bool isAnd = logic.isAnd(symbol);
+            for (int i = 0; i < term.size(); ++i) {
+                if (argValue(i) != isAnd) { return setBool(not isAnd); }
+            }
+            return setBool(isAnd);
+        }
+        if (logic.isImplies(symbol)) { // Right associative
+            bool res = argValue(term.size() - 1);
+            for (int i = term.size() - 2; i >= 0; --i) {
+                res = not argValue(i) or res;
+            }
+            return setBool(res);
+        }
+        if (logic.isXor(symbol)) {
+            bool res = false;
+            for (int i = 0; i < term.size(); ++i) {
+                res = res != argValue(i);
+            }
+            return setBool(res);
+        }
+        return false;
     }
-    if (hasDerivedVal(term)) {
-        return getDerivedVal(term);
+    if (not arithLogic or not hasArgsOfKind(Value::Kind::Number)) { return false; }
+    auto argValue = [&](int i) -> opensmt::Number const & { return valueOf(term[i]).number; };
+    ArithLogic const & arith = *arithLogic;
+    if (arith.isPlus(symbol)) {
+        opensmt::Number res = 0;
+        for (int i = 0; i < term.size(); ++i) {
+            res += argValue(i);
+        }
+        return setNumber(std::move(res));
     }
-    if (logic.isVar(term)) {
-        if (hasVarVal(term)) {
-            return getVarVal(term);
+    if (arith.isTimes(symbol)) {
+        opensmt::Number res = 1;
+        for (int i = 0; i < term.size(); ++i) {
+            res *= argValue(i);
         }
-        // else - new variable use and remember default value
-        PTRef defaultVal = logic.getDefaultValuePTRef(term);
-        // cache value and return
-        addDerivedVal(term, defaultVal);
-        return defaultVal;
-    }
-    else {
-        // complex term not seen before, compute and store the value
-        int size = logic.getPterm(term).size();
-        vec<PTRef> nargs;
-        for (int i = 0; i < size; ++i) {
-            PTRef narg = evaluate(logic.getPterm(term)[i]);
-            nargs.push(narg);
+        return setNumber(std::move(res));
+    }
+    if (arith.isNeg(symbol) or (arith.isMinus(symbol) and term.size() == 1)) {
+        return setNumber(-argValue(0));
+    }
+    if (arith.isMinus(symbol)) {
+        opensmt::Number res = argValue(0);
+        for (int i = 1; i < term.size(); ++i) {
+            res -= argValue(i);
         }
-        SymRef symbol = logic.getPterm(term).symb();
-        PTRef val;
-        if (symDef.find(symbol) != symDef.end()) {
-            const TemplateFunction & tfun = symDef.at(symbol);
-            val = logic.instantiateFunctionTemplate(tfun, nargs);
+        return setNumber(std::move(res));
+    }
+    if (arith.isRealDiv(symbol) or arith.isIntDiv(symbol) or arith.isMod(symbol)) {
+        // Division by zero is left to the logic
+        if (term.size() != 2 or argValue(1).isZero()) { return false; }
+        auto realDiv = argValue(0) / argValue(1);
+        if (arith.isRealDiv(symbol)) { return setNumber(std::move(realDiv)); }
+        auto intDiv = argValue(1).sign() > 0 ? realDiv.floor() : realDiv.ceil();
+        if (arith.isIntDiv(symbol)) { return setNumber(std::move(intDiv)); }
+        return setNumber(argValue(0) - intDiv * argValue(1));
+    }
+    bool isLeq = arith.isLeq(symbol);
+    bool isLt = arith.isLt(symbol);
+    bool isGeq = arith.isGeq(symbol);
+    bool isGt = arith.isGt(symbol);
+    if (isLeq or isLt or isGeq or isGt) {
+        for (int i = 0; i + 1 < term.size(); ++i) {
+            auto const & lhs = argValue(i);
+            auto const & rhs = argValue(i + 1);
+            bool holds = isLeq ? lhs <= rhs : isLt ? lhs < rhs : isGeq ? lhs >= rhs : lhs > rhs;
+            if (not holds) { return setBool(false); }
+        }
+        return setBool(true);
+    }
+    return false;
+}
+
+bool Model::sameValue(Value const & first, Value const & second) {
+    assert(first.kind == second.kind);
+    switch (first.kind) {
+        case Value::Kind::Bool:
+            return first.boolean == second.boolean;
+        case Value::Kind::Number:
+            return first.number == second.number;
+        default:
+            return first.term == second.term;
+    }
+}
+
+Model::Value Model::fromTerm(PTRef val) const {
+    Value value;
+    value.term = val;
+    if (logic.isTrue(val) or logic.isFalse(val)) {
+        value.kind = Value::Kind::Bool;
+        value.boolean = logic.isTrue(val);
+    } else if (arithLogic and arithLogic->isNumConst(val)) {
+        value.kind = Value::Kind::Number;
+        value.number = arithLogic->getNumConst(val);
+    } else {
+        value.kind = Value::Kind::Term;
+    }
+    return value;
+}
+
+PTRef Model::toTerm(PTRef term) {
+    Value & value = valueOf(term);
+    assert(value.kind != Value::Kind::Unknown);
+    if (value.term == PTRef_Undef) {
+        if (value.kind == Value::Kind::Bool) {
+            value.term = value.boolean ? logic.getTerm_true() : logic.getTerm_false();
         } else {
-            val = logic.insertTerm(symbol, std::move(nargs));
+            assert(value.kind == Value::Kind::Number and arithLogic);
+            value.term = arithLogic->mkConst(logic.getSortRef(term), value.number);
         }
-        assert(val != PTRef_Undef);
-        addDerivedVal(term, val);
-        return val;
     }
+    return value.term;
 }
 
 /**
@@ -4,15 +4,20 @@
 
 #include "PTRef.h"
 #include "Logic.h"
+#include "Number.h"
+#include "TypeUtils.h"
 
 #include <unordered_map>
 #include <algorithm>
+#include <vector>
 
 #include <cassert>
 
 #ifndef OPENSMT_MODEL_H
 #define OPENSMT_MODEL_H
 
+class ArithLogic;
+
 class Model {
 
 public:
@@ -22,42 +27,48 @@ public:
     Model(Logic& logic, Evaluation basicEval, SymbolDefinition symbolDef);
     Model(Logic& logic, Evaluation basicEval) : Model(logic, std::move(basicEval), {}) { }
     PTRef evaluate(PTRef term);
+    // Evaluates all the terms at once; the values are turned into terms only for the given terms
+    vec<PTRef> evaluate(opensmt::span<PTRef const> terms);
     TemplateFunction getDefinition(SymRef) const;
+    // Adds the definitions of symbols that the model does not define yet
+    void addDefinitions(SymbolDefinition definitions);
     static std::string getFormalArgBaseNameForSymbol(const Logic & logic, SymRef sr, const std::string & formalArgDefaultPrefix); // Return a string that is not equal to the argument
 
 private:
+    // The value of an evaluated term, kept natively for Booleans and numbers
+    struct Value {
+        enum class Kind : char { Unknown, Bool, Number, Term };
+        Kind kind = Kind::Unknown;
+        bool boolean = false;
+        opensmt::Number number;
+        PTRef term = PTRef_Undef; // The value as a term, created on demand for Booleans and numbers
+    };
+
     bool isCorrect(const SymbolDefinition & defs) const;
     const Evaluation varEval;
-    const SymbolDefinition symDef;
+    SymbolDefinition symDef;
 
-    Evaluation extendedEval;
+    std::vector<Value> values; // Indexed by the ids of the evaluated terms
 
     Logic & logic;
+    ArithLogic * arithLogic; // nullptr in logics without arithmetic
     const std::string formalArgDefaultPrefix;
 
-    inline bool hasVarVal(PTRef term) const {
-        assert(logic.isVar(term));
-        return varEval.find(term) != varEval.end();
-    }
-
-    inline PTRef getVarVal(PTRef term) const {
-        assert(hasVarVal(term));
-        return varEval.at(term);
+    Value & valueOf(PTRef term) { return values[Idx(logic.getPterm(term).getId())]; }
+    bool isEvaluated(PTRef term) const {
+        auto index = Idx(logic.getPterm(term).getId());
+        return index < values.size() and values[index].kind != Value::Kind::Unknown;
     }
-
-    inline bool hasDerivedVal(PTRef term) {
-        return extendedEval.find(term) != extendedEval.end();
-    }
-
-    inline PTRef getDerivedVal(PTRef term) {
-        assert(hasDerivedVal(term));
-        return extendedEval.at(term);
+    bool isComparable(Value const & value) const {
+        return value.kind != Value::Kind::Term or logic.isConstant(value.term);
     }
+    static bool sameValue(Value const & first, Value const & second);
 
-    inline void addDerivedVal(PTRef term, PTRef val) {
-        auto res = extendedEval.insert(std::make_pair(term, val));
-        assert(res.second); (void)res;
-    }
+    void computeValues(PTRef root);
+    Value computeValue(PTRef term);
+    bool computeNativeValue(PTRef term, Value & value);
+    Value fromTerm(PTRef val) const;
+    PTRef toTerm(PTRef term);
 };
 
 
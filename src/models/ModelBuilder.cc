@@ -8,7 +8,11 @@
 #include <unordered_set>
 
 std::unique_ptr<Model> ModelBuilder::build() {
-    std::unordered_map<SymRef,TemplateFunction,SymRefHash> builtDefinitions;
+    return std::make_unique<Model>(logic, assignment, buildDefinitions());
+}
+
+Model::SymbolDefinition ModelBuilder::buildDefinitions() {
+    Model::SymbolDefinition builtDefinitions;
     for (auto & symbolSigVal : definitions) {
         const ValuationNode * valuationNode = symbolSigVal.second.second;
         SRef sr = logic.getSortRef(symbolSigVal.first);
@@ -16,7 +20,7 @@ std::unique_ptr<Model> ModelBuilder::build() {
         TemplateFunction templateFun(std::move(symbolSigVal.second.first), body);
         builtDefinitions[symbolSigVal.first] = std::move(templateFun);
     }
-    return std::make_unique<Model>(logic, assignment, builtDefinitions);
+    return builtDefinitions;
 }
 
 void ModelBuilder::addToTheoryFunction(SymRef sr, const vec<PTRef> & vals, PTRef val)
@@ -105,6 +105,7 @@ public:
     }
 
     std::unique_ptr<Model> build();
+    Model::SymbolDefinition buildDefinitions();
 };
 
 
@@ -366,6 +366,21 @@ bool SMTConfig::setOption(const char* name, const SMTOption& value, const char*&
         else {}
     }
 
+    if (strcmp(name, o_time_phases) == 0) {
+        bool timePhases = value.getValue().numval != 0;
+        phaseTimer.setDetailed(timePhases);
+        phaseTimer.setReportOut(timePhases ? &getDiagnosticOut() : nullptr);
+    }
+
+    if (strcmp(name, o_trace_out) == 0) {
+        if (value.getValue().type != O_STR) { msg = s_err_not_str; return false; }
+        phaseTimer.setTraceOut(nullptr);
+        if (trace_out.is_open()) { trace_out.close(); }
+        trace_out.open(value.getValue().strval, std::ios_base::out);
+        if (not trace_out.is_open()) { msg = s_err_trace_out; return false; }
+        phaseTimer.setTraceOut(&trace_out);
+    }
+
     // produce stats
     if (strcmp(name, o_produce_stats) == 0) {
         if (value.getValue().type != O_BOOL) { msg = s_err_not_bool; return false; }
@@ -398,6 +413,11 @@ bool SMTConfig::setOption(const char* name, const SMTOption& value, const char*&
         if (seed == 0) { msg = s_err_seed_zero; return false; }
     }
 
+    if (strcmp(name, o_time_limit) == 0 or strcmp(name, o_conflict_limit) == 0 or strcmp(name, o_memory_limit) == 0) {
+        if (value.getValue().type != O_NUM) { msg = s_err_not_num; return false; }
+        if (value.getValue().numval < 0) { msg = s_err_negative; return false; }
+    }
+
     if (strcmp(name, o_sat_split_type) == 0) {
         if (value.getValue().type != O_STR) { msg = s_err_not_str; return false; }
         const char* val = value.getValue().strval;
@@ -426,6 +446,17 @@ const SMTOption& SMTConfig::getOption(const char* name) const {
         return option_Empty;
 }
 
+void SMTConfig::copyOptionsFrom(SMTConfig const & other) {
+    for (char const * name : other.option_names) {
+        if (not other.optionTable.has(name) or strcmp(name, o_produce_stats) == 0 or strcmp(name, o_stats_out) == 0
+            or strcmp(name, o_trace_out) == 0 or strcmp(name, o_time_phases) == 0) {
+            continue;
+        }
+        const char* msg;
+        setOption(name, *other.optionTable[name], msg);
+    }
+}
+
 bool SMTConfig::setInfo(const char* name_, const Info& value) {
     if (infoTable.has(name_))
         infoTable.remove(name_);
@@ -457,6 +488,7 @@ const char* SMTConfig::o_simp_garbage_frac = ":simp-gc-frac";
 const char* SMTConfig::o_use_asymm     = ":asymm";
 const char* SMTConfig::o_use_rcheck    = ":rcheck";
 const char* SMTConfig::o_use_elim      = ":elim";
+const char* SMTConfig::o_use_gates     = ":gates";
 const char* SMTConfig::o_var_decay     = ":var-decay";
 const char* SMTConfig::o_clause_decay  = ":clause-decay";
 const char* SMTConfig::o_random_var_freq= ":random-var-freq";
@@ -473,6 +505,7 @@ const char* SMTConfig::o_produce_inter = ":produce-interpolants";
 const char* SMTConfig::o_certify_inter = ":certify-interpolants";
 const char* SMTConfig::o_simplify_inter = ":simplify-interpolants";
 const char* SMTConfig::o_interpolant_cnf = ":cnf-interpolants";
+const char* SMTConfig::o_streaming_inter = ":streaming-interpolants";
 const char* SMTConfig::o_proof_struct_hash       = ":proof-struct-hash";
 const char* SMTConfig::o_proof_check   = ":proof-check";
 const char* SMTConfig::o_proof_multiple_inter    = ":proof-interpolation-property";
@@ -482,6 +515,8 @@ const char* SMTConfig::o_proof_rec_piv = ":proof-rpi";
 const char* SMTConfig::o_proof_push_units = ":proof-lower-units";
 const char* SMTConfig::o_proof_transf_trav = ":proof-reduce-expose";
 const char* SMTConfig::o_proof_num_graph_traversals = ":proof-num-graph-traversals";
+const char* SMTConfig::o_proof_fill_threads = ":proof-fill-threads";
+const char* SMTConfig::o_proof_reduction_threads = ":proof-reduction-threads";
 const char* SMTConfig::o_proof_red_trans = ":proof-num-global-iterations";
 const char* SMTConfig::o_itp_bool_alg = ":interpolation-bool-algorithm";
 const char* SMTConfig::o_itp_euf_alg = ":interpolation-euf-algorithm";
@@ -502,6 +537,8 @@ const char* SMTConfig::o_sat_split_type = ":split-type";
 const char* SMTConfig::o_sat_split_inittune = ":split-init-tune";
 const char* SMTConfig::o_sat_split_midtune = ":split-mid-tune";
 const char* SMTConfig::o_sat_split_num = ":split-num";
+const char* SMTConfig::o_sat_split_threads = ":split-threads";
+const char* SMTConfig::o_sat_split_sync_conflicts = ":split-sync-conflicts";
 const char* SMTConfig::o_sat_split_fix_vars = ":split-fix-vars";
 const char* SMTConfig::o_sat_split_asap = ":split-asap";
 const char* SMTConfig::o_sat_split_units = ":split-units";
@@ -510,6 +547,7 @@ const char* SMTConfig::o_sat_split_test_cube_and_conquer = ":test-cube-and-conqu
 const char* SMTConfig::o_sat_split_randomize_lookahead = ":randomize-lookahead";
 const char* SMTConfig::o_sat_split_randomize_lookahead_buf = ":randomize-lookahead-buf"; // The n best found literals
 const char* SMTConfig::o_sat_remove_symmetries = ":remove-symmetries";
+const char* SMTConfig::o_symmetry_time_limit = ":symmetry-time-limit";
 const char* SMTConfig::o_dryrun = ":dryrun";
 const char* SMTConfig::o_do_substitutions = ":do-substitutions";
 const char* SMTConfig::o_respect_logic_partitioning_hints = ":respect-logic-partitioning-hints"; // Logic can have a say whether a var is good for partitioning
@@ -517,11 +555,27 @@ const char* SMTConfig::o_sat_scatter_split = ":scatter-split";
 const char* SMTConfig::o_sat_lookahead_split = ":lookahead-split";
 const char* SMTConfig::o_sat_pure_lookahead = ":pure-lookahead";
 const char* SMTConfig::o_lookahead_score_deep = ":lookahead-score-deep";
+const char* SMTConfig::o_lookahead_bool_probes = ":lookahead-bool-probes";
 const char* SMTConfig::o_sat_solver_limit = ":solver-limit";
 const char* SMTConfig::o_sat_picky = ":picky";
 const char* SMTConfig::o_sat_picky_w = ":picky_w";
 const char* SMTConfig::o_global_declarations = ":global-declarations";
 const char* SMTConfig::o_sat_split_mode     = ":split-mode";
+const char* SMTConfig::o_ackermannize = ":ackermannize";
+const char* SMTConfig::o_ackermann_max_arity = ":ackermann-max-arity";
+const char* SMTConfig::o_ackermann_max_occurrences = ":ackermann-max-occurrences";
+const char* SMTConfig::o_dynamic_ackermann = ":dynamic-ackermann";
+const char* SMTConfig::o_minimize_uf_explanations = ":minimize-uf-explanations";
+const char* SMTConfig::o_cnf_polarity = ":cnf-polarity";
+const char* SMTConfig::o_ite_lifting = ":ite-lifting";
+const char* SMTConfig::o_produce_unsat_cores = ":produce-unsat-cores";
+const char* SMTConfig::o_minimize_unsat_cores = ":minimize-unsat-cores";
+const char* SMTConfig::o_time_limit = ":time-limit";
+const char* SMTConfig::o_conflict_limit = ":conflict-limit";
+const char* SMTConfig::o_memory_limit = ":memory-limit";
+const char* SMTConfig::o_statistics_json = ":statistics-json";
+const char* SMTConfig::o_time_phases = ":time-phases";
+const char* SMTConfig::o_trace_out = ":trace-out";
 
 char* SMTConfig::server_host=NULL;
 uint16_t SMTConfig::server_port = 0;
@@ -532,9 +586,11 @@ uint16_t SMTConfig::database_port = 0;
 const char* SMTConfig::s_err_not_str = "expected string";
 const char* SMTConfig::s_err_not_bool = "expected Boolean";
 const char* SMTConfig::s_err_not_num = "expected number";
+const char* SMTConfig::s_err_negative = "expected non-negative number";
 const char* SMTConfig::s_err_seed_zero = "seed cannot be 0";
 const char* SMTConfig::s_err_unknown_split = "unknown split type";
 const char* SMTConfig::s_err_unknown_units = "unknown split units";
+const char* SMTConfig::s_err_trace_out = "cannot open the trace file";
 
 void
 SMTConfig::initializeConfig( )
@@ -30,6 +30,7 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "SolverTypes.h"
 #include "StringMap.h"
 #include "smt2tokens.h"
+#include "PhaseTimer.h"
 
 #include <cstring>
 #include <libgen.h>
@@ -246,6 +247,8 @@ public:
   static const char* o_use_rcheck;
   // Perform variable elimination.
   static const char* o_use_elim;
+  // Use the gate definitions of the cnfizer in variable elimination and equivalent literal substitution.
+  static const char* o_use_gates;
   static const char* o_var_decay;
   static const char* o_clause_decay;
   static const char* o_random_var_freq;
@@ -261,8 +264,11 @@ public:
   static const char* o_certify_inter;
   static const char* o_simplify_inter;
   static const char* o_interpolant_cnf;
+  static const char* o_streaming_inter;
   static const char* o_proof_struct_hash;
   static const char* o_proof_num_graph_traversals;
+  static const char* o_proof_fill_threads;
+  static const char* o_proof_reduction_threads;
   static const char* o_proof_red_trans;
   static const char* o_proof_rec_piv;
   static const char* o_proof_push_units;
@@ -290,12 +296,15 @@ public:
   static const char* o_sat_split_inittune;
   static const char* o_sat_split_midtune;
   static const char* o_sat_split_num;
+  static const char* o_sat_split_threads; // Number of local threads solving the splits
+  static const char* o_sat_split_sync_conflicts; // Conflicts between the barriers of deterministic local splitting, 0 for none
   static const char* o_sat_split_fix_vars; // Like split_num, but give the number of vars to fix instead
   static const char* o_sat_split_asap;
   static const char* o_sat_scatter_split;
   static const char* o_sat_lookahead_split;
   static const char* o_sat_pure_lookahead;
   static const char* o_lookahead_score_deep;
+  static const char* o_lookahead_bool_probes; // Probe with unit propagation only, check the theory on the chosen literal
   static const char* o_sat_picky;
   static const char* o_sat_picky_w;
   static const char* o_sat_split_units;
@@ -305,6 +314,7 @@ public:
   static const char* o_sat_split_randomize_lookahead_buf;
   static const char* o_produce_models;
   static const char* o_sat_remove_symmetries;
+  static const char* o_symmetry_time_limit;
   static const char* o_dryrun;
   static const char* o_do_substitutions;
   static const char* o_respect_logic_partitioning_hints;
@@ -312,6 +322,22 @@ public:
   static const char* o_ghost_vars;
   static const char* o_sat_solver_limit;
   static const char* o_global_declarations;
+  static const char* o_ackermannize;
+  static const char* o_ackermann_max_arity;
+  static const char* o_ackermann_max_occurrences;
+  static const char* o_dynamic_ackermann;
+  static const char* o_minimize_uf_explanations;
+  static const char* o_cnf_polarity;
+  static const char* o_ite_lifting;
+  static const char* o_produce_unsat_cores;
+  static const char* o_minimize_unsat_cores;
+  static const char* o_time_limit;     // Wall time of a query in milliseconds, 0 for none
+  static const char* o_conflict_limit; // Conflicts of a query, 0 for none; not applied to local cube-and-conquer
+  static const char* o_memory_limit;   // Resident memory of the process during a query in megabytes, 0 for none
+  static const char* o_statistics_json; // Answer (get-info :all-statistics) with a JSON object
+  static const char* o_time_phases;    // Time also the phases of the search and report the phases of every check;
+                                       // not copied to the solvers of local cube-and-conquer
+  static const char* o_trace_out;      // File receiving the timed phases as Chrome trace events
 
   static const char* o_sat_split_mode;
 private:
@@ -319,9 +345,11 @@ private:
   static const char* s_err_not_str;
   static const char* s_err_not_bool;
   static const char* s_err_not_num;
+  static const char* s_err_negative;
   static const char* s_err_seed_zero;
   static const char* s_err_unknown_split;
   static const char* s_err_unknown_units;
+  static const char* s_err_trace_out;
 
 
   Info          info_Empty;
@@ -338,7 +366,9 @@ private:
       return strcmp(o_name, o_produce_inter) == 0 || strcmp(o_name, o_produce_proofs) == 0
         || strcmp(o_name, o_sat_pure_lookahead) == 0 || strcmp(o_name, o_sat_lookahead_split) == 0
         || strcmp(o_name, o_sat_picky) == 0 || strcmp(o_name, o_sat_scatter_split) == 0
-        || strcmp(o_name, o_ghost_vars) == 0;
+        || strcmp(o_name, o_ghost_vars) == 0 || strcmp(o_name, o_ackermannize) == 0
+        || strcmp(o_name, o_ackermann_max_arity) == 0 || strcmp(o_name, o_ackermann_max_occurrences) == 0
+        || strcmp(o_name, o_dynamic_ackermann) == 0;
   }
 
   void          insertOption(const char* o_name, SMTOption* o) {
@@ -395,6 +425,7 @@ public:
   ~SMTConfig ( )
   {
     if ( produceStats() )  stats_out.close( );
+    phaseTimer.setTraceOut(nullptr);
     if ( rocset )         out.close( );
     if ( docset )         err.close( );
     for (int i = 0; i < options.size(); i++)
@@ -409,6 +440,9 @@ public:
 
   bool             setOption(const char* name, const SMTOption& value, const char*& msg);
   const SMTOption& getOption(const char* name) const;
+  // Sets the options of this config to the values set in other, except for the statistics, the phase reports and the
+  // trace; the solvers working for another one (cube-and-conquer) thus stay silent
+  void             copyOptionsFrom(SMTConfig const & other);
 
   bool          setInfo  (const char* name, const Info& value);
   const Info&   getInfo  (const char* name) const;
@@ -421,6 +455,7 @@ public:
   void printConfig      ( std::ostream & out );
 
   inline std::ostream & getStatsOut     ( ) { assert( optionTable.has(o_produce_stats) );  return stats_out; }
+  inline opensmt::PhaseTimer & getPhaseTimer() { return phaseTimer; }
   inline std::ostream & getRegularOut   ( ) { return rocset ? out : std::cout; }
   inline std::ostream & getDiagnosticOut( ) { return docset ? err : std::cerr; }
   inline int  getRandomSeed   ( ) const { return optionTable.has(o_random_seed) ? optionTable[o_random_seed]->getValue().numval : 91648253; }
@@ -536,6 +571,9 @@ public:
   int sat_use_elim() const
     { return optionTable.has(o_use_elim) ?
         optionTable[o_use_elim]->getValue().numval == 1: true; }
+  int sat_use_gates() const
+    { return optionTable.has(o_use_gates) ?
+        optionTable[o_use_gates]->getValue().numval == 1: true; }
   double sat_var_decay() const
     { return optionTable.has(o_var_decay) ?
         optionTable[o_var_decay]->getValue().decval : 1 / 0.95; }
@@ -581,12 +619,25 @@ public:
   int simplify_inter() const
     { return optionTable.has(o_simplify_inter) ?
              optionTable[o_simplify_inter]->getValue().numval : 0; }
+  // Compute interpolants directly from the derivations of the SAT solver, without building the proof graph.
+  // Only used when the proof is not reduced; the interpolation context must be used before the solver is modified.
+  bool streaming_inter() const
+    { return optionTable.has(o_streaming_inter) ?
+        optionTable[o_streaming_inter]->getValue().numval > 0 : false; }
   int proof_struct_hash() const
     { return optionTable.has(o_proof_struct_hash) ?
         optionTable[o_proof_struct_hash]->getValue().numval : 1; }
   int proof_num_graph_traversals() const
     { return optionTable.has(o_proof_num_graph_traversals) ?
         optionTable[o_proof_num_graph_traversals]->getValue().numval : 3; }
+  // Number of threads used for computing the clauses of the proof graph
+  int proof_fill_threads() const
+    { return optionTable.has(o_proof_fill_threads) ?
+        optionTable[o_proof_fill_threads]->getValue().numval : 1; }
+  // Number of threads reducing the regions of the proof; with one thread the whole proof is reduced at once
+  int proof_reduction_threads() const
+    { return optionTable.has(o_proof_reduction_threads) ?
+        optionTable[o_proof_reduction_threads]->getValue().numval : 1; }
   int proof_red_trans() const
     { return optionTable.has(o_proof_red_trans) ?
         optionTable[o_proof_red_trans]->getValue().numval : 2; }
@@ -742,6 +793,14 @@ public:
       return optionTable.has(o_sat_split_num) ?
               optionTable[o_sat_split_num]->getValue().numval :
               2; }
+  int sat_split_threads() const {
+      return optionTable.has(o_sat_split_threads) ?
+              optionTable[o_sat_split_threads]->getValue().numval :
+              0; }
+  int sat_split_sync_conflicts() const {
+      return optionTable.has(o_sat_split_sync_conflicts) ?
+              optionTable[o_sat_split_sync_conflicts]->getValue().numval :
+              0; }
   int sat_split_fixvars() const {
       return optionTable.has(o_sat_split_fix_vars) ?
               optionTable[o_sat_split_fix_vars]->getValue().numval :
@@ -766,6 +825,10 @@ public:
       return optionTable.has(o_lookahead_score_deep) ?
               optionTable[o_lookahead_score_deep]->getValue().numval :
               0; }
+  int lookahead_bool_probes() const {
+      return optionTable.has(o_lookahead_bool_probes) ?
+              optionTable[o_lookahead_bool_probes]->getValue().numval :
+              0; }
   int sat_picky() const {
       return optionTable.has(o_sat_picky) ?
               optionTable[o_sat_picky]->getValue().numval :
@@ -784,6 +847,27 @@ public:
     { return optionTable.has(o_sat_remove_symmetries) ?
         optionTable[o_sat_remove_symmetries]->getValue().numval : 0; }
 
+  // Time budget for the symmetry detection in milliseconds; 0 means no limit
+  int symmetry_time_limit() const
+    { return optionTable.has(o_symmetry_time_limit) ?
+        optionTable[o_symmetry_time_limit]->getValue().numval : 1000; }
+
+  int time_limit() const
+    { return optionTable.has(o_time_limit) ?
+        optionTable[o_time_limit]->getValue().numval : 0; }
+
+  int conflict_limit() const
+    { return optionTable.has(o_conflict_limit) ?
+        optionTable[o_conflict_limit]->getValue().numval : 0; }
+
+  int memory_limit() const
+    { return optionTable.has(o_memory_limit) ?
+        optionTable[o_memory_limit]->getValue().numval : 0; }
+
+  bool statistics_json() const
+    { return optionTable.has(o_statistics_json) ?
+        optionTable[o_statistics_json]->getValue().numval : false; }
+
   int dryrun() const
     { return optionTable.has(o_dryrun) ?
         optionTable[o_dryrun]->getValue().numval : 0; }
@@ -816,6 +900,46 @@ public:
     { return optionTable.has(o_do_substitutions) ?
         optionTable[o_do_substitutions]->getValue().numval : 1; }
 
+  int ackermannize() const
+    { return optionTable.has(o_ackermannize) ?
+        optionTable[o_ackermannize]->getValue().numval : 0; }
+
+  int ackermann_max_arity() const
+    { return optionTable.has(o_ackermann_max_arity) ?
+        optionTable[o_ackermann_max_arity]->getValue().numval : 2; }
+
+  int ackermann_max_occurrences() const
+    { return optionTable.has(o_ackermann_max_occurrences) ?
+        optionTable[o_ackermann_max_occurrences]->getValue().numval : 8; }
+
+  // Number of conflicts a congruence has to take part in before its Ackermann lemma is added; 0 disables the lemmas
+  int dynamic_ackermann() const
+    { return optionTable.has(o_dynamic_ackermann) ?
+        optionTable[o_dynamic_ackermann]->getValue().numval : 0; }
+
+  bool minimize_uf_explanations() const
+    { return optionTable.has(o_minimize_uf_explanations) ?
+        optionTable[o_minimize_uf_explanations]->getValue().numval != 0 : false; }
+
+  // Emit only the directions of the Tseitin definitions required by the polarity of the subformula (Plaisted-Greenbaum)
+  bool cnf_polarity() const
+    { return optionTable.has(o_cnf_polarity) ?
+        optionTable[o_cnf_polarity]->getValue().numval != 0 : false; }
+
+  // Lift ites with a single use out of the linear terms and atoms instead of naming them with auxiliary variables
+  bool ite_lifting() const
+    { return optionTable.has(o_ite_lifting) ?
+        optionTable[o_ite_lifting]->getValue().numval != 0 : true; }
+
+  bool produce_unsat_cores() const
+    { return optionTable.has(o_produce_unsat_cores) ?
+        optionTable[o_produce_unsat_cores]->getValue().numval != 0 : false; }
+
+  // Shrink the core over the assumptions until no assumption can be dropped from it, at the cost of a query per assumption
+  bool minimize_unsat_cores() const
+    { return optionTable.has(o_minimize_unsat_cores) ?
+        optionTable[o_minimize_unsat_cores]->getValue().numval != 0 : false; }
+
 
    bool use_theory_polarity_suggestion() const
    { return sat_theory_polarity_suggestion != 0; }
@@ -937,6 +1061,8 @@ public:
 private:
 
   std::ofstream     stats_out;                    // File for statistics
+  std::ofstream     trace_out;                    // File for the trace of the phases
+  opensmt::PhaseTimer phaseTimer;                 // The times of the phases of the solvers using this config
   std::ofstream     out;                          // Regular output channel
   std::ofstream     err;                          // Diagnostic output channel
 };
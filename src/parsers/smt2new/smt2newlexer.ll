@@ -74,6 +74,7 @@ using namespace osmttokens;
 
 "assert"           { yyget_lval(yyscanner)->tok = { t_assert }; return TK_ASSERT;        }
 "check-sat"        { yyget_lval(yyscanner)->tok = { t_checksat }; return TK_CHECKSAT;      }
+"check-sat-assuming" { yyget_lval(yyscanner)->tok = { t_checksatassuming }; return TK_CHECKSATASSUMING; }
 "declare-sort"     { yyget_lval(yyscanner)->tok = { t_declaresort }; return TK_DECLARESORT;   }
 "declare-fun"      { yyget_lval(yyscanner)->tok = { t_declarefun }; return TK_DECLAREFUN;    }
 "declare-const"    { yyget_lval(yyscanner)->tok = { t_declareconst} ; return TK_DECLARECONST; }
@@ -86,6 +87,7 @@ using namespace osmttokens;
 "get-option"       { yyget_lval(yyscanner)->tok = { t_getoption }; return TK_GETOPTION;     }
 "get-proof"        { yyget_lval(yyscanner)->tok = { t_getproof }; return TK_GETPROOF;      }
 "get-unsat-core"   { yyget_lval(yyscanner)->tok = { t_getunsatcore }; return TK_GETUNSATCORE;  }
+"get-unsat-assumptions" { yyget_lval(yyscanner)->tok = { t_getunsatassumptions }; return TK_GETUNSATASSUMPTIONS; }
 "get-value"        { yyget_lval(yyscanner)->tok = { t_getvalue }; return TK_GETVALUE;      }
 "get-model"        { yyget_lval(yyscanner)->tok = { t_getmodel }; return TK_GETMODEL;      }
 "pop"              { yyget_lval(yyscanner)->tok = { t_pop }; return TK_POP;           }
@@ -11,6 +11,106 @@
 #include "VerificationUtils.h"
 #include "BoolRewriting.h"
 
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <unordered_map>
+
+/**
+ * Resolution proof read directly from the derivations recorded by the SAT solver.
+ *
+ * Only the clauses reachable from the empty clause are considered. They are kept in topological order together with
+ * the number of their uses as antecedents, so that the data computed for a clause can be released after its last use.
+ * The derivations and the literals of these clauses are copied, since the solver frees the clauses of its proof that
+ * are no longer used. Unlike ProofGraph, no resolution nodes are built.
+ */
+class StreamedProof {
+public:
+    struct Derivation {
+        clause_type type;
+        std::vector<CRef> chain; // The antecedents; clauses with trivial derivations are replaced by their antecedents
+        std::vector<Var> pivots;
+    };
+
+    explicit StreamedProof(Proof const & proof);
+
+    // The empty clause, or the clause it is a copy of
+    CRef getRoot() const { return root; }
+    Derivation const & getDerivation(CRef clause) const { return derivations.at(clause); }
+    std::vector<Lit> const & getClause(CRef clause) const { return clauses.at(clause); }
+    std::vector<CRef> const & getTopologicalOrder() const { return order; }
+    unsigned getNumberOfUses(CRef clause) const { return uses.at(clause); }
+
+    DenseIdSet<Var> const & getVariables() const { return variables; }
+    std::vector<Lit> const & getAssumedLiterals() const { return assumedLiterals; }
+    bool isAssumedVar(Var v) const {
+        return std::find_if(assumedLiterals.begin(), assumedLiterals.end(), [v](Lit l) { return var(l) == v; }) != assumedLiterals.end();
+    }
+
+private:
+    CRef root;
+    std::unordered_map<CRef, Derivation> derivations;
+    std::unordered_map<CRef, std::vector<Lit>> clauses;
+    std::vector<CRef> order;
+    std::unordered_map<CRef, unsigned> uses;
+    DenseIdSet<Var> variables;
+    std::vector<Lit> assumedLiterals;
+};
+
+StreamedProof::StreamedProof(Proof const & proof) : assumedLiterals(proof.getAssumedLiterals()) {
+    auto const & proofDerivations = proof.getProof();
+    {
+        auto it = proofDerivations.find(CRef_Undef);
+        if (it == proofDerivations.end()) { throw OsmtInternalException("Proof streaming: Empty clause was not derived!"); }
+        if (it->second.isEmpty()) { throw OsmtInternalException("Proof streaming: Empty clause has no chain!"); }
+    }
+    // A chain of a single clause is not a resolution but a copy of that clause
+    auto getAntecedent = [&proofDerivations](CRef clause) {
+        while (proofDerivations.at(clause).chain_cla.size() == 1) {
+            clause = proofDerivations.at(clause).chain_cla[0];
+        }
+        return clause;
+    };
+    root = getAntecedent(CRef_Undef);
+    // Depth-first visit from the empty clause; a clause is emitted after all its antecedents
+    std::vector<std::pair<CRef, std::size_t>> stack; // Clause and index of the next antecedent to visit
+    uses.emplace(root, 0);
+    stack.emplace_back(root, 0);
+    while (not stack.empty()) {
+        CRef clause = stack.back().first;
+        std::size_t next = stack.back().second;
+        ProofDer const & derivation = proofDerivations.at(clause);
+        if (isLeafClauseType(derivation.type) or next == derivation.chain_cla.size()) {
+            Derivation & copy = derivations[clause];
+            copy.type = derivation.type;
+            if (not isLeafClauseType(derivation.type)) {
+                std::transform(derivation.chain_cla.begin(), derivation.chain_cla.end(), std::back_inserter(copy.chain), getAntecedent);
+                copy.pivots = derivation.chain_var;
+            }
+            if (clause == CRef_Undef) {
+                clauses.emplace(clause, std::vector<Lit>());
+            } else {
+                Clause const & literals = proof.getClause(clause);
+                clauses.emplace(clause, std::vector<Lit>(literals.begin(), literals.end()));
+            }
+            order.push_back(clause);
+            stack.pop_back();
+            continue;
+        }
+        if (derivation.type != clause_type::CLA_LEARNT or derivation.chain_cla.size() < 2) {
+            throw OsmtInternalException("Proof streaming: Unexpected derivation of a clause");
+        }
+        if (next == 0) {
+            for (Var pivot : derivation.chain_var) { variables.insert(pivot); }
+        }
+        ++stack.back().second;
+        CRef antecedent = getAntecedent(derivation.chain_cla[next]);
+        auto [it, inserted] = uses.emplace(antecedent, 0);
+        ++it->second;
+        if (inserted) { stack.emplace_back(antecedent, 0); }
+    }
+}
+
 class SingleInterpolationComputationContext {
     // Interpolation data for resolution proof element
     struct InterpolationNodeData {
@@ -71,8 +171,8 @@ class SingleInterpolationComputationContext {
     Logic & logic;
     SMTConfig const & config;
     PartitionManager & pmanager;
-    ProofGraph const & proofGraph;
-    std::unique_ptr<THandler> thandler;
+    std::vector<Lit> const & assumedLiterals;
+    THandler & thandler;
     ipartitions_t const & A_mask;
 
 public:
@@ -90,13 +190,20 @@ public:
 
     SingleInterpolationComputationContext(
             SMTConfig const & config,
-            Theory & theory,
-            TermMapper & termMapper,
+            Logic & logic,
+            THandler & thandler,
             PartitionManager & pmanager,
-            ProofGraph const & proof,
+            DenseIdSet<Var> const & proofVariables,
+            std::vector<Lit> const & assumedLiterals,
             ipartitions_t const & A_mask
     );
 
+    bool isAssumedLiteral(Lit l) const {
+        return std::find(assumedLiterals.begin(), assumedLiterals.end(), l) != assumedLiterals.end();
+    }
+
+    bool isAssumedVar(Var v) const { return isAssumedLiteral(mkLit(v, true)) or isAssumedLiteral(mkLit(v, false)); }
+
     inline bool isColoredA(ProofNode const & n, Var v) const { return nodeData[n.getId()].isColoredA(getSharedVarIndex(v)); }
 
     inline bool isColoredB(ProofNode const & n, Var v) const { return nodeData[n.getId()].isColoredB(getSharedVarIndex(v)); }
@@ -115,6 +222,12 @@ public:
 
     inline void setPartialInterpolant(ProofNode const & n, PTRef itp) { nodeData[n.getId()].partialInterpolant = itp; }
 
+    inline void initNodeData(std::size_t size) { nodeData.resize(size); }
+
+    inline void addNodeData() { nodeData.emplace_back(); }
+
+    inline void resetNodeData(ProofNode const & n) { nodeData[n.getId()] = InterpolationNodeData(); }
+
     inline void updateColoringfromAnts(ProofNode const & n) {
         assert(not n.isLeaf());
         auto & data = nodeData[n.getId()];
@@ -130,14 +243,10 @@ public:
         data.clearSharedVar(getSharedVarIndex(n.getPivot()));
     }
 
-    void initTSolver();
-    void backtrackTSolver();
-    bool assertLiteralsToTSolver(vec<Lit> const &);
-
     ipartitions_t const & getVarPartition(Var v) const { return pmanager.getIPartitions(varToPTRef(v)); }
-    inline Lit PTRefToLit(PTRef ref) const {return thandler->getTMap().getLit(ref);}
-    inline Var PTRefToVar(PTRef ref) const { return thandler->getTMap().getVar(ref); }
-    inline PTRef varToPTRef(Var v) const { return thandler->getTMap().varToPTRef(v); }
+    inline Lit PTRefToLit(PTRef ref) const {return thandler.getTMap().getLit(ref);}
+    inline Var PTRefToVar(PTRef ref) const { return thandler.getTMap().getVar(ref); }
+    inline PTRef varToPTRef(Var v) const { return thandler.getTMap().varToPTRef(v); }
 
     icolor_t getSharedVarColorInNode(Var v, ProofNode const & node) const {
         if (isColoredA(node, v)) return icolor_t::I_A;
@@ -170,22 +279,27 @@ public:
 
     icolor_t getClauseColor(CRef clause) const;
 
-    std::unique_ptr<std::map<Var, icolor_t>> computePSFunction() const;
+    template<typename TForEachOriginalLeaf>
+    std::unique_ptr<std::map<Var, icolor_t>> computePSFunction(TForEachOriginalLeaf forEachOriginalLeaf) const;
 
 
     PTRef computePartialInterpolantForOriginalClause(ProofNode const & n) const;
 
+    // The negation of the clause must be asserted to the theory solver, which must be in conflict
     PTRef computePartialInterpolantForTheoryClause(ProofNode const & n);
 
     PTRef computePartialInterpolantForSplitClause(ProofNode const & n) const;
 
+    // Labels the leaf and returns its partial interpolant
+    PTRef computePartialInterpolantForLeaf(ProofNode & n, std::map<Var, icolor_t> const * PSFunction);
+
     PTRef compInterpLabelingInner(ProofNode &);
 
     icolor_t getPivotColor(ProofNode const &);
 
     icolor_t getVarColor(ProofNode const & n, Var v) const;
 
-    PTRef produceSingleInterpolant();
+    void reportInterpolant(PTRef interpolant) const;
 
     void checkInterAlgo() const;
 
@@ -246,11 +360,9 @@ bool decideOnAlternativeInterpolation(PTRef I1, PTRef I2, Logic const & logic) {
 }
 
 icolor_t getClass(ipartitions_t const & mask, ipartitions_t const & A_mask) {
-    ipartitions_t B_mask = ~A_mask;
-
     // Check if belongs to A or B
-    const bool in_A = ((mask & A_mask) != 0);
-    const bool in_B = ((mask & B_mask) != 0);
+    const bool in_A = opensmt::isAlocal(mask, A_mask);
+    const bool in_B = opensmt::isBlocal(mask, A_mask);
     assert(in_A or in_B);
 
     icolor_t clause_color = icolor_t::I_UNDEF;
@@ -296,7 +408,7 @@ icolor_t SingleInterpolationComputationContext::getPivotColor(ProofNode const &
         // Remove pivot from resolvent if class AB
         clearPivotColoring(n);
     }
-    if (proofGraph.isAssumedVar(v)) { // Small hack to deal with assumption literals in proof
+    if (isAssumedVar(v)) { // Small hack to deal with assumption literals in proof
         return icolor_t::I_S;
     }
     return var_color;
@@ -305,7 +417,7 @@ icolor_t SingleInterpolationComputationContext::getPivotColor(ProofNode const &
 // Input: variable, current interpolant partition masks for A
 // Output: returns A-local , B-local or AB-common
 icolor_t SingleInterpolationComputationContext::getVarClass(Var v) const {
-    if (proofGraph.isAssumedVar(v)) { return icolor_t::I_AB; } // MB: Does not matter for assumed literals
+    if (isAssumedVar(v)) { return icolor_t::I_AB; } // MB: Does not matter for assumed literals
     const ipartitions_t & var_mask = getVarPartition(v);
     return getClass(var_mask, A_mask);
 }
@@ -317,20 +429,16 @@ icolor_t SingleInterpolationComputationContext::getClauseColor(CRef clause) cons
     return getClass(clause_mask, A_mask);
 }
 
-std::unique_ptr<std::map<Var, icolor_t>> SingleInterpolationComputationContext::computePSFunction() const {
+template<typename TForEachOriginalLeaf>
+std::unique_ptr<std::map<Var, icolor_t>> SingleInterpolationComputationContext::computePSFunction(TForEachOriginalLeaf forEachOriginalLeaf) const {
 
     auto labels = std::make_unique<std::map<Var, icolor_t>>();
 
     std::map<Var, int> occ_a, occ_b;
 
-    for (auto leafId : proofGraph.getLeaves()) {
-        ProofNode * n = proofGraph.getNode(leafId);
-        assert(n and n->isLeaf());
-        if (n->getType() != clause_type::CLA_ORIG) {
-            continue;
-        }
-        icolor_t col = getClauseColor(n->getClauseRef());
-        for (Lit l : n->getClause()) {
+    forEachOriginalLeaf([&](CRef clauseRef, auto const & clause) {
+        icolor_t col = getClauseColor(clauseRef);
+        for (Lit l : clause) {
             Var v = var(l);
             icolor_t vclass = getVarClassFromCache(v);
             if (vclass != icolor_t::I_AB) continue;
@@ -345,7 +453,7 @@ std::unique_ptr<std::map<Var, icolor_t>> SingleInterpolationComputationContext::
                     occ_a[v] = 0;
             }
         }
-    }
+    });
     assert(occ_a.size() == occ_b.size());
     for (auto const & entry : occ_a) {
         Var v = entry.first;
@@ -386,32 +494,6 @@ void SingleInterpolationComputationContext::checkInterAlgo() const {
     }
 }
 
-void SingleInterpolationComputationContext::backtrackTSolver() {
-    thandler->backtrack(-1);
-}
-
-bool SingleInterpolationComputationContext::assertLiteralsToTSolver(vec<Lit> const & vec) {
-    return thandler->assertLits(vec);
-}
-
-void SingleInterpolationComputationContext::initTSolver() {
-    auto const & leaves_ids = proofGraph.getLeaves();
-    assert(not leaves_ids.empty());
-    for (auto id : leaves_ids) {
-        ProofNode * node = proofGraph.getNode(id);
-        assert(node);
-        assert(isLeafClauseType(node->getType()));
-        if (node->getType() != clause_type::CLA_THEORY) { continue; }
-        const auto & clause = proofGraph.getNode(id)->getClause();
-        for (auto const & lit : clause) {
-            Var v = var(lit);
-            PTRef atom = this->varToPTRef(v);
-            assert(logic.isTheoryTerm(atom));
-            thandler->declareAtom(atom);
-        }
-    }
-}
-
 bool SingleInterpolationComputationContext::verifyPartialInterpolant(ProofNode const & n) {
     if(verbose())
         std::cout << "; Verifying partial interpolant" << '\n';
@@ -491,15 +573,14 @@ bool SingleInterpolationComputationContext::verifyPartialInterpolantB(ProofNode
 
 SingleInterpolationComputationContext::SingleInterpolationComputationContext(
         const SMTConfig & config,
-        Theory & theory,
-        TermMapper & termMapper,
+        Logic & logic,
+        THandler & thandler,
         PartitionManager & pmanager,
-        const ProofGraph & proof,
+        const DenseIdSet<Var> & vars,
+        const std::vector<Lit> & assumedLiterals,
         const ipartitions_t & A_mask
-) : logic(theory.getLogic()), config(config), pmanager(pmanager), proofGraph(proof), thandler(new THandler(theory, termMapper)), A_mask(A_mask) {
-    auto const & vars = proof.getVariables();
+) : logic(logic), config(config), pmanager(pmanager), assumedLiterals(assumedLiterals), thandler(thandler), A_mask(A_mask) {
     std::size_t varCounts = (*std::max_element(vars.begin(), vars.end())) + 1;
-    nodeData.resize(proof.getGraphSize());
     AB_vars_mapping.resize(varCounts, -3);
 
     // NOTE class A has value -1, class B value -2, undetermined value -3, class AB has index bit from 0 onwards
@@ -514,84 +595,319 @@ SingleInterpolationComputationContext::SingleInterpolationComputationContext(
         }
         else throw OsmtInternalException("Error in computing variable colors");
     }
-    initTSolver();
 }
 
 
 /**************** MAIN INTERPOLANTS GENERATION METHODS ************************/
 
-PTRef SingleInterpolationComputationContext::produceSingleInterpolant() {
+/**
+ * Computes the interpolants of several partitionings of the same proof in a single traversal.
+ *
+ * Every node of the proof gets one partial interpolant per A-mask. The theory solver is shared by all partitionings,
+ * so the conflict of each theory clause is established once and then interpolated for every mask.
+ */
+class InterpolantBatchComputation {
+    SMTConfig const & config;
+    Logic & logic;
+    THandler thandler;
+    std::vector<std::unique_ptr<SingleInterpolationComputationContext>> contexts;
+    std::vector<std::unique_ptr<std::map<Var, icolor_t>>> PSFunctions;
+
+public:
+    InterpolantBatchComputation(
+            SMTConfig const & config,
+            Theory & theory,
+            TermMapper & termMapper,
+            PartitionManager & pmanager,
+            DenseIdSet<Var> const & proofVariables,
+            std::vector<Lit> const & assumedLiterals,
+            std::vector<ipartitions_t> const & A_masks
+    );
+
+    std::vector<PTRef> produceInterpolants(ProofGraph const & proofGraph);
+
+    // Computes the interpolants in one pass over the proof, keeping data only for clauses that are still to be used
+    std::vector<PTRef> produceInterpolants(StreamedProof const & proof);
+
+private:
+    template<typename TClause>
+    void declareTheoryAtoms(TClause const & clause);
+
+    template<typename TForEachOriginalLeaf>
+    void computePSFunctions(TForEachOriginalLeaf forEachOriginalLeaf);
+
+    void computeLeafInterpolants(ProofNode & n);
+
+    void computeInnerInterpolants(ProofNode & n);
+
+    std::vector<PTRef> getRootInterpolants(ProofNode const & root) const;
+};
+
+InterpolantBatchComputation::InterpolantBatchComputation(
+        SMTConfig const & config,
+        Theory & theory,
+        TermMapper & termMapper,
+        PartitionManager & pmanager,
+        DenseIdSet<Var> const & proofVariables,
+        std::vector<Lit> const & assumedLiterals,
+        std::vector<ipartitions_t> const & A_masks
+) : config(config), logic(theory.getLogic()), thandler(theory, termMapper) {
+    assert(not A_masks.empty());
+    contexts.reserve(A_masks.size());
+    for (auto const & A_mask : A_masks) {
+        contexts.push_back(std::make_unique<SingleInterpolationComputationContext>(config, logic, thandler, pmanager,
+                                                                                   proofVariables, assumedLiterals, A_mask));
+    }
+}
+
+template<typename TClause>
+void InterpolantBatchComputation::declareTheoryAtoms(TClause const & clause) {
+    for (auto const & lit : clause) {
+        PTRef atom = thandler.getTMap().varToPTRef(var(lit));
+        assert(logic.isTheoryTerm(atom));
+        thandler.declareAtom(atom);
+    }
+}
+
+template<typename TForEachOriginalLeaf>
+void InterpolantBatchComputation::computePSFunctions(TForEachOriginalLeaf forEachOriginalLeaf) {
+    PSFunctions.clear();
+    for (auto const & context : contexts) {
+        PSFunctions.push_back(context->needProofStatistics() ? context->computePSFunction(forEachOriginalLeaf) : nullptr);
+    }
+}
+
+void InterpolantBatchComputation::computeLeafInterpolants(ProofNode & n) {
+    bool const theoryClause = n.getType() == clause_type::CLA_THEORY;
+    if (theoryClause) {
+        thandler.backtrack(-1);
+        vec<Lit> negated;
+        for (Lit l : n.getClause()) { negated.push(~l); }
+        bool satisfiable = thandler.assertLits(negated);
+        if (satisfiable) {
+            TRes tres = thandler.check(true);
+            satisfiable = (tres != TRes::UNSAT);
+        }
+        if (satisfiable) {
+            assert(false);
+            throw OsmtInternalException("Asserting negation of theory clause did not result in conflict in theory solver!");
+        }
+    }
+    for (std::size_t i = 0; i < contexts.size(); ++i) {
+        PTRef partial_interp = contexts[i]->computePartialInterpolantForLeaf(n, PSFunctions[i].get());
+        assert(partial_interp != PTRef_Undef);
+        contexts[i]->setPartialInterpolant(n, partial_interp);
+    }
+    if (theoryClause) { thandler.backtrack(-1); }
+}
+
+void InterpolantBatchComputation::computeInnerInterpolants(ProofNode & n) {
+    for (auto & context : contexts) {
+        PTRef partial_interp = context->compInterpLabelingInner(n);
+        assert(partial_interp != PTRef_Undef);
+        context->setPartialInterpolant(n, partial_interp);
+    }
+}
+
+std::vector<PTRef> InterpolantBatchComputation::getRootInterpolants(ProofNode const & root) const {
+    std::vector<PTRef> interpolants;
+    interpolants.reserve(contexts.size());
+    for (auto const & context : contexts) {
+        PTRef interpolant = context->getPartialInterpolant(root);
+        assert(interpolant != PTRef_Undef);
+        context->reportInterpolant(interpolant);
+        interpolants.push_back(interpolant);
+    }
+    return interpolants;
+}
+
+std::vector<PTRef> InterpolantBatchComputation::produceInterpolants(ProofGraph const & proofGraph) {
 
     // Check
-    checkInterAlgo();
+    contexts.front()->checkInterAlgo();
 
-    // Clause and partial interpolant
-    ProofNode *n = nullptr;
-    PTRef partial_interp = PTRef_Undef;
+    for (auto & context : contexts) { context->initNodeData(proofGraph.getGraphSize()); }
+    assert(not proofGraph.getLeaves().empty());
+    for (auto id : proofGraph.getLeaves()) {
+        ProofNode * node = proofGraph.getNode(id);
+        assert(node);
+        assert(isLeafClauseType(node->getType()));
+        if (node->getType() == clause_type::CLA_THEORY) { declareTheoryAtoms(node->getClause()); }
+    }
 
     // Vector for topological ordering
     std::vector<clauseid_t> DFSv = proofGraph.topolSortingTopDown();
-    size_t proof_size = DFSv.size();
 
-    if (verbose() > 0) std::cerr << "; Generating interpolant " << std::endl;
+    if (config.verbosity() > 0) std::cerr << "; Generating interpolants for " << contexts.size() << " partitioning(s)" << std::endl;
 
-    auto PSFunction = needProofStatistics() ? computePSFunction() : nullptr;
+    computePSFunctions([&proofGraph](auto && visit) {
+        for (auto leafId : proofGraph.getLeaves()) {
+            ProofNode * leaf = proofGraph.getNode(leafId);
+            assert(leaf and leaf->isLeaf());
+            if (leaf->getType() == clause_type::CLA_ORIG) { visit(leaf->getClauseRef(), leaf->getClause()); }
+        }
+    });
 
-    // Traverse proof and compute current interpolant
-    for ( size_t i = 0 ; i < proof_size ; i++ )
-    {
-        n = proofGraph.getNode(DFSv[i]);
+    // Traverse proof and compute current interpolants
+    for (clauseid_t id : DFSv) {
+        ProofNode * n = proofGraph.getNode(id);
         assert(n);
+        if (n->isLeaf()) { computeLeafInterpolants(*n); }
+        else { computeInnerInterpolants(*n); }
+    }
+    // Last clause visited is the empty clause with total interpolants
+    assert(not DFSv.empty() and DFSv.back() == proofGraph.getRoot()->getId());
 
-        // Generate partial interpolant for clause i
-        if (n->isLeaf())
-        {
-            if (!isLeafClauseType(n->getType())) throw OsmtInternalException("; Leaf node with non-leaf clause type");
+    PSFunctions.clear();
 
-            labelLeaf(*n, PSFunction.get());
+    return getRootInterpolants(*proofGraph.getRoot());
+}
 
-            if (n->getType() == clause_type::CLA_ORIG)
-            {
-                partial_interp = computePartialInterpolantForOriginalClause(*n);
-            }
-            else if (n->getType() == clause_type::CLA_THEORY) {
-                partial_interp = computePartialInterpolantForTheoryClause(*n);
-            }
-            else if (n->getType() == clause_type::CLA_SPLIT) {
-                partial_interp = computePartialInterpolantForSplitClause(*n);
-            }
-            else {
-                assert(n->getType() == clause_type::CLA_ASSUMPTION);
-                // MB: Frame literals must be ignored when interpolating
-                // This interpolant will be ignored eventually, any value would do
-                setPartialInterpolant(*n, logic.getTerm_true());
-                continue;
-            }
+std::vector<PTRef> InterpolantBatchComputation::produceInterpolants(StreamedProof const & proof) {
+
+    contexts.front()->checkInterAlgo();
+
+    auto const & order = proof.getTopologicalOrder();
+    for (CRef clause : order) {
+        if (proof.getDerivation(clause).type == clause_type::CLA_THEORY) { declareTheoryAtoms(proof.getClause(clause)); }
+    }
+
+    if (config.verbosity() > 0) std::cerr << "; Generating interpolants for " << contexts.size() << " partitioning(s)" << std::endl;
+
+    computePSFunctions([&](auto && visit) {
+        for (CRef clause : order) {
+            if (proof.getDerivation(clause).type == clause_type::CLA_ORIG) { visit(clause, proof.getClause(clause)); }
+        }
+    });
+
+    // Nodes exist only for the clauses whose resolvents have not all been processed yet; ids index the node data
+    std::deque<ProofNode> nodes;
+    std::vector<ProofNode *> freeNodes;
+    auto newNode = [&]() -> ProofNode & {
+        if (freeNodes.empty()) {
+            nodes.emplace_back();
+            nodes.back().setId(static_cast<clauseid_t>(nodes.size() - 1));
+            for (auto & context : contexts) { context->addNodeData(); }
+            return nodes.back();
+        }
+        ProofNode & node = *freeNodes.back();
+        freeNodes.pop_back();
+        return node;
+    };
+    auto releaseNode = [&](ProofNode & node) {
+        for (auto & context : contexts) { context->resetNodeData(node); }
+        node.setAnt1(nullptr);
+        node.setAnt2(nullptr);
+        node.release();
+        freeNodes.push_back(&node);
+    };
+
+    struct LiveClause {
+        ProofNode * node;
+        unsigned remainingUses;
+    };
+    std::unordered_map<CRef, LiveClause> live;
+    auto getNode = [&live](CRef clause) -> ProofNode & {
+        assert(live.find(clause) != live.end());
+        return *live.at(clause).node;
+    };
+    auto useClause = [&](CRef clause) {
+        auto it = live.find(clause);
+        assert(it != live.end() and it->second.remainingUses > 0);
+        if (--it->second.remainingUses == 0) {
+            releaseNode(*it->second.node);
+            live.erase(it);
+        }
+    };
 
-            assert ( partial_interp != PTRef_Undef );
-            setPartialInterpolant(*n, partial_interp);
-            if (enabledPedInterpVerif()) {
-                verifyPartialInterpolant(*n);
+    std::vector<PTRef> rootInterpolants;
+    for (CRef clause : order) {
+        auto const & derivation = proof.getDerivation(clause);
+        ProofNode * node = nullptr;
+        if (isLeafClauseType(derivation.type)) {
+            node = &newNode();
+            node->setType(derivation.type);
+            node->initClause(proof.getClause(clause));
+            node->setClauseRef(clause);
+            std::sort(node->getClause().begin(), node->getClause().end());
+            computeLeafInterpolants(*node);
+        } else {
+            // The chain resolves the last derived clause with the next clause of the chain, as in ProofGraph
+            auto const & chain = derivation.chain;
+            CRef first = chain[0];
+            ProofNode * last = &getNode(first);
+            for (std::size_t i = 1; i < chain.size(); ++i) {
+                CRef clause_i = chain[i];
+                ProofNode & resolvent = newNode();
+                resolvent.setType(i < chain.size() - 1 ? clause_type::CLA_DERIVED : clause_type::CLA_LEARNT);
+                Var pivot = derivation.pivots[i - 1];
+                resolvent.setPivot(pivot);
+                // Make sure ant1 has the pivot positive (and ant2 negated)
+                std::vector<Lit> const & clausei = proof.getClause(clause_i);
+                auto it = std::find_if(clausei.begin(), clausei.end(), [pivot](Lit l) { return var(l) == pivot; });
+                assert(it != clausei.end());
+                bool pos_piv = it == clausei.end() or not sign(*it);
+                ProofNode & other = getNode(clause_i);
+                resolvent.setAnt1(pos_piv ? &other : last);
+                resolvent.setAnt2(pos_piv ? last : &other);
+                computeInnerInterpolants(resolvent);
+
+                if (i == 1) { useClause(first); }
+                else { releaseNode(*last); }
+                useClause(clause_i);
+                last = &resolvent;
             }
+            node = last;
         }
-        else { // Inner node
-            partial_interp = compInterpLabelingInner(*n);
-            assert (partial_interp != PTRef_Undef);
-            setPartialInterpolant(*n, partial_interp);
+        if (clause == proof.getRoot()) {
+            rootInterpolants = getRootInterpolants(*node);
+        } else {
+            live.emplace(clause, LiveClause{node, proof.getNumberOfUses(clause)});
         }
     }
+    assert(not rootInterpolants.empty());
+    assert(live.empty());
+
+    PSFunctions.clear();
+
+    return rootInterpolants;
+}
+
+PTRef SingleInterpolationComputationContext::computePartialInterpolantForLeaf(ProofNode & n, std::map<Var, icolor_t> const * PSFunction) {
+    if (!isLeafClauseType(n.getType())) throw OsmtInternalException("; Leaf node with non-leaf clause type");
 
-    PSFunction.release();
+    labelLeaf(n, PSFunction);
 
-    PTRef rootInterpolant = getPartialInterpolant(*proofGraph.getRoot());
-    assert(rootInterpolant != PTRef_Undef);
-    // Last clause visited is the empty clause with total interpolant
-    assert(partial_interp == rootInterpolant);
+    PTRef partial_interp = PTRef_Undef;
+    if (n.getType() == clause_type::CLA_ORIG) {
+        partial_interp = computePartialInterpolantForOriginalClause(n);
+    }
+    else if (n.getType() == clause_type::CLA_THEORY) {
+        partial_interp = computePartialInterpolantForTheoryClause(n);
+    }
+    else if (n.getType() == clause_type::CLA_SPLIT) {
+        partial_interp = computePartialInterpolantForSplitClause(n);
+    }
+    else {
+        assert(n.getType() == clause_type::CLA_ASSUMPTION);
+        // MB: Frame literals must be ignored when interpolating
+        // This interpolant will be ignored eventually, any value would do
+        return logic.getTerm_true();
+    }
 
+    assert ( partial_interp != PTRef_Undef );
+    if (enabledPedInterpVerif()) {
+        setPartialInterpolant(n, partial_interp);
+        verifyPartialInterpolant(n);
+    }
+    return partial_interp;
+}
+
+void SingleInterpolationComputationContext::reportInterpolant(PTRef interpolant) const {
     if (verbose()) {
         //getComplexityInterpolant(partial_interp);
         int nbool, neq, nuf, nif;
-        logic.collectStats(partial_interp, nbool, neq, nuf, nif);
+        logic.collectStats(interpolant, nbool, neq, nuf, nif);
         std::cerr << "; Number of boolean connectives: " << nbool << '\n';
         std::cerr << "; Number of equalities: " << neq << '\n';
         std::cerr << "; Number of uninterpreted functions: " << nuf << '\n';
@@ -599,9 +915,8 @@ PTRef SingleInterpolationComputationContext::produceSingleInterpolant() {
     }
 
     if (verbose() > 1) {
-        std::cout << "; Interpolant:\n" << logic.printTerm(rootInterpolant) << '\n';
+        std::cout << "; Interpolant:\n" << logic.printTerm(interpolant) << '\n';
     }
-    return rootInterpolant;
 }
 
 /********** FULL LABELING BASED INTERPOLATION **********/
@@ -626,7 +941,7 @@ void SingleInterpolationComputationContext::labelLeaf(ProofNode & n, std::map<Va
 std::vector<Lit> SingleInterpolationComputationContext::getRestrictedNodeClause(ProofNode const & node, icolor_t wantedVarClass) const {
     std::vector<Lit> restrictedClause;
     for (Lit l : node.getClause()) {
-        if (proofGraph.isAssumedLiteral(~l)) {
+        if (isAssumedLiteral(~l)) {
             // ignore if the negation is assumed, it's as if this literal did not exist
             continue;
         }
@@ -676,29 +991,11 @@ PTRef SingleInterpolationComputationContext::computePartialInterpolantForOrigina
 }
 
 PTRef SingleInterpolationComputationContext::computePartialInterpolantForTheoryClause(ProofNode const & n) {
-    backtrackTSolver();
-    vec<Lit> newvec;
-    std::vector<Lit> const & oldvec = n.getClause();
-    for (Lit l : oldvec) {
-        newvec.push(~l);
-    }
-    bool satisfiable = this->assertLiteralsToTSolver(newvec);
-    if (satisfiable) {
-        TRes tres = thandler->check(true);
-        satisfiable = (tres != TRes::UNSAT);
-    }
-    if (satisfiable) {
-        assert(false);
-        throw OsmtInternalException("Asserting negation of theory clause did not result in conflict in theory solver!");
-    }
     THandler::ItpColorMap ptref2label;
-    for (Lit l : oldvec) {
+    for (Lit l : n.getClause()) {
         ptref2label.insert({varToPTRef(var(l)), getVarColor(n, var(l))});
     }
-
-    PTRef interpolant = thandler->getInterpolant(A_mask, &ptref2label, pmanager);
-    backtrackTSolver();
-    return interpolant;
+    return thandler.getInterpolant(A_mask, &ptref2label, pmanager);
 }
 
 /*
@@ -739,12 +1036,12 @@ PTRef SingleInterpolationComputationContext::compInterpLabelingInner(ProofNode &
     if (pivot_color == icolor_t::I_S) {
         Var v = n.getPivot();
         Lit pos = mkLit(v);
-        if (proofGraph.isAssumedLiteral(pos)) {
+        if (isAssumedLiteral(pos)) {
             // Positive occurence of assumed literal is in first parent => return interpolant from second
             return partial_interp_ant2;
         }
         else {
-            assert(proofGraph.isAssumedLiteral(~pos));
+            assert(isAssumedLiteral(~pos));
             return partial_interp_ant1;
         }
     }
@@ -842,9 +1139,17 @@ void SingleInterpolationComputationContext::setLeafMcMillanPrimeLabeling(ProofNo
 /************************ INTERPOLATION CONTEXT ************************************************************/
 
 InterpolationContext::InterpolationContext(SMTConfig & c, Theory & th, TermMapper & termMapper, Proof const & proof,
-                                           PartitionManager & pmanager)
-        : config(c), theory(th), termMapper(termMapper), logic(th.getLogic()), pmanager(pmanager),
-          proof_graph{new ProofGraph(c, th.getLogic(), termMapper, proof)} {
+                                           PartitionManager & pmanager, opensmt::ResourceLimits * limits)
+        : config(c), theory(th), termMapper(termMapper), logic(th.getLogic()), pmanager(pmanager) {
+    opensmt::PhaseTimer::Scope scope(c.getPhaseTimer(), c.getPhaseTimer().getPhase("proof-transform"));
+    if (c.streaming_inter() and not c.proof_reduce() and c.proof_interpolant_cnf() == 0 and c.print_proofs_dotty == 0) {
+        streamed_proof = std::make_unique<StreamedProof>(proof);
+        if (updatePartitionsOfTheoryVars(*streamed_proof).empty()) { return; }
+        // Theory variables without partition must be eliminated by transforming the proof
+        streamed_proof.reset();
+    }
+    proof_graph = std::make_unique<ProofGraph>(c, th.getLogic(), termMapper, proof);
+    proof_graph->setResourceLimits(limits);
     ensureNoLiteralsWithoutPartition();
     if (c.proof_reduce()) {
         reduceProofGraph();
@@ -862,23 +1167,51 @@ void InterpolationContext::printProofDotty() {
     proof_graph->printProofGraph();
 }
 
-void InterpolationContext::getSingleInterpolant(vec<PTRef> & interpolants, const ipartitions_t & A_mask) {
-    assert(proof_graph);
-    PTRef itp = SingleInterpolationComputationContext(config, theory, termMapper, pmanager, *proof_graph, A_mask).produceSingleInterpolant();
+void InterpolationContext::getInterpolants(const std::vector<vec<int>> & partitions, vec<PTRef> & interpolants) {
+    std::vector<ipartitions_t> A_masks;
+    A_masks.reserve(partitions.size());
+    for (auto const & partition : partitions) {
+        ipartitions_t A_mask = 0;
+        for (int i : partition) { setbit(A_mask, static_cast<unsigned>(i)); }
+        A_masks.push_back(std::move(A_mask));
+    }
+    getInterpolants(interpolants, A_masks);
+}
 
-    if (enabledInterpVerif()) {
-        bool sound = verifyInterpolant(itp, A_mask);
-        assert(sound);
-        if (verbose()) {
-            if (sound) std::cout << "; Final interpolant is sound" << '\n';
-            else std::cout << "; Final interpolant is NOT sound" << '\n';
-        }
+void InterpolationContext::getInterpolants(vec<PTRef> & interpolants, const std::vector<ipartitions_t> & A_masks) {
+    assert(proof_graph or streamed_proof);
+    if (A_masks.empty()) { return; }
+    opensmt::PhaseTimer::Scope scope(config.getPhaseTimer(), config.getPhaseTimer().getPhase("interpolation"));
+    std::vector<PTRef> itps;
+    if (streamed_proof) {
+        itps = InterpolantBatchComputation(config, theory, termMapper, pmanager, streamed_proof->getVariables(),
+                                           streamed_proof->getAssumedLiterals(), A_masks).produceInterpolants(*streamed_proof);
+    } else {
+        itps = InterpolantBatchComputation(config, theory, termMapper, pmanager, proof_graph->getVariables(),
+                                           proof_graph->getAssumedLiterals(), A_masks).produceInterpolants(*proof_graph);
     }
+    assert(itps.size() == A_masks.size());
+
+    for (std::size_t i = 0; i < itps.size(); ++i) {
+        PTRef itp = itps[i];
+        if (enabledInterpVerif()) {
+            bool sound = verifyInterpolant(itp, A_masks[i]);
+            assert(sound);
+            if (verbose()) {
+                if (sound) std::cout << "; Final interpolant is sound" << '\n';
+                else std::cout << "; Final interpolant is NOT sound" << '\n';
+            }
+        }
 
-    if (config.simplify_inter() > 0) {
-        itp = simplifyInterpolant(itp);
+        if (config.simplify_inter() > 0) {
+            itp = simplifyInterpolant(itp);
+        }
+        interpolants.push(itp);
     }
-    interpolants.push(itp);
+}
+
+void InterpolationContext::getSingleInterpolant(vec<PTRef> & interpolants, const ipartitions_t & A_mask) {
+    getInterpolants(interpolants, std::vector<ipartitions_t>{A_mask});
 }
 
 void InterpolationContext::getSingleInterpolant(std::vector<PTRef> & interpolants, const ipartitions_t & A_mask) {
@@ -888,18 +1221,18 @@ void InterpolationContext::getSingleInterpolant(std::vector<PTRef> & interpolant
 }
 
 bool InterpolationContext::getPathInterpolants(vec<PTRef> & interpolants, const std::vector<ipartitions_t> & A_masks) {
-    assert(proof_graph);
     bool propertySatisfied = true;
     // check that masks are subset of each other
     assert(std::mismatch(A_masks.begin() + 1, A_masks.end(), A_masks.begin(), [](auto const & next, auto const & previous){
         return (previous & next) == previous;
     }).first == A_masks.end());
 
-    for (unsigned i = 0; i < A_masks.size(); ++i) {
-        getSingleInterpolant(interpolants, A_masks[i]);
-        if (i > 0 and enabledInterpVerif()) {
-            PTRef previous_itp = interpolants[interpolants.size() - 2];
-            PTRef next_itp = interpolants[interpolants.size() - 1];
+    int const first = interpolants.size();
+    getInterpolants(interpolants, A_masks);
+    if (enabledInterpVerif()) {
+        for (unsigned i = 1; i < A_masks.size(); ++i) {
+            PTRef previous_itp = interpolants[first + i - 1];
+            PTRef next_itp = interpolants[first + i];
             PTRef movedPartitions = logic.mkAnd(pmanager.getPartitions(A_masks[i] ^ A_masks[i - 1]));
             propertySatisfied &= VerificationUtils(logic).impliesInternal(logic.mkAnd(previous_itp, movedPartitions), next_itp);
             if (not propertySatisfied) {
@@ -971,10 +1304,19 @@ PTRef InterpolationContext::simplifyInterpolant(PTRef itp) const {
 }
 
 void InterpolationContext::ensureNoLiteralsWithoutPartition() {
+    std::vector<Var> noPartitionVars = updatePartitionsOfTheoryVars(*proof_graph);
+    if (!noPartitionVars.empty()) {
+        proof_graph->eliminateNoPartitionTheoryVars(noPartitionVars);
+    }
+}
+
+// Assigns partitions to the theory variables of the proof that have none; returns the variables where this is not possible
+template<typename TProof>
+std::vector<Var> InterpolationContext::updatePartitionsOfTheoryVars(TProof const & proof) {
     std::vector<Var> noPartitionVars;
-    for (Var v : proof_graph->getVariables()) {
+    for (Var v : proof.getVariables()) {
         auto const& part = pmanager.getIPartitions(termMapper.varToPTRef(v));
-        if(part == 0 && not proof_graph->isAssumedVar(v)) {
+        if(part == 0 && not proof.isAssumedVar(v)) {
             PTRef term = termMapper.varToPTRef(v);
             assert(this->logic.isTheoryTerm(term));
             auto allowedPartitions = pmanager.computeAllowedPartitions(term);
@@ -987,8 +1329,6 @@ void InterpolationContext::ensureNoLiteralsWithoutPartition() {
             }
         }
     }
-    if (!noPartitionVars.empty()) {
-        proof_graph->eliminateNoPartitionTheoryVars(noPartitionVars);
-    }
+    return noPartitionVars;
 }
 
@@ -11,10 +11,12 @@
 #include <memory>
 
 #include "Theory.h"
+#include "ResourceLimits.h"
 
 // forward declaration
 class Proof;
 class ProofGraph;
+class StreamedProof;
 
 class InterpolationContext {
     SMTConfig & config;
@@ -22,10 +24,14 @@ class InterpolationContext {
     TermMapper & termMapper;
     Logic & logic;
     PartitionManager & pmanager;
+    // Exactly one of the two is used; the streamed proof only when enabled and the proof is neither transformed nor
+    // printed
     std::unique_ptr<ProofGraph> proof_graph;
+    std::unique_ptr<StreamedProof> streamed_proof;
 public:
+    // The reduction of the proof, if enabled, is cut short once the limits are exhausted
     InterpolationContext(SMTConfig & c, Theory & th, TermMapper & termMapper, Proof const & t,
-                         PartitionManager & pmanager);
+                         PartitionManager & pmanager, opensmt::ResourceLimits * limits = nullptr);
 
     ~InterpolationContext();
 
@@ -34,6 +40,9 @@ public:
     // Create interpolants with each A consisting of the specified partitions
     void getInterpolants(const std::vector<vec<int> > & partitions, vec<PTRef> & interpolants);
 
+    // Create one interpolant for each A-mask; the proof is labelled and traversed only once for all masks
+    void getInterpolants(vec<PTRef> & interpolants, const std::vector<ipartitions_t> & A_masks);
+
     void getSingleInterpolant(vec<PTRef> & interpolants, const ipartitions_t & A_mask);
 
     void getSingleInterpolant(std::vector<PTRef>& interpolants, const ipartitions_t& A_mask);
@@ -51,6 +60,9 @@ private:
 
     void ensureNoLiteralsWithoutPartition();
 
+    template<typename TProof>
+    std::vector<Var> updatePartitionsOfTheoryVars(TProof const & proof);
+
     /***** CONFIGURATION ****/
 
     int verbose() const { return config.verbosity(); }
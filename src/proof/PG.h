@@ -25,11 +25,17 @@ along with Periplo. If not, see <http://www.gnu.org/licenses/>.
 #include "Theory.h"
 #include "THandler.h"
 #include "OsmtInternalException.h"
+#include "ResourceLimits.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
 #include <memory>
 #include <map>
 #include <new>
+#include <unordered_map>
 #include <functional>
+#include <vector>
 
 using namespace opensmt;
 
@@ -104,27 +110,101 @@ public:
 	friend std::ostream& operator<< (std::ostream &out, RuleContext &ra);
 };
 
+// Set of small non-negative ids (clause ids, variables) stored as a bitset over the id range.
+// Iteration visits the ids in increasing order, like std::set.
+template<typename T>
+class DenseIdSet
+{
+    using word_t = std::uint64_t;
+    static constexpr unsigned bitsPerWord = 64;
+
+public:
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = T const *;
+        using reference         = T;
+
+        const_iterator(std::vector<word_t> const & words, std::size_t pos) : words(&words), pos(pos) { skipToSet(); }
+
+        T operator*() const { return static_cast<T>(pos); }
+        const_iterator & operator++() { ++pos; skipToSet(); return *this; }
+        const_iterator operator++(int) { const_iterator old = *this; ++(*this); return old; }
+        bool operator==(const_iterator const & other) const { return pos == other.pos; }
+        bool operator!=(const_iterator const & other) const { return pos != other.pos; }
+
+    private:
+        void skipToSet() {
+            std::size_t const end = words->size() * bitsPerWord;
+            while (pos < end) {
+                word_t rest = (*words)[pos / bitsPerWord] >> (pos % bitsPerWord);
+                if (rest != 0) { pos += __builtin_ctzll(rest); return; }
+                pos = (pos / bitsPerWord + 1) * bitsPerWord;
+            }
+            pos = end;
+        }
+
+        std::vector<word_t> const * words;
+        std::size_t pos;
+    };
+
+    bool insert(T id) {
+        auto const i = static_cast<std::size_t>(id);
+        if (i / bitsPerWord >= words.size()) { words.resize(i / bitsPerWord + 1, 0); }
+        word_t & word = words[i / bitsPerWord];
+        word_t const mask = word_t(1) << (i % bitsPerWord);
+        if (word & mask) { return false; }
+        word |= mask;
+        ++count;
+        return true;
+    }
+
+    bool erase(T id) {
+        if (not contains(id)) { return false; }
+        auto const i = static_cast<std::size_t>(id);
+        words[i / bitsPerWord] &= ~(word_t(1) << (i % bitsPerWord));
+        --count;
+        return true;
+    }
+
+    bool contains(T id) const {
+        auto const i = static_cast<std::size_t>(id);
+        return i / bitsPerWord < words.size() and (words[i / bitsPerWord] >> (i % bitsPerWord)) & 1;
+    }
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    void clear() { words.clear(); count = 0; }
+
+    const_iterator begin() const { return const_iterator(words, 0); }
+    const_iterator end() const { return const_iterator(words, words.size() * bitsPerWord); }
+
+private:
+    std::vector<word_t> words;
+    std::size_t count = 0;
+};
+
 // Resolution proof graph element
 struct ProofNode
 {
     ProofNode    ()
-    : clause     (nullptr)
-    , clause_ref (CRef_Undef)
+    : clause_ref (CRef_Undef)
     , pivot      (-1)
     , ant1       (nullptr)
     , ant2       (nullptr)
     , resolvents ()
+    , has_clause (false)
     { }
 
-    ~ProofNode ( )
-    {
-        delete clause;
-    }
-
     //
     // Auxiliary
     //
-    inline void                 resetClause() { delete clause; clause = NULL; }
+    inline void                 resetClause() { std::vector<Lit>().swap(clause); has_clause = false; }
+    // Frees the memory held by the node; the node itself goes back to the arena of the graph
+    void                        release() { resetClause(); std::vector<clauseid_t>().swap(resolvents); }
 
     void setClauseRef(CRef cref)
     {
@@ -134,45 +214,46 @@ struct ProofNode
 
     void                        initClause(Clause& cla)
     {
-        assert(clause == NULL);
-        clause = new std::vector<Lit>(cla.size());
-        for(size_t k = 0; k < cla.size(); ++k) (*clause)[k] = cla[k];
+        assert(not has_clause);
+        clause.assign(cla.begin(), cla.end());
+        has_clause = true;
     }
 
-    void                        initClause(std::vector<Lit>& cla)
+    void                        initClause(std::vector<Lit> const & cla)
     {
-        assert(clause == NULL);
-        clause = new std::vector<Lit>(cla.size());
-        for(size_t k = 0; k < cla.size(); ++k) (*clause)[k] = cla[k];
+        assert(not has_clause);
+        clause.assign(cla.begin(), cla.end());
+        has_clause = true;
     }
 
-    void                        setClause(std::vector<Lit>& cla)
+    void                        setClause(std::vector<Lit> const & cla)
     {
-        assert(clause);
-        clause->resize(cla.size());
-        for(size_t k = 0; k < cla.size(); ++k) (*clause)[k] = cla[k];
+        assert(has_clause);
+        clause.assign(cla.begin(), cla.end());
     }
 
     void initClause()
     {
-        assert(clause == NULL);
-        clause = new std::vector<Lit>;
+        assert(not has_clause);
+        has_clause = true;
     }
 
     //
     // Getty methods
     //
     inline clauseid_t            getId                  ( ) const { return id; }
-    inline std::vector<Lit> &         getClause              ( )       { assert(clause); return *clause; }
-    inline std::vector<Lit> const &   getClause              ( ) const { assert(clause); return *clause; }
-    inline std::vector<Lit> const *   getPClause             ( ) const { return clause; }
-    inline size_t                getClauseSize          ( ) const { return clause->size( ); }
+    inline std::vector<Lit> &         getClause              ( )       { assert(has_clause); return clause; }
+    inline std::vector<Lit> const &   getClause              ( ) const { assert(has_clause); return clause; }
+    inline bool                  hasClause              ( ) const { return has_clause; }
+    inline size_t                getClauseSize          ( ) const { assert(has_clause); return clause.size( ); }
     inline Var                   getPivot               ( ) const { return pivot; }
     inline ProofNode *           getAnt1                ( ) const { return ant1; }
     inline ProofNode *           getAnt2                ( ) const { return ant2; }
     inline clause_type           getType                ( ) const { return type; }
     unsigned                     getNumResolvents       ( ) const { return resolvents.size(); }
-    std::set<clauseid_t>&        getResolvents          ( ) { return resolvents; }
+    // Resolvent ids in increasing order
+    std::vector<clauseid_t> const & getResolvents       ( ) const { return resolvents; }
+    bool                         hasRes                 ( clauseid_t id ) const { return std::binary_search(resolvents.begin(), resolvents.end(), id); }
     //
     // Setty methods
     //
@@ -181,8 +262,16 @@ struct ProofNode
     inline void                  setAnt1                ( ProofNode * a1 )               { ant1 = a1; }
     inline void                  setAnt2                ( ProofNode * a2 )               { ant2 = a2; }
     inline void                  setType                ( clause_type new_type )         { type = new_type; }
-    void                         addRes                 ( clauseid_t id )                { resolvents.insert( id ); }
-    void                         remRes                 ( clauseid_t id )                { resolvents.erase( id ); }
+    void                         addRes                 ( clauseid_t id )
+    {
+        auto it = std::lower_bound(resolvents.begin(), resolvents.end(), id);
+        if (it == resolvents.end() or *it != id) { resolvents.insert(it, id); }
+    }
+    void                         remRes                 ( clauseid_t id )
+    {
+        auto it = std::lower_bound(resolvents.begin(), resolvents.end(), id);
+        if (it != resolvents.end() and *it == id) { resolvents.erase(it); }
+    }
     //
     // Test methods
     //
@@ -198,15 +287,50 @@ struct ProofNode
 
 private:
     clauseid_t         id;                 // id
-    std::vector<Lit>*     clause;             // Clause
+    std::vector<Lit>   clause;             // Clause, sorted
     CRef clause_ref;
     Var                pivot;              // Non-leaf node pivot
     ProofNode *        ant1;               // Edges to antecedents
     ProofNode *        ant2;               // Edges to antecedents
-    std::set<clauseid_t> resolvents;       // Resolvents
+    std::vector<clauseid_t> resolvents;    // Resolvents, sorted
+    bool               has_clause;         // Whether the clause is computed
     clause_type        type;               // Node type
 };
 
+// Storage of the proof nodes in fixed-size chunks.
+// Nodes are never moved, so the antecedent pointers stay valid; removed nodes are reused by the next allocations.
+class ProofNodeArena
+{
+public:
+    ProofNode * allocate()
+    {
+        if (not freeNodes.empty()) {
+            ProofNode * n = freeNodes.back();
+            freeNodes.pop_back();
+            *n = ProofNode();
+            return n;
+        }
+        if (chunks.empty() or usedInLastChunk == chunkSize) {
+            chunks.emplace_back(new ProofNode[chunkSize]);
+            usedInLastChunk = 0;
+        }
+        return &chunks.back()[usedInLastChunk++];
+    }
+
+    // The node must not be reachable from the graph anymore
+    void release(ProofNode * n)
+    {
+        n->release();
+        freeNodes.push_back(n);
+    }
+
+private:
+    static constexpr std::size_t chunkSize = 4096;
+    std::vector<std::unique_ptr<ProofNode[]>> chunks;
+    std::size_t usedInLastChunk = 0;
+    std::vector<ProofNode *> freeNodes;
+};
+
 class ProofGraph
 {
 public:
@@ -225,26 +349,36 @@ public:
 		buildProofGraph(proof);
 }
 
+private:
+    // Graph of the subproof of the region rooted at regionNodes[0], whose nodes are dominated by that root.
+    // The antecedents outside the region become leaves; see reduceRegionsInParallel
+    ProofGraph ( ProofGraph const & parent, std::vector<clauseid_t> const & regionNodes );
+
+public:
 	~ProofGraph()
 	{
 		mpz_clear(visited_1);
 		mpz_clear(visited_2);
-		for(size_t i=0;i<getGraphSize();i++)
-			if(getNode(i)!=NULL) removeNode(i);
 	}
 
     void printProofAsDotty                  ( std::ostream &);
+    // The reduction stops after the traversal in progress once the limits are exhausted, the proof stays valid
+    void setResourceLimits                  ( opensmt::ResourceLimits * limits ) { resourceLimits = limits; }
     //
     // Config
     //
-    inline int     verbose                        ( ) const { return config.verbosity(); }
+    // The graphs of regions are reduced silently and checked as part of the whole proof
+    inline int     verbose                        ( ) const { return isRegion() ? 0 : config.verbosity(); }
     inline int     printProofSMT                  ( ) const { return config.print_proofs_smtlib2; }
     inline int     printProofDotty                ( ) const { return config.print_proofs_dotty; }
     inline double  ratioReductionSolvingTime      ( ) const { return config.proof_ratio_red_solv; }
     inline double  reductionTime                  ( ) const { return config.proof_red_time; }
     inline int     reductionLoops                 ( ) const { return config.proof_red_trans(); }
     inline int     numGraphTraversals             ( ) const { return config.proof_num_graph_traversals(); }
-    inline int     proofCheck                     ( ) const { return config.proof_check(); }
+    inline int     numFillThreads                 ( ) const { return config.proof_fill_threads(); }
+    inline int     numReductionThreads            ( ) const { return config.proof_reduction_threads(); }
+    inline int     proofCheck                     ( ) const { return isRegion() ? 0 : config.proof_check(); }
+    inline bool    resourcesExhausted             ( ) { return resourceLimits and resourceLimits->exhausted(); }
 
 
     bool 		    restructuringForStrongerInterpolant	    ( ) { return ( config.proof_trans_strength == 1); }
@@ -260,7 +394,7 @@ public:
     // Build et al.
     //
     void		   emptyProofGraph				 ();					// Empties all clauses besides leaves
-    void 		   fillProofGraph				 ();					// Explicitly compute all clauses
+    unsigned 	   fillProofGraph				 ();					// Explicitly compute all clauses, level by level; returns the most threads used for a level
     int            cleanProofGraph               ( );                   // Removes proof leftovers
     void           removeNode                    ( clauseid_t );        // Remove node
     unsigned       removeTree                    ( clauseid_t );        // Remove useless subproof
@@ -294,8 +428,8 @@ public:
     std::vector<clauseid_t> topolSortingTopDown() const;
     std::vector<clauseid_t> topolSortingBotUp() const;
 
-    std::set<clauseid_t> const & getLeaves() const { return leaves_ids; };
-    std::set<Var> const & getVariables() const { return proof_variables; }
+    DenseIdSet<clauseid_t> const & getLeaves() const { return leaves_ids; };
+    DenseIdSet<Var> const & getVariables() const { return proof_variables; }
 
     void              printClause           ( ProofNode * );
     void              printClause           ( ProofNode *, std::ostream & );
@@ -318,6 +452,9 @@ public:
     void            proofPostStructuralHashing();
     double          recyclePivotsIter();
     void            recycleUnits();
+    // Reduces the regions of the proof separated by dominators on several threads and merges them back,
+    // then restructures the rest of the proof and redoes structural hashing across regions; returns the number of regions
+    unsigned        reduceRegionsInParallel();
 
     RuleContext     getRuleContext				 (clauseid_t, clauseid_t);
     // In case of A1 rule, return id of node added
@@ -356,6 +493,7 @@ public:
     ApplicationResult handleRuleApplicationForCNFinterpolant(RuleContext & ra1, RuleContext & ra2, std::function<bool(RuleContext &)> allowSwap);
     bool allowSwapRuleForCNFinterpolant(RuleContext& ra, std::function<icolor_t(Var)>);
 
+    std::vector<Lit> const & getAssumedLiterals() const { return assumedLiterals; }
     inline bool isAssumedLiteral(Lit l) const {
         return std::find(assumedLiterals.begin(), assumedLiterals.end(), l) != assumedLiterals.end();
     }
@@ -368,6 +506,7 @@ public:
 private:
     void buildProofGraph(Proof const & proof);
     ProofNode * createProofNodeFor(CRef cref, clause_type _ctype, Proof const & proof); // Helper method for building the proof graph
+    ProofNode * newNode(); // Allocates a node in the arena and appends it to the graph
 
     inline void       addLeaf(clauseid_t id)      {  leaves_ids.insert(id); }
     inline void       removeLeaf(clauseid_t id)   {  leaves_ids.erase(id); }
@@ -378,6 +517,20 @@ private:
     void replaceSubproofsWithNoPartitionTheoryVars(std::vector<Var> const & vars);
 
     void recyclePivotsIter_RecyclePhase();
+    // Moves the resolvents of n to one of its antecedents and removes n, and the other antecedent if it became useless
+    ProofNode * removeResolutionStep(ProofNode * n, bool choose_ant1);
+
+    bool isRegion() const { return not idsInParent.empty(); }
+    // Maximal subtrees of the dominator tree holding at most 1/parts of the nodes, each listed from its root;
+    // regionOf maps the nodes of the graph to the index of their region, or -1
+    std::vector<std::vector<clauseid_t>> findRegions(std::size_t parts, std::vector<int> & regionOf) const;
+    void reduceRegion(bool recyclePivots, bool structuralHashing, bool recyclePivotsFirst);
+    // Replaces the region with its reduced graph; returns the node now deriving the clause of the region root.
+    // replacedBy records the removed region roots, which may be antecedents of the regions spliced later
+    ProofNode * spliceRegion(ProofGraph const & region, std::vector<int> const & regionOf, int regionIndex,
+                             std::unordered_map<clauseid_t, clauseid_t> & replacedBy);
+    // Recomputes the clauses below the given nodes whose clauses became smaller
+    void restructureBelow(std::vector<clauseid_t> const & shrunk);
 
 
     //NOTE added for experimentation
@@ -386,13 +539,16 @@ private:
     SMTConfig &                 config;
     Logic &                     logic_;
     TermMapper const &          termMapper;
+    opensmt::ResourceLimits *   resourceLimits = nullptr;
+    ProofNodeArena              nodes;
     std::vector<ProofNode *>    graph {};
     double                         building_time;               // Time spent building graph
     clauseid_t                     root;                        // Proof root
-    std::set<clauseid_t>		   leaves_ids;					// Proof leaves, for top-down visits
-    std::set< Var >                proof_variables;             // Variables actually present in the proof
+    DenseIdSet<clauseid_t>         leaves_ids;                  // Proof leaves, for top-down visits
+    DenseIdSet<Var>                proof_variables;             // Variables actually present in the proof
     unsigned                       max_id_variable;             // Highest value for a variable
     std::vector<Lit> assumedLiterals;
+    std::vector<clauseid_t>        idsInParent;                 // For the graph of a region, the ids of its nodes in the whole proof
 
 
     // Info on graph dimension
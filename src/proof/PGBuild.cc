@@ -24,6 +24,7 @@ along with Periplo. If not, see <http://www.gnu.org/licenses/>.
 #include "ReportUtils.h"
 
 #include <deque>
+#include <thread>
 
 std::ostream& operator<< (std::ostream &out, RuleContext &ra)
 {
@@ -70,20 +71,23 @@ struct ProofBuildingStatistics {
 };
 }
 
+ProofNode * ProofGraph::newNode() {
+    ProofNode * n = nodes.allocate();
+    auto currId = static_cast<clauseid_t>(graph.size());
+    graph.push_back(n);
+    n->setId(currId);
+    assert(getNode(currId) == n);
+    return n;
+}
+
 ProofNode * ProofGraph::createProofNodeFor(CRef clause, clause_type _ctype, Proof const & proof) {
-    ProofNode * n = new ProofNode();
+    ProofNode * n = newNode();
     if (isLeafClauseType(_ctype)) {
         n->initClause(proof.getClause(clause));
         n->setClauseRef(clause);
         //Sort clause literals
         std::sort(n->getClause().begin(),n->getClause().end());
     }
-
-    //Add node to graph vector
-    auto currId = static_cast<clauseid_t>(graph.size());
-    graph.push_back(n);
-    n->setId(currId);
-    assert(getNode(currId) == n);
     return n;
 }
 
@@ -216,12 +220,8 @@ void ProofGraph::buildProofGraph(const Proof & proof) {
 
                 // End tree not reached: deduced node
                 if (i < chaincla.size() - 1) {
-                    currId = graph.size();
-                    n = new ProofNode();
-                    //Add node to graph vector
-                    n->setId(currId);
-                    graph.push_back(n);
-                    assert(getNode(currId) == n);
+                    n = newNode();
+                    currId = n->getId();
                     n->setType(clause_type::CLA_DERIVED);
                     counters.recordNewClause(clause_type::CLA_DERIVED);
                 } else { // End tree reached: currClause
@@ -290,7 +290,7 @@ void ProofGraph::buildProofGraph(const Proof & proof) {
             if (getNode(i)) {
                 num_non_null++;
 #ifdef PEDANTIC_DEBUG
-                if (getNode(i)->getPClause()) {
+                if (getNode(i)->hasClause()) {
                     cl_non_null++;
                 }
 #endif
@@ -335,11 +335,16 @@ void ProofGraph::buildProofGraph(const Proof & proof) {
     }
 }
 
-void ProofGraph::fillProofGraph() {
+unsigned ProofGraph::fillProofGraph() {
     if (verbose() > 1) {
         uint64_t mem_used = memUsed();
         reportf("; Memory used before filling the proof: %.3f MB\n", mem_used == 0 ? 0 : mem_used / 1048576.0);
     }
+    // Level of a node is the length of the longest path to a leaf;
+    // the clauses of the nodes of one level depend only on lower levels and can be computed concurrently
+    std::vector<unsigned> level(getGraphSize(), 0);
+    std::vector<clauseid_t> inner;
+    unsigned maxLevel = 0;
     std::vector<clauseid_t> q;
     q.push_back(getRoot()->getId());
     do {
@@ -358,18 +363,59 @@ void ProofGraph::fillProofGraph() {
                 assert(n);
                 //Non leaf node
                 if (not n->isLeaf()) {
-                    n->initClause();
-                    mergeClauses(n->getAnt1()->getClause(), n->getAnt2()->getClause(), n->getClause(), n->getPivot());
+                    level[id] = 1 + std::max(level[n->getAnt1()->getId()], level[n->getAnt2()->getId()]);
+                    maxLevel = std::max(maxLevel, level[id]);
+                    inner.push_back(id);
                 }
             }
         } else q.pop_back();
     } while (not q.empty());
     resetVisited1();
 
+    // Bucket the inner nodes by level
+    std::vector<std::size_t> levelStart(maxLevel + 2, 0);
+    for (clauseid_t id : inner) { ++levelStart[level[id] + 1]; }
+    for (unsigned l = 1; l < levelStart.size(); ++l) { levelStart[l] += levelStart[l - 1]; }
+    std::vector<clauseid_t> byLevel(inner.size());
+    {
+        std::vector<std::size_t> next(levelStart.begin(), levelStart.end() - 1);
+        for (clauseid_t id : inner) { byLevel[next[level[id]]++] = id; }
+    }
+
+    auto fillRange = [this, &byLevel](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            ProofNode * n = getNode(byLevel[i]);
+            n->initClause();
+            mergeClauses(n->getAnt1()->getClause(), n->getAnt2()->getClause(), n->getClause(), n->getPivot());
+        }
+    };
+    // Levels too small to be worth spawning threads are filled by this thread
+    constexpr std::size_t minNodesPerThread = 256;
+    std::size_t const threads = static_cast<std::size_t>(std::max(1, numFillThreads()));
+    std::size_t mostWorkers = 1;
+    for (unsigned l = 1; l <= maxLevel; ++l) {
+        std::size_t const begin = levelStart[l];
+        std::size_t const end = levelStart[l + 1];
+        std::size_t const workers = std::min(threads, (end - begin) / minNodesPerThread);
+        if (workers <= 1) {
+            fillRange(begin, end);
+            continue;
+        }
+        mostWorkers = std::max(mostWorkers, workers);
+        std::size_t const chunk = (end - begin + workers - 1) / workers;
+        std::vector<std::thread> pool;
+        for (std::size_t w = 1; w < workers; ++w) {
+            pool.emplace_back(fillRange, begin + w * chunk, std::min(end, begin + (w + 1) * chunk));
+        }
+        fillRange(begin, std::min(end, begin + chunk));
+        for (auto & t : pool) { t.join(); }
+    }
+
     if (verbose() > 0) {
         uint64_t mem_used = memUsed();
         reportf("; Memory used after filling the proof: %.3f MB\n", mem_used == 0 ? 0 : mem_used / 1048576.0);
     }
+    return static_cast<unsigned>(mostWorkers);
 }
 
 void ProofGraph::emptyProofGraph() {
@@ -443,9 +489,9 @@ void ProofGraph::removeNode(clauseid_t vid) {
     }
     n->setAnt1(nullptr);
     n->setAnt2(nullptr);
-    delete n;
     // Remove n from proof
     graph[vid] = nullptr;
+    nodes.release(n);
 }
 
 unsigned ProofGraph::removeTree(clauseid_t vid) {
@@ -456,8 +502,6 @@ unsigned ProofGraph::removeTree(clauseid_t vid) {
     //Go on removing nodes with 0 resolvents
     //Visit graph from root keeping track of edges and nodes
     std::deque<clauseid_t> q;
-    // Better a set than a boolean vector to avoid wasting memory
-    std::set<clauseid_t> visit;
     q.push_back(vid);
     do {
         clauseid_t c = q.front();
@@ -495,11 +539,8 @@ clauseid_t ProofGraph::dupliNode(RuleContext & ra) {
         assert(res->getAnt1() == w or res->getAnt2() == w);
     }
     // Create node and add to graph vector
-    ProofNode * n = new ProofNode();
-    clauseid_t currId = getGraphSize();
-    n->setId(currId);
-    graph.push_back(n);
-    assert(getNode(currId) == n);
+    ProofNode * n = newNode();
+    clauseid_t currId = n->getId();
     n->setType(w->getType());
     n->initClause(w->getClause());
     n->setClauseRef(w->getClauseRef());
@@ -519,7 +560,7 @@ clauseid_t ProofGraph::dupliNode(RuleContext & ra) {
     if (v->getAnt1() == w) v->setAnt1(n);
     else if (v->getAnt2() == w) v->setAnt2(n);
     else throw OsmtInternalException("Error in node duplication");
-    assert(w->getResolvents().find(v_id) == w->getResolvents().end());
+    assert(not w->hasRes(v_id));
     assert(w->getNumResolvents() == num_old_res - 1);
     // Remember to modify context
     ra.cw = currId;
@@ -172,7 +172,7 @@ void ProofGraph::checkClause(clauseid_t nid) {
         }
     }
     // Check that every resolvent has this node as its antecedent
-    std::set<clauseid_t> & resolvents = n->getResolvents();
+    auto const & resolvents = n->getResolvents();
     for (clauseid_t id : resolvents) {
         assert(id < getGraphSize());
         ProofNode * res = getNode(id);
@@ -103,13 +103,15 @@ void ProofGraph::getGraphInfo()
 
 std::vector<clauseid_t> ProofGraph::topolSortingTopDown() const {
     std::vector<clauseid_t> DFS;
-    std::deque<clauseid_t> q;
+    // FIFO queue as a flat array; a node is enqueued at most once per antecedent
+    std::vector<clauseid_t> q;
     DFS.reserve(getGraphSize());
+    q.reserve(2 * getGraphSize());
     // Enqueue leaves first
     q.assign(leaves_ids.begin(),leaves_ids.end());
+    std::size_t head = 0;
     do {
-        clauseid_t id = q.front();
-        q.pop_front();
+        clauseid_t id = q[head++];
         ProofNode * n = getNode(id);
         assert(n);
         if (not isSetVisited1(id)) {
@@ -124,7 +126,7 @@ std::vector<clauseid_t> ProofGraph::topolSortingTopDown() const {
             }
         }
     }
-    while(not q.empty());
+    while(head < q.size());
     resetVisited1();
     return DFS;
 }
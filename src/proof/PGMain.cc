@@ -228,6 +228,7 @@ double ProofGraph::doReduction(double solving_time) {
         std::cerr << "# Each global iteration consists of: " << '\n';
         if (enabledStructuralHashing()) std::cerr << "# StructuralHashing" << '\n';
         if (enabledRecyclePivots()) std::cerr << "# RecyclePivotsWithIntersection" << '\n';
+        if (numReductionThreads() > 1) std::cerr << "# on the regions of the proof, " << numReductionThreads() << " threads" << '\n';
         if (enabledTransfTraversals()) {
             std::cerr << "# ReduceAndExpose ";
             if (ratioReductionSolvingTime() > 0 || reductionTime() > 0)
@@ -242,12 +243,15 @@ double ProofGraph::doReduction(double solving_time) {
     time_init = cpuTime();
     if (enabledPushDownUnits()) recycleUnits();
     for (int k = 1; k <= num_global_reduction_loops; k++) {
+        if (resourcesExhausted()) { break; }
         if (verbose() > 0) std::cerr << "# Global iteration " << k << '\n';
         i_time = cpuTime();
-        if (switchToRPHashing()) {
+        // Without regions to spread over the threads the whole proof is reduced at once
+        bool reducedInRegions = numReductionThreads() > 1 and reduceRegionsInParallel() > 0;
+        if (not reducedInRegions and switchToRPHashing()) {
             if (enabledRecyclePivots()) recyclePivotsIter();
             if (enabledStructuralHashing()) proofPostStructuralHashing();
-        } else {
+        } else if (not reducedInRegions) {
             if (enabledStructuralHashing()) proofPostStructuralHashing();
             if (enabledRecyclePivots()) recyclePivotsIter();
         }
@@ -216,7 +216,7 @@ clauseid_t ProofGraph::applyRuleA1( RuleContext& ra )
     v3->addRes(ra.getW());
 
     //Creation new node y
-    ProofNode* y=new ProofNode();
+    ProofNode* y=newNode();
     y->initClause();
     //y given by resolution v2,v3 over v pivot
     mergeClauses(v2->getClause(),v3->getClause(),y->getClause(),v->getPivot());
@@ -226,9 +226,7 @@ clauseid_t ProofGraph::applyRuleA1( RuleContext& ra )
     y->setAnt2(v3);
     y->setType(clause_type::CLA_DERIVED);
     y->setPivot(v->getPivot());
-    y->setId(graph.size());
     y->addRes(ra.getV());
-    graph.push_back(y);
     v2->addRes(y->getId());
     v3->addRes(y->getId());
     // Return id new node
@@ -449,7 +447,7 @@ void ProofGraph::applyRuleB3( RuleContext& ra )
     w->remRes( ra.getV() );
     v3->remRes( ra.getV() );
     // v2 inherits v children
-    std::set<clauseid_t>& resolvents = v->getResolvents();
+    auto const & resolvents = v->getResolvents();
     for (clauseid_t resolvent_id : resolvents) {
         assert(resolvent_id < getGraphSize());
         ProofNode* res = getNode(resolvent_id);
@@ -24,7 +24,10 @@ along with Periplo. If not, see <http://www.gnu.org/licenses/>.
 #include "OsmtInternalException.h"
 #include "ReportUtils.h"
 
+#include <atomic>
 #include <deque>
+#include <numeric>
+#include <thread>
 #include <unordered_set>
 
 //************************* RECYCLE PIVOTS AND RECYCLE UNITS ***************************
@@ -239,42 +242,12 @@ double ProofGraph::recyclePivotsIter() {
                         choose_ant1 = not piv_in_ant1;
                     }
 
-                    ProofNode * replacing = choose_ant1 ? n->getAnt1() : n->getAnt2();
-                    ProofNode * other = choose_ant1 ? n->getAnt2() : n->getAnt1();
-
-                    bool identicalParents = replacing == other; // MB: This is possible, test_recyclePivots_IdenticalAntecedents is an example.
-
-                    replacing->remRes(id);
-                    if (not identicalParents) {
-                        other->remRes(id);
-                    }
-
-                    auto const & resolvents = n->getResolvents();
-                    for (clauseid_t resId : resolvents) {
-                        assert(resId < getGraphSize());
-                        ProofNode * res = getNode(resId);
-                        assert(res);
-                        if (res->getAnt1() == n) { res->setAnt1(replacing); }
-                        else if (res->getAnt2() == n) { res->setAnt2(replacing); }
-                        else { throw OsmtInternalException("Invalid proof structure " + std::string(__FILE__) + ", " + std::to_string(__LINE__)); }
-                        replacing->addRes(resId);
+                    for (clauseid_t resId : n->getResolvents()) {
                         assert(not isSetVisited2(resId));
                         // Enqueue resolvent
                         q.push_back(resId);
                     }
-
-                    //We might have reached old sink
-                    //Case legal only if we have produced another empty clause
-                    //Substitute old sink with new
-                    if (isRoot(n)) {
-                        assert(not identicalParents);
-                        assert(replacing->getClauseSize() == 0);
-                        setRoot(replacing->getId());
-                        assert(n->getNumResolvents() == 0);
-                        assert(replacing->getNumResolvents() == 0);
-                    }
-                    removeNode(n->getId());
-                    if (not identicalParents and other->getNumResolvents() == 0) { removeTree(other->getId()); }
+                    ProofNode * replacing = removeResolutionStep(n, choose_ant1);
                     // NOTE extra check
                     if (proofCheck() > 1) checkClause(replacing->getId());
                 }
@@ -325,6 +298,44 @@ double ProofGraph::recyclePivotsIter() {
     return (endTime - initTime);
 }
 
+ProofNode * ProofGraph::removeResolutionStep(ProofNode * n, bool choose_ant1) {
+    clauseid_t id = n->getId();
+    ProofNode * replacing = choose_ant1 ? n->getAnt1() : n->getAnt2();
+    ProofNode * other = choose_ant1 ? n->getAnt2() : n->getAnt1();
+
+    bool identicalParents = replacing == other; // MB: This is possible, test_recyclePivots_IdenticalAntecedents is an example.
+
+    replacing->remRes(id);
+    if (not identicalParents) {
+        other->remRes(id);
+    }
+
+    for (clauseid_t resId : n->getResolvents()) {
+        assert(resId < getGraphSize());
+        ProofNode * res = getNode(resId);
+        assert(res);
+        if (res->getAnt1() == n) { res->setAnt1(replacing); }
+        else if (res->getAnt2() == n) { res->setAnt2(replacing); }
+        else { throw OsmtInternalException("Invalid proof structure " + std::string(__FILE__) + ", " + std::to_string(__LINE__)); }
+        replacing->addRes(resId);
+    }
+
+    //We might have reached old sink
+    //Case legal only if we have produced a subset of its clause, empty for the whole proof
+    //Substitute old sink with new
+    if (isRoot(n)) {
+        assert(not identicalParents);
+        assert(std::includes(n->getClause().begin(), n->getClause().end(),
+                             replacing->getClause().begin(), replacing->getClause().end()));
+        setRoot(replacing->getId());
+        assert(n->getNumResolvents() == 0);
+        assert(replacing->getNumResolvents() == 0);
+    }
+    removeNode(id);
+    if (not identicalParents and other->getNumResolvents() == 0) { removeTree(other->getId()); }
+    return replacing;
+}
+
 void ProofGraph::recycleUnits() {
     assert(mpz_cmp_ui(visited_1, 0) == 0 and mpz_cmp_ui(visited_2, 0) == 0);
     if (verbose() > 1) { std::cerr << "# " << "Recycle units begin" << '\n'; }
@@ -490,14 +501,12 @@ void ProofGraph::recycleUnits() {
         } else {
             assert(oldroot->hasOccurrenceBin(var(unit->getClause()[0])) != -1);
             //printClause(unit);
-            ProofNode *newroot = new ProofNode();
+            ProofNode *newroot = newNode();
             newroot->initClause();
             newroot->setAnt1(oldroot);
             newroot->setAnt2(unit);
             newroot->setType(clause_type::CLA_DERIVED);
             newroot->setPivot(var((unit->getClause())[0]));
-            newroot->setId(graph.size());
-            graph.push_back(newroot);
             unit->addRes(newroot->getId());
             oldroot->addRes(newroot->getId());
             //newroot given by resolution of root and unit over v pivot
@@ -564,7 +573,9 @@ void ProofGraph::proofTransformAndRestructure(const double left_time, const int
     // - some transformation is done (in case of pivot reordering)
     while ((max_num_loops == -1 ? true : curr_num_loops < max_num_loops) and
            (left_time == -1 ? true : (cpuTime() - init_time) <= left_time) and
-           (left_time != -1 or max_num_loops != -1 or some_transf_done))
+           (left_time != -1 or max_num_loops != -1 or some_transf_done) and
+           // Only the reduction, which is bounded anyway, may stop early
+           ((left_time == -1 and max_num_loops == -1) or not resourcesExhausted()))
     {
         assert(isResetVisited1() and isResetVisited2());
         // Enqueue leaves first
@@ -889,6 +900,249 @@ void ProofGraph::proofPostStructuralHashing()
 	///////////////////////////////////////////////////////////////////////////////
 }
 
+//************************* REDUCTION OF REGIONS ON SEVERAL THREADS ***************************
+
+ProofGraph::ProofGraph(ProofGraph const & parent, std::vector<clauseid_t> const & regionNodes)
+: config     ( parent.config )
+, logic_     ( parent.logic_ )
+, termMapper ( parent.termMapper )
+, idsInParent( regionNodes )
+{
+    mpz_init(visited_1);
+    mpz_init(visited_2);
+    max_id_variable = parent.max_id_variable;
+    num_nodes = 0;
+    num_edges = 0;
+
+    std::unordered_map<clauseid_t, clauseid_t> localIds;
+    for (clauseid_t id : regionNodes) { localIds.emplace(id, newNode()->getId()); }
+    // Antecedents outside the region become leaves with the same clause
+    auto getLocalNode = [this, &localIds](ProofNode const * original) {
+        auto it = localIds.find(original->getId());
+        if (it != localIds.end()) { return getNode(it->second); }
+        ProofNode * boundary = newNode();
+        boundary->setType(isLeafClauseType(original->getType()) ? original->getType() : clause_type::CLA_ORIG);
+        boundary->initClause(original->getClause());
+        boundary->setClauseRef(original->getClauseRef());
+        addLeaf(boundary->getId());
+        idsInParent.push_back(original->getId());
+        localIds.emplace(original->getId(), boundary->getId());
+        return boundary;
+    };
+    for (clauseid_t i = 0; i < regionNodes.size(); ++i) {
+        ProofNode const * original = parent.getNode(regionNodes[i]);
+        ProofNode * n = getNode(i);
+        n->setType(original->getType());
+        n->initClause(original->getClause());
+        n->setClauseRef(original->getClauseRef());
+        if (original->isLeaf()) {
+            addLeaf(i);
+            continue;
+        }
+        n->setPivot(original->getPivot());
+        ProofNode * ant1 = getLocalNode(original->getAnt1());
+        ProofNode * ant2 = getLocalNode(original->getAnt2());
+        n->setAnt1(ant1);
+        n->setAnt2(ant2);
+        ant1->addRes(i);
+        ant2->addRes(i);
+    }
+    root = 0;
+}
+
+std::vector<std::vector<clauseid_t>> ProofGraph::findRegions(std::size_t parts, std::vector<int> & regionOf) const {
+    // Regions too small for a resolution step to be removed are left to the rest of the proof
+    constexpr std::size_t minRegionSize = 4;
+    // Each node comes after all its resolvents, the root first
+    std::vector<clauseid_t> order = topolSortingBotUp();
+    std::vector<std::size_t> position(getGraphSize());
+    for (std::size_t i = 0; i < order.size(); ++i) { position[order[i]] = i; }
+    // Immediate dominators, on the paths from the root to the leaves
+    std::vector<clauseid_t> idom(getGraphSize(), getRoot()->getId());
+    for (std::size_t i = 1; i < order.size(); ++i) {
+        auto const & resolvents = getNode(order[i])->getResolvents();
+        assert(not resolvents.empty());
+        clauseid_t dom = resolvents[0];
+        for (clauseid_t other : resolvents) {
+            // Walk up the dominator tree to the common dominator
+            while (dom != other) {
+                while (position[dom] > position[other]) { dom = idom[dom]; }
+                while (position[other] > position[dom]) { other = idom[other]; }
+            }
+        }
+        idom[order[i]] = dom;
+    }
+    std::vector<std::size_t> dominated(getGraphSize(), 1);
+    for (std::size_t i = order.size() - 1; i > 0; --i) { dominated[idom[order[i]]] += dominated[order[i]]; }
+
+    std::size_t const maxSize = order.size() / parts;
+    std::vector<std::vector<clauseid_t>> regions;
+    regionOf.assign(getGraphSize(), -1);
+    for (std::size_t i = 1; i < order.size(); ++i) {
+        clauseid_t id = order[i];
+        int region = regionOf[idom[id]];
+        if (region == -1 and dominated[id] >= minRegionSize and dominated[id] <= maxSize) {
+            region = static_cast<int>(regions.size());
+            regions.emplace_back();
+        }
+        if (region != -1) {
+            regionOf[id] = region;
+            regions[region].push_back(id);
+        }
+    }
+    return regions;
+}
+
+void ProofGraph::reduceRegion(bool recyclePivots, bool structuralHashing, bool recyclePivotsFirst) {
+    if (recyclePivotsFirst) {
+        if (recyclePivots) recyclePivotsIter();
+        if (structuralHashing) proofPostStructuralHashing();
+    } else {
+        if (structuralHashing) proofPostStructuralHashing();
+        if (recyclePivots) recyclePivotsIter();
+    }
+    cleanProofGraph();
+}
+
+ProofNode * ProofGraph::spliceRegion(ProofGraph const & region, std::vector<int> const & regionOf, int regionIndex,
+                                     std::unordered_map<clauseid_t, clauseid_t> & replacedBy) {
+    auto const & ids = region.idsInParent;
+    assert(region.getGraphSize() == ids.size());
+    auto inRegion = [&regionOf, regionIndex](clauseid_t id) { return regionOf[id] == regionIndex; };
+    auto getSplicedNode = [this, &ids, &replacedBy](clauseid_t localId) {
+        clauseid_t id = ids[localId];
+        for (auto it = replacedBy.find(id); it != replacedBy.end(); it = replacedBy.find(id)) { id = it->second; }
+        return getNode(id);
+    };
+    // The nodes outside the region keep only their resolvents outside, the reduced region adds its own
+    for (clauseid_t i = 0; i < ids.size(); ++i) {
+        if (inRegion(ids[i])) { continue; }
+        ProofNode * boundary = getSplicedNode(i);
+        std::vector<clauseid_t> inside;
+        for (clauseid_t resId : boundary->getResolvents()) {
+            if (inRegion(resId)) { inside.push_back(resId); }
+        }
+        for (clauseid_t resId : inside) { boundary->remRes(resId); }
+    }
+    for (clauseid_t i = 0; i < ids.size(); ++i) {
+        ProofNode const * reduced = region.getNode(i);
+        if (not reduced) { continue; }
+        ProofNode * n = getSplicedNode(i);
+        if (inRegion(ids[i])) {
+            if (not reduced->isLeaf()) {
+                n->setAnt1(getSplicedNode(reduced->getAnt1()->getId()));
+                n->setAnt2(getSplicedNode(reduced->getAnt2()->getId()));
+                n->setClause(reduced->getClause());
+            }
+            // The root of the region keeps its resolvents, all outside
+            if (i != 0) {
+                std::vector<clauseid_t> old = n->getResolvents();
+                for (clauseid_t resId : old) { n->remRes(resId); }
+            }
+        }
+        for (clauseid_t resId : reduced->getResolvents()) { n->addRes(ids[resId]); }
+    }
+    ProofNode * oldRoot = getNode(ids[0]);
+    ProofNode * derived = getSplicedNode(region.getRoot()->getId());
+    if (derived != oldRoot) {
+        for (clauseid_t resId : oldRoot->getResolvents()) {
+            ProofNode * res = getNode(resId);
+            assert(res);
+            if (res->getAnt1() == oldRoot) { res->setAnt1(derived); }
+            else if (res->getAnt2() == oldRoot) { res->setAnt2(derived); }
+            else { throw OsmtInternalException("Invalid proof structure " + std::string(__FILE__) + ", " + std::to_string(__LINE__)); }
+            derived->addRes(resId);
+        }
+        replacedBy[oldRoot->getId()] = derived->getId();
+    }
+    for (clauseid_t i = 0; i < ids.size(); ++i) {
+        if (not region.getNode(i) and inRegion(ids[i])) { removeNode(ids[i]); }
+    }
+    return derived;
+}
+
+void ProofGraph::restructureBelow(std::vector<clauseid_t> const & shrunk) {
+    DenseIdSet<clauseid_t> changed;
+    for (clauseid_t id : shrunk) { changed.insert(id); }
+    // From leaves to root, so that the antecedents are final when a node is reached
+    for (clauseid_t id : topolSortingTopDown()) {
+        ProofNode * n = getNode(id);
+        if (not n or n->isLeaf()) { continue; }
+        if (not changed.contains(n->getAnt1()->getId()) and not changed.contains(n->getAnt2()->getId())) { continue; }
+        short f1 = n->getAnt1()->hasOccurrenceBin(n->getPivot());
+        short f2 = n->getAnt2()->hasOccurrenceBin(n->getPivot());
+        if (f1 != -1 and f2 != -1) {
+            assert(f1 != f2);
+            std::size_t oldSize = n->getClauseSize();
+            mergeClauses(n->getAnt1()->getClause(), n->getAnt2()->getClause(), n->getClause(), n->getPivot());
+            if (n->getClauseSize() != oldSize) { changed.insert(id); }
+        } else {
+            // Pivot missing from an antecedent, which then replaces n
+            bool choose_ant1 = (f1 == -1 and f2 == -1) ? chooseReplacingAntecedent(n) : f1 == -1;
+            changed.insert(removeResolutionStep(n, choose_ant1)->getId());
+        }
+    }
+}
+
+unsigned ProofGraph::reduceRegionsInParallel() {
+    if (verbose() > 1) { std::cerr << "; Reduction of regions begin" << std::endl; }
+    double initTime = cpuTime();
+    std::size_t const threads = static_cast<std::size_t>(std::max(1, numReductionThreads()));
+    cleanProofGraph();
+    std::vector<int> regionOf;
+    // No region is larger than the share of one thread
+    std::vector<std::vector<clauseid_t>> regions = findRegions(threads, regionOf);
+    if (regions.empty()) { return 0; }
+
+    bool const recyclePivots = enabledRecyclePivots();
+    bool const structuralHashing = enabledStructuralHashing();
+    bool const recyclePivotsFirst = switchToRPHashing();
+    // Largest regions first, each thread takes the next region left
+    std::vector<std::size_t> schedule(regions.size());
+    std::iota(schedule.begin(), schedule.end(), 0);
+    std::stable_sort(schedule.begin(), schedule.end(), [&regions](std::size_t first, std::size_t second) {
+        return regions[first].size() > regions[second].size();
+    });
+    std::vector<std::unique_ptr<ProofGraph>> reduced(regions.size());
+    std::atomic<std::size_t> next{0};
+    auto reduceNext = [&]() {
+        for (std::size_t i = next++; i < schedule.size(); i = next++) {
+            std::size_t r = schedule[i];
+            reduced[r].reset(new ProofGraph(*this, regions[r]));
+            reduced[r]->reduceRegion(recyclePivots, structuralHashing, recyclePivotsFirst);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (std::size_t t = 1; t < std::min(threads, regions.size()); ++t) { pool.emplace_back(reduceNext); }
+    reduceNext();
+    for (auto & t : pool) { t.join(); }
+
+    // Merging: the regions go back in place, then the rest of the proof follows their smaller clauses
+    std::unordered_map<clauseid_t, clauseid_t> replacedBy;
+    std::vector<clauseid_t> shrunk;
+    for (std::size_t r = 0; r < regions.size(); ++r) {
+        clauseid_t oldRoot = regions[r][0];
+        std::size_t oldSize = getNode(oldRoot)->getClauseSize();
+        ProofNode * derived = spliceRegion(*reduced[r], regionOf, static_cast<int>(r), replacedBy);
+        if (derived->getId() != oldRoot or derived->getClauseSize() != oldSize) { shrunk.push_back(derived->getId()); }
+        reduced[r].reset();
+    }
+    restructureBelow(shrunk);
+    if (verbose() > 0) {
+        std::cerr << "; Regions: " << regions.size() << " reduced on " << std::min(threads, regions.size())
+                  << " thread(s)\tTime: " << (cpuTime() - initTime) << " s" << std::endl;
+    }
+    // Structural hashing across regions
+    if (structuralHashing) {
+        proofPostStructuralHashing();
+    } else if (proofCheck()) {
+        unsigned rem = cleanProofGraph();
+        if (rem > 0) std::cerr << "; Cleaned " << rem << " residual nodes" << std::endl;
+        checkProof(true);
+    }
+    return static_cast<unsigned>(regions.size());
+}
+
 
 namespace{
 class LightVars {
@@ -25,197 +25,184 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "Ackermanize.h"
 
-Enode *
-Ackermanize::doit( Enode * formula )
-{
-  assert( config.logic == QF_UFIDL
-       || config.logic == QF_UFLRA );
+#include "Model.h"
+#include "ModelBuilder.h"
+#include "Rewriter.h"
+#include "TreeOps.h"
+
+#include <algorithm>
+
+class Ackermanize::Config : public DefaultRewriterConfig {
+    Ackermanize & ackermanize;
+public:
+    Config(Ackermanize & ackermanize) : ackermanize(ackermanize) {}
+
+    PTRef rewrite(PTRef term) override {
+        SymRef sym = ackermanize.logic.getSymRef(term);
+        auto it = ackermanize.decisions.find(sym);
+        if (it != ackermanize.decisions.end() and it->second == Decision::Eliminate) {
+            return ackermanize.getVarFor(term);
+        }
+        return term;
+    }
+};
 
-  map< Enode *, vector< Enode * > > uf_to_ack_vars;
-  map< Enode *, vector< Enode * > > uf_to_ack_args;
+namespace {
+class ApplicationCounterConfig : public DefaultVisitorConfig {
+    Logic const & logic;
+public:
+    std::unordered_map<SymRef, unsigned, SymRefHash> counts;
 
-  Enode * purified = retrieveAckVarsAndArguments( formula, uf_to_ack_vars, uf_to_ack_args );
-  Enode * result   = generateAckermannExpansion ( purified, uf_to_ack_vars, uf_to_ack_args ); 
+    ApplicationCounterConfig(Logic const & logic) : logic(logic) {}
 
-  return result;
+    void visit(PTRef term) override {
+        SymRef sym = logic.getSymRef(term);
+        if (logic.isUF(sym)) {
+            ++counts[sym];
+        }
+    }
+};
 }
 
-Enode *
-Ackermanize::retrieveAckVarsAndArguments( Enode * formula
-                                        , map< Enode *, vector< Enode * > > & uf_to_ack_vars
-                                        , map< Enode *, vector< Enode * > > & uf_to_ack_args )
-{
-  assert( formula );
-  vector< Enode * > unprocessed_enodes;
-  egraph.initDupMap1( );
-
-  unprocessed_enodes.push_back( formula );
-
-  char def_name[ 256 ];
-  //
-  // Visit the DAG of the formula from the leaves to the root
-  //
-  while( !unprocessed_enodes.empty( ) )
-  {
-    Enode * enode = unprocessed_enodes.back( );
-    // 
-    // Skip if the node has already been processed before
-    //
-    if ( egraph.valDupMap1( enode ) != NULL )
-    {
-      unprocessed_enodes.pop_back( );
-      continue;
+Ackermanize::Ackermanize(Logic & logic, unsigned maxArity, unsigned maxOccurrences)
+    : logic(logic)
+    , maxArity(maxArity)
+    , maxOccurrences(maxOccurrences)
+{ }
+
+bool Ackermanize::isCandidate(SymRef sym) const {
+    Symbol const & symbol = logic.getSym(sym);
+    if (symbol.nargs() > maxArity or logic.getSortRef(sym) == logic.getSort_bool()) {
+        return false;
     }
+    return std::none_of(symbol.begin(), symbol.end(), [this](SRef sort) { return sort == logic.getSort_bool(); });
+}
 
-    bool unprocessed_children = false;
-    Enode * arg_list;
-    for ( arg_list = enode->getCdr( ) ; 
-	  arg_list != egraph.enil ; 
-	  arg_list = arg_list->getCdr( ) )
-    {
-      Enode * arg = arg_list->getCar( );
-
-      assert( arg->isTerm( ) );
-      //
-      // Push only if it is unprocessed
-      //
-      if ( egraph.valDupMap1( arg ) == NULL )
-      {
-	unprocessed_enodes.push_back( arg );
-	unprocessed_children = true;
-      }
+void Ackermanize::decideNewSymbols(PTRef fla) {
+    ApplicationCounterConfig config(logic);
+    TermVisitor<ApplicationCounterConfig>(logic, config).visit(fla);
+    for (auto [sym, count] : config.counts) {
+        if (decisions.find(sym) != decisions.end()) { continue; }
+        decisions[sym] = isCandidate(sym) and count <= maxOccurrences ? Decision::Eliminate : Decision::Keep;
     }
-    //
-    // SKip if unprocessed_children
-    //
-    if ( unprocessed_children )
-      continue;
-
-    unprocessed_enodes.pop_back( );                      
-    Enode * result = NULL;
-    //
-    // At this point, every child has been processed
-    //
-    if ( enode->isUf( ) || enode->isUp( ) )
-    {
-      sprintf( def_name, "%s_app_%d", (enode->getCar( )->getName( )).c_str( )
-	                            , enode->getId( ) );
-      // Check buffer overflow in name
-      assert( (enode->getCar( )->getName( )).length( ) <= 240 );
-      Snode * s = enode->getRetSort( );
-      egraph.newSymbol( def_name, NULL, s );  
-      result = egraph.mkVar( def_name );
-      // Store variable in map for f
-      uf_to_ack_vars[ enode->getCar( ) ].push_back( result );
-      // Retrieve arguments
-      for ( Enode * arg_list = enode->getCdr( ) 
-	  ; !arg_list->isEnil( ) 
-	  ; arg_list = arg_list->getCdr( ) )
-      {
-	Enode * new_arg = egraph.valDupMap1( arg_list->getCar( ) );
-	uf_to_ack_args[ enode->getCar( ) ].push_back( new_arg );
-      }
-      assert( uf_to_ack_args.find( enode->getCar( ) ) != uf_to_ack_args.end( ) );
+}
+
+/*
+ * Releases the eliminated symbols that have more applications than allowed.
+ * Returns true if some symbol has been released.
+ */
+bool Ackermanize::releaseOverfullSymbols() {
+    bool released = false;
+    for (auto it = applications.begin(); it != applications.end();) {
+        auto & [sym, apps] = *it;
+        if (apps.size() <= maxOccurrences) {
+            ++it;
+            continue;
+        }
+        for (auto const & app : apps) {
+            definitions.push(logic.mkEq(app.var, app.term));
+        }
+        decisions[sym] = Decision::Released;
+        it = applications.erase(it);
+        released = true;
     }
-    else
-    {
-      result = egraph.copyEnodeEtypeTermWithCache( enode );
+    return released;
+}
+
+PTRef Ackermanize::getVarFor(PTRef application) {
+    auto it = applicationToVar.find(application);
+    if (it != applicationToVar.end()) {
+        return it->second;
     }
+    auto name = prefix + std::to_string(application.x);
+    PTRef var = logic.mkVar(logic.getSortRef(application), name.c_str());
+    applicationToVar.insert({application, var});
+    applications[logic.getSymRef(application)].push_back({application, var});
+    return var;
+}
 
-    assert( result );
-    assert( egraph.valDupMap1( enode ) == NULL );
-    egraph.storeDupMap1( enode, result );
-  }
+PTRef Ackermanize::abstract(PTRef fla) {
+    Config config(*this);
+    return Rewriter<Config>(logic, config).rewrite(fla);
+}
 
-  Enode * new_formula = egraph.valDupMap1( formula );
-  assert( new_formula );
-  egraph.doneDupMap1( );
+PTRef Ackermanize::mkConsistencyConstraint(Application const & first, Application const & second) const {
+    vec<PTRef> firstArgs;
+    vec<PTRef> secondArgs;
+    for (PTRef arg : logic.getPterm(first.term)) { firstArgs.push(arg); }
+    for (PTRef arg : logic.getPterm(second.term)) { secondArgs.push(arg); }
+    vec<PTRef> literals;
+    for (int i = 0; i < firstArgs.size(); ++i) {
+        PTRef eq = logic.mkEq(firstArgs[i], secondArgs[i]);
+        if (eq == logic.getTerm_false()) { return logic.getTerm_true(); }
+        if (eq == logic.getTerm_true()) { continue; }
+        literals.push(logic.mkNot(eq));
+    }
+    literals.push(logic.mkEq(first.var, second.var));
+    return logic.mkOr(std::move(literals));
+}
 
-  return new_formula;
+/*
+ * Returns the record of the frame, started from what the frames below it have emitted.  The records of the frames
+ * popped since the last call are dropped, so that what they emitted is emitted again.
+ */
+Ackermanize::Emitted & Ackermanize::emittedUpTo(std::size_t level, uint32_t frameId) {
+    while (not emitted.empty() and (emitted.back().level > level
+                                    or (emitted.back().level == level and emitted.back().frameId != frameId))) {
+        emitted.pop_back();
+    }
+    if (emitted.empty() or emitted.back().level < level) {
+        Emitted below = emitted.empty() ? Emitted{level, frameId, 0, {}} : emitted.back();
+        below.level = level;
+        below.frameId = frameId;
+        emitted.push_back(std::move(below));
+    }
+    return emitted.back();
 }
 
-Enode * 
-Ackermanize::generateAckermannExpansion( Enode * formula
-                                       , map< Enode *, vector< Enode * > > & uf_to_ack_vars
-                                       , map< Enode *, vector< Enode * > > & uf_to_ack_args )
-{
-  list< Enode * > new_axioms_list;
-  //
-  // For each functional symbol
-  //
-  for ( map< Enode *, vector< Enode * > >::iterator it = uf_to_ack_vars.begin( )
-      ; it != uf_to_ack_vars.end( )
-      ; it ++ )
-  {
-    assert( uf_to_ack_args.find( it->first ) != uf_to_ack_args.end( ) );
-    vector< Enode * > & args = uf_to_ack_args[ it->first ];
-
-    Enode * s = it->first;
-    const int arity = s->getArity( );
-    vector< Enode * > & vars = it->second;
-    //
-    // For each ack variable
-    //
-    for ( unsigned i = 0 ; i < vars.size( ) - 1 ; i ++ )
-    {
-      const int index_i = arity * i;
-      for ( unsigned j = i + 1 ; j < vars.size( ) ; j ++ )
-      {
-	const int index_j = arity * j;
-	//
-	// Construct (ai_1 = aj_1 /\ ai_2 = aj_2 /\ ... /\ ai_n = aj_n) --> var_i = var_j
-	// equiv to  (ai_1 != aj_1 \/ ai_2 != aj_2 \/ ... \/ ai_n != aj_n \/ var_i = var_j)
-	//
-	// equiv to  (ai_1 < aj_1 \/ ai_1 > aj_1 \/ ... \/ var_i <= var_j)
-	// equiv to  (ai_1 < aj_1 \/ ai_1 > aj_1 \/ ... \/ var_i => var_j)
-	//
-	list< Enode * > axiom;
-
-	for ( int k = 0 ; k < arity ; k ++ )
-	{
-	  Enode * ai_k = args[ index_i + k ];
-	  Enode * aj_k = args[ index_j + k ];
-	  // Generate ai_1 < aj_1
-	  Enode * lt = egraph.mkLt( egraph.cons( ai_k, egraph.cons( aj_k ) ) );
-	  Enode * gt = egraph.mkGt( egraph.cons( ai_k, egraph.cons( aj_k ) ) );
-	  axiom.push_back( lt );
-	  axiom.push_back( gt );
-	}
-	//
-	// Construct 
-	// var_i <= var_j and var_i >= var_j
-	// or for the boolean case
-	// var_i -> var_j and var_i <- var_j
-	//
-	Enode * le = NULL; 
-	Enode * ge = NULL; 
-	const bool is_bool = vars[ i ]->hasSortBool( );
-	if ( is_bool )
-	{
-	  le = egraph.mkOr( egraph.cons( egraph.mkNot( egraph.cons( vars[ i ] ) )
-			  , egraph.cons( vars[ j ] ) ) );
-	  ge = egraph.mkOr( egraph.cons( egraph.mkNot( egraph.cons( vars[ j ] ) )
-		          , egraph.cons( vars[ i ] ) ) );
-	}
-	else
-	{
-	  le = egraph.mkLeq( egraph.cons( vars[ i ]
-	                   , egraph.cons( vars[ j ] ) ) );
-	  ge = egraph.mkGeq( egraph.cons( vars[ i ]
-	                   , egraph.cons( vars[ j ] ) ) );
-	}
-	axiom.push_back( le );
-	Enode * axiom_1 = egraph.mkOr( egraph.cons( axiom ) );
-	axiom.pop_back( );
-	axiom.push_back( ge );
-	Enode * axiom_2 = egraph.mkOr( egraph.cons( axiom ) );
-	new_axioms_list.push_back( axiom_1 );
-	new_axioms_list.push_back( axiom_2 );
-      }
+PTRef Ackermanize::rewrite(PTRef fla, std::size_t level, uint32_t frameId) {
+    decideNewSymbols(fla);
+    PTRef res = abstract(fla);
+    // Releasing a symbol changes the arguments of the applications above it, so abstract again until stable
+    while (releaseOverfullSymbols()) {
+        res = abstract(fla);
+    }
+    Emitted & done = emittedUpTo(level, frameId);
+    vec<PTRef> conjuncts;
+    conjuncts.push(res);
+    for (int i = done.definitions; i < definitions.size(); ++i) {
+        conjuncts.push(definitions[i]);
     }
-  }
+    done.definitions = definitions.size();
+    for (auto const & [sym, apps] : applications) {
+        std::size_t & constrained = done.applications[sym];
+        // Only the pairs with a new application
+        for (std::size_t j = constrained; j < apps.size(); ++j) {
+            for (std::size_t i = 0; i < j; ++i) {
+                conjuncts.push(mkConsistencyConstraint(apps[i], apps[j]));
+            }
+        }
+        constrained = apps.size();
+    }
+    return logic.mkAnd(std::move(conjuncts));
+}
 
-  new_axioms_list.push_back( formula );
-  Enode * result = egraph.mkAnd( egraph.cons( new_axioms_list ) );
-  return result;
+bool Ackermanize::hasEliminatedFunctions() const {
+    return not applications.empty();
+}
+
+void Ackermanize::fillEliminatedFunctions(ModelBuilder & builder, Model & model) const {
+    for (auto const & [sym, apps] : applications) {
+        for (auto const & app : apps) {
+            vec<PTRef> values;
+            for (PTRef arg : logic.getPterm(app.term)) {
+                values.push(arg);
+            }
+            // Evaluation may create new terms, so the arguments are first copied out of the term
+            for (PTRef & value : values) {
+                value = model.evaluate(value);
+            }
+            builder.addToTheoryFunction(sym, values, model.evaluate(app.var));
+        }
+    }
 }
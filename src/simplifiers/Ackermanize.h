@@ -26,30 +26,86 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #ifndef ACKERMANIZE_H
 #define ACKERMANIZE_H
 
-#include "Global.h"
-#include "Otl.h"
-#include "Egraph.h"
+#include "Logic.h"
 
-class Ackermanize
-{
+#include <unordered_map>
+#include <vector>
+
+class Model;
+class ModelBuilder;
+
+/**
+ * Eager Ackermannization of uninterpreted functions.
+ *
+ * Every application of an eliminated function symbol is replaced by a fresh variable, and for every two applications
+ * f(a_1,...,a_n) and f(b_1,...,b_n), replaced by v and w, the constraint (a_1 = b_1 and ... and a_n = b_n) => v = w
+ * is conjoined to the formula.
+ *
+ * A symbol is eliminated if it has at most maxArity arguments, its arguments and its result are not Boolean, and it
+ * has at most maxOccurrences distinct applications.  The decision is taken the first time the symbol is seen.
+ * If a later formula pushes an eliminated symbol over the occurrence limit, the symbol is released: its fresh
+ * variables are defined by the corresponding applications and the symbol is left to the congruence closure.
+ *
+ * The formulas are rewritten frame by frame.  A rewritten formula carries only the definitions and the constraints
+ * that have not been emitted in its frame or in the frames below it, so the constraints between the applications of
+ * the earlier formulas are not repeated.  Those emitted in a frame that has since been popped are emitted again.
+ */
+class Ackermanize {
 public:
+    Ackermanize(Logic & logic, unsigned maxArity, unsigned maxOccurrences);
 
-  Ackermanize( Egraph & egraph_, SMTConfig & config_ )
-   : egraph  ( egraph_ )
-   , config  ( config_ )
-  { }
+    /**
+     * Ackermannizes a formula of a frame.
+     * @param level the level of the frame in the stack of frames
+     * @param frameId the identifier of the frame, telling a frame apart from the frames popped from the same level
+     */
+    PTRef rewrite(PTRef fla, std::size_t level = 0, uint32_t frameId = 0);
 
-  virtual ~Ackermanize( ) { }
+    bool hasEliminatedFunctions() const;
 
-  Enode * doit ( Enode * ); // Main routine
+    /**
+     * Adds to the builder the interpretation of the eliminated symbols.
+     * @param model a model of the Ackermannized formula, used to evaluate the arguments and the fresh variables
+     */
+    void fillEliminatedFunctions(ModelBuilder & builder, Model & model) const;
 
 private:
+    class Config;
+
+    enum class Decision : char { Eliminate, Keep, Released };
+
+    struct Application {
+        PTRef term; // The application after replacing the eliminated applications in its arguments
+        PTRef var;  // The fresh variable standing for the application
+    };
+
+    // What has been emitted up to a frame
+    struct Emitted {
+        std::size_t level;
+        uint32_t frameId;
+        int definitions; // The number of definitions
+        std::unordered_map<SymRef, std::size_t, SymRefHash> applications; // The applications constrained pairwise
+    };
+
+    static constexpr const char * prefix = ".ack_";
+
+    Logic & logic;
+    unsigned const maxArity;
+    unsigned const maxOccurrences;
+
+    std::unordered_map<SymRef, Decision, SymRefHash> decisions;
+    std::unordered_map<SymRef, std::vector<Application>, SymRefHash> applications;
+    std::unordered_map<PTRef, PTRef, PTRefHash> applicationToVar;
+    vec<PTRef> definitions; // Definitions of the fresh variables of released symbols
+    std::vector<Emitted> emitted; // By increasing level
 
-  Enode * retrieveAckVarsAndArguments( Enode *, map< Enode *, vector< Enode * > > &, map< Enode *, vector< Enode * > > & );
-  Enode * generateAckermannExpansion ( Enode *, map< Enode *, vector< Enode * > > &, map< Enode *, vector< Enode * > > & );
-  
-  Egraph &    egraph;       // Reference to Egraph
-  SMTConfig & config;       // Reference to Config
+    bool isCandidate(SymRef sym) const;
+    void decideNewSymbols(PTRef fla);
+    bool releaseOverfullSymbols();
+    PTRef abstract(PTRef fla);
+    PTRef getVarFor(PTRef application);
+    PTRef mkConsistencyConstraint(Application const & first, Application const & second) const;
+    Emitted & emittedUpTo(std::size_t level, uint32_t frameId);
 };
 
 #endif
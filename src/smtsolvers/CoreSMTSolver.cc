@@ -72,6 +72,10 @@ namespace opensmt {
 CoreSMTSolver::CoreSMTSolver(SMTConfig & c, THandler& t )
     : config           (c)
     , theory_handler   (t)
+    , phaseTimer       (c.getPhaseTimer())
+    , searchPhase      (phaseTimer.getPhase("search"))
+    , propagatePhase   (phaseTimer.getPhase("propagate"))
+    , analyzePhase     (phaseTimer.getPhase("analyze"))
     , verbosity        (c.verbosity())
     , init             (false)
     , stop             (false)
@@ -538,6 +542,20 @@ Var CoreSMTSolver::doActivityDecision() {
     return next;
 }
 
+vec<Lit> CoreSMTSolver::getActiveLits(vec<Var> const & candidates, int n) const {
+    std::vector<Var> vars;
+    for (Var v : candidates) {
+        if (v < nVars() and value(v) == l_Undef and decision[v]) { vars.push_back(v); }
+    }
+    auto const mid = vars.begin() + std::min<std::size_t>(n, vars.size());
+    std::partial_sort(vars.begin(), mid, vars.end(), [this](Var x, Var y) { return activity[x] > activity[y]; });
+    vec<Lit> lits;
+    for (auto it = vars.begin(); it != mid; ++it) {
+        lits.push(mkLit(*it, savedPolarity[*it] == flipState));
+    }
+    return lits;
+}
+
 Lit CoreSMTSolver::choosePolarity(Var next) {
     assert(next != var_Undef);
     bool sign = false;
@@ -594,6 +612,7 @@ Lit CoreSMTSolver::pickBranchLit()
 
 void CoreSMTSolver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
 {
+    opensmt::PhaseTimer::Scope scope(phaseTimer, analyzePhase, opensmt::PhaseTimer::Detail::Fine);
     bool logsProofForInterpolation = this->logsProofForInterpolation();
     assert(!logsProofForInterpolation || !proof->hasOpenChain());
     assert(confl != CRef_Undef);
@@ -972,6 +991,9 @@ void CoreSMTSolver::analyzeFinal(Lit p, vec<Lit>& out_conflict)
                         CRef assumptionUnitClause = proof->getUnitForAssumptionLiteral(trail[i]);
                         proof->addResolutionStep(assumptionUnitClause, x);
                     }
+                } else if (level(x) > 0 and user_assumptions.has(x)) {
+                    assert(not logsProofForInterpolation());
+                    out_conflict.push(~trail[i]);
                 }
             }
             else
@@ -1041,6 +1063,7 @@ void CoreSMTSolver::uncheckedEnqueue(Lit p, CRef from)
   |________________________________________________________________________________________________@*/
 CRef CoreSMTSolver::propagate()
 {
+    opensmt::PhaseTimer::Scope scope(phaseTimer, propagatePhase, opensmt::PhaseTimer::Detail::Fine);
     CRef    confl     = CRef_Undef;
     int     num_props = 0;
     watches.cleanAll();
@@ -1453,6 +1476,7 @@ lbool CoreSMTSolver::search(int nof_conflicts)
             }
             learnt_clause.clear();
             analyze(confl, learnt_clause, backtrack_level);
+            learnt_sizes.add(learnt_clause.size());
 
             cancelUntil(backtrack_level);
 
@@ -1471,7 +1495,9 @@ lbool CoreSMTSolver::search(int nof_conflicts)
                 learnts_size += learnt_clause.size( );
                 all_learnts ++;
 
-                CRef cr = ca.alloc(learnt_clause, {true, computeGlue(learnt_clause)});
+                uint32_t glue = computeGlue(learnt_clause);
+                learnt_glues.add(glue);
+                CRef cr = ca.alloc(learnt_clause, {true, glue});
 
                 if (logsProofForInterpolation()) {
                     proof->endChain(cr);
@@ -1532,7 +1558,7 @@ lbool CoreSMTSolver::search(int nof_conflicts)
                     analyzeFinal(~p, conflict);
                     int max = 0;
                     for (Lit q : conflict) {
-                        if (!sign(q)) {
+                        if (!sign(q) and assumptions_order.has(var(q))) {
                             max = assumptions_order[var(q)] > max ? assumptions_order[var(q)] : max;
                         }
                     }
@@ -1580,9 +1606,14 @@ lbool CoreSMTSolver::search(int nof_conflicts)
                     next = pickBranchLit();
                 }
 
-                if (next == lit_Undef)
-                    // Model found:
+                if (next == lit_Undef) {
+                    // Model found, unless a theory check gave up on the exhausted resources
+                    if (resourceLimits and resourceLimits->exhausted()) {
+                        cancelUntil(0);
+                        return l_Undef;
+                    }
                     return l_True;
+                }
             }
 
             assert(value(next) == l_Undef);
@@ -1705,10 +1736,11 @@ lbool CoreSMTSolver::solve_()
     double next_printout = restart_first;
 
     // Search:
+    opensmt::PhaseTimer::Scope searchScope(phaseTimer, searchPhase);
 
     if (config.dryrun())
         stop = true;
-    while (status == l_Undef && okContinue() && !this->stop) {
+    while (status == l_Undef && okContinue() && !this->stop && withinBudget()) {
         // Print some information. At every restart for
         // standard mode or any 2^n intervarls for luby
         // restarts
@@ -1738,7 +1770,7 @@ lbool CoreSMTSolver::solve_()
             model[i] = value(i);
         }
     } else {
-        assert(not okContinue() || status == l_False || this->stop);
+        assert(not okContinue() || status == l_False || this->stop || not withinBudget());
     }
 
     // We terminate
@@ -1828,6 +1860,15 @@ void CoreSMTSolver::setAssumptions(vec<Lit> const & assumps) {
     }
 }
 
+void CoreSMTSolver::setUserAssumptions(vec<Lit> const & lits) {
+    user_assumptions.clear();
+    for (int i = 0; i < lits.size(); i++) {
+        if (not user_assumptions.has(var(lits[i]))) {
+            user_assumptions.insert(var(lits[i]), i);
+        }
+    }
+}
+
 int CoreSMTSolver::restartNextLimit ( int nof_conflicts )
 {
     // Luby's restart
@@ -1879,6 +1920,21 @@ void CoreSMTSolver::printStatistics( ostream & os )
 }
 #endif // STATISTICS
 
+void CoreSMTSolver::collectStatistics(opensmt::Statistics & stats) const {
+    stats.addCounter("sat.solves", solves);
+    stats.addCounter("sat.restarts", starts);
+    stats.addCounter("sat.decisions", decisions);
+    stats.addCounter("sat.random-decisions", rnd_decisions);
+    stats.addCounter("sat.propagations", propagations);
+    stats.addCounter("sat.conflicts", conflicts);
+    stats.addCounter("sat.theory-conflicts", learnt_theory_conflicts);
+    stats.addCounter("sat.clauses", clauses.size());
+    stats.addCounter("sat.learnts", learnts.size());
+    stats.addCounter("sat.vars", nVars());
+    stats.addHistogram("sat.learnt-size", learnt_sizes);
+    stats.addHistogram("sat.learnt-glue", learnt_glues);
+}
+
 std::ostream& operator <<(std::ostream& out, Lit l) {
     out << (sign(l) ? "-" : "") << var(l);
     return out;
@@ -48,6 +48,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 #include "THandler.h"
 
+#include <atomic>
 #include <cstdio>
 #include <iosfwd>
 #include <memory>
@@ -62,6 +63,8 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "SolverTypes.h"
 
 #include "Timer.h"
+#include "ResourceLimits.h"
+#include "Statistics.h"
 
 class Proof;
 class ModelBuilder;
@@ -85,12 +88,18 @@ class CoreSMTSolver
 protected:
     SMTConfig & config;         // Stores Config
     THandler  & theory_handler; // Handles theory
+    opensmt::PhaseTimer & phaseTimer;
+    opensmt::PhaseTimer::PhaseId const searchPhase;
+    opensmt::PhaseTimer::PhaseId const propagatePhase;
+    opensmt::PhaseTimer::PhaseId const analyzePhase;
     bool      verbosity;
     bool      init;
     enum class ConsistencyAction { BacktrackToZero, ReturnUndef, SkipToSearchBegin, NoOp };
     int search_counter;
 public:
-    bool stop = false;
+    std::atomic<bool> stop = false; // May be set from another thread to end the search at the next restart
+    // May be set from another thread to end the search once the solver has had this many conflicts
+    std::atomic<uint64_t> stopAtConflicts = UINT64_MAX;
 
     // Constructor/Destructor:
     //
@@ -161,6 +170,7 @@ public:
     void    budgetOff();
     void    interrupt();          // Trigger a (potentially asynchronous) interruption of the solver.
     void    clearInterrupt();     // Clear interrupt indicator flag.
+    void    setResourceLimits(opensmt::ResourceLimits * limits) { resourceLimits = limits; } // Polled with the budget
 
     // Memory management:
     //
@@ -176,6 +186,11 @@ public:
     inline void restoreOK          ( )       { ok = true; conflict_frame = 0; }
     inline bool isOK               ( ) const { return ok; } // FALSE means solver is in a conflicting state
     inline int  getConflictFrame   ( ) const { assert(not isOK()); return conflict_frame; }
+    // Literals assumed in the next solve call besides the frame literals; the final conflict is expressed in them too
+    void        setUserAssumptions ( vec<Lit> const & lits );
+    inline bool isUserAssumption   ( Var v ) const { return user_assumptions.has(v); }
+    // Up to n unassigned decision variables of the candidates, the most active first, in their saved polarity
+    vec<Lit>    getActiveLits      ( vec<Var> const & candidates, int n ) const;
 
     template<class C>
     void     printSMTClause   (std::ostream &, const C& );
@@ -223,6 +238,11 @@ public:
     uint64_t all_learnts;
     uint64_t learnt_theory_conflicts;
     uint64_t top_level_lits;
+    opensmt::Histogram learnt_sizes;   // The sizes of the clauses learnt from the conflicts of the search
+    opensmt::Histogram learnt_glues;   // Their glue, for the clauses of at least two literals
+
+    // Adds the statistics of the search under sat.*
+    virtual void collectStatistics(opensmt::Statistics & stats) const;
 
 
 protected:
@@ -337,6 +357,7 @@ protected:
     int64_t             simpDB_props;     // Remaining number of propagations that must be made before next execution of 'simplify()'.
     vec<Lit>            assumptions;      // Current set of assumptions provided to solve by the user.
     Map<Var,int, VarHash> assumptions_order; // Defined for active assumption variables: how manyeth active assumption variable this is in assumptions
+    Map<Var,int, VarHash> user_assumptions; // Defined for the variables of the user assumptions: the index of the (first) assumption
     Heap<VarOrderLt>    order_heap;       // A priority queue of variables ordered with respect to the variable activity.
     double              random_seed;      // Used by the random variable selection.
     double              progress_estimate;// Set by 'search()'.
@@ -360,7 +381,8 @@ protected:
     //
     int64_t             conflict_budget;    // -1 means no budget.
     int64_t             propagation_budget; // -1 means no budget.
-    bool                asynch_interrupt;
+    std::atomic<bool>   asynch_interrupt;
+    opensmt::ResourceLimits * resourceLimits = nullptr;
 
     // Main internal methods:
     //
@@ -427,7 +449,7 @@ protected:
 
     int      level            (Var x) const;
     double   progressEstimate ()      const; // DELETE THIS ?? IT'S NOT VERY USEFUL ...
-    bool     withinBudget     ()      const;
+    bool     withinBudget     ()      ;
 
 
     void     printSMTLit              (std::ostream &, const Lit);
@@ -727,11 +749,13 @@ inline void     CoreSMTSolver::setPropBudget(int64_t x)                   { prop
 inline void     CoreSMTSolver::interrupt()                                { asynch_interrupt = true; }
 inline void     CoreSMTSolver::clearInterrupt()                           { asynch_interrupt = false; }
 inline void     CoreSMTSolver::budgetOff()                                { conflict_budget = propagation_budget = -1; }
-inline bool     CoreSMTSolver::withinBudget() const
+inline bool     CoreSMTSolver::withinBudget()
 {
     return !asynch_interrupt &&
+           conflicts < stopAtConflicts.load(std::memory_order_relaxed) &&
            (conflict_budget    < 0 || conflicts < (uint64_t)conflict_budget) &&
-           (propagation_budget < 0 || propagations < (uint64_t)propagation_budget);
+           (propagation_budget < 0 || propagations < (uint64_t)propagation_budget) &&
+           (not resourceLimits || not resourceLimits->exhausted());
 }
 
 /**
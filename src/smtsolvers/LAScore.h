@@ -68,6 +68,17 @@ public:
         }
     }
 
+    // A literal assigned after it was inserted is no longer a candidate; its slot is the first to be reused
+    void evictAssigned() {
+        for (int i = 0; i < size; i++) {
+            if (buf[i].second != lit_Undef && value(buf[i].second) != l_Undef) {
+                buf[i] = EVLitPair{EV(), lit_Undef};
+                heur_worst = buf[i].first;
+                heur_worst_loc = i;
+            }
+        }
+    }
+
     Lit getLit(int i) {
         assert(i < size);
         assert(i >= 0);
@@ -123,6 +134,7 @@ public:
     virtual void updateLABest(Var v) =  0;
     virtual void newVar() = 0;
     virtual Lit  getBest() = 0;
+    virtual void evictAssigned() = 0; // Called when literals get assigned during the round
     virtual void setChecked(Var v) = 0;
     virtual bool isAlreadyChecked(Var v) const = 0;
     virtual bool safeToSkip(Var v, Lit cmp) const = 0; // Given that the heuristic value of cmp is known, is it safe to skip checking value of v
@@ -180,6 +192,7 @@ public:
     void updateLABest(Var v) override;
     void newVar() override;
     Lit  getBest() override;
+    void evictAssigned() override { buf_LABests.evictAssigned(); }
     void setChecked(Var v) override;
     bool isAlreadyChecked(Var v) const override;
     bool safeToSkip(Var v, Lit cmp) const override; // Given that the heuristic value of cmp is known, is it safe to skip checking value of v
@@ -308,6 +321,8 @@ public:
 
     Lit getBest() override;
 
+    void evictAssigned() override { buf_LABests.evictAssigned(); }
+
     void setChecked(Var v) override;
 
     bool isAlreadyChecked(Var v) const override;
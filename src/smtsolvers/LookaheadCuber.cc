@@ -0,0 +1,56 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "LookaheadCuber.h"
+
+#include <algorithm>
+
+namespace {
+int log2Ceil(int n) {
+    int r = 0;
+    while ((1 << r) < n) { ++r; }
+    return r;
+}
+}
+
+LookaheadSMTSolver::LALoopRes LookaheadCuber::solveLookahead() {
+    cubes.clear();
+    auto [result, root] = buildAndTraverse<LACubeNode, CubeBuildConfig>(CubeBuildConfig{*this});
+    if (result == LALoopRes::unknown_final) {
+        collectCubes(*root);
+    }
+    return result;
+}
+
+bool LookaheadCuber::CubeBuildConfig::stopCondition(LACubeNode & n, int splitNum) {
+    if (cuber.pathDecisions(n).size() < log2Ceil(splitNum)) { return false; }
+    n.isLeaf = true;
+    return true;
+}
+
+// The literals on the path from the root to n, except for the assumptions
+vec<Lit> LookaheadCuber::pathDecisions(LANode const & n) const {
+    vec<Lit> decisions;
+    for (LANode const * curr = &n; curr->p != curr; curr = curr->p) {
+        if (std::find(assumptions.begin(), assumptions.end(), curr->l) == assumptions.end()) {
+            decisions.push(curr->l);
+        }
+    }
+    return decisions;
+}
+
+// The refuted subtrees have been removed from the final tree, its leaves are the cubes
+void LookaheadCuber::collectCubes(LACubeNode const & root) {
+    vec<LACubeNode const *> queue;
+    queue.push(&root);
+    while (queue.size() > 0) {
+        LACubeNode const * n = queue.last();
+        queue.pop();
+        if (n->isLeaf) {
+            cubes.push_back(pathDecisions(*n));
+        }
+        if (n->c1 != nullptr) { queue.push(n->getC1()); }
+        if (n->c2 != nullptr) { queue.push(n->getC2()); }
+    }
+}
@@ -0,0 +1,50 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef OPENSMT_LOOKAHEADCUBER_H
+#define OPENSMT_LOOKAHEADCUBER_H
+
+#include "LookaheadSMTSolver.h"
+
+#include <vector>
+
+/**
+ * Lookahead solver that stops the lookahead tree at the depth giving sat_split_num() leaves and returns the decisions
+ * on the paths to the leaves that were not refuted as cubes.  The assumptions, including the frame activation
+ * literals, are neither counted in the depth nor part of the cubes.
+ *
+ * The query is undecided exactly if the solver returns l_Undef, and then every model of the formula satisfies one of
+ * the cubes.
+ */
+class LookaheadCuber : public LookaheadSMTSolver {
+public:
+    LookaheadCuber(SMTConfig & config, THandler & thandler) : LookaheadSMTSolver(config, thandler) {}
+
+    std::vector<vec<Lit>> const & getCubes() const { return cubes; }
+
+protected:
+    LALoopRes solveLookahead() override;
+
+private:
+    class LACubeNode : public LookaheadSMTSolver::LANode {
+    public:
+        bool isLeaf = false;
+        LACubeNode * getParent() override { return static_cast<LACubeNode *>(p); }
+        LACubeNode const * getC1() const { return static_cast<LACubeNode const *>(c1.get()); }
+        LACubeNode const * getC2() const { return static_cast<LACubeNode const *>(c2.get()); }
+    };
+
+    struct CubeBuildConfig {
+        LookaheadCuber & cuber;
+        bool stopCondition(LACubeNode & n, int splitNum);
+        LALoopRes exitState() const { return LALoopRes::unknown_final; }
+    };
+
+    std::vector<vec<Lit>> cubes;
+
+    vec<Lit> pathDecisions(LANode const & n) const;
+    void collectCubes(LACubeNode const & root);
+};
+
+#endif //OPENSMT_LOOKAHEADCUBER_H
@@ -13,9 +13,19 @@ LookaheadSMTSolver::LookaheadSMTSolver(SMTConfig & c, THandler & thandler)
 Var LookaheadSMTSolver::newVar(bool dvar) {
     Var v = SimpSMTSolver::newVar(dvar);
     score->newVar();
+    for (int i = 0; i < 2; ++i) {
+        probeCache.push();
+        impliedIn.push(-1);
+    }
     return v;
 }
 
+void LookaheadSMTSolver::collectStatistics(opensmt::Statistics & stats) const {
+    SimpSMTSolver::collectStatistics(stats);
+    stats.addCounter("sat.lookahead-probes", probes);
+    stats.addCounter("sat.lookahead-reused-probes", reusedProbes);
+}
+
 lbool LookaheadSMTSolver::solve_() {
     for (Lit l : this->assumptions) {
         this->addVar_(var(l));
@@ -42,7 +52,7 @@ lbool LookaheadSMTSolver::solve_() {
             model[i] = value(i);
         }
     } else {
-        assert(not okContinue() || res == LALoopRes::unsat || this->stop);
+        assert(not okContinue() || res == LALoopRes::unsat || res == LALoopRes::unknown_final || this->stop);
     }
     switch (res) {
         case LALoopRes::unknown_final:
@@ -67,10 +77,11 @@ lbool LookaheadSMTSolver::solve_() {
 // Returns l_True if there was no conflict.
 //
 // Backtracks the solver to the correct decision level and continues until no
-// new conflicts or propagations are available in theory or in unit propagation
+// new conflicts or propagations are available in theory or in unit propagation.
+// Without withTheory only unit propagation is done.
 //
 
-lbool LookaheadSMTSolver::laPropagateWrapper() {
+lbool LookaheadSMTSolver::laPropagateWrapper(bool withTheory) {
     CRef cr;
     bool diff;
     do {
@@ -100,7 +111,7 @@ lbool LookaheadSMTSolver::laPropagateWrapper() {
             }
             diff = true;
         }
-        if (!diff) {
+        if (!diff && withTheory) {
             TPropRes res = checkTheory(true);
             if (res == TPropRes::Unsat) {
                 return l_False; // Unsat
@@ -228,8 +239,10 @@ std::pair<LookaheadSMTSolver::laresult, Lit> LookaheadSMTSolver::lookaheadLoop()
     confl_quota = prev;
 
     score->updateRound();
+    ++sweep;
     int i = 0;
     int d = decisionLevel();
+    bool const boolProbes = config.lookahead_bool_probes();
 
     bool respect_logic_partitioning_hints = config.respect_logic_partitioning_hints();
     int skipped_vars_due_to_logic = 0;
@@ -292,48 +305,84 @@ std::pair<LookaheadSMTSolver::laresult, Lit> LookaheadSMTSolver::lookaheadLoop()
             respect_logic_partitioning_hints = false;
             continue;
         }
-        int p0 = 0, p1 = 0;
+        int props[2] = {0, 0};
+        bool failed = false;
+        int const stamp = ++probeCount;
+        vec<Lit> necessary;
         for (int p : {0, 1}) { // for both polarities
             assert(decisionLevel() == d);
-            double ss = score->getSolverScore(this);
-            newDecisionLevel();
             Lit l = mkLit(v, p);
-            // checking literal propagations
-            uncheckedEnqueue(l);
-            lbool res = laPropagateWrapper();
-            if (res == l_False) {
-                return {laresult::la_tl_unsat, lit_Undef};
-            } else if (res == l_Undef) {
-                cancelUntil(0);
-                return {laresult::la_restart, lit_Undef};
+            if (probeCache[toInt(l)].sweep == sweep) {
+                // Already probed below a literal implied by l
+                props[p] = probeCache[toInt(l)].score;
+                ++reusedProbes;
+                continue;
             }
-            // Else we go on
-            if (decisionLevel() == d + 1) {
-                // literal is succesfully propagated
-                score->updateSolverScore(ss, this);
-            } else if (decisionLevel() == d) {
-                // propagation resulted in backtrack
-                score->updateRound();
+            double ss = score->getSolverScore(this);
+            double const base = ss;
+            ProbeRes res = probe(l, !boolProbes);
+            if (res == ProbeRes::failed) {
+                failed = true;
                 break;
-            } else {
-                // Backtracking should happen.
-                return {laresult::la_unsat, lit_Undef};
+            } else if (res != ProbeRes::ok) {
+                return {toLAResult(res), lit_Undef};
             }
-            p == 0 ? p0 = ss : p1 = ss;
-            // Update also the clause deletion heuristic?
-            cancelUntil(decisionLevel() - 1);
+            // literal is succesfully propagated
+            score->updateSolverScore(ss, this);
+            props[p] = ss;
+            for (int j = trail_lim[d]; j < trail.size(); j++) {
+                // The literals implied by both polarities are necessary
+                if (p == 0) {
+                    impliedIn[toInt(trail[j])] = stamp;
+                } else if (impliedIn[toInt(trail[j])] == stamp) {
+                    necessary.push(trail[j]);
+                }
+            }
+            res = config.sat_picky() ? ProbeRes::ok : probeImplyingLiterals(l, base, score->getBest());
+            cancelUntil(d);
+            if (res == ProbeRes::failed) {
+                failed = true;
+                break;
+            } else if (res != ProbeRes::ok) {
+                return {toLAResult(res), lit_Undef};
+            }
+        }
+        if (failed) {
+            // The refutation is kept as a learnt clause and the probes of this round stay valid, but the ones shared by
+            // the tree lookahead started from the old assignment
+            ++sweep;
+            score->evictAssigned();
+            continue;
         }
         if (value(v) == l_Undef) {
             // updating var score
-            score->setLAValue(v, p0, p1);
+            score->setLAValue(v, props[0], props[1]);
             score->updateLABest(v);
         }
+        if (necessary.size() > 0 && !logsProofForInterpolation()) {
+            ProbeRes res = assertNecessary(necessary);
+            if (res != ProbeRes::ok) { return {toLAResult(res), lit_Undef}; }
+            ++sweep;
+            score->evictAssigned();
+        }
     }
     Lit best = score->getBest();
-    if (static_cast<unsigned int>(trail.size()) == dec_vars && best == lit_Undef) {
+    if (best == lit_Undef && decisionVarsAssigned()) {
         // all variables are set
         return {laresult::la_sat, best};
     }
+    if (boolProbes && best != lit_Undef) {
+        // Only the chosen literal is checked against the theory
+        for (Lit l : {best, ~best}) {
+            ProbeRes res = probe(l, true);
+            if (res == ProbeRes::failed) {
+                return {laresult::la_ok, lit_Undef}; // Look ahead again from the extended assignment
+            } else if (res != ProbeRes::ok) {
+                return {toLAResult(res), lit_Undef};
+            }
+            cancelUntil(d);
+        }
+    }
 
     // lookahead phase is over
     if (!config.sat_picky()) { idx = (idx + i) % nVars(); }
@@ -341,6 +390,128 @@ std::pair<LookaheadSMTSolver::laresult, Lit> LookaheadSMTSolver::lookaheadLoop()
     return {laresult::la_ok, best};
 }
 
+// The trail may also contain non-decision variables, so its size alone does not tell
+bool LookaheadSMTSolver::decisionVarsAssigned() const {
+    if (static_cast<unsigned int>(trail.size()) < dec_vars) { return false; }
+    for (Var v = 0; v < nVars(); v++) {
+        if (decision[v] && value(v) == l_Undef) { return false; }
+    }
+    return true;
+}
+
+/**
+ * Propagates @param l on a new decision level.  Returns ok if the solver stays on the new level, failed if the
+ * literal was refuted and the solver backjumped to the level of the probe, and unsat if it backjumped further.
+ */
+LookaheadSMTSolver::ProbeRes LookaheadSMTSolver::probe(Lit l, bool withTheory) {
+    int const d = decisionLevel();
+    ++probes;
+    newDecisionLevel();
+    uncheckedEnqueue(l);
+    lbool res = laPropagateWrapper(withTheory);
+    if (res == l_True && decisionLevel() <= d && !withTheory) {
+        // The theory has to see the literals learnt on the level the solver backjumped to before it is used again
+        res = laPropagateWrapper();
+    }
+    if (res == l_False) {
+        return ProbeRes::tl_unsat;
+    } else if (res == l_Undef) {
+        cancelUntil(0);
+        return ProbeRes::restart;
+    }
+    if (decisionLevel() > d) { return ProbeRes::ok; }
+    return decisionLevel() == d ? ProbeRes::failed : ProbeRes::unsat;
+}
+
+/**
+ * Tree lookahead below the probed literal @param parent.  A literal l in a binary clause (~l | parent) implies the
+ * parent, so propagating l on top of the parent gives the same assignment as probing l alone, without propagating the
+ * parent again.  The scores, relative to the solver score @param base of the level of the probes, are cached for the
+ * rest of the sweep.  Returns failed if a refuted literal made the solver backjump below the parent.
+ */
+LookaheadSMTSolver::ProbeRes LookaheadSMTSolver::probeImplyingLiterals(Lit parent, double base, Lit best) {
+    int const level = decisionLevel();
+    vec<Lit> children;
+    for (Watcher const & w : watches[~parent]) {
+        Clause const & c = ca[w.cref];
+        if (c.mark() == 1 || c.size() != 2) { continue; }
+        Lit child = ~(c[0] == parent ? c[1] : c[0]);
+        Var x = var(child);
+        if (value(child) != l_Undef || !decision[x] || score->isAlreadyChecked(x)
+            || probeCache[toInt(child)].sweep == sweep
+            || (best != lit_Undef && score->safeToSkip(x, best))
+            || (config.respect_logic_partitioning_hints() && !okToPartition(x))) {
+            continue;
+        }
+        children.push(child);
+    }
+    for (Lit child : children) {
+        if (value(child) != l_Undef) { continue; } // Refuted together with an earlier child
+        ProbeRes res = probe(child, !config.lookahead_bool_probes());
+        if (res == ProbeRes::ok) {
+            double ss = base;
+            score->updateSolverScore(ss, this);
+            probeCache[toInt(child)] = {sweep, static_cast<int>(ss)};
+            cancelUntil(level);
+        } else if (res == ProbeRes::unsat && decisionLevel() == level - 1) {
+            return ProbeRes::failed;
+        } else if (res != ProbeRes::failed) {
+            return res;
+        }
+    }
+    return ProbeRes::ok;
+}
+
+/**
+ * Asserts on the current decision level the literals implied by both polarities of a probed variable.  The reason of
+ * such a literal, the clause of the literal and the negated decisions, is kept as a learnt clause so that the later
+ * rounds do not have to find the literal again.  On level 0 the literal is a fact and is asserted without a reason.
+ */
+LookaheadSMTSolver::ProbeRes LookaheadSMTSolver::assertNecessary(vec<Lit> const & necessary) {
+    int const d = decisionLevel();
+    vec<Lit> negatedDecisions; // The latest first, to be watched
+    for (int j = trail.size() - 1; d > 0 && j >= trail_lim[0]; j--) {
+        if (reason(var(trail[j])) == CRef_Undef) { negatedDecisions.push(~trail[j]); }
+    }
+    for (Lit l : necessary) {
+        if (value(l) != l_Undef) { continue; }
+        if (negatedDecisions.size() == 0) {
+            uncheckedEnqueue(l); // On level 0 the literal needs no reason
+            continue;
+        }
+        vec<Lit> lits{l};
+        for (Lit dec : negatedDecisions) {
+            lits.push(dec);
+        }
+        CRef cr = ca.alloc(lits, {true, computeGlue(lits)});
+        learnts.push(cr);
+        attachClause(cr);
+        uncheckedEnqueue(l, cr);
+    }
+    lbool res = laPropagateWrapper();
+    if (res == l_False) {
+        return ProbeRes::tl_unsat;
+    } else if (res == l_Undef) {
+        cancelUntil(0);
+        return ProbeRes::restart;
+    }
+    return decisionLevel() == d ? ProbeRes::ok : ProbeRes::unsat;
+}
+
+LookaheadSMTSolver::laresult LookaheadSMTSolver::toLAResult(ProbeRes res) {
+    switch (res) {
+        case ProbeRes::tl_unsat:
+            return laresult::la_tl_unsat;
+        case ProbeRes::restart:
+            return laresult::la_restart;
+        case ProbeRes::unsat:
+            return laresult::la_unsat;
+        default:
+            assert(false);
+            return laresult::la_unsat;
+    }
+}
+
 void LookaheadSMTSolver::cancelUntil(int level) {
     assert(level >= 0);
     if (decisionLevel() > level) {
@@ -49,7 +49,7 @@ protected:
         }
     };
 
-    lbool laPropagateWrapper();
+    lbool laPropagateWrapper(bool withTheory = true);
 
 protected:
     // The result from the lookahead loop
@@ -63,6 +63,14 @@ protected:
 
     virtual LALoopRes solveLookahead();
     std::pair<laresult, Lit> lookaheadLoop();
+
+    // The outcome of propagating a probed literal on a new decision level
+    enum class ProbeRes { ok, failed, unsat, tl_unsat, restart };
+    ProbeRes probe(Lit l, bool withTheory);
+    ProbeRes probeImplyingLiterals(Lit parent, double base, Lit best); // Tree lookahead below the probed parent
+    ProbeRes assertNecessary(vec<Lit> const & necessary);
+    static laresult toLAResult(ProbeRes res);
+    bool decisionVarsAssigned() const;
     virtual void cancelUntil(int level) override; // Backtrack until a certain level.
     lbool solve_() override;                      // Does not change the formula
 
@@ -72,11 +80,25 @@ protected:
     laresult expandTree(LANode & n, std::unique_ptr<LANode> c1,
                         std::unique_ptr<LANode> c2); // Do lookahead.  On success write the new children to c1 and c2
     std::unique_ptr<LookaheadScore> score;
+
+    // Probe results shared by the tree lookahead.  A result is valid only in the sweep that computed it; the sweep
+    // changes whenever the assignment the probes start from does.
+    struct ProbeCache {
+        int sweep = -1;
+        int score = 0;
+    };
+    vec<ProbeCache> probeCache; // Indexed by literals
+    vec<int> impliedIn;         // Indexed by literals, the last probe that implied the literal
+    int sweep = 0;
+    int probeCount = 0;
+    uint64_t probes = 0;
+    uint64_t reusedProbes = 0;  // The probes answered from the cache
     bool okToPartition(Var v) const { return theory_handler.getTheory().okToPartition(theory_handler.varToTerm(v)); };
 
 public:
     LookaheadSMTSolver(SMTConfig &, THandler &);
     Var newVar(bool dvar) override;
+    void collectStatistics(opensmt::Statistics & stats) const override;
 };
 
 // Maintain the tree explicitly.  Each internal node should have the info whether its
@@ -98,6 +120,9 @@ LookaheadSMTSolver::buildAndTraverse(BuildConfig && buildConfig) {
     }
 
     while (queue.size() != 0) {
+        if (resourceLimits and resourceLimits->exhausted()) {
+            return {LALoopRes::unknown_final, nullptr};
+        }
         Node * n = queue.last();
         queue.pop();
         assert(n);
@@ -147,7 +172,7 @@ LookaheadSMTSolver::buildAndTraverse(BuildConfig && buildConfig) {
                     analyzeFinal(~p, conflict);
                     int max = 0;
                     for (Lit q : conflict) {
-                        if (!sign(q)) { max = assumptions_order[var(q)] > max ? assumptions_order[var(q)] : max; }
+                        if (!sign(q) and assumptions_order.has(var(q))) { max = assumptions_order[var(q)] > max ? assumptions_order[var(q)] : max; }
                     }
                     conflict_frame = max + 1;
                     ok = false;
@@ -175,6 +200,10 @@ LookaheadSMTSolver::buildAndTraverse(BuildConfig && buildConfig) {
                     queue.push(n);
                     continue;
                 case laresult::la_sat:
+                    // The theory check of the model may have given up on the exhausted resources
+                    if (resourceLimits and resourceLimits->exhausted()) {
+                        return {LALoopRes::unknown_final, nullptr};
+                    }
                     return {LALoopRes::sat, nullptr};
                 case laresult::la_ok:;
             }
@@ -61,13 +61,16 @@ SimpSMTSolver::SimpSMTSolver(SMTConfig & c, THandler & t) :
     , use_asymm          (c.sat_use_asymm())
     , use_rcheck         (c.sat_use_rcheck())
     , use_elim           (c.sat_use_elim())
+    , use_gates          (c.sat_use_gates())
     , merges             (0)
     , asymm_lits         (0)
     , eliminated_vars    (0)
+    , gate_elims         (0)
+    , substituted_vars   (0)
     , elimorder          (1)
     , use_simplification (true)
     , occurs             (ClauseDeleted(ca))
-    , elim_heap          (ElimLt(n_occ))
+    , elim_heap          (ElimLt(n_occ, gate_of))
     , bwdsub_assigns     (0)
     , n_touched          (0)
 {
@@ -105,6 +108,7 @@ Var SimpSMTSolver::newVar(bool dvar)
 
     frozen    .push((char)false);
     eliminated.push((char)false);
+    gate_of   .push(-1);
 
     if (use_simplification)
     {
@@ -243,6 +247,29 @@ bool SimpSMTSolver::addOriginalSMTClause(const vec<Lit> & smt_clause, opensmt::p
 }
 
 
+void SimpSMTSolver::addGate(GateType type, Lit output, const vec<Lit>& inputs)
+{
+    if (!use_simplification || !use_gates) return;
+    Var v = var(output);
+    if (gate_of[v] != -1) return;
+    assert(type != GateType::Xor || inputs.size() == 2);
+
+    Gate gate{type, output, {}};
+    for (Lit l : inputs)
+        gate.inputs.push_back(l);
+    std::sort(gate.inputs.begin(), gate.inputs.end());
+    // The definitions are matched against the clauses literal by literal, repeated variables would break that
+    for (std::size_t i = 0; i < gate.inputs.size(); i++)
+        if (var(gate.inputs[i]) == v || (i > 0 && var(gate.inputs[i]) == var(gate.inputs[i-1])))
+            return;
+
+    gate_of[v] = gates.size();
+    gates.push_back(std::move(gate));
+    if (elim_heap.inHeap(v))
+        elim_heap.decrease(v);
+}
+
+
 void SimpSMTSolver::removeClause(CRef cr)
 {
     const Clause& c = ca[cr];
@@ -265,6 +292,14 @@ bool SimpSMTSolver::strengthenClause(CRef cr, Lit l)
     assert(decisionLevel() == 0);
     assert(use_simplification);
 
+    // A top-level unit not yet processed by the backward subsumption may satisfy the clause, its watches could then
+    // end up on false literals
+    if (satisfied(c))
+    {
+        removeClause(cr);
+        return true;
+    }
+
     // FIX: this is too inefficient but would be nice to have (properly implemented)
     // if (!find(subsumption_queue, &c))
     subsumption_queue.insert(cr);
@@ -544,6 +579,13 @@ static void mkElimClause(vec<uint32_t>& elimclauses, Lit x)
     elimclauses.push(1);
 }
 
+static void mkElimClause(vec<uint32_t>& elimclauses, Lit x, Lit y)
+{
+    elimclauses.push(toInt(x));
+    elimclauses.push(toInt(y));
+    elimclauses.push(2);
+}
+
 static void mkElimClause(vec<uint32_t>& elimclauses, Var v, Clause& c)
 {
     int first = elimclauses.size();
@@ -569,6 +611,61 @@ static void mkElimClause(vec<uint32_t>& elimclauses, Var v, Clause& c)
     elimclauses.push(c.size());
 }
 
+// Marks the clauses of 'cls' that form the definition of 'gate'. Returns false if some clause of the definition is
+// missing, e.g., because it has been strengthened or was satisfied when it was added.
+bool SimpSMTSolver::findGateClauses(const Gate& gate, const vec<CRef>& cls, vec<char>& in_gate) const
+{
+    const std::vector<Lit>& inputs = gate.inputs;
+    const Lit o = gate.output;
+    auto inputIndex = [&inputs](Lit l) {
+        auto it = std::lower_bound(inputs.begin(), inputs.end(), l);
+        return it != inputs.end() && *it == l ? static_cast<int>(it - inputs.begin()) : -1;
+    };
+
+    in_gate.clear();
+    in_gate.growTo(cls.size(), (char)false);
+    // And gate: a binary clause (~o | a) per input and the clause (o | ~a_1 | ... | ~a_n)
+    // Xor gate: the four clauses over o, a, b with an odd number of negated literals
+    vec<char> found(gate.type == GateType::And ? inputs.size() + 1 : 4, (char)false);
+    int n_found = 0;
+    for (int i = 0; i < cls.size(); i++) {
+        const Clause& c = ca[cls[i]];
+        int slot = -1;
+        if (gate.type == GateType::And) {
+            if (c.size() == 2 && (c[0] == ~o || c[1] == ~o)) {
+                slot = inputIndex(c[0] == ~o ? c[1] : c[0]);
+            } else if (c.size() == inputs.size() + 1) {
+                slot = inputs.size();
+                for (unsigned j = 0; j < c.size() && slot != -1; j++)
+                    if (c[j] != o && inputIndex(~c[j]) == -1)
+                        slot = -1;
+            }
+        } else if (c.size() == 3) {
+            int negated = 0, pattern = 0;
+            for (unsigned j = 0; j < c.size() && negated >= 0; j++) {
+                if (var(c[j]) == var(o)) {
+                    negated += c[j] != o;
+                } else if (var(c[j]) == var(inputs[0]) || var(c[j]) == var(inputs[1])) {
+                    int k = var(c[j]) == var(inputs[0]) ? 0 : 1;
+                    bool differs = c[j] != inputs[k];
+                    negated += differs;
+                    pattern |= differs << k;
+                } else {
+                    negated = -1;
+                }
+            }
+            if (negated % 2 == 1)
+                slot = pattern;
+        }
+        if (slot != -1 && !found[slot]) {
+            found[slot] = true;
+            in_gate[i] = true;
+            n_found++;
+        }
+    }
+    return n_found == found.size();
+}
+
 bool SimpSMTSolver::eliminateVar(Var v)
 {
     assert(!frozen[v]);
@@ -579,8 +676,19 @@ bool SimpSMTSolver::eliminateVar(Var v)
     //
     const vec<CRef>& cls = occurs.lookup(v);
     vec<CRef>        pos, neg;
-    for (int i = 0; i < cls.size(); i++)
-        (find(ca[cls[i]], mkLit(v)) ? pos : neg).push(cls[i]);
+    vec<char>        in_gate;
+    vec<char>        pos_gate, neg_gate;
+    bool             use_gate = hasGate(v) && findGateClauses(gates[gate_of[v]], cls, in_gate);
+    for (int i = 0; i < cls.size(); i++) {
+        bool positive = find(ca[cls[i]], mkLit(v));
+        (positive ? pos : neg).push(cls[i]);
+        (positive ? pos_gate : neg_gate).push(use_gate && in_gate[i]);
+    }
+
+    // If v is defined by a gate, the resolvents of two gate clauses are tautologies and the resolvents of two
+    // other clauses are implied by the rest, so only gate clauses are resolved with other clauses:
+    //
+    auto resolve = [&](int i, int j) { return !use_gate || pos_gate[i] != neg_gate[j]; };
 
     // Check wether the increase in number of clauses stays within the allowed ('grow'). Moreover, no
     // clause must exceed the limit on the maximal clause size (if it is set):
@@ -590,7 +698,7 @@ bool SimpSMTSolver::eliminateVar(Var v)
 
     for (int i = 0; i < pos.size(); i++)
         for (int j = 0; j < neg.size(); j++)
-            if (merge(ca[pos[i]], ca[neg[j]], v, clause_size) &&
+            if (resolve(i, j) && merge(ca[pos[i]], ca[neg[j]], v, clause_size) &&
                     (++cnt > cls.size() + grow || (clause_lim != -1 && clause_size > clause_lim)))
                 return true;
 #ifdef PEDANTIC_DEBUG
@@ -600,6 +708,7 @@ bool SimpSMTSolver::eliminateVar(Var v)
     eliminated[v] = true;
     setDecisionVar(v, false);
     eliminated_vars++;
+    if (use_gate) gate_elims++;
 
     if (pos.size() > neg.size())
     {
@@ -622,7 +731,7 @@ bool SimpSMTSolver::eliminateVar(Var v)
     for (int i = 0; i < pos.size(); i++) {
         for (int j = 0; j < neg.size(); j++) {
             opensmt::pair<CRef,CRef> dummy {CRef_Undef, CRef_Undef};
-            if (merge(ca[pos[i]], ca[neg[j]], v, resolvent) && !addOriginalSMTClause(resolvent, dummy))
+            if (resolve(i, j) && merge(ca[pos[i]], ca[neg[j]], v, resolvent) && !addOriginalSMTClause(resolvent, dummy))
                 return false;
         }
     }
@@ -648,6 +757,9 @@ bool SimpSMTSolver::substitute(Var v, Lit x)
 
     eliminated[v] = true;
     setDecisionVar(v, false);
+    // The model extension gives v the value of x
+    mkElimClause(elimclauses, mkLit(v), ~x);
+    mkElimClause(elimclauses, ~mkLit(v), x);
     const vec<CRef>& cls = occurs.lookup(v);
 
     vec<Lit>& subst_clause = add_tmp;
@@ -673,6 +785,44 @@ bool SimpSMTSolver::substitute(Var v, Lit x)
 }
 
 
+// If the top-level assignment reduces the gate to an equivalence of two literals, one of them is replaced by
+// the other. Returns false if the substitution made the problem unsatisfiable.
+bool SimpSMTSolver::substituteGate(const Gate& gate)
+{
+    if (isEliminated(var(gate.output))) return true;
+    for (Lit l : gate.inputs)
+        if (isEliminated(var(l))) return true;
+
+    Lit a = lit_Undef, b = lit_Undef; // a <-> b follows from the gate
+    if (gate.type == GateType::And) {
+        // All inputs but one are true
+        if (value(gate.output) != l_Undef) return true;
+        for (Lit l : gate.inputs) {
+            if (value(l) == l_True) continue;
+            if (value(l) == l_False || b != lit_Undef) return true;
+            b = l;
+        }
+        a = gate.output;
+    } else {
+        // Exactly one of o, x, y in o <-> x xor y is assigned
+        Lit o = gate.output, x = gate.inputs[0], y = gate.inputs[1];
+        if (value(o) != l_Undef && value(x) == l_Undef && value(y) == l_Undef)
+            a = x, b = y ^ (value(o) == l_True);
+        else if (value(x) != l_Undef && value(o) == l_Undef && value(y) == l_Undef)
+            a = o, b = y ^ (value(x) == l_True);
+        else if (value(y) != l_Undef && value(o) == l_Undef && value(x) == l_Undef)
+            a = o, b = x ^ (value(y) == l_True);
+    }
+    if (a == lit_Undef || b == lit_Undef || var(a) == var(b)) return true;
+
+    if (frozen[var(a)]) std::swap(a, b);
+    if (frozen[var(a)]) return true;
+
+    substituted_vars++;
+    return substitute(var(a), b ^ sign(a));
+}
+
+
 void SimpSMTSolver::extendModel()
 {
     int i, j;
@@ -703,6 +853,17 @@ bool SimpSMTSolver::eliminate(bool turn_off_elim)
     //
     while (n_touched > 0 || bwdsub_assigns < trail.size() || elim_heap.size() > 0)
     {
+        // Equivalences from the gates first, the substituted clauses then take part in the subsumption
+        if (use_gates)
+        {
+            for (const Gate& gate : gates)
+                if (!substituteGate(gate))
+                {
+                    ok = false;
+                    goto cleanup;
+                }
+        }
+
         gatherTouchedClauses();
         // printf("  ## (time = %6.2f s) BWD-SUB: queue = %d, trail = %d\n", cpuTime(), subsumption_queue.size(), trail.size() - bwdsub_assigns);
         if ((subsumption_queue.size() > 0 || bwdsub_assigns < trail.size()) &&
@@ -731,7 +892,6 @@ bool SimpSMTSolver::eliminate(bool turn_off_elim)
 
             if (isEliminated(elim) || value(elim) != l_Undef) continue;
 
-
             if (use_asymm)
             {
                 // Temporarily freeze variable. Otherwise, it would immediately end up on the queue again:
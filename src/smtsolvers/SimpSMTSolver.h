@@ -48,6 +48,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 #include "Queue.h"
 #include "CoreSMTSolver.h"
+#include <vector>
 
 class SimpSMTSolver : public CoreSMTSolver
 {
@@ -68,6 +69,12 @@ public:
 
     bool    substitute(Var v, Lit x);  // Replace all occurences of v with x (may cause a contradiction).
 
+    // Gate definitions known to the cnfizer. An or gate is an and gate of the negated literals, and an iff gate
+    // is a xor gate with the negated output.
+    //
+    enum class GateType : char { And, Xor };
+    void    addGate   (GateType type, Lit output, const vec<Lit>& inputs); // output <-> and(inputs) or output <-> xor(inputs)
+
     // Variable mode:
     // 
     void    setFrozen (Var v, bool b); // If a variable is frozen it will not be eliminated.
@@ -109,12 +116,15 @@ public:
     bool    use_asymm;         // Shrink clauses by asymmetric branching.
     bool    use_rcheck;        // Check if a clause is already implied. Prett costly, and subsumes subsumptions :)
     bool    use_elim;          // Perform variable elimination.
+    bool    use_gates;         // Restrict the resolvents of gate variables and substitute equivalent gate literals.
 
     // Statistics:
     //
     int     merges;
     int     asymm_lits;
     int     eliminated_vars;
+    int     gate_elims;        // Eliminations that used the gate definition of the variable
+    int     substituted_vars;
 
 // protected:
   public:
@@ -123,12 +133,23 @@ public:
     //
     struct ElimLt {
         const vec<int>& n_occ;
-        explicit ElimLt(const vec<int>& no) : n_occ(no) {}
+        const vec<int>& gate_of;
+        ElimLt(const vec<int>& no, const vec<int>& go) : n_occ(no), gate_of(go) {}
 
         // TODO: are 64-bit operations here noticably bad on 32-bit platforms? Could use a saturating
         // 32-bit implementation instead then, but this will have to do for now.
         uint64_t cost  (Var x)        const { return (uint64_t)n_occ[toInt(mkLit(x))] * (uint64_t)n_occ[toInt(~mkLit(x))]; }
-        bool operator()(Var x, Var y) const { return cost(x) < cost(y); }
+        // Gate variables go first, eliminating their inputs before them would destroy the definitions
+        bool operator()(Var x, Var y) const {
+            bool gx = gate_of[x] != -1, gy = gate_of[y] != -1;
+            return gx != gy ? gx : cost(x) < cost(y);
+        }
+    };
+
+    struct Gate {
+        GateType         type;
+        Lit              output;
+        std::vector<Lit> inputs;    // Sorted
     };
 
     struct ClauseDeleted {
@@ -140,6 +161,7 @@ public:
     //
     int                 elimorder;
     bool                use_simplification;
+    vec<int>            gate_of;    // Index of the gate defining the variable, -1 if there is none
     OccLists<Var, vec<CRef>, ClauseDeleted>
                         occurs;
     Heap<ElimLt>        elim_heap;
@@ -152,6 +174,7 @@ public:
     Queue<CRef>         subsumption_queue;
     vec<char>           frozen;
     vec<char>           eliminated;
+    std::vector<Gate>   gates;
 
     // Temporaries:
     //
@@ -171,6 +194,9 @@ public:
     bool          merge                    (const Clause& _ps, const Clause& _qs, Var v, int& size);
     bool          backwardSubsumptionCheck (bool verbose = false);
     bool          eliminateVar             (Var v);
+    bool          hasGate                  (Var v) const;
+    bool          findGateClauses          (const Gate& gate, const vec<CRef>& cls, vec<char>& in_gate) const;
+    bool          substituteGate           (const Gate& gate);
     void          extendModel              ();
 
     void          removeClause             (CRef cr);
@@ -195,6 +221,7 @@ inline void SimpSMTSolver::updateElimHeap(Var v) {
     if (elim_heap.inHeap(v) || (!frozen[v] && !isEliminated(v) && value(v) == l_Undef))
         elim_heap.update(v); }
 
+inline bool SimpSMTSolver::hasGate (Var v) const { return use_gates && gate_of[v] != -1; }
 inline void  SimpSMTSolver::setFrozen    (Var v, bool b) { if ( !use_simplification ) return; frozen[v] = (char)b; if (b) { updateElimHeap(v); } }
 inline lbool SimpSMTSolver::solve        (                     bool do_simp, bool turn_off_simp)  { return solve(vec<Lit>{}, do_simp, turn_off_simp); }
 inline lbool SimpSMTSolver::solve        (Lit p       ,        bool do_simp, bool turn_off_simp)  { return solve(vec<Lit>{p}, do_simp, turn_off_simp); }
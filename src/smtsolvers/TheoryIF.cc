@@ -182,7 +182,10 @@ TPropRes CoreSMTSolver::handleNewSplitClauses(SplitClauses & splitClauses) {
             }
         }
     }
-    assert(res != TPropRes::Undef);
+    if (res == TPropRes::Undef) {
+        // All new clauses are already satisfied by the current assignment (e.g., lemmas learnt eagerly by the theory)
+        res = TPropRes::Decide;
+    }
     if (res == TPropRes::Propagate) {
         assert(std::all_of(propData.begin(), propData.end(), [this](auto const & datum){
             return value(var(datum.lit)) == l_Undef;
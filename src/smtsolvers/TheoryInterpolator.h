@@ -33,8 +33,8 @@ private:
     ipartitions_t mask;
 
     icolor_t getColorForMask(ipartitions_t const & otherMask) {
-        bool isInA = (otherMask & mask) != 0;
-        bool isInB = (otherMask & ~mask) != 0;
+        bool isInA = opensmt::isAlocal(otherMask, mask);
+        bool isInB = opensmt::isBlocal(otherMask, mask);
         if (isInA and not isInB) { return icolor_t::I_A; }
         if (isInB and not isInA) { return icolor_t::I_B; }
         if (isInA and isInB) { return icolor_t::I_AB; }
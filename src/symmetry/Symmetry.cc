@@ -1,404 +1,234 @@
 #include "Symmetry.h"
-#include <stack>
-#include <algorithm>
-#include "symmetry/bliss/utils.hh"
+#include <cstdio>
+#include <unordered_set>
 #include "bliss/graph.cc"
-#include "Vec.h"
 
 namespace bliss
 {
 	template class Digraph<PTRef>;
 }
 
-namespace symmetry 
+namespace symmetry
 {
 
-	//C++11 only
-	//using Cycle = std::vector<unsigned int>;
-
-	//C++98 compatible
-	//typedef std::vector<unsigned int> Cycle;
-	
-	// Detector::HookParams::HookParams(const bliss::Digraph<PTRef>& g, Logic& l, PTRef& f) :
-	// 								 graph(g), 
-	// 								 logic(l), 
-	// 								 formula(f) {}
-
-	/*
-		Permutation cycle filtering criterion
-	*/
-	bool Detector::CycleFilter::operator()(const Detector::Cycle& cycle) {
-		if(cycle.size() != 2) { return true; }
-
-	 	const PTRef* t1 = graph->get_vertex_value(cycle[0]);
-		const PTRef* t2 = graph->get_vertex_value(cycle[1]);
-	 	SRef sort1 = logic.getSortRef(*t1);
-		SRef sort2 = logic.getSortRef(*t2);
-
-		return !(logic.hasSortBool(*t1) && sort1 == sort2);
-	}
-	
-	Detector::Detector(Logic& l, PTRef& formula) : 
+	Detector::Detector(Logic& l, PTRef formula) :
 			  nextColor(ARGUMENT_NODES_COLOR),
-			  graph( new bliss::Digraph<PTRef>() ),
-			  term(formula),
+			  graph(new bliss::Digraph<PTRef>()),
 			  logic(l),
-			  sbps(PTRef_Undef)
+			  timeLimit(0),
+			  numGenerators(0),
+			  searchAborted(false),
+			  sbps(l.getTerm_true())
 	{
+		graph->set_splitting_heuristic(bliss::Digraph<PTRef>::shs_fsm);
 
-		bliss::Digraph<PTRef>::SplittingHeuristic shs_directed = bliss::Digraph<PTRef>::shs_fsm;
-		graph->set_splitting_heuristic(shs_directed);
+		// The formula is a DAG, every term is encoded only once
+		std::unordered_set<PTRef, PTRefHash> processed;
+		std::vector<PTRef> terms{formula};
 
-		std::stack<PTRef*> terms;
-		terms.push(&term);
-		
 		while(!terms.empty()) {
-			
-			PTRef& currentRef = *(terms.top());
-			Pterm& current = logic.getPterm(currentRef);
-			std::string symbol = logic.getSymName(currentRef);
-			terms.pop();
 
-			//if the unique symbol is not already in the graph, add it
-			//Detector::GraphNode symbolNode{addSymbolNode(currentRef, logic)};
-			Detector::GraphNode rootNode = addRootNode(currentRef);
+			PTRef current = terms.back();
+			terms.pop_back();
+			if(!processed.insert(current).second) { continue; }
 
-			if(current.nargs()) //if arity > 0
-			{
-				Detector::GraphNode root_node = addRootNode(currentRef);
+			GraphNode rootNode = addRootNode(current);
+			const Pterm& term = logic.getPterm(current);
 
-				if(commutes(currentRef)) 
-				{
-					//std::cerr << " ; The term " << symbol << " commutes" << std::endl;
- 					for(int i = 0; i < current.size(); ++i)
-					{
-						const PTRef& ti = current[i];
-						Detector::GraphNode ti_root_node = addRootNode(ti);
-						graph->add_edge(root_node, ti_root_node);
-					}
-				}
-				else 
+			if(commutes(current))
+			{
+				for(PTRef arg : term) { graph->add_edge(rootNode, addRootNode(arg)); }
+			}
+			else
+			{
+				// Chain the argument nodes to fix the order of the arguments
+				GraphNode previous = rootNode;
+				for(PTRef arg : term)
 				{
-					//TODO: ugly, think of how to fix this
-					//this is necessary because if the term has only one arg it won't enter the next loop
-					if(current.size() == 1)
-					{
-						const PTRef& ti = current[0];
-						Detector::GraphNode ti_arg_node = addArgumentNode(ti, currentRef);
-						graph->add_edge(root_node, ti_arg_node);						
-					}
-
-					for(int i = 0; i < current.size()-1; ++i)
-					{
-						const PTRef& ti 	  = current[i];
-						const PTRef& ti_p_one = current[i+1];
-						Detector::GraphNode ti_arg_node = addArgumentNode(ti, currentRef);
-						Detector::GraphNode ti_p_one_arg_node = addArgumentNode(ti_p_one, currentRef);
-						graph->add_edge(ti_arg_node, ti_p_one_arg_node);
-						if(i == 0) { graph->add_edge(root_node, ti_arg_node); }
-					}
+					GraphNode argumentNode = addArgumentNode(arg);
+					graph->add_edge(previous, argumentNode);
+					previous = argumentNode;
 				}
 			}
 
-			for(int i = 0; i < current.size(); ++i) {
-				PTRef* c = &(current[i]);
-				terms.push(c);
-			}
+			for(PTRef arg : term) { terms.push_back(arg); }
 		}
 	}
 
-	Detector::~Detector()
-	{
-		delete graph;
-		//graph = nullptr;
-		graph = NULL;
-	}
+	Detector::~Detector() = default;
 
 	/**
 		Exports the generated graph to file in dot format
 	*/
-	void Detector::toDot(const std::string path)
+	void Detector::toDot(const std::string & path)
 	{
 		FILE* file = fopen(path.c_str(), "w");
 		if(file != NULL) {
-                    graph->write_dot(file);
-                    fclose(file);
-                }
-		//file = nullptr;
-		file = NULL;	
+			graph->write_dot(file);
+			fclose(file);
+		}
 	}
 
-	/***
-		Utility to compute the cycle form of a permutation
-		TODO: discuss with antti if it would be better to return a pointer to a vector
-		instead of returning by value
+	/**
+		Records the lex-leader pairs of a generator.
+
+		Positions of the lex-leader ordering are the root nodes in the order of the vertices.  A cycle is handled at
+		its smallest vertex; every Boolean 2-cycle (p q) with p < q contributes the pair (p, q).  The ordering is cut at
+		the first cycle over root nodes that is not a Boolean 2-cycle, since the rest of the comparison cannot be
+		expressed propositionally.  Cutting the ordering only weakens the predicate, so it stays sound.
 	*/
-	static std::vector<Detector::Cycle> computePermCycles(const unsigned int size, const unsigned int* perm)
+	void Detector::addGenerator(unsigned int n, const unsigned int* aut)
 	{
-		assert(size > 0);
-		assert(perm);
-
-		std::vector<Detector::Cycle> cycles;
-
-		for(unsigned int i = 0; i < size; i++) {
-	  	
-	    	unsigned int j = perm[i];
-	    	
-	    	if(j == i) { continue; }
-	    	
-	    	bool is_first = true;
-	    	while(j != i) {
-	      		if(j < i) {
-	        		is_first = false;
-	        		break;
-	      		}
-	      		j = perm[j];
-	    	}
-	    	
-	    	if(!is_first) { continue; }
-	  		
-	  		Detector::Cycle cycle;
-	  		cycle.push_back(i);
-	    	
-	    	j = perm[i];
-	    	while(j != i) {
-	      	
-	    		cycle.push_back(j);
-	        	j = perm[j];
-	      	
-	    	}
-	    	
-	    	cycles.push_back(cycle);
-	  }
-	  return cycles;
+		assert(n == vertexTerms.size());
+		++numGenerators;
+
+		std::vector<std::pair<PTRef, PTRef>> pairs;
+		for(unsigned int i = 0; i < n and pairs.size() < MAX_LEX_LEADER_PAIRS; ++i)
+		{
+			if(aut[i] == i) { continue; }
+
+			bool isFirst = true;
+			unsigned int length = 1;
+			for(unsigned int j = aut[i]; j != i; j = aut[j], ++length)
+			{
+				if(j < i) {
+					isFirst = false;
+					break;
+				}
+			}
+			if(!isFirst) { continue; }
+
+			// Colors are preserved, so a cycle consists either of root nodes only or of no root nodes at all
+			PTRef p = vertexTerms[i];
+			if(p == PTRef_Undef) { continue; }
+			if(length != 2 or not logic.hasSortBool(p)) { break; }
+
+			pairs.emplace_back(p, vertexTerms[aut[i]]);
+		}
+
+		if(!pairs.empty()) { lexLeaderPairs.push_back(std::move(pairs)); }
 	}
 
 	/**
-		Computes the SBPs from a generator.
+		Hook called by bliss for every generator of the automorphism group.
 
-		param must be pointing to a Detector instance.
+		param must be pointing to a Detector instance.  No terms may be created here, the terms are built in findSBPs.
 	*/
 	void Detector::computeSBPs(void *param, unsigned int n, const unsigned int *aut)
 	{
-		//std::cerr << "; Helloooooo" << std::endl;
-  		assert(param);
-  		//Detector::HookParams* params = static_cast<Detector::HookParams*>(param);
-  		Detector* params = static_cast<Detector*>(param);
-  		std::vector<Detector::Cycle> cycles = computePermCycles(n,aut);
-
-  		const bliss::Digraph<PTRef>* graph = params->graph;
-  		Logic& logic = params->logic;
-  		PTRef& formula = params->term;
-
-  		//filter only the "interesting" cycles
-  		cycles.erase(
-    		std::remove_if(cycles.begin(), cycles.end(),
-     //    	[&](const Cycle & c) { 
-     //     		 	if(c.size() != 2) { return true; }
-
-	 			// 	const PTRef* t1 = graph->get_vertex_value(c[0]);
-					// const PTRef* t2 = graph->get_vertex_value(c[1]);
-	 			// 	SRef sort1 = logic.getSortRef(*t1);
-					// SRef sort2 = logic.getSortRef(*t2);
-
-					// return !(logic.hasSortBool(*t1) && sort1 == sort2);
-     //    	}),
-    		Detector::CycleFilter(graph, logic)),
-    		cycles.end()); 
-
-  		vec<PTRef> sbps;
-
-  		//TODO: refactor this loop in separate function?
-  		//for i in {0..n}
-  		for(unsigned int i=0; i<cycles.size(); ++i)
-  		{
-  			Detector::Cycle ci = cycles[i];
-  			const PTRef* pi = graph->get_vertex_value(ci[0]);
-  			const PTRef* qi = graph->get_vertex_value(ci[1]);
-
-  			vec<PTRef> rhsTerms;
-  			rhsTerms.push(*pi);
-  			rhsTerms.push(*qi);
-  			PTRef rhs = logic.mkImpl(rhsTerms);
-
-  			if(i==0) { //special case, only rhs of the SBP
-
-  				sbps.push(rhs);
-  				
-  			} else {
-  				
-  				vec<PTRef> lhsTerms;
-  				for(unsigned int j=0; j<i; ++j)
-  				{
-  					Detector::Cycle cj = cycles[j];
-  					const PTRef* pj = graph->get_vertex_value(cj[0]);
-  					const PTRef* qj = graph->get_vertex_value(cj[1]);
-  					vec<PTRef> eq;
-  					eq.push(*pj);
-  					eq.push(*qj);
-  					PTRef con = logic.mkEq(eq);
-  					lhsTerms.push(con);
-  				}
-  				PTRef lhs = logic.mkAnd(lhsTerms);
-				vec<PTRef> final;
-				final.push(lhs);
-				final.push(rhs);
-				PTRef sbp = logic.mkImpl(final);
-				sbps.push(sbp);
-  			}
-  		}
-
-  		if(params->sbps != PTRef_Undef) 
-  		{
-  			sbps.push(params->sbps);
-  		}
-  		params->sbps = logic.mkAnd(sbps); 
-
-  		//bliss::print_permutation(stderr, n, aut, 0);
-  		//fprintf(stderr, "\n");
+		assert(param);
+		static_cast<Detector*>(param)->addGenerator(n, aut);
 	}
 
 	/**
-		Augments the formula passed to Detector with the symmetry breaking predicates
+		Computes the generators of the symmetry group and their lex-leader predicates.
+
+		For a generator with pairs (p_1, q_1), ..., (p_k, q_k) the predicate is the conjunction over i of
+		(p_1 <=> q_1) and ... and (p_{i-1} <=> q_{i-1}) => (p_i => q_i), where the prefixes are shared.
 	*/
 	void Detector::findSBPs()
 	{
 		bliss::Stats stats;
-		//HookParams* params = new HookParams(*graph, logic, term);
-		void* hookParams = static_cast<void*>(this);
-		graph->find_automorphisms(stats, &Detector::computeSBPs, hookParams);
-		//delete params;
-	}
+		graph->set_time_limit(timeLimit);
+		graph->find_automorphisms(stats, &Detector::computeSBPs, static_cast<void*>(this));
+		searchAborted = graph->search_aborted();
 
-	/**
-		Adds a unique symbol node to the graph, or returns it if already exists
-	*/
-	Detector::GraphNode Detector::addSymbolNode(const PTRef& term) 
-	{	
-		std::string symbol = logic.getSymName(term);
-		if(!cache.symbolNodes.count(symbol)) 
+		vec<PTRef> predicates;
+		for(auto const & pairs : lexLeaderPairs)
 		{
-			//std::cout << "Adding symbol node for " << symbol << "\n";
-			unsigned int color;
-			//coloring uninterpreted node
-			if(logic.isUF(term) || logic.isUP(term) || logic.isBoolAtom(term)) 
+			PTRef prefixEqual = logic.getTerm_true();
+			for(auto const & [p, q] : pairs)
 			{
-				//if I already assigned a color to this sort I retrieve it else I create one
-				//std::cerr << "Term " << logic.printTerm(term) << " is uninterpreted\n";
-				SRef sortRef = logic.getSortRef(term);
-				std::string sortName = logic.getSortName(sortRef);
-				color = ((cache.symbolSortColors.count(sortName)) ? 
-				 	   	 cache.symbolSortColors[sortName] : 
-				 	     ++nextColor);
-
-				cache.symbolSortColors[sortName] = color;
-			}
-			else 
-			{ 
-				//std::cerr << "; Term " << logic.printTerm(term) << " is interpreted\n";
-				color = ++nextColor;
+				predicates.push(logic.mkImpl(prefixEqual, logic.mkImpl(p, q)));
+				prefixEqual = logic.mkAnd(prefixEqual, logic.mkEq(p, q));
 			}
-
-			//const PTRef *termRef{&term};
-			Detector::GraphNode symNode= graph->add_vertex(color, symbol, &term);
-			//std::cerr << "; [" << symNode << "] " << "Added symbol node " << symbol << std::endl;
-			
-			cache.symbolNodes[symbol] = symNode;
-			return symNode;
 		}
-		return cache.symbolNodes[symbol];
+		lexLeaderPairs.clear();
+		sbps = logic.mkAnd(std::move(predicates));
 	}
 
-	/**
-		Adds a root node for a term to the graph, or return it if already inserted
-	*/
-	Detector::GraphNode Detector::addRootNode(const PTRef& term) 
+	Detector::GraphNode Detector::addVertex(unsigned int color, PTRef term)
 	{
-		if(!cache.rootNodes.count(term)) 
-		{
+		GraphNode node = graph->add_vertex(color, logic.getSymName(term));
+		assert(node == vertexTerms.size());
+		vertexTerms.push_back(PTRef_Undef);
+		return node;
+	}
 
-			const Pterm& current = logic.getPterm(term);
-			SRef sortRef = logic.getSortRef(term);
-			std::string symbol = logic.getSymName(term);
-			std::string sortName = logic.getSortName(sortRef);
-
-			//root nodes get a color based on their sort
-			unsigned int color = ((cache.rootSortColors.count(sortName)) ? cache.rootSortColors[sortName] : ++nextColor);
-			cache.rootSortColors[sortName] = color;
-
-			//retrieve symbol node
-			//Detector::GraphNode symbolNode{addSymbolNode(term, logic)};
-			//Detector::GraphNode rootNode{ (current.nargs() == 0) ? symbolNode : graph->add_vertex(color, symbol) };
-			const PTRef* termRef{&term};
-			Detector::GraphNode rootNode = graph->add_vertex(color, symbol, &term);
-			//std::cerr << "; [" << rootNode << "] " << "Added root node " << symbol << std::endl;
-			
-			if(current.nargs() > 0) 
-			{ 
-				Detector::GraphNode symbolNode = addSymbolNode(term);
-				graph->add_edge(rootNode, symbolNode); 
-			} 
-			else //this node is also the symbol node for the term 
-			{
-				//std::cerr << "; [" << rootNode << "] " << "Symbold node for  " << symbol << " is also symbol node" << std::endl;
-				cache.symbolNodes[symbol] = rootNode;
-				
-				//if symbol node is interpreted, change the color to a unique one
-				if(!(logic.isUF(term) || logic.isUP(term) || logic.isBoolAtom(term))) {
-					unsigned int newColor = ++nextColor;
-					graph->change_color(rootNode, newColor);
-				} 
-				//else it is uninterpreted, so set it as the color for symbol nodes of the same sort
-				//or should I leave it as the color for root nodes of the same sort?
-				//(ambiguous in the algorithm description which one gets the priority)
-				else {
-					color = ((cache.symbolSortColors.count(sortName)) ? 
-				 	   	 cache.symbolSortColors[sortName] : 
-				 	     ++nextColor);
-					cache.symbolSortColors[sortName] = color;
-					graph->change_color(rootNode, color);
-				}
-				
-			}
+	unsigned int Detector::getSortColor(std::unordered_map<SRef, unsigned int, SRefHash> & colors, SRef sort)
+	{
+		auto it = colors.find(sort);
+		if(it != colors.end()) { return it->second; }
+		unsigned int color = ++nextColor;
+		colors.emplace(sort, color);
+		return color;
+	}
 
-			cache.rootNodes[term] = rootNode;
-		}
-		
-		return cache.rootNodes[term];
+	bool Detector::isUninterpreted(PTRef term) const
+	{
+		SymRef symbol = logic.getSymRef(term);
+		return not logic.isInterpreted(symbol) and not logic.isConstant(symbol);
 	}
 
 	/**
-		Adds an argument node for an argument to the graph, or return it if already inserted
+		Adds a unique symbol node to the graph, or returns it if already exists
 	*/
-	Detector::GraphNode Detector::addArgumentNode(const PTRef& term, const PTRef& parent)
+	Detector::GraphNode Detector::addSymbolNode(PTRef term)
 	{
+		SymRef symbol = logic.getSymRef(term);
+		auto it = cache.symbolNodes.find(symbol);
+		if(it != cache.symbolNodes.end()) { return it->second; }
+
+		// Uninterpreted symbols of the same sort may be permuted, interpreted ones are fixed
+		unsigned int color = isUninterpreted(term) ?
+			getSortColor(cache.functionSortColors, logic.getSortRef(term)) :
+			++nextColor;
+		GraphNode symbolNode = addVertex(color, term);
+		cache.symbolNodes.emplace(symbol, symbolNode);
+		return symbolNode;
+	}
 
-		std::pair<PTRef, PTRef> key = std::make_pair(term, parent);
-		std::string symbol = logic.getSymName(term);
+	/**
+		Adds a root node for a term to the graph, or return it if already inserted
+	*/
+	Detector::GraphNode Detector::addRootNode(PTRef term)
+	{
+		auto it = cache.rootNodes.find(term);
+		if(it != cache.rootNodes.end()) { return it->second; }
 
-		if(!cache.argumentNodes.count(key))
+		SRef sort = logic.getSortRef(term);
+		GraphNode rootNode;
+		if(logic.getPterm(term).nargs() > 0)
 		{
-			const PTRef* termRef = &term;
-			//add argument node with specific unique color
-			Detector::GraphNode argumentNode = graph->add_vertex(ARGUMENT_NODES_COLOR, symbol, &term);
-			//std::cerr << "; [" << argumentNode << "] " << "Added symbol node " << symbol << std::endl;
-
-			cache.argumentNodes[key] = argumentNode;
-
-			//get root node
-			Detector::GraphNode rootNode = addRootNode(term);
-
-			//connect argument node to root node
-			graph->add_edge(argumentNode, rootNode);
-			return argumentNode;
+			// root nodes get a color based on their sort
+			rootNode = addVertex(getSortColor(cache.rootSortColors, sort), term);
+			graph->add_edge(rootNode, addSymbolNode(term));
 		}
-		return cache.argumentNodes[key];
+		else //this node is also the symbol node for the term
+		{
+			unsigned int color = isUninterpreted(term) ? getSortColor(cache.symbolSortColors, sort) : ++nextColor;
+			rootNode = addVertex(color, term);
+			cache.symbolNodes.emplace(logic.getSymRef(term), rootNode);
+		}
+		vertexTerms[rootNode] = term;
+		cache.rootNodes.emplace(term, rootNode);
+		return rootNode;
+	}
+
+	/**
+		Adds an argument node for an argument of a non-commutative term and connects it to the root node of the argument
+	*/
+	Detector::GraphNode Detector::addArgumentNode(PTRef term)
+	{
+		GraphNode argumentNode = addVertex(ARGUMENT_NODES_COLOR, term);
+		graph->add_edge(argumentNode, addRootNode(term));
+		return argumentNode;
 	}
 
 	/**
 		Check if a term commutes
 	*/
-	bool Detector::commutes(const PTRef& term)
+	bool Detector::commutes(PTRef term) const
 	{
 		return logic.commutes(logic.getSymRef(term));
 	}
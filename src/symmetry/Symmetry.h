@@ -1,74 +1,95 @@
 #ifndef SYMMETRY_H
 #define SYMMETRY_H
 
-#include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
-#include "symmetry/bliss/graph.hh"
-#include "logics/Logic.h"
-#include "pterms/Pterm.h"
+#include "bliss/graph.hh"
+#include "Logic.h"
+#include "PTRef.h"
 
-namespace symmetry 
+namespace symmetry
 {
 
+	/**
+		Detects the symmetries of a formula and builds lex-leader symmetry breaking predicates for them.
 
+		The formula is encoded as a colored graph: every term has a root node colored by its sort, every symbol has a
+		symbol node (uninterpreted symbols share a color per sort, interpreted ones get a unique color), and the
+		arguments of non-commutative terms are ordered by a chain of argument nodes. The automorphisms of the graph
+		found by bliss are symmetries of the formula.
+	*/
 	class Detector {
-		
-		//for a cleaner interface (?)
+
 		typedef unsigned int GraphNode;
-		
 
 		public:
 
-			typedef std::vector<unsigned int> Cycle;
-
-			Detector(Logic&, PTRef&);
+			Detector(Logic&, PTRef formula);
 			~Detector();
-			void toDot(const std::string path);
+			void toDot(const std::string & path);
+
+			/**
+				Sets the budget of the automorphism search in seconds; non-positive means no limit.
+				The predicates of the generators found before the budget runs out are still produced.
+			*/
+			void setTimeLimit(double seconds) { timeLimit = seconds; }
+
 			void findSBPs();
-			inline PTRef getSBPs() { return sbps; }
-			static const unsigned int ARGUMENT_NODES_COLOR = 1;
-			
-			//Functor for easy permutation cycle filtering
-			class CycleFilter {
 
-				const bliss::Digraph<PTRef>* graph;
-				Logic& logic;
+			/**
+				Returns the conjunction of the symmetry breaking predicates, or true if there are none.
+				Only valid after findSBPs().
+			*/
+			PTRef getSBPs() const { return sbps; }
+			unsigned int getNumberOfGenerators() const { return numGenerators; }
+			bool isSearchAborted() const { return searchAborted; }
 
-				public:
-					CycleFilter(const bliss::Digraph<PTRef>* g, Logic& l):
-						graph(g), logic(l) {}
+			static const unsigned int ARGUMENT_NODES_COLOR = 1;
 
-					bool operator()(const Cycle&);
-			}; 
+			// Maximal number of variable pairs compared in the lex-leader predicate of a single generator
+			static const unsigned int MAX_LEX_LEADER_PAIRS = 64;
 
 		private:
-			
+
 			class GraphCache {
 				public:
-					std::map<std::string, GraphNode> symbolNodes;
-					std::map<PTRef, GraphNode> rootNodes;
-					std::map<std::pair<PTRef, PTRef>, GraphNode> argumentNodes;
-					
-					std::map<std::string, unsigned int> symbolSortColors;
-					std::map<std::string, unsigned int> rootSortColors;
+					std::unordered_map<SymRef, GraphNode, SymRefHash> symbolNodes;
+					std::unordered_map<PTRef, GraphNode, PTRefHash> rootNodes;
+
+					// Colors of uninterpreted constants and of uninterpreted function symbols are kept apart
+					std::unordered_map<SRef, unsigned int, SRefHash> symbolSortColors;
+					std::unordered_map<SRef, unsigned int, SRefHash> functionSortColors;
+					std::unordered_map<SRef, unsigned int, SRefHash> rootSortColors;
 			};
-			friend class GraphCache; //do I really need this?
 
 			unsigned int nextColor;
-			bliss::Digraph<PTRef>* graph;
-			PTRef& term;
+			std::unique_ptr<bliss::Digraph<PTRef>> graph;
 			Logic& logic;
 			GraphCache cache;
+			// The term represented by a root node, PTRef_Undef for symbol and argument nodes
+			std::vector<PTRef> vertexTerms;
+			// For every generator the pairs of Boolean terms (p, q) of its lex-leader predicate, in vertex order
+			std::vector<std::vector<std::pair<PTRef, PTRef>>> lexLeaderPairs;
+			double timeLimit;
+			unsigned int numGenerators;
+			bool searchAborted;
 			PTRef sbps;
-			
-			GraphNode addSymbolNode(const PTRef&);
-			GraphNode addRootNode(const PTRef&);
-			GraphNode addArgumentNode(const PTRef& term, const PTRef& parent);
-			
-			//TODO: shouldn't this be moved to Pterm.h/c?			
-			bool commutes(const PTRef&);
 
+			GraphNode addVertex(unsigned int color, PTRef term);
+			GraphNode addSymbolNode(PTRef term);
+			GraphNode addRootNode(PTRef term);
+			GraphNode addArgumentNode(PTRef term);
+			unsigned int getSortColor(std::unordered_map<SRef, unsigned int, SRefHash> & colors, SRef sort);
+			bool isUninterpreted(PTRef term) const;
+
+			//TODO: shouldn't this be moved to Pterm.h/c?
+			bool commutes(PTRef term) const;
+
+			void addGenerator(unsigned int n, const unsigned int* aut);
 			static void computeSBPs(void*, unsigned int, const unsigned int*);
 
 	};
@@ -60,6 +60,9 @@ AbstractGraph::AbstractGraph()
   opt_use_failure_recording = true;
   /* Default value for using component recursion */
   opt_use_comprec = true;
+  /* No time limit by default */
+  opt_time_limit = 0;
+  aborted = false;
 
 
   verbose_level = 0;
@@ -636,6 +639,7 @@ AbstractGraph::search(const bool canonical, Stats& stats)
   stats.reset();
   stats.nof_nodes = 1;
   stats.nof_leaf_nodes = 1;
+  aborted = false;
 
   /* Free old first path data structures */
   if(first_path_labeling) {
@@ -832,8 +836,20 @@ AbstractGraph::search(const bool canonical, Stats& stats)
   /*
    * The actual backtracking search
    */
+  unsigned int nodes_until_time_check = 0;
   while(!search_stack.empty()) 
     {
+      /* Stop the search if the time limit has been reached */
+      if(opt_time_limit > 0 and nodes_until_time_check-- == 0)
+	{
+	  if(timer1.get_duration() > opt_time_limit)
+	    {
+	      aborted = true;
+	      break;
+	    }
+	  nodes_until_time_check = 256;
+	}
+
       TreeNode&          current_node  = search_stack.back();
       const unsigned int current_level = (unsigned int)search_stack.size()-1;
 
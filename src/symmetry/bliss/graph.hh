@@ -184,6 +184,11 @@ protected:
    * Is the long prune method in use?
    */
   bool opt_use_long_prune;
+
+  /* The time limit of a search in seconds, non-positive for no limit */
+  double opt_time_limit;
+  /* Was the last search stopped by the time limit? */
+  bool aborted;
   /**\internal
    * Maximum amount of memory (in megabytes) available for
    * the long prune method
@@ -397,6 +402,19 @@ public:
    */
   void set_component_recursion(const bool active) {assert(!in_search); opt_use_comprec = active;}
 
+  /** Set a limit on the user+system time (in seconds) spent in a search.
+   * When the limit is reached, the search stops and only the generators
+   * found so far have been reported.
+   * May not be called during the search.
+   * \param seconds  the limit; a non-positive value means no limit
+   */
+  void set_time_limit(const double seconds) {assert(!in_search); opt_time_limit = seconds;}
+
+  /**
+   * Return true if the last search was stopped by the time limit.
+   */
+  bool search_aborted() const {return aborted;}
+
 
 
   /**
@@ -67,6 +67,7 @@ PtAsgn_reason TSolver::getDeduction() {
     if (deductions_next >= th_deductions.size_()) {
         return PtAsgn_reason_Undef;
     }
+    generalTSolverStats.deductions_sent ++;
     return th_deductions[deductions_next++];
 }
 
@@ -82,17 +83,25 @@ vec<PtAsgn> TSolver::getReasonFor(PtAsgn lit) {
     vec<PtAsgn> conflict;
     getConflict(conflict);
     popBacktrackPoint();
-#ifdef STATISTICS
     if (conflict.size() > generalTSolverStats.max_reas_size)
         generalTSolverStats.max_reas_size = conflict.size();
     if (conflict.size() < generalTSolverStats.min_reas_size)
         generalTSolverStats.min_reas_size = conflict.size();
     generalTSolverStats.reasons_sent ++;
     generalTSolverStats.avg_reas_size += conflict.size();
-#endif // STATISTICS
     return conflict;
 }
 
+void TSolver::collectStatistics(opensmt::Statistics & stats) const {
+    std::string const prefix = opensmt::Statistics::keyOf(name) + '.';
+    stats.addCounter(prefix + "sat-calls", generalTSolverStats.sat_calls);
+    stats.addCounter(prefix + "unsat-calls", generalTSolverStats.unsat_calls);
+    stats.addCounter(prefix + "conflicts-sent", generalTSolverStats.conflicts_sent);
+    stats.addCounter(prefix + "deductions-done", generalTSolverStats.deductions_done);
+    stats.addCounter(prefix + "deductions-sent", generalTSolverStats.deductions_sent);
+    stats.addCounter(prefix + "reasons-sent", generalTSolverStats.reasons_sent);
+}
+
 void TSolver::printStatistics(std::ostream & os) {
     os << "; -------------------------\n";
     os << "; STATISTICS FOR " << getName() << '\n';
@@ -33,6 +33,8 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "SolverTypes.h"
 #include "TResult.h"
 #include "MapWithKeys.h"
+#include "ResourceLimits.h"
+#include "Statistics.h"
 
 #include <unordered_set>
 
@@ -45,8 +47,8 @@ class Logic;
 class TSolverStats
 {
   public:
-    long sat_calls;
-    long unsat_calls;
+    uint64_t sat_calls;
+    uint64_t unsat_calls;
 
     TSolverStats ()
     : sat_calls         ( 0 )
@@ -95,17 +97,17 @@ class TSolverStats
 
     // Calls statistics
     // Conflict statistics
-    int   conflicts_sent;
-    float avg_conf_size;
-    int   max_conf_size;
-    int   min_conf_size;
+    uint64_t conflicts_sent;
+    float    avg_conf_size;
+    int      max_conf_size;
+    int      min_conf_size;
     // Deductions statistics
-    int   deductions_done;
-    int   deductions_sent;
-    int   reasons_sent;
-    float avg_reas_size;
-    int   max_reas_size;
-    int   min_reas_size;
+    uint64_t deductions_done;
+    uint64_t deductions_sent;
+    uint64_t reasons_sent;
+    float    avg_reas_size;
+    int      max_reas_size;
+    int      min_reas_size;
 };
 
 
@@ -188,6 +190,11 @@ public:
     bool isInformed(PTRef tr) const { return informed_PTRefs.has(tr); }
 
     virtual void printStatistics(std::ostream & os);
+    // Adds the statistics of the solver, named after the solver (la-solver.sat-calls)
+    virtual void collectStatistics(opensmt::Statistics & stats) const;
+
+    // The limits polled in the long-running checks; the solver gives up a check with TRes::UNKNOWN when exhausted
+    virtual void setResourceLimits(opensmt::ResourceLimits * limits) { resourceLimits = limits; }
 protected:
     void                        setInformed(PTRef tr) { informed_PTRefs.insert(tr, true); }
     const vec<PTRef> &          getInformed() { return informed_PTRefs.getKeys(); }
@@ -195,6 +202,7 @@ protected:
     std::string                 name;             // Name of the solver
     SMTConfig &                 config;           // Reference to configuration
     vec< size_t >               backtrack_points; // Keeps track of backtrack points
+    opensmt::ResourceLimits *   resourceLimits = nullptr;
 
 private:
     MapWithKeys<PTRef,bool,PTRefHash>   informed_PTRefs;
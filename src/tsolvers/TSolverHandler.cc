@@ -66,10 +66,20 @@ void TSolverHandler::informNewSplit(PTRef tr)
     }
 }
 
+void TSolverHandler::setSolverSchedule(vec<TSolver*> && schedule) {
+    solverSchedule = std::move(schedule);
+    checkPhases.clear();
+    for (auto solver : solverSchedule) {
+        checkPhases.push_back(config.getPhaseTimer().getPhase("theory-" + opensmt::Statistics::keyOf(solver->getName())));
+    }
+}
+
 TRes TSolverHandler::check(bool complete)
 {
     TRes res_final = TRes::SAT;
-    for (auto solver : solverSchedule) {
+    for (int i = 0; i < solverSchedule.size(); ++i) {
+        TSolver * solver = solverSchedule[i];
+        opensmt::PhaseTimer::Scope scope(config.getPhaseTimer(), checkPhases[i], opensmt::PhaseTimer::Detail::Fine);
         TRes res = solver->check(complete);
         if (res == TRes::UNSAT) {
             return TRes::UNSAT;
@@ -79,6 +89,18 @@ TRes TSolverHandler::check(bool complete)
     return res_final;
 }
 
+void TSolverHandler::setResourceLimits(opensmt::ResourceLimits * limits) {
+    for (auto solver : solverSchedule) {
+        solver->setResourceLimits(limits);
+    }
+}
+
+void TSolverHandler::collectStatistics(opensmt::Statistics & stats) const {
+    for (auto solver : solverSchedule) {
+        solver->collectStatistics(stats);
+    }
+}
+
 vec<PTRef> TSolverHandler::getSplitClauses() {
     vec<PTRef> split_terms;
     for (auto solver : solverSchedule) {
@@ -43,10 +43,11 @@ class TSolverHandler
 {
     friend THandler;
     vec<TSolver*>  solverSchedule;
+    std::vector<opensmt::PhaseTimer::PhaseId> checkPhases; // The phase of the checks of each solver of the schedule
 protected:
     SMTConfig     &config;
     TSolverHandler(SMTConfig & c) : config(c) { }
-    void setSolverSchedule(vec<TSolver*> && schedule) { solverSchedule = std::move(schedule); }
+    void setSolverSchedule(vec<TSolver*> && schedule);
 public:
     using ItpColorMap = std::map<PTRef, icolor_t>;
 
@@ -66,6 +67,8 @@ public:
     virtual TRes    check(bool);
     virtual vec<PTRef> getSplitClauses();
     virtual void fillTheoryFunctions(ModelBuilder & modelBuilder) const;
+    void setResourceLimits(opensmt::ResourceLimits * limits);
+    void collectStatistics(opensmt::Statistics & stats) const;
 private:
     // Helper method for computing reasons
     TSolver* getReasoningSolverFor(PTRef ptref) const;
@@ -32,7 +32,7 @@ lbool UFLATHandler::getPolaritySuggestion(PTRef pt) const {
 
 TRes UFLATHandler::check(bool full) {
     auto res = TSolverHandler::check(full);
-    if (full and res == TRes::SAT and not lasolver->hasNewSplits() and (not arraySolver or not arraySolver->hasNewSplits())) {
+    if (full and res == TRes::SAT and not ufsolver->hasNewSplits() and not lasolver->hasNewSplits() and (not arraySolver or not arraySolver->hasNewSplits())) {
         equalitiesToPropagate = ufsolver->collectEqualitiesFor(interfaceVars, knownEqualities);
         // MB: Only collect equalities from LASolver if there are none from UF solver.
         //  This prevents duplication of equalities
@@ -71,8 +71,12 @@ namespace {
 }
 
 vec<PTRef> UFLATHandler::getSplitClauses() {
-    assert(not ufsolver->hasNewSplits());
     vec<PTRef> res;
+    // The only splits of the UF solver are Ackermann lemmas over uninterpreted sorts; these need no interface clauses
+    if (ufsolver->hasNewSplits()) {
+        ufsolver->getNewSplits(res);
+        return res;
+    }
     if (lasolver->hasNewSplits()) {
         lasolver->getNewSplits(res);
         return res;
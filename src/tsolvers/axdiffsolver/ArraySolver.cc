@@ -9,6 +9,7 @@
 
 #include "TreeOps.h"
 
+#include <algorithm>
 #include <numeric>
 
 static SolverDescr descr_ax_solver("Array Solver", "Solver for Theory of Arrays");
@@ -28,57 +29,79 @@ bool ArraySolver::assertLit(PtAsgn literal) {
     if (logic.isEquality(literal.tr)) {
         setPolarity(literal.tr, literal.sgn);
         assertedLiterals.push(literal);
-        if (literal.sgn == l_True) { // Strong equivalence context has changed -> reset
-            clear();
-        } else if (literal.sgn == l_False) {
-            // For asserted disequality check current read-over-weak-eq lemmas to see if any is now completely falsified
-            for (auto & lemma : lemmas) {
-                auto & undecided = lemma.undecidedEqualities;
-                auto it = undecided.find(literal.tr);
-                if (it != undecided.end()) {
-                    undecided.erase(it);
-                }
-                if (undecided.empty()) {
-                    has_explanation = true;
-                    computeExplanation(lemma.equality);
-                    return false;
-                }
+        // Asserted equality changes the WE-graph only if Egraph merged some classes; this is detected in check
+        if (literal.sgn == l_False) {
+            // For asserted disequality check the read-over-weak-eq lemmas it occurs in to see if any is now completely falsified
+            PTRef violated = updateFalsifiedConditions(literal.tr, 1);
+            if (violated != PTRef_Undef and isGraphCurrent()) {
+                computeExplanation(violated);
+                return false;
             }
         }
     }
     return true;
 }
 
+/*
+ * Update the number of falsified conditions of the lemmas in which the given equality occurs.
+ * Returns the equality of a lemma that is violated after the update, or PTRef_Undef if there is none.
+ */
+PTRef ArraySolver::updateFalsifiedConditions(PTRef equality, int change) {
+    auto it = lemmasOfCondition.find(equality);
+    if (it == lemmasOfCondition.end()) { return PTRef_Undef; }
+    PTRef violated = PTRef_Undef;
+    for (unsigned lemmaIndex : it->second) {
+        auto & lemma = lemmas[lemmaIndex];
+        lemma.falsified += change;
+        assert(lemma.falsified <= lemma.conditions.size());
+        if (violated == PTRef_Undef and lemma.isViolated()) {
+            violated = lemma.equality;
+        }
+    }
+    return violated;
+}
+
 void ArraySolver::pushBacktrackPoint() {
     backtrack_points.push(assertedLiterals.size_());
+    graphBacktrackPoints.push_back({nodesTrail.size(), classesTrail.size(), edges.size(), mergesProcessed, arraysInserted, storesInserted});
     TSolver::pushBacktrackPoint();
 }
 
 void ArraySolver::popBacktrackPoint() {
-    clear();
+    has_explanation = false;
+    explanation.clear();
     assert(backtrack_points.size() > 0);
     auto lastSize = backtrack_points.last();
     backtrack_points.pop();
     while (assertedLiterals.size_() > lastSize) {
         auto lit = assertedLiterals.last();
         assertedLiterals.pop();
+        if (lit.sgn == l_False) {
+            updateFalsifiedConditions(lit.tr, -1);
+        }
         clearPolarity(lit.tr);
     }
+    assert(not graphBacktrackPoints.empty());
+    backtrackWeakEq(graphBacktrackPoints.back());
+    graphBacktrackPoints.pop_back();
 
     TSolver::popBacktrackPoint();
 }
 
 void ArraySolver::popBacktrackPoints(unsigned int i) {
-    clear();
     TSolver::popBacktrackPoints(i);
 }
 
 TRes ArraySolver::check(bool complete) {
-    if (not valid) {
-        buildWeakEq();
+    if (not isGraphCurrent()) {
+        updateWeakEq();
+        clearLemmas();
+        collectLemmaConditions();
+        valid = true;
+        builtForMergeStamp = egraph.getMergeStamp();
     }
     for (auto const & lemma : lemmas) {
-        if (lemma.undecidedEqualities.empty()) {
+        if (lemma.isViolated()) {
             has_explanation = true;
             computeExplanation(lemma.equality);
             return TRes::UNSAT;
@@ -131,28 +154,41 @@ void ArraySolver::declareAtom(PTRef tr) {
         ArraySolver::Terms & arrayTerms;
         ArraySolver::Terms & storeTerms;
         ArraySolver::Terms & selectTerms;
+        std::unordered_set<ERef, ERefHash> & knownTerms;
         Egraph const & egraph;
 
     public:
-        TermCollectorConfig(Logic const & logic, Terms & arrayTerms, Terms & storeTerms, Terms & selectTerms, Egraph const & egraph)
-        : logic(logic), arrayTerms(arrayTerms), storeTerms(storeTerms), selectTerms(selectTerms), egraph(egraph) {}
+        TermCollectorConfig(Logic const & logic, Terms & arrayTerms, Terms & storeTerms, Terms & selectTerms,
+                            std::unordered_set<ERef, ERefHash> & knownTerms, Egraph const & egraph)
+        : logic(logic), arrayTerms(arrayTerms), storeTerms(storeTerms), selectTerms(selectTerms), knownTerms(knownTerms), egraph(egraph) {}
 
         void visit(PTRef term) override {
             if (logic.isArraySort(logic.getSortRef(term))) {
                 ERef eref = egraph.termToERef(term);
-                arrayTerms.insert(eref);
+                if (not knownTerms.insert(eref).second) { return; }
+                arrayTerms.push(eref);
                 if (logic.isArrayStore(term)) {
-                    storeTerms.insert(eref);
+                    storeTerms.push(eref);
                 }
             } else if (logic.isArraySelect(term)) {
                 ERef eref = egraph.termToERef(term);
-                selectTerms.insert(eref);
+                if (not knownTerms.insert(eref).second) { return; }
+                selectTerms.push(eref);
             }
         }
     };
 
-    TermCollectorConfig config(logic, arrayTerms, storeTerms, selectTerms, egraph);
+    auto const knownTermsCount = knownTerms.size();
+    TermCollectorConfig config(logic, arrayTerms, storeTerms, selectTerms, knownTerms, egraph);
     TermVisitor<TermCollectorConfig>(logic, config).visit(tr);
+    if (knownTerms.size() != knownTermsCount) {
+        // New terms are inserted into the WE-graph and their lemmas computed in the next check
+        valid = false;
+        for (unsigned int i = nodes.size(); i < static_cast<unsigned int>(arrayTerms.size()); ++i) {
+            nodesMap.insert({arrayTerms[i], NodeRef{i}});
+            nodes.emplace_back(arrayTerms[i]);
+        }
+    }
 
     if (logic.isEquality(tr)) {
         setInformed(tr);
@@ -178,97 +214,251 @@ void ArraySolver::getNewSplits(vec<PTRef> & splits) {
  */
 
 void ArraySolver::makeIndexedWeakRepresentative(NodeRef nodeRef) {
-    ArrayNode & node = getNode(nodeRef);
-    NodeRef secondaryRef = node.secondaryEdge;
+    NodeRef secondaryRef = getNode(nodeRef).secondaryEdge;
     if (secondaryRef != NodeRef_Undef) {
-        if (getRoot(getIndexOfPrimaryEdge(secondaryRef)) != getRoot(getIndexOfPrimaryEdge(nodeRef))) {
-            node.secondaryEdge = getNode(secondaryRef).primaryEdge;
+        if (getIndexClassOfPrimaryEdge(secondaryRef) != getIndexClassOfPrimaryEdge(nodeRef)) {
+            modifyNode(nodeRef).secondaryEdge = getNode(secondaryRef).primaryEdge;
             makeIndexedWeakRepresentative(nodeRef);
         } else {
             makeIndexedWeakRepresentative(secondaryRef);
             // invert secondary edge
-            getNode(secondaryRef).secondaryEdge = nodeRef;
-            getNode(secondaryRef).secondaryStore = node.secondaryStore;
+            ArrayNode & secondaryNode = modifyNode(secondaryRef);
+            secondaryNode.secondaryEdge = nodeRef;
+            secondaryNode.secondaryCause = getNode(nodeRef).secondaryCause;
+            ArrayNode & node = modifyNode(nodeRef);
             node.secondaryEdge = NodeRef_Undef;
-            node.secondaryStore = ERef_Undef;
+            node.secondaryCause = EdgeRef_Undef;
         }
     }
 }
 
 void ArraySolver::makeWeakRepresentative(NodeRef nodeRef) {
-    ArrayNode & node = getNode(nodeRef);
-    NodeRef parentRef = node.primaryEdge;
+    NodeRef parentRef = getNode(nodeRef).primaryEdge;
     if (parentRef != NodeRef_Undef) {
         makeWeakRepresentative(parentRef);
         // Invert primary edge
-        getNode(parentRef).primaryEdge = nodeRef;
-        getNode(parentRef).primaryStore = node.primaryStore;
+        ArrayNode & parentNode = modifyNode(parentRef);
+        parentNode.primaryEdge = nodeRef;
+        parentNode.primaryCause = getNode(nodeRef).primaryCause;
         // Make representative for i-weak equivalence class
-        // Information about primary store is needed in "makeIndexedWeakRepresentative"!
+        // Information about primary edge is needed in "makeIndexedWeakRepresentative"!
         makeIndexedWeakRepresentative(nodeRef);
+        ArrayNode & node = modifyNode(nodeRef);
         node.primaryEdge = NodeRef_Undef;
-        node.primaryStore = ERef_Undef;
+        node.primaryCause = EdgeRef_Undef;
     }
 }
 
-void ArraySolver::merge(ERef storeTerm) {
-    assert(logic.isArrayStore(egraph.ERefToTerm(storeTerm)));
-    ERef arrayTerm = getArrayFromStore(storeTerm);
-    ERef indexTerm = getRoot(getIndexFromStore(storeTerm));
-    NodeRef arrayNode = getNodeRef(getRoot(arrayTerm));
-    NodeRef storeNode = getNodeRef(getRoot(storeTerm));
-    if (arrayNode == storeNode) { return; }
-    makeWeakRepresentative(arrayNode);
-    if (getRepresentative(storeNode) == arrayNode) {
-        mergeSecondary(storeNode, arrayNode, storeTerm, std::unordered_set<ERef,ERefHash>({indexTerm}));
+EdgeRef ArraySolver::addEdge(NodeRef first, NodeRef second, ERef store) {
+    EdgeRef edgeRef {static_cast<unsigned int>(edges.size())};
+    edges.push_back({first, second, store});
+    return edgeRef;
+}
+
+void ArraySolver::merge(EdgeRef edgeRef) {
+    NodeRef first = getEdge(edgeRef).first;
+    NodeRef second = getEdge(edgeRef).second;
+    ERef store = getEdge(edgeRef).store;
+    assert(first != second);
+    makeWeakRepresentative(first);
+    if (getRepresentative(second) == first) {
+        vec<ERef> forbiddenIndices;
+        if (store != ERef_Undef) {
+            forbiddenIndices.push(getRoot(getIndexFromStore(store)));
+        }
+        mergeSecondary(second, first, edgeRef, forbiddenIndices);
     } else {
         // new primary edge
-        getNode(arrayNode).primaryEdge = storeNode;
-        getNode(arrayNode).primaryStore = storeTerm;
+        ArrayNode & node = modifyNode(first);
+        node.primaryEdge = second;
+        node.primaryCause = edgeRef;
     }
 }
 
-void ArraySolver::mergeSecondary(NodeRef nodeRef, NodeRef root, ERef store, std::unordered_set<ERef,ERefHash> && forbiddenIndices) {
+void ArraySolver::mergeSecondary(NodeRef nodeRef, NodeRef root, EdgeRef edge, vec<ERef> & forbiddenIndices) {
     if (nodeRef == root) { return; }
-    ArrayNode & node = getNode(nodeRef);
-    ERef primaryIndex = getRoot(getIndexOfPrimaryEdge(nodeRef));
-    assert(getRoot(primaryIndex) == primaryIndex);
-    if (forbiddenIndices.find(primaryIndex) == forbiddenIndices.end() and getIndexedRepresentative(nodeRef, primaryIndex) != root) {
-        makeIndexedWeakRepresentative(nodeRef);
-        node.secondaryEdge = root;
-        node.secondaryStore = store;
+    ERef primaryIndex = getIndexClassOfPrimaryEdge(nodeRef);
+    // Strong primary edge does not separate any i-weak equivalence classes
+    if (primaryIndex != ERef_Undef) {
+        assert(getRoot(primaryIndex) == primaryIndex);
+        bool forbidden = std::find(forbiddenIndices.begin(), forbiddenIndices.end(), primaryIndex) != forbiddenIndices.end();
+        if (not forbidden) {
+            if (getIndexedRepresentative(nodeRef, primaryIndex) != root) {
+                makeIndexedWeakRepresentative(nodeRef);
+                ArrayNode & node = modifyNode(nodeRef);
+                node.secondaryEdge = root;
+                node.secondaryCause = edge;
+            }
+            forbiddenIndices.push(primaryIndex);
+        }
     }
-    forbiddenIndices.insert(primaryIndex);
-    mergeSecondary(node.primaryEdge, root, store, std::move(forbiddenIndices));
+    mergeSecondary(getNode(nodeRef).primaryEdge, root, edge, forbiddenIndices);
 }
 
 /*
- * Build the WE-graph for current context and compute read-over-weak-eq lemmas that need to be valid.
+ * Bring the WE-graph up to date with the merges of Egraph and the declared terms.
+ *
+ * Merge of two classes of arrays inserts a strong edge between them, new store term inserts its weak edge.
+ * Merge of two classes that both contain store indices joins the i-weak equivalence classes of the two indices. Their
+ * secondary edges are dropped before inserting the new edges (leaving the graph valid for the new partition with fewer
+ * edges) and rebuilt for all the edges afterwards.
  */
-void ArraySolver::buildWeakEq() {
-    assert(not valid);
-    assert(nodes.empty() and rootsMap.empty() and lemmas.empty());
-    for (ERef arrayTerm : arrayTerms) {
-        ERef root = getRoot(arrayTerm);
-        if (rootsMap.find(root) == rootsMap.end()) {
-            NodeRef nodeRef {static_cast<unsigned int>(nodes.size())};
-            nodes.emplace_back(root);
-            rootsMap.insert({root, nodeRef});
+void ArraySolver::updateWeakEq() {
+    std::vector<std::pair<NodeRef, NodeRef>> strongEdges;
+    std::unordered_set<ERef, ERefHash> mergedIndices;
+    for (; mergesProcessed < egraph.getMergesCount(); ++mergesProcessed) {
+        auto const & egraphMerge = egraph.getMerge(mergesProcessed);
+        ClassInfo mergedInfo = getClassInfo(egraphMerge.merged);
+        if (mergedInfo.node == NodeRef_Undef and not mergedInfo.hasStoreIndex) { continue; }
+        ClassInfo rootInfo = getClassInfo(egraphMerge.root);
+        if (rootInfo.node != NodeRef_Undef and mergedInfo.node != NodeRef_Undef) {
+            strongEdges.emplace_back(rootInfo.node, mergedInfo.node);
+        }
+        if (rootInfo.hasStoreIndex and mergedInfo.hasStoreIndex) {
+            mergedIndices.insert(getRoot(egraphMerge.root));
+        }
+        setClassInfo(egraphMerge.root, {rootInfo.node != NodeRef_Undef ? rootInfo.node : mergedInfo.node,
+                                  rootInfo.hasStoreIndex or mergedInfo.hasStoreIndex});
+    }
+    for (; arraysInserted < static_cast<unsigned int>(arrayTerms.size()); ++arraysInserted) {
+        ERef array = arrayTerms[arraysInserted];
+        ERef root = getRoot(array);
+        ClassInfo info = getClassInfo(root);
+        if (info.node != NodeRef_Undef) {
+            strongEdges.emplace_back(info.node, getNodeRef(array));
+        } else {
+            setClassInfo(root, {getNodeRef(array), info.hasStoreIndex});
         }
     }
-    for (ERef store : storeTerms) {
-        merge(store);
+    unsigned int const storesInsertedBefore = storesInserted;
+    for (; storesInserted < static_cast<unsigned int>(storeTerms.size()); ++storesInserted) {
+        ERef root = getRoot(getIndexFromStore(storeTerms[storesInserted]));
+        ClassInfo info = getClassInfo(root);
+        if (not info.hasStoreIndex) {
+            setClassInfo(root, {info.node, true});
+        }
+    }
+
+    if (not mergedIndices.empty()) {
+        for (unsigned int i = 0; i < nodes.size(); ++i) {
+            NodeRef nodeRef {i};
+            if (getNode(nodeRef).secondaryEdge != NodeRef_Undef and mergedIndices.count(getIndexClassOfPrimaryEdge(nodeRef)) > 0) {
+                ArrayNode & node = modifyNode(nodeRef);
+                node.secondaryEdge = NodeRef_Undef;
+                node.secondaryCause = EdgeRef_Undef;
+            }
+        }
+    }
+    for (auto [first, second] : strongEdges) {
+        merge(addEdge(first, second, ERef_Undef));
+    }
+    for (unsigned int i = storesInsertedBefore; i < storesInserted; ++i) {
+        ERef store = storeTerms[i];
+        merge(addEdge(getNodeRef(getArrayFromStore(store)), getNodeRef(store), store));
+    }
+    for (ERef index : mergedIndices) {
+        rebuildSecondaryEdges(index);
     }
-    lemmas = collectLemmaConditions(logic);
-    valid = true;
+}
+
+/*
+ * Rebuild the secondary edges for the given index.
+ *
+ * The primary edges labeled by the index cut the weak equivalence classes into regions, the i-weak equivalence
+ * classes are the regions connected by the other edges. In every i-weak equivalence class the region of the weak
+ * representative, or any region if there is none, becomes the representative. The secondary edges then point from
+ * the top of every other region to a node in the region closer to the representative.
+ */
+void ArraySolver::rebuildSecondaryEdges(ERef index) {
+    assert(getRoot(index) == index);
+    Traversal traversal(*this);
+    std::vector<NodeRef> regions(nodes.size());
+    for (unsigned int i = 0; i < nodes.size(); ++i) {
+        regions[i] = traversal.findSecondaryNode(NodeRef{i}, index);
+        ArrayNode const & node = getNode(NodeRef{i});
+        if (node.secondaryEdge != NodeRef_Undef and getIndexClassOfPrimaryEdge(NodeRef{i}) == index) {
+            ArrayNode & top = modifyNode(NodeRef{i});
+            top.secondaryEdge = NodeRef_Undef;
+            top.secondaryCause = EdgeRef_Undef;
+        }
+    }
+    struct Crossing {
+        EdgeRef edge;
+        NodeRef here;
+        NodeRef there;
+    };
+    // For the top of every region the edges leaving the region
+    std::vector<std::vector<Crossing>> crossings(nodes.size());
+    for (unsigned int i = 0; i < edges.size(); ++i) {
+        ArrayEdge const & edge = edges[i];
+        if (edge.store != ERef_Undef and getRoot(getIndexFromStore(edge.store)) == index) { continue; }
+        NodeRef firstRegion = regions[edge.first.id];
+        NodeRef secondRegion = regions[edge.second.id];
+        if (firstRegion == secondRegion) { continue; }
+        crossings[firstRegion.id].push_back({EdgeRef{i}, edge.first, edge.second});
+        crossings[secondRegion.id].push_back({EdgeRef{i}, edge.second, edge.first});
+    }
+    std::vector<bool> reached(nodes.size(), false);
+    std::vector<NodeRef> queue;
+    auto connectClass = [&](NodeRef representative) {
+        reached[representative.id] = true;
+        queue.push_back(representative);
+        while (not queue.empty()) {
+            NodeRef region = queue.back();
+            queue.pop_back();
+            for (Crossing const & crossing : crossings[region.id]) {
+                NodeRef other = regions[crossing.there.id];
+                if (reached[other.id]) { continue; }
+                reached[other.id] = true;
+                ArrayNode & top = modifyNode(other);
+                top.secondaryEdge = crossing.here;
+                top.secondaryCause = crossing.edge;
+                queue.push_back(other);
+            }
+        }
+    };
+    for (unsigned int i = 0; i < nodes.size(); ++i) {
+        if (getNode(NodeRef{i}).primaryEdge == NodeRef_Undef) {
+            connectClass(NodeRef{i});
+        }
+    }
+    for (unsigned int i = 0; i < nodes.size(); ++i) {
+        if (regions[i].id == i and not reached[i]) {
+            connectClass(NodeRef{i});
+        }
+    }
+}
+
+/*
+ * Undo the changes of the WE-graph since the given backtrack point.
+ */
+void ArraySolver::backtrackWeakEq(GraphBacktrackPoint const & point) {
+    bool changed = nodesTrail.size() > point.nodesTrailSize or classesTrail.size() > point.classesTrailSize
+        or edges.size() > point.edgesSize;
+    while (nodesTrail.size() > point.nodesTrailSize) {
+        auto const & [nodeRef, node] = nodesTrail.back();
+        nodes[nodeRef.id] = node;
+        nodesTrail.pop_back();
+    }
+    while (classesTrail.size() > point.classesTrailSize) {
+        auto const & [root, info] = classesTrail.back();
+        classes[root] = info;
+        classesTrail.pop_back();
+    }
+    edges.resize(point.edgesSize);
+    mergesProcessed = point.mergesProcessed;
+    arraysInserted = point.arraysInserted;
+    storesInserted = point.storesInserted;
+    if (changed) { valid = false; }
 }
 
 void ArraySolver::computeSelectsInfo() {
+    selectsInfo.resize(nodes.size());
     for (ERef select : selectTerms) {
         ERef index = getRoot(getIndexFromSelect(select));
-        NodeRef arrayNode = getNodeRef(getRoot(getArrayFromSelect(select)));
+        NodeRef arrayNode = getNodeRef(getArrayFromSelect(select));
         NodeRef weakIRepresentative = getIndexedRepresentative(arrayNode, index);
-        selectsInfo[weakIRepresentative].insert({index, select});
+        selectsInfo[weakIRepresentative.id].insert({index, select});
     }
 }
 
@@ -312,24 +502,26 @@ struct ExtensionalityInfoHash {
 TRes ArraySolver::checkExtensionality() {
     if (selectsInfo.empty()) { computeSelectsInfo(); }
 
-    std::unordered_map<NodeRef, ExtensionalityInfo, NodeRefHash> extensionalityInfos;
+    // Extensionality info of the nodes, indexed by NodeRef
+    std::vector<ExtensionalityInfo> extensionalityInfos(nodes.size());
+    std::vector<bool> computed(nodes.size(), false);
     std::unordered_map<ExtensionalityInfo, NodeRef, ExtensionalityInfoHash> inverseExtensionalityInfos;
     vec<opensmt::pair<NodeRef, NodeRef>> equalitiesToPropagate;
 
     vec<NodeRef> queue;
-    queue.capacity(rootsMap.size());
-    for (auto const & entry : rootsMap) {
-        queue.push(entry.second);
+    queue.capacity(nodes.size());
+    for (unsigned int i = 0; i < nodes.size(); ++i) {
+        queue.push(NodeRef{i});
     }
 
     while (queue.size() > 0) {
         NodeRef const current = queue.last();
-        if (extensionalityInfos.find(current) != extensionalityInfos.end()) {
+        if (computed[current.id]) {
             queue.pop();
             continue;
         }
         ArrayNode const & node = getNode(current);
-        if (node.primaryEdge != NodeRef_Undef and extensionalityInfos.find(node.primaryEdge) == extensionalityInfos.end()) {
+        if (node.primaryEdge != NodeRef_Undef and not computed[node.primaryEdge.id]) {
             queue.push(node.primaryEdge);
             continue;
         }
@@ -338,24 +530,19 @@ TRes ArraySolver::checkExtensionality() {
         NodeRef const weakEqRoot = getRepresentative(current);
         if (current == weakEqRoot) { // Root of weak-eq class
             extensionalityInfo.weakEqRoot = current;
-            auto it = selectsInfo.find(current);
-            if (it != selectsInfo.end()) {
-                auto const & selects = it->second;
-                for (auto && [index, value] : selects) {
-                    extensionalityInfo.indexValueMap.insert({index, getRoot(value)});
-                }
+            for (auto && [index, value] : selectsInfo[current.id]) {
+                extensionalityInfo.indexValueMap.insert({index, getRoot(value)});
             }
         } else { // not weak-eq root
-            ERef primaryIndex = getRoot(getIndexFromStore(node.primaryStore));
-            assert(extensionalityInfos.find(node.primaryEdge) != extensionalityInfos.end());
-            // Select are the same as primary parent, except possibly at primary index
-            extensionalityInfo = extensionalityInfos.at(node.primaryEdge);
-            extensionalityInfo.erase(primaryIndex);
-
-            NodeRef weakIRoot = getIndexedRepresentative(current, primaryIndex);
-            auto selectsInfoIt = selectsInfo.find(weakIRoot);
-            if (selectsInfoIt != selectsInfo.end()) {
-                auto const & weakIRootSelects = selectsInfoIt->second;
+            ERef primaryIndex = getIndexClassOfPrimaryEdge(current);
+            assert(computed[node.primaryEdge.id]);
+            // Select are the same as primary parent, except possibly at primary index (none for strong edge)
+            extensionalityInfo = extensionalityInfos[node.primaryEdge.id];
+            if (primaryIndex != ERef_Undef) {
+                extensionalityInfo.erase(primaryIndex);
+
+                NodeRef weakIRoot = getIndexedRepresentative(current, primaryIndex);
+                auto const & weakIRootSelects = selectsInfo[weakIRoot.id];
                 auto it = weakIRootSelects.find(primaryIndex);
                 if (it != weakIRootSelects.end()) {
                     ERef valueAtPrimaryIndex = getRoot(it->second);
@@ -363,19 +550,20 @@ TRes ArraySolver::checkExtensionality() {
                 } else {
                     extensionalityInfo.weakIRoots.insert({primaryIndex, weakIRoot});
                 }
-            } else {
-                extensionalityInfo.weakIRoots.insert({primaryIndex, weakIRoot});
             }
         }
 
         auto it = inverseExtensionalityInfos.find(extensionalityInfo);
         if (it != inverseExtensionalityInfos.end()) {
-            equalitiesToPropagate.push({current, it->second});
+            if (getRoot(node.term) != getRoot(getNode(it->second).term)) { // Arrays equal in Egraph need no lemma
+                equalitiesToPropagate.push({current, it->second});
+            }
             it->second = current;
         } else {
             inverseExtensionalityInfos.insert({extensionalityInfo, current});
         }
-        extensionalityInfos.insert({current, std::move(extensionalityInfo)});
+        extensionalityInfos[current.id] = std::move(extensionalityInfo);
+        computed[current.id] = true;
     }
 
     for (auto const & entry : equalitiesToPropagate) {
@@ -413,8 +601,8 @@ PTRef ArraySolver::computeExtensionalityClause(NodeRef n1, NodeRef n2) {
     Traversal traversal(*this);
     ExplanationCollection explanationCollection;
     IndicesCollection indicesCollection;
-    ExplanationCursor source(traversal, n1, getNode(n1).term);
-    ExplanationCursor destination(traversal, n2, getNode(n2).term);
+    ExplanationCursor source(traversal, n1);
+    ExplanationCursor destination(traversal, n2);
     source.collectPrimaries(destination, indicesCollection, explanationCollection);
     for (ERef index : indicesCollection) {
         explainWeakCongruencePath(explanationCollection, n1, n2, index);
@@ -437,14 +625,21 @@ PTRef ArraySolver::computeExtensionalityClause(NodeRef n1, NodeRef n2) {
  * Somewhat naive way how to compute all read-over-weak-eq lemmas for current WE-graph.
  *
  * Every pair of selects with weakly-equivalent array terms needs a corresponding lemma.
+ * The lemmas are indexed by their conditions, so that a lemma violated by an asserted disequality is found directly.
  */
-std::vector<ArraySolver::LemmaConditions> ArraySolver::collectLemmaConditions(Logic & logic) const {
+void ArraySolver::collectLemmaConditions() {
     std::unordered_map<ERef, vec<ERef>, ERefHash> indicesToSelects;
     for (ERef select : selectTerms) {
         ERef root = getRoot(getIndexFromSelect(select));
         indicesToSelects[root].push(select);
     }
-    std::vector<LemmaConditions> newLemmas;
+    auto addCondition = [this](std::vector<PTRef> & conditions, unsigned & falsified, PTRef equality) {
+        if (logic.isFalse(equality)) { return; }
+        assert(not isSatisfied(equality));
+        if (std::find(conditions.begin(), conditions.end(), equality) != conditions.end()) { return; }
+        conditions.push_back(equality);
+        if (isFalsified(equality)) { ++falsified; }
+    };
     for (auto const & [index, selects] : indicesToSelects) {
         if (selects.size() < 2) { continue; }
         // TODO: Figure out better way how to compute all candidates for lemmas
@@ -453,30 +648,27 @@ std::vector<ArraySolver::LemmaConditions> ArraySolver::collectLemmaConditions(Lo
             for (auto secondIt = selects.begin(); *secondIt != first; ++secondIt) {
                 ERef second = *secondIt;
                 if (firstRoot == getRoot(second)) { continue; } // The selects are already the same, no lemma needed
-                NodeRef arrayFirst = getNodeRef(getRoot(getArrayFromSelect(first)));
-                NodeRef arraySecond = getNodeRef(getRoot(getArrayFromSelect(second)));
+                NodeRef arrayFirst = getNodeRef(getArrayFromSelect(first));
+                NodeRef arraySecond = getNodeRef(getArrayFromSelect(second));
                 if (arrayFirst == arraySecond or getIndexedRepresentative(arrayFirst, index) == getIndexedRepresentative(arraySecond, index)) {
-                    std::unordered_set<PTRef, PTRefHash> undecidedEqualities;
+                    std::vector<PTRef> conditions;
+                    unsigned falsified = 0;
                     PTRef equalityOfSelects = getEquality(first, second, logic);
-                    if (not isFalsified(equalityOfSelects)) {
-                        assert(not isSatisfied(equalityOfSelects));
-                        undecidedEqualities.insert(equalityOfSelects);
-                    }
+                    addCondition(conditions, falsified, equalityOfSelects);
                     auto storeIndices = Traversal(*this).computeStoreIndices(arrayFirst, arraySecond, index);
                     for (ERef storeIndex : storeIndices) {
                         assert(storeIndex != index);
-                        PTRef equalityOfIndices = getEquality(index, storeIndex, logic);
-                        if (not isFalsified(equalityOfIndices)) {
-                            assert(not isSatisfied(equalityOfIndices));
-                            undecidedEqualities.insert(equalityOfIndices);
-                        }
+                        addCondition(conditions, falsified, getEquality(index, storeIndex, logic));
+                    }
+                    unsigned lemmaIndex = lemmas.size();
+                    for (PTRef condition : conditions) {
+                        lemmasOfCondition[condition].push_back(lemmaIndex);
                     }
-                    newLemmas.emplace_back(equalityOfSelects, std::move(undecidedEqualities));
+                    lemmas.emplace_back(equalityOfSelects, std::move(conditions), falsified);
                 }
             }
         }
     }
-    return newLemmas;
 }
 
 /*
@@ -553,8 +745,8 @@ ArraySolver::ExplanationCollection ArraySolver::readOverWeakEquivalenceConflict(
  */
 ArraySolver::ExplanationCollection ArraySolver::explainWeakEquivalencePath(ERef array1, ERef array2, ERef index) {
     assert(getRoot(index) == index);
-    NodeRef node1 = getNodeRef(getRoot(array1));
-    NodeRef node2 = getNodeRef(getRoot(array2));
+    NodeRef node1 = getNodeRef(array1);
+    NodeRef node2 = getNodeRef(array2);
     assert(getIndexedRepresentative(node1, index) == getIndexedRepresentative(node2, index));
 
     Traversal traversal(*this);
@@ -563,8 +755,8 @@ ArraySolver::ExplanationCollection ArraySolver::explainWeakEquivalencePath(ERef
 
     auto count1 = traversal.countSecondaryEdges(node1, index);
     auto count2 = traversal.countSecondaryEdges(node2, index);
-    ExplanationCursor cursor1(traversal, node1, array1);
-    ExplanationCursor cursor2(traversal, node2, array2);
+    ExplanationCursor cursor1(traversal, node1);
+    ExplanationCursor cursor2(traversal, node2);
     while (count1 > count2) {
         cursor1.collectOneSecondary(index, storeIndices, explanations);
         --count1;
@@ -587,12 +779,27 @@ ArraySolver::ExplanationCollection ArraySolver::explainWeakEquivalencePath(ERef
     return explanations;
 }
 
-void ArraySolver::clear() {
+void ArraySolver::clearLemmas() {
     lemmas.clear();
+    lemmasOfCondition.clear();
     selectsInfo.clear();
-    nodes.clear();
-    rootsMap.clear();
     valid = false;
+}
+
+void ArraySolver::clear() {
+    clearLemmas();
+    for (unsigned int i = 0; i < nodes.size(); ++i) {
+        nodes[i] = ArrayNode(arrayTerms[i]);
+    }
+    edges.clear();
+    classes.clear();
+    nodesTrail.clear();
+    classesTrail.clear();
+    mergesProcessed = 0;
+    arraysInserted = 0;
+    storesInserted = 0;
+    // The graph is empty at every backtrack point now
+    std::fill(graphBacktrackPoints.begin(), graphBacktrackPoints.end(), GraphBacktrackPoint{});
 
     has_explanation = false;
     explanation.clear();
@@ -609,6 +816,19 @@ void ArraySolver::recordExplanationOfEgraphEquivalence(ExplanationCollection & e
     }
 }
 
+/*
+ * Collect why the terms connected by the edge are weakly equivalent: the index of the store term for a weak edge
+ * (the real index, not its root!), the explanation of their equality in Egraph for a strong edge
+ */
+void ArraySolver::explainEdge(EdgeRef edgeRef, IndicesCollection & indices, ExplanationCollection & explanations) const {
+    ArrayEdge const & edge = getEdge(edgeRef);
+    if (edge.store != ERef_Undef) {
+        indices.insert(getIndexFromStore(edge.store));
+    } else {
+        recordExplanationOfEgraphEquivalence(explanations, getNode(edge.first).term, getNode(edge.second).term);
+    }
+}
+
 void ArraySolver::explainWeakCongruencePath(ExplanationCollection & explanationCollection, NodeRef source, NodeRef target, ERef index) {
     ERef indexRoot = getRoot(index);
     if (index != indexRoot) {
@@ -621,11 +841,8 @@ void ArraySolver::explainWeakCongruencePath(ExplanationCollection & explanationC
         explanationCollection.merge(explainWeakEquivalencePath(getNode(source).term, getNode(target).term, index));
         return;
     }
-    assert(selectsInfo.count(sourceRepresentative) > 0);
-    assert(selectsInfo.count(targetRepresentative) > 0);
-
-    ERef sourceSelect = selectsInfo.find(sourceRepresentative)->second.at(index);
-    ERef targetSelect = selectsInfo.find(targetRepresentative)->second.at(index);
+    ERef sourceSelect = selectsInfo[sourceRepresentative.id].at(index);
+    ERef targetSelect = selectsInfo[targetRepresentative.id].at(index);
 
     auto explainPathToSelect = [&](ERef select, ERef arrayTerm) {
         ERef selectArray = getArrayFromSelect(select);
@@ -648,8 +865,7 @@ unsigned int ArraySolver::Traversal::countSecondaryEdges(NodeRef start, ERef ind
     NodeRef currentRef = start;
     while (getNode(currentRef).primaryEdge != NodeRef_Undef) {
         auto const & currentNode = getNode(currentRef);
-        auto primaryIndex = getRoot(solver.getIndexOfPrimaryEdge(currentRef));
-        if (primaryIndex == index) {
+        if (getIndexClassOfPrimaryEdge(currentRef) == index) {
             if (currentNode.secondaryEdge == NodeRef_Undef) {
                 break;
             } else {
@@ -665,7 +881,7 @@ unsigned int ArraySolver::Traversal::countSecondaryEdges(NodeRef start, ERef ind
 
 NodeRef ArraySolver::Traversal::findSecondaryNode(NodeRef nodeRef, ERef index) const {
     assert(getRoot(index) == index);
-    while (getNode(nodeRef).primaryEdge != NodeRef_Undef and getRoot(getIndexOfPrimaryEdge(nodeRef)) != index) {
+    while (getNode(nodeRef).primaryEdge != NodeRef_Undef and getIndexClassOfPrimaryEdge(nodeRef) != index) {
         nodeRef = getNode(nodeRef).primaryEdge;
     }
     return nodeRef;
@@ -673,22 +889,21 @@ NodeRef ArraySolver::Traversal::findSecondaryNode(NodeRef nodeRef, ERef index) c
 
 void ArraySolver::Cursor::collectOneSecondary(IndicesCollection & indices, ERef index) {
     NodeRef secondaryNode = traversal.findSecondaryNode(currentNodeRef, index);
-    ERef store = getNode(secondaryNode).secondaryStore;
     auto & solver = traversal.getSolver();
-    ERef array = solver.getArrayFromStore(store);
-    NodeRef arrayNode = solver.getNodeRef(solver.getRoot(array));
-    NodeRef storeNode = solver.getNodeRef(solver.getRoot(store));
-    if (traversal.findSecondaryNode(arrayNode, index) == secondaryNode) {
-        collectOverPrimaries(indices, arrayNode);
-        currentNodeRef = storeNode;
-    } else if (traversal.findSecondaryNode(storeNode, index) == secondaryNode) {
-        collectOverPrimaries(indices, storeNode);
-        currentNodeRef = arrayNode;
+    ArrayEdge const & edge = solver.getEdge(getNode(secondaryNode).secondaryCause);
+    if (traversal.findSecondaryNode(edge.first, index) == secondaryNode) {
+        collectOverPrimaries(indices, edge.first);
+        currentNodeRef = edge.second;
+    } else if (traversal.findSecondaryNode(edge.second, index) == secondaryNode) {
+        collectOverPrimaries(indices, edge.second);
+        currentNodeRef = edge.first;
     } else {
         // TODO: change to assert and avoid the second check after verifying this is true
         throw std::logic_error("Unreachable!");
     }
-    indices.insert(solver.getIndexFromStore(store));
+    if (edge.store != ERef_Undef) {
+        indices.insert(solver.getIndexFromStore(edge.store));
+    }
 }
 
 unsigned int ArraySolver::Traversal::countPrimaryEdges(NodeRef start) const {
@@ -702,24 +917,28 @@ unsigned int ArraySolver::Traversal::countPrimaryEdges(NodeRef start) const {
 }
 
 void ArraySolver::Cursor::collectOverPrimaries(IndicesCollection & indices, NodeRef destination) {
+    auto collectIndex = [&](NodeRef node) {
+        ERef index = traversal.getIndexOfPrimaryEdge(node);
+        if (index != ERef_Undef) { indices.insert(index); } // Strong edges have no index
+    };
     // compute the steps to the common root
     auto steps1 = countPrimaryEdges();
     auto steps2 = Cursor(traversal.getSolver(),destination).countPrimaryEdges();
     // if one needs more step than the other, follow the primary edges until the steps equal
     while (steps1 > steps2) {
-        indices.insert(traversal.getIndexOfPrimaryEdge(currentNodeRef));
+        collectIndex(currentNodeRef);
         currentNodeRef = getNode(currentNodeRef).primaryEdge;
         steps1--;
     }
     while (steps2 > steps1) {
-        indices.insert(traversal.getIndexOfPrimaryEdge(destination));
+        collectIndex(destination);
         destination = getNode(destination).primaryEdge;
         steps2--;
     }
     // now follow the primary edge from both nodes until the common ancestor is found
     while (currentNodeRef != destination) {
-        indices.insert(traversal.getIndexOfPrimaryEdge(currentNodeRef));
-        indices.insert(traversal.getIndexOfPrimaryEdge(destination));
+        collectIndex(currentNodeRef);
+        collectIndex(destination);
         currentNodeRef = getNode(currentNodeRef).primaryEdge;
         destination = getNode(destination).primaryEdge;
     }
@@ -730,34 +949,30 @@ void ArraySolver::ExplanationCursor::collectOneSecondary(
     IndicesCollection & indices,
     ExplanationCollection & explanations) {
 
-    NodeRef secondaryRef = traversal.findSecondaryNode(currentNode.ref, index);
-    ERef secondaryStore = traversal.getNode(secondaryRef).secondaryStore;
-    assert(secondaryStore != ERef_Undef);
+    NodeRef secondaryRef = traversal.findSecondaryNode(currentNodeRef, index);
+    EdgeRef secondaryCause = traversal.getNode(secondaryRef).secondaryCause;
+    assert(secondaryCause != EdgeRef_Undef);
     auto & solver = traversal.getSolver();
-    ERef array = solver.getArrayFromStore(secondaryStore);
     // We need to find the source of the secondary edge (in the same region as this->node),
     // collect the primary path to that node, and update the cursor to the target of the secondary edge
-    NodeRef source = solver.getNodeRef(solver.getRoot(array));
-    NodeRef target = solver.getNodeRef(solver.getRoot(secondaryStore));
-    ERef sourceTerm = array;
-    ERef targetTerm = secondaryStore;
+    NodeRef source = solver.getEdge(secondaryCause).first;
+    NodeRef target = solver.getEdge(secondaryCause).second;
     if (traversal.findSecondaryNode(target, index) == secondaryRef) {
         // We got the source and target wrong, target is the node in the same region as this->node, swap
         std::swap(source, target);
-        std::swap(sourceTerm, targetTerm);
     }
     assert(traversal.findSecondaryNode(source, index) == secondaryRef);
-    ExplanationCursor cursor(traversal, source, sourceTerm);
+    ExplanationCursor cursor(traversal, source);
     collectPrimaries(cursor, indices, explanations);
-    currentNode = {target, targetTerm};
-    indices.insert(solver.getIndexFromStore(secondaryStore));
+    solver.explainEdge(secondaryCause, indices, explanations);
+    currentNodeRef = target;
 }
 
 void ArraySolver::ExplanationCursor::collectPrimaries(ExplanationCursor & destination,
                                                       IndicesCollection & indices,
                                                       ExplanationCollection & explanations) {
-    auto count1 = traversal.countPrimaryEdges(currentNode.ref);
-    auto count2 = traversal.countPrimaryEdges(destination.currentNode.ref);
+    auto count1 = traversal.countPrimaryEdges(currentNodeRef);
+    auto count2 = traversal.countPrimaryEdges(destination.currentNodeRef);
     while (count1 > count2) {
         collectOnePrimary(indices, explanations);
         --count1;
@@ -766,28 +981,14 @@ void ArraySolver::ExplanationCursor::collectPrimaries(ExplanationCursor & destin
         destination.collectOnePrimary(indices, explanations);
         --count2;
     }
-    while (currentNode.ref != destination.currentNode.ref) {
+    while (currentNodeRef != destination.currentNodeRef) {
         collectOnePrimary(indices, explanations);
         destination.collectOnePrimary(indices, explanations);
     }
-    if (currentNode.term != destination.currentNode.term) {
-        // Same array node but not same Enode
-        traversal.getSolver().recordExplanationOfEgraphEquivalence(explanations, currentNode.term, destination.currentNode.term);
-    }
 }
 
 void ArraySolver::ExplanationCursor::collectOnePrimary(IndicesCollection & indices, ExplanationCollection & explanations) {
-    auto const & solver = traversal.getSolver();
-    ERef store = traversal.getNode(currentNode.ref).primaryStore;
-    ERef source = store;
-    ERef target = solver.getArrayFromStore(store);
-    if (solver.getNodeRef(solver.getRoot(source)) != currentNode.ref) {
-        std::swap(source, target);
-    }
-    assert(solver.getNodeRef(solver.getRoot(source)) == currentNode.ref);
-    if (currentNode.term != source) {
-        solver.recordExplanationOfEgraphEquivalence(explanations, currentNode.term, source);
-    }
-    indices.insert(traversal.getSolver().getIndexFromStore(store)); // MB: This must be the real index, not its root!
-    currentNode = {traversal.getNode(currentNode.ref).primaryEdge, target};
+    ArrayNode const & node = traversal.getNode(currentNodeRef);
+    traversal.getSolver().explainEdge(node.primaryCause, indices, explanations);
+    currentNodeRef = node.primaryEdge;
 }
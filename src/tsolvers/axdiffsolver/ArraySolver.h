@@ -23,9 +23,10 @@
  *  1. Strong edges, when the terms are equal in the current context (known from Egraph)
  *  2. Weak edges that connects a `store` term with the underlying array term.
  *
- *  In fact, in the implementation, the WE-graph is re-built when the context of strong equivalence changes
- *  (new equality is asserted to Egraph). Thus, the nodes in WE-graph actually represents whole equivalence classes
- *  (not individual terms).
+ *  The WE-graph is kept over assertions and follows the merges of Egraph in place: merging two equivalence classes of
+ *  arrays inserts a strong edge between the classes, and merging two equivalence classes of store indices repairs the
+ *  secondary edges of the merged index. The changes of the graph are recorded on a trail and undone on backtracking.
+ *  The lemmas are recomputed only when the equivalence classes change, which is detected using the merge stamp of Egraph.
  *
  *  Two arrays are weakly equivalent if they are connected by a path in the WE-graph. If two arrays are weakly equivalent
  *  then they can differ only on finitely many indices. In fact, they can differ only on the indices of store terms
@@ -64,23 +65,40 @@ struct NodeRefHash {
     }
 };
 
+struct EdgeRef { unsigned int id; };
+const struct EdgeRef EdgeRef_Undef = {UINT32_MAX};
+
+inline bool operator==(EdgeRef a, EdgeRef b) { return a.id == b.id; }
+inline bool operator!=(EdgeRef a, EdgeRef b) { return a.id != b.id; }
+
 /*
  * Node in the WE-graph.
  * It remembers
- * 1. The corresponding array term (root of its equivalence class)
- * 2. Parent node following the primary edge and store term that is the cause of this edge
- * 3. Node following the secondary edge and the store term that is the cause of this edge
+ * 1. The corresponding array term
+ * 2. Parent node following the primary edge and the edge that is the cause of this primary edge
+ * 3. Node following the secondary edge and the edge that is the cause of this secondary edge
  */
 struct ArrayNode {
     ERef term {ERef_Undef};
     NodeRef primaryEdge {NodeRef_Undef};
-    ERef primaryStore {ERef_Undef};
+    EdgeRef primaryCause {EdgeRef_Undef};
     NodeRef secondaryEdge {NodeRef_Undef};
-    ERef secondaryStore {ERef_Undef};
+    EdgeRef secondaryCause {EdgeRef_Undef};
 
     explicit ArrayNode(ERef term) : term(term) {}
 };
 
+/*
+ * Edge in the WE-graph.
+ * A weak edge connects the node of the array of a store term (first) with the node of the store term (second).
+ * A strong edge connects the nodes of two array terms that are equal in Egraph; it has no store term.
+ */
+struct ArrayEdge {
+    NodeRef first;
+    NodeRef second;
+    ERef store;
+};
+
 /*
  * Class representing both the theory solver and the WE-graph (MB: This should probably be split)
  */
@@ -88,17 +106,46 @@ class ArraySolver : public TSolver {
     Logic & logic;
     Egraph & egraph; // MB: Array solver needs egraph to be able to work with the current (strong) equivalence context
 
-    using Terms = std::set<ERef>;
+    using Terms = vec<ERef>;
     Terms arrayTerms;
     Terms storeTerms;
     Terms selectTerms;
+    std::unordered_set<ERef, ERefHash> knownTerms;
 
-    // WE-graph
+    // WE-graph, with a node for every array term (in the order of arrayTerms)
     std::vector<ArrayNode> nodes;
-    std::unordered_map<ERef, NodeRef, ERefHash> rootsMap;
+    std::vector<ArrayEdge> edges;
+    std::unordered_map<ERef, NodeRef, ERefHash> nodesMap;
+
+    // What the WE-graph knows about an equivalence class of Egraph, indexed by the root of the class
+    struct ClassInfo {
+        NodeRef node = NodeRef_Undef; // The node of some array term of the class
+        bool hasStoreIndex = false; // Whether the class contains the index of some store term
+    };
+    std::unordered_map<ERef, ClassInfo, ERefHash> classes;
+
+    // The merges of Egraph and the array and store terms that are already part of the WE-graph
+    unsigned mergesProcessed = 0;
+    unsigned arraysInserted = 0;
+    unsigned storesInserted = 0;
+
+    // The changes of the WE-graph, undone on backtracking
+    std::vector<std::pair<NodeRef, ArrayNode>> nodesTrail;
+    std::vector<std::pair<ERef, ClassInfo>> classesTrail;
+
+    struct GraphBacktrackPoint {
+        std::size_t nodesTrailSize = 0;
+        std::size_t classesTrailSize = 0;
+        std::size_t edgesSize = 0;
+        unsigned mergesProcessed = 0;
+        unsigned arraysInserted = 0;
+        unsigned storesInserted = 0;
+    };
+    std::vector<GraphBacktrackPoint> graphBacktrackPoints;
 
-    // Whether or not WE-graph has been built for current context
+    // Whether or not the lemmas have been computed for the WE-graph, and for which partition of Egraph
     bool valid = false;
+    uint64_t builtForMergeStamp = 0;
 
     vec<PtAsgn> assertedLiterals;
 
@@ -165,6 +212,10 @@ private:
         ERef getIndexOfPrimaryEdge(NodeRef node) const {
             return solver.getIndexOfPrimaryEdge(node);
         }
+
+        ERef getIndexClassOfPrimaryEdge(NodeRef node) const {
+            return solver.getIndexClassOfPrimaryEdge(node);
+        }
     };
 
     /*
@@ -193,15 +244,11 @@ private:
      */
     class ExplanationCursor {
         Traversal const & traversal;
-        struct CurrentNode {
-            NodeRef ref = NodeRef_Undef;
-            ERef term = ERef_Undef;
-        };
-        CurrentNode currentNode;
+        NodeRef currentNodeRef;
     public:
-        ExplanationCursor(Traversal const & traversal, NodeRef node, ERef term) : traversal(traversal), currentNode{node, term} {}
+        ExplanationCursor(Traversal const & traversal, NodeRef node) : traversal(traversal), currentNodeRef(node) {}
 
-        NodeRef getCurrentNodeRef() const { return currentNode.ref; }
+        NodeRef getCurrentNodeRef() const { return currentNodeRef; }
 
         void collectPrimaries(ExplanationCursor & destination, IndicesCollection & indices, ExplanationCollection & explanations);
         void collectOnePrimary(IndicesCollection & indices, ExplanationCollection & explanations);
@@ -212,19 +259,34 @@ private:
      * Internal methods for building weak equivalence graph and computing lemma consequences of the graph
      */
 private:
+    /*
+     * Read-over-weak-eq lemma: the equality of two selects follows from the equalities of its index with the store
+     * indices on the weak path. The lemma is violated when all its conditions (the equality of the selects and
+     * the equalities of the indices) are false.
+     */
     struct LemmaConditions {
         PTRef equality;
-        std::unordered_set<PTRef, PTRefHash> undecidedEqualities;
+        std::vector<PTRef> conditions;
+        unsigned falsified; // Number of conditions currently asserted false
     public:
-        LemmaConditions(PTRef equality, std::unordered_set<PTRef, PTRefHash> && undecidedEqualities)
-            : equality(equality), undecidedEqualities(std::move(undecidedEqualities)) {}
+        LemmaConditions(PTRef equality, std::vector<PTRef> && conditions, unsigned falsified)
+            : equality(equality), conditions(std::move(conditions)), falsified(falsified) {}
+
+        bool isViolated() const { return falsified == conditions.size(); }
     };
 
     std::vector<LemmaConditions> lemmas;
+    // For every condition the indices of the lemmas in which it occurs
+    std::unordered_map<PTRef, std::vector<unsigned>, PTRefHash> lemmasOfCondition;
 
-    using SelectsInfo = std::unordered_map<NodeRef, std::unordered_map<ERef, ERef, ERefHash>, NodeRefHash>;
+    // For every i-weak representative (indexed by its NodeRef) the select terms on its indices
+    using SelectsInfo = std::vector<std::unordered_map<ERef, ERef, ERefHash>>;
     SelectsInfo selectsInfo;
 
+    bool isGraphCurrent() const { return valid and builtForMergeStamp == egraph.getMergeStamp(); }
+
+    PTRef updateFalsifiedConditions(PTRef equality, int change);
+
     PTRef getEquality(ERef lhs, ERef rhs, Logic & logic) const { return logic.mkEq(egraph.ERefToTerm(lhs), egraph.ERefToTerm(rhs)); }
 
     bool isFalsified(PTRef equality) const { return logic.isFalse(equality) or (this->hasPolarity(equality) and this->getPolarity(equality) == l_False); }
@@ -242,17 +304,27 @@ private:
 
     void recordExplanationOfEgraphEquivalence(ExplanationCollection & explanationCollection, ERef lhs, ERef rhs) const;
 
-    std::vector<LemmaConditions> collectLemmaConditions(Logic & logic) const;
+    void explainEdge(EdgeRef edge, IndicesCollection & indices, ExplanationCollection & explanations) const;
+
+    void collectLemmaConditions();
 
     void computeSelectsInfo();
 
     TRes checkExtensionality();
 
-    void buildWeakEq();
+    void updateWeakEq();
+
+    void backtrackWeakEq(GraphBacktrackPoint const & point);
 
-    void merge(ERef);
+    EdgeRef addEdge(NodeRef first, NodeRef second, ERef store);
 
-    void mergeSecondary(NodeRef, NodeRef, ERef, std::unordered_set<ERef, ERefHash> && forbiddenIndices);
+    void merge(EdgeRef);
+
+    void mergeSecondary(NodeRef, NodeRef, EdgeRef, vec<ERef> & forbiddenIndices);
+
+    void rebuildSecondaryEdges(ERef index);
+
+    void clearLemmas();
 
     void clear();
 
@@ -288,7 +360,9 @@ private:
         return egraph.getRoot(term);
     }
 
-    ArrayNode & getNode(NodeRef ref) {
+    // Returns the node for modification, remembering its current state on the trail
+    ArrayNode & modifyNode(NodeRef ref) {
+        nodesTrail.emplace_back(ref, nodes[ref.id]);
         return nodes[ref.id];
     }
 
@@ -296,12 +370,26 @@ private:
         return nodes[ref.id];
     }
 
-    NodeRef getNodeRef(ERef root) const {
-        auto it = rootsMap.find(root);
-        assert(it != rootsMap.end());
+    NodeRef getNodeRef(ERef term) const {
+        auto it = nodesMap.find(term);
+        assert(it != nodesMap.end());
         return it->second;
     }
 
+    ArrayEdge const & getEdge(EdgeRef ref) const {
+        return edges[ref.id];
+    }
+
+    ClassInfo getClassInfo(ERef root) const {
+        auto it = classes.find(root);
+        return it == classes.end() ? ClassInfo{} : it->second;
+    }
+
+    void setClassInfo(ERef root, ClassInfo info) {
+        classesTrail.emplace_back(root, getClassInfo(root));
+        classes[root] = info;
+    }
+
     void makeWeakRepresentative(NodeRef);
 
     void makeIndexedWeakRepresentative(NodeRef);
@@ -313,14 +401,24 @@ private:
         return nodeRef;
     }
 
+    // The index of the store term causing the primary edge, ERef_Undef for strong edge
     ERef getIndexOfPrimaryEdge(NodeRef node) const {
-        return getIndexFromStore(getNode(node).primaryStore);
+        EdgeRef primaryCause = getNode(node).primaryCause;
+        assert(primaryCause != EdgeRef_Undef);
+        ERef store = getEdge(primaryCause).store;
+        return store == ERef_Undef ? ERef_Undef : getIndexFromStore(store);
+    }
+
+    // The root of the index of the primary edge, ERef_Undef for strong edge which does not separate any i-weak classes
+    ERef getIndexClassOfPrimaryEdge(NodeRef node) const {
+        ERef index = getIndexOfPrimaryEdge(node);
+        return index == ERef_Undef ? ERef_Undef : getRoot(index);
     }
 
     NodeRef getIndexedRepresentative(NodeRef nodeRef, ERef index) const {
         ArrayNode const & node = getNode(nodeRef);
         if (node.primaryEdge == NodeRef_Undef) { return nodeRef; }
-        if (getRoot(getIndexOfPrimaryEdge(nodeRef)) != index) { return getIndexedRepresentative(node.primaryEdge, index); }
+        if (getIndexClassOfPrimaryEdge(nodeRef) != index) { return getIndexedRepresentative(node.primaryEdge, index); }
         if (node.secondaryEdge == NodeRef_Undef) { return nodeRef; }
         return getIndexedRepresentative(node.secondaryEdge, index);
     }
@@ -43,6 +43,7 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "GCTest.h"
 #endif
 
+#include <unordered_map>
 #include <unordered_set>
 
 class UFSolverStats
@@ -52,13 +53,15 @@ class UFSolverStats
         opensmt::OSMTTimeVal egraph_backtrack_timer;
         opensmt::OSMTTimeVal egraph_explain_timer;
         int num_eq_classes;
-        UFSolverStats() : num_eq_classes(0) {}
+        uint64_t num_ackermann_lemmas;
+        UFSolverStats() : num_eq_classes(0), num_ackermann_lemmas(0) {}
         void printStatistics(std::ostream & os)
         {
             os << "; egraph time..............: " << egraph_asrt_timer.getTime() << " s\n";
             os << "; backtrack time...........: " << egraph_backtrack_timer.getTime() << " s\n";
             os << "; explain time.............: " << egraph_explain_timer.getTime() << " s\n";
             os << "; # eq classes at the end..: " << num_eq_classes << "\n";
+            os << "; # Ackermann lemmas.......: " << num_ackermann_lemmas << "\n";
         }
 };
 
@@ -196,6 +199,19 @@ private:
 
     UFSolverStats egraphStats;
 
+    /*
+     * Dynamic Ackermannization: once a congruence has been used in enough conflicts, the corresponding
+     * Ackermann lemma is added as a split clause, so that the SAT solver can learn from the argument equalities.
+     */
+    int const dynamicAckermannThreshold; // 0 means disabled
+    std::unordered_map<std::pair<PTRef,PTRef>, int, PTRefPairHash> congruenceConflicts;
+    void countCongruencesInConflict();
+    void addAckermannLemma(PTRef, PTRef);
+
+    bool const minimizeExplanations;
+    static constexpr int maxMinimizedExplanationSize = 64;
+    void minimizeExplanation(vec<PtAsgn> & expl, ERef x, ERef y);
+
     class Values {
         Map<ERef, ERef, ERefHash> values;
         Map<ERef, int, ERefHash> valueERefToInt;
@@ -242,6 +258,19 @@ public:
 
     ERef getRoot(ERef er) const { return getEnode(er).getRoot(); }
 
+    // A merge currently in effect: the class of `merged` was merged into the class of `root`, the root of both since
+    struct Merge {
+        ERef root;
+        ERef merged;
+        uint64_t stamp;
+    };
+
+    // Identifies the current partition of the terms into equivalence classes: the stamp of the latest merge in effect
+    uint64_t getMergeStamp() const { return merges.size() == 0 ? 0 : merges.last().stamp; }
+
+    // The merges currently in effect, in the order they were done
+    unsigned getMergesCount() const { return merges.size(); }
+    Merge const & getMerge(unsigned i) const { return merges[i]; }
 
     bool isConstant(ERef er) const {
         return logic.isConstant(getEnode(er).getTerm());
@@ -276,6 +305,7 @@ public:
     lbool      getPolaritySuggestion   (PTRef);                     // Return a suggested polarity for a given literal
     void       getConflict             (vec<PtAsgn> &) override;
     TRes       check                   (bool) override { return TRes::SAT; }// Check satisfiability
+    void       getNewSplits            (vec<PTRef> &) override;
     void       computeModel            () override;
     void       fillTheoryFunctions     (ModelBuilder & modelBuilder) const override;
     void       clearModel              ();
@@ -283,6 +313,7 @@ public:
     vec<PTRef> collectEqualitiesFor(vec<PTRef> const & vars, std::unordered_set<PTRef, PTRefHash> const & knownEqualities) override;
 
     void       printStatistics         (std::ostream &) override;
+    void       collectStatistics       (opensmt::Statistics &) const override;
 
 #if MORE_DEDUCTIONS
   bool                deduceMore              ( vector< ERef > & );
@@ -366,6 +397,8 @@ private:
 
     vec<opensmt::pair<ERef,ERef>> pending;                          // Pending merges
     vec<Undo>                 undo_stack_main;                  // Keeps track of terms involved in operations
+    vec<Merge>                merges;                           // The merges currently in effect with their unique stamps
+    uint64_t                  merges_done = 0;                  // Number of merges ever done, source of the stamps
 
     void reanalyze(ERef);
 
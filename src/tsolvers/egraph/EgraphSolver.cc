@@ -63,6 +63,8 @@ The algorithm and data structures are inspired by the following paper:
 #include "Deductions.h"
 #include "ModelBuilder.h"
 
+#include <algorithm>
+
 
 static SolverDescr descr_uf_solver("UF Solver", "Solver for Quantifier Free Theory of Uninterpreted Functions with Equalities");
 
@@ -79,6 +81,8 @@ Egraph::Egraph(SMTConfig & c, Logic & l, ExplainerType explainerType)
       , logic              (l)
       , enode_store        ( logic )
       , fa_garbage_frac    ( 0.5 )
+      , dynamicAckermannThreshold ( explainerType == ExplainerType::CLASSIC and not c.produce_inter() ? c.dynamic_ackermann() : 0 )
+      , minimizeExplanations ( explainerType == ExplainerType::CLASSIC and c.minimize_uf_explanations() )
       , values             ( nullptr )
 {
     auto rawExplainer = [this](ExplainerType type) -> Explainer * {
@@ -95,6 +99,9 @@ Egraph::Egraph(SMTConfig & c, Logic & l, ExplainerType explainerType)
         }
     }(explainerType);
     explainer.reset(rawExplainer);
+    if (dynamicAckermannThreshold > 0) {
+        explainer->enableCongruenceRecording();
+    }
 }
 
 //
@@ -179,14 +186,12 @@ void Egraph::getConflict(vec<PtAsgn> & conflict)
     for (PtAsgn lit : explanation) {
         conflict.push(lit);
     }
-#ifdef STATISTICS
     if (conflict.size() > generalTSolverStats.max_conf_size)
         generalTSolverStats.max_conf_size = conflict.size();
     if (conflict.size() < generalTSolverStats.min_conf_size)
         generalTSolverStats.min_conf_size = conflict.size();
     generalTSolverStats.conflicts_sent ++;
     generalTSolverStats.avg_conf_size += conflict.size();
-#endif
 }
 
 void Egraph::clearModel()
@@ -303,11 +308,9 @@ bool Egraph::addEquality(PtAsgn pa) {
             return false;
     }
 
-#ifdef STATISTICS
     if (res == false)
         generalTSolverStats.unsat_calls++;
     // The sat_calls is increased already in addTrue
-#endif
 
     return res;
 }
@@ -336,11 +339,9 @@ bool Egraph::addDisequality(PtAsgn pa) {
         if (!res2)
             return false;
     }
-#ifdef STATISTICS
     if (!res)
         generalTSolverStats.unsat_calls++;
     // The sat_calls is increased already in addFalse
-#endif
 
     return res;
 }
@@ -352,13 +353,11 @@ bool Egraph::addTrue(PTRef term) {
     if (res and termToNegatedERef.has(term)) {
         res = assertEq(termToNegatedERef[term], termToERef(logic.getTerm_false()), PtAsgn(term, l_True));
     }
-#ifdef STATISTICS
     if (res == false)
         generalTSolverStats.unsat_calls++;
     else {
         generalTSolverStats.sat_calls++;
     }
-#endif
     return res;
 }
 
@@ -369,13 +368,11 @@ bool Egraph::addFalse(PTRef term) {
     if (res and termToNegatedERef.has(term)) {
         res = assertEq(termToNegatedERef[term], termToERef(logic.getTerm_true()), PtAsgn(term, l_False));
     }
-#ifdef STATISTICS
     if (res == false)
         generalTSolverStats.unsat_calls++;
     else {
         generalTSolverStats.sat_calls++;
     }
-#endif
     return res;
 }
 
@@ -709,6 +706,7 @@ void Egraph::backtrackToStackSize ( size_t size ) {
                 ERef e = u.arg.er;
                 undoMerge(e);
                 explainer->removeExplanation();
+                merges.pop();
                 break;
             }
 #if MORE_DEDUCTIONS
@@ -823,6 +821,7 @@ void Egraph::merge ( ERef x, ERef y, PtAsgn reason )
 
     // Step 8: Push undo record
     undo_stack_main.push( Undo(MERGE,y) );
+    merges.push({x, y, ++merges_done});
 }
 
 //
@@ -896,9 +895,7 @@ void Egraph::deduce( ERef x, ERef y, PtAsgn reason ) {
             // Negated boolean terms are handled in the positive case
             assert(v_tr == enode_store.getPTRef(v));
             storeDeduction(PtAsgn_reason(v_tr, deduced_polarity, reason.tr));
-#ifdef STATISTICS
             generalTSolverStats.deductions_done ++;
-#endif
         }
         v = getEnode(v).getEqNext();
         if (v == vstart)
@@ -1459,6 +1456,9 @@ void Egraph::processParentsAfterUnMerge(ERef oldroot) {
 
 void Egraph::doExplain(ERef x, ERef y, PtAsgn reason_inequality) {
     explanation = explainer->explain(x,y);
+    if (minimizeExplanations) {
+        minimizeExplanation(explanation, x, y);
+    }
 #ifdef EXPLICIT_CONGRUENCE_EXPLANATIONS
     for (auto ptRefPair : explainer->getCongruences()) {
         PTRef x = ptRefPair.first;
@@ -1468,6 +1468,7 @@ void Egraph::doExplain(ERef x, ERef y, PtAsgn reason_inequality) {
 #endif
     explanation.push(reason_inequality);
     has_explanation = true;
+    countCongruencesInConflict();
 }
 
 void Egraph::explainConstants(ERef p, ERef q) {
@@ -1477,7 +1478,235 @@ void Egraph::explainConstants(ERef p, ERef q) {
     assert(logic.isConstant(getEnode(enr_qroot).getTerm()));
     assert(enr_proot != enr_qroot);
     explanation = explainer->explain(enr_proot,enr_qroot);
+    if (minimizeExplanations) {
+        minimizeExplanation(explanation, enr_proot, enr_qroot);
+    }
     has_explanation = true;
+    countCongruencesInConflict();
+}
+
+namespace {
+/**
+ * A congruence closure over the terms of an explanation that can be extended one equality at a time and rolled back.
+ * The union-find has no path compression, so that a merge is undone by resetting the parent of the merged root.
+ */
+class ExplanationClosure {
+public:
+    // The terms are numbered from 0; a term applies the symbol to the terms args
+    int addTerm(SymRef symbol, std::vector<int> args) {
+        int const t = static_cast<int>(parent.size());
+        for (int arg : args) {
+            if (uses[arg].empty() or uses[arg].back() != t) { uses[arg].push_back(t); }
+        }
+        symbols.push_back(symbol);
+        arguments.push_back(std::move(args));
+        parent.push_back(t);
+        size.push_back(1);
+        uses.emplace_back();
+        return t;
+    }
+    int find(int t) const {
+        while (parent[t] != t) { t = parent[t]; }
+        return t;
+    }
+
+    // Merges the classes of a and b and of the terms that become congruent
+    void merge(int a, int b) {
+        pending.emplace_back(a, b);
+        while (not pending.empty()) {
+            auto [u, v] = pending.back();
+            pending.pop_back();
+            int small = find(u);
+            int large = find(v);
+            if (small == large) { continue; }
+            if (size[small] > size[large]) { std::swap(small, large); }
+            std::size_t const largeUses = uses[large].size();
+            trail.push_back({small, large, largeUses});
+            parent[small] = large;
+            size[large] += size[small];
+            // Two terms become congruent only through the arguments in the two merged classes
+            for (int p : uses[small]) {
+                for (std::size_t i = 0; i < largeUses; ++i) {
+                    int q = uses[large][i];
+                    if (find(p) != find(q) and congruent(p, q)) { pending.emplace_back(p, q); }
+                }
+            }
+            uses[large].insert(uses[large].end(), uses[small].begin(), uses[small].end());
+        }
+    }
+
+    std::size_t mark() const { return trail.size(); }
+
+    void undo(std::size_t mark) {
+        while (trail.size() > mark) {
+            Merge const & m = trail.back();
+            parent[m.small] = m.small;
+            size[m.large] -= size[m.small];
+            uses[m.large].resize(m.largeUses);
+            trail.pop_back();
+        }
+    }
+
+private:
+    struct Merge {
+        int small;
+        int large;
+        std::size_t largeUses; // The size of the use list of large before the merge
+    };
+    std::vector<SymRef> symbols;
+    std::vector<std::vector<int>> arguments;
+    std::vector<int> parent;
+    std::vector<int> size;
+    std::vector<std::vector<int>> uses;    // The terms having the class of the root as an argument
+    std::vector<Merge> trail;
+    std::vector<std::pair<int,int>> pending;
+
+    bool congruent(int p, int q) const {
+        if (symbols[p] != symbols[q] or arguments[p].size() != arguments[q].size()) { return false; }
+        for (std::size_t k = 0; k < arguments[p].size(); ++k) {
+            if (find(arguments[p][k]) != find(arguments[q][k])) { return false; }
+        }
+        return true;
+    }
+};
+}
+
+/**
+ * Drops literals from an explanation of x = y so that the remaining ones still imply x = y and none of them can be
+ * dropped.  The literals are found one at a time: starting from the literals already kept, the candidates are merged
+ * in order into an undoable congruence closure over the terms of the explanation until x = y holds.  The last merged
+ * candidate is needed, it is kept and only the candidates before it are searched again.  A round costs one pass over
+ * the candidates, and there are as many rounds as kept literals.  Only explanations of bounded size are minimized.
+ */
+void Egraph::minimizeExplanation(vec<PtAsgn> & expl, ERef x, ERef y) {
+    if (expl.size() <= 1 or expl.size() > maxMinimizedExplanationSize) { return; }
+
+    ExplanationClosure closure;
+    std::unordered_map<uint32_t, int> termIndex;
+    auto indexOf = [&](ERef root) {
+        // The arguments are numbered before the terms applying them
+        std::vector<std::pair<ERef,bool>> queue;
+        queue.emplace_back(root, false);
+        while (not queue.empty()) {
+            auto [e, argsDone] = queue.back();
+            queue.pop_back();
+            if (termIndex.find(e.x) != termIndex.end()) { continue; }
+            Enode const & node = getEnode(e);
+            if (not argsDone) {
+                queue.emplace_back(e, true);
+                for (uint32_t i = 0; i < node.getSize(); ++i) { queue.emplace_back(node[i], false); }
+                continue;
+            }
+            std::vector<int> args;
+            for (uint32_t i = 0; i < node.getSize(); ++i) { args.push_back(termIndex.at(node[i].x)); }
+            termIndex.insert({e.x, closure.addTerm(node.getSymbol(), std::move(args))});
+        }
+        return termIndex.at(root.x);
+    };
+
+    // The pairs of terms merged by each literal
+    std::vector<std::vector<std::pair<int,int>>> merges(expl.size());
+    for (int i = 0; i < expl.size(); ++i) {
+        PtAsgn lit = expl[i];
+        if (logic.isEquality(lit.tr) and lit.sgn == l_True) {
+            vec<ERef> args;
+            for (PTRef arg : logic.getPterm(lit.tr)) {
+                ERef er = ERef_Undef;
+                if (enode_store.peekERef(arg, er)) { args.push(er); }
+            }
+            if (args.size_() != logic.getPterm(lit.tr).nargs()) { continue; }
+            for (int j = 1; j < args.size(); ++j) {
+                merges[i].emplace_back(indexOf(args[0]), indexOf(args[j]));
+            }
+        } else if (logic.isUP(lit.tr) and lit.sgn != l_Undef) {
+            ERef value = lit.sgn == l_True ? enode_store.getEnode_true() : enode_store.getEnode_false();
+            merges[i].emplace_back(indexOf(termToERef(lit.tr)), indexOf(value));
+        }
+    }
+    int const xIndex = indexOf(x);
+    int const yIndex = indexOf(y);
+    auto implied = [&]() { return closure.find(xIndex) == closure.find(yIndex); };
+    auto assume = [&](int i) {
+        for (auto [a, b] : merges[i]) { closure.merge(a, b); }
+    };
+
+    std::vector<char> kept(expl.size(), 0);
+    std::vector<int> candidates;
+    for (int i = 0; i < expl.size(); ++i) {
+        if (merges[i].empty()) {
+            kept[i] = 1; // Not understood here, keep it
+            assume(i);
+        } else {
+            candidates.push_back(i);
+        }
+    }
+    while (not implied() and not candidates.empty()) {
+        std::size_t const start = closure.mark();
+        std::size_t needed = 0;
+        while (needed < candidates.size()) {
+            assume(candidates[needed]);
+            if (implied()) { break; }
+            ++needed;
+        }
+        closure.undo(start);
+        if (needed == candidates.size()) {
+            // The literals not understood here are needed after all
+            return;
+        }
+        kept[candidates[needed]] = 1;
+        assume(candidates[needed]);
+        candidates.resize(needed);
+    }
+    int j = 0;
+    for (int i = 0; i < expl.size(); ++i) {
+        if (kept[i]) { expl[j++] = expl[i]; }
+    }
+    expl.shrink(expl.size() - j);
+}
+
+void Egraph::countCongruencesInConflict() {
+    if (dynamicAckermannThreshold == 0) { return; }
+    for (auto const & [v, p] : explainer->getUsedCongruences()) {
+        PTRef first = getEnode(v).getTerm();
+        PTRef second = getEnode(p).getTerm();
+        if (second < first) { std::swap(first, second); }
+        if (++congruenceConflicts[{first, second}] == dynamicAckermannThreshold) {
+            addAckermannLemma(first, second);
+        }
+    }
+}
+
+/**
+ * Adds the clause f(a_1,...,a_n) = f(b_1,...,b_n) or a_1 != b_1 or ... or a_n != b_n to the split clauses.
+ * Only congruences over uninterpreted sorts are considered, since these are decided by the egraph alone and the
+ * lemma therefore cannot be falsified by a consistent assignment.
+ */
+void Egraph::addAckermannLemma(PTRef first, PTRef second) {
+    auto isUninterpreted = [this](PTRef term) { return logic.yieldsSortUninterpreted(term); };
+    vec<PTRef> firstArgs;
+    vec<PTRef> secondArgs;
+    for (PTRef arg : logic.getPterm(first)) { firstArgs.push(arg); }
+    for (PTRef arg : logic.getPterm(second)) { secondArgs.push(arg); }
+    if (not isUninterpreted(first) or not std::all_of(firstArgs.begin(), firstArgs.end(), isUninterpreted)) {
+        return;
+    }
+    vec<PTRef> literals;
+    for (int i = 0; i < firstArgs.size(); ++i) {
+        if (firstArgs[i] != secondArgs[i]) {
+            literals.push(logic.mkNot(logic.mkEq(firstArgs[i], secondArgs[i])));
+        }
+    }
+    literals.push(logic.mkEq(first, second));
+    PTRef lemma = logic.mkOr(std::move(literals));
+    if (logic.isOr(lemma) or logic.isAtom(lemma)) {
+        splitondemand.push(lemma);
+        ++egraphStats.num_ackermann_lemmas;
+    }
+}
+
+void Egraph::getNewSplits(vec<PTRef> & splits) {
+    splitondemand.copyTo(splits);
+    splitondemand.clear();
 }
 
 uint32_t UseVector::addParent(ERef parent) {
@@ -1598,6 +1827,11 @@ void Egraph::printStatistics(std::ostream & os) {
     egraphStats.printStatistics(os);
 }
 
+void Egraph::collectStatistics(opensmt::Statistics & stats) const {
+    TSolver::collectStatistics(stats);
+    stats.addCounter(opensmt::Statistics::keyOf(name) + ".ackermann-lemmas", egraphStats.num_ackermann_lemmas);
+}
+
 void Egraph::reanalyze(ERef eref) {
     // FIXME: This will probably never be false, we need to find a different condition
     if (backtrack_points.size() > 0) {
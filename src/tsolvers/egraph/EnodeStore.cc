@@ -42,8 +42,12 @@ EnodeStore::EnodeStore(Logic& l)
     PTRef f = logic.getTerm_false();
     constructTerm(t);
     constructTerm(f);
-    ERef_True = termToERef[t];
-    ERef_False = termToERef[f];
+    ERef_True = getERef(t);
+    ERef_False = getERef(f);
+}
+
+uint32_t EnodeStore::termIndex(PTRef tr) const {
+    return Idx(logic.getPterm(tr).getId());
 }
 
 /**
@@ -54,8 +58,9 @@ EnodeStore::EnodeStore(Logic& l)
  * @return Reference to the newly created ENode
  */
 ERef EnodeStore::addTerm(PTRef term, bool ignoreChildren) {
-    if (termToERef.has(term))
-        return termToERef[term];
+    ERef existing = ERef_Undef;
+    if (peekERef(term, existing))
+        return existing;
 
     Pterm const & pterm = logic.getPterm(term);
     SymRef symref = pterm.symb();
@@ -64,15 +69,18 @@ ERef EnodeStore::addTerm(PTRef term, bool ignoreChildren) {
         if (ignoreChildren) { return opensmt::span<ERef>(nullptr, 0); }
         args.capacity(pterm.nargs());
         for (PTRef arg : pterm) {
-            assert(termToERef.has(arg));
-            args.push(termToERef[arg]);
+            args.push(getERef(arg));
         }
         return opensmt::span(args.begin(), args.size_());
     }();
     ERef newEnode = ea.alloc(symref, argSpan, term);
 
-    assert(not termToERef.has(term));
-    termToERef.insert(term, newEnode);
+    assert(not has(term));
+    uint32_t index = termIndex(term);
+    if (index >= termToERef.size_()) {
+        termToERef.growTo(index + 1, ERef_Undef);
+    }
+    termToERef[index] = newEnode;
     termEnodes.push(newEnode);
     return newEnode;
 }
@@ -120,7 +128,7 @@ vec<PTRefERefPair> EnodeStore::constructTerm(PTRef tr) {
 
     assert(needsEnode(tr));
 
-    if (termToERef.has(tr))
+    if (has(tr))
         return {};
 
     vec<PTRefERefPair> new_enodes;
@@ -151,3 +159,59 @@ bool EnodeStore::needsRecursiveDefinition(PTRef tr) const {
     Pterm const & t = logic.getPterm(tr);
     return std::all_of(t.begin(), t.end(), [this](PTRef ch) { return needsEnode(ch); });
 }
+
+uint32_t SignatureTable::find(ERef e, uint32_t h) const {
+    uint32_t index = h & mask();
+    while (true) {
+        Slot const & slot = slots[index];
+        if (isEmpty(slot) or (not isTombstone(slot) and slot.hash == h and equal(slot.ref, e))) {
+            return index;
+        }
+        index = (index + 1) & mask();
+    }
+}
+
+ERef SignatureTable::lookup(ERef e) const {
+    if (elems == 0) { return ERef_Undef; }
+    Slot const & slot = slots[find(e, static_cast<uint32_t>(hash(e)))];
+    return isEmpty(slot) ? ERef_Undef : slot.ref;
+}
+
+void SignatureTable::insert(ERef e) {
+    // Keep the load, including tombstones, under 3/4. Grow if the table is more than half full, otherwise just purge the tombstones
+    if ((elems + tombstones + 1) * 4 > slots.size() * 3) {
+        rehash(slots.empty() ? 16 : (elems + 1) * 2 > slots.size() ? slots.size() * 2 : slots.size());
+    }
+    auto h = static_cast<uint32_t>(hash(e));
+    uint32_t index = h & mask();
+    while (not isEmpty(slots[index]) and not isTombstone(slots[index])) {
+        assert(slots[index].hash != h or not equal(slots[index].ref, e));
+        index = (index + 1) & mask();
+    }
+    if (isTombstone(slots[index])) { --tombstones; }
+    slots[index] = {h, e};
+    ++elems;
+}
+
+void SignatureTable::remove(ERef e) {
+    uint32_t index = find(e, static_cast<uint32_t>(hash(e)));
+    assert(not isEmpty(slots[index]));
+    slots[index].ref.x = tombstoneRef;
+    --elems;
+    ++tombstones;
+}
+
+void SignatureTable::rehash(std::size_t capacity) {
+    assert((capacity & (capacity - 1)) == 0);
+    std::vector<Slot> old(capacity, Slot{0, ERef{emptyRef}});
+    std::swap(old, slots);
+    tombstones = 0;
+    for (Slot const & slot : old) {
+        if (isEmpty(slot) or isTombstone(slot)) { continue; }
+        uint32_t index = slot.hash & mask();
+        while (not isEmpty(slots[index])) {
+            index = (index + 1) & mask();
+        }
+        slots[index] = slot;
+    }
+}
@@ -30,60 +30,101 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Enode.h"
 #include "OsmtInternalException.h"
 
+#include <vector>
+
 class Logic;
 
 struct PTRefERefPair { PTRef tr; ERef er; };
 
-class EnodeStore {
-
-    struct SignatureHash {
-        EnodeAllocator const & ea;
+struct SignatureHash {
+    EnodeAllocator const & ea;
 
-        SignatureHash(EnodeAllocator const & ea) : ea{ea} {}
+    SignatureHash(EnodeAllocator const & ea) : ea{ea} {}
 
-        // Hash function from https://stackoverflow.com/questions/20511347/a-good-hash-function-for-a-vector
-        std::size_t operator()(ERef ref) const {
-            Enode const & node = ea[ref];
-            std::size_t seed = node.getSymbol().x;
-            for (uint32_t i = 0; i < node.getSize(); ++i) {
-                seed ^= ea[node[i]].getRoot().x + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-            }
-            return seed;
+    // Hash function from https://stackoverflow.com/questions/20511347/a-good-hash-function-for-a-vector
+    std::size_t operator()(ERef ref) const {
+        Enode const & node = ea[ref];
+        std::size_t seed = node.getSymbol().x;
+        for (uint32_t i = 0; i < node.getSize(); ++i) {
+            seed ^= ea[node[i]].getRoot().x + 0x9e3779b9 + (seed << 6) + (seed >> 2);
         }
-    };
+        return seed;
+    }
+};
 
-    struct SignatureEqual {
-        EnodeAllocator const & ea;
+struct SignatureEqual {
+    EnodeAllocator const & ea;
 
-        SignatureEqual(EnodeAllocator const & ea) : ea{ea} {}
+    SignatureEqual(EnodeAllocator const & ea) : ea{ea} {}
 
-        bool operator()(ERef a, ERef b) const {
-            if (a == b) { return true; }
-            Enode const & anode = ea[a];
-            Enode const & bnode = ea[b];
-            if (anode.getSize() != bnode.getSize() or anode.getSymbol() != bnode.getSymbol()) { return false; }
-            for (uint32_t i = 0; i < anode.getSize(); ++i) {
-                if (ea[anode[i]].getRoot() != ea[bnode[i]].getRoot()) { return false; }
-            }
-            return true;
+    bool operator()(ERef a, ERef b) const {
+        if (a == b) { return true; }
+        Enode const & anode = ea[a];
+        Enode const & bnode = ea[b];
+        if (anode.getSize() != bnode.getSize() or anode.getSymbol() != bnode.getSymbol()) { return false; }
+        for (uint32_t i = 0; i < anode.getSize(); ++i) {
+            if (ea[anode[i]].getRoot() != ea[bnode[i]].getRoot()) { return false; }
         }
+        return true;
+    }
+};
+
+/**
+ * Open-addressing table of enode signatures with linear probing.
+ *
+ * The hash of a signature is cached in its slot, which is valid since the Egraph removes a signature before the
+ * roots of its children change and inserts it again afterwards.  A removed signature leaves a tombstone.  Since
+ * merges and unmerges remove and re-insert signatures in LIFO order, an insertion typically reuses the tombstone
+ * left by the corresponding removal, and tombstones are only purged when the table is rehashed.
+ */
+class SignatureTable {
+    struct Slot {
+        uint32_t hash;
+        ERef ref;
     };
+    static constexpr uint32_t emptyRef = UINT32_MAX;
+    static constexpr uint32_t tombstoneRef = UINT32_MAX - 1;
+
+    std::vector<Slot> slots;
+    uint32_t elems = 0;
+    uint32_t tombstones = 0;
+    SignatureHash hash;
+    SignatureEqual equal;
+
+    static bool isEmpty(Slot const & slot) { return slot.ref.x == emptyRef; }
+    static bool isTombstone(Slot const & slot) { return slot.ref.x == tombstoneRef; }
+    uint32_t mask() const { return static_cast<uint32_t>(slots.size()) - 1; }
+    uint32_t find(ERef e, uint32_t h) const;  // Index of the slot with signature equal to e's, or of an empty slot
+    void rehash(std::size_t capacity);
+
+public:
+    SignatureTable(SignatureHash hash, SignatureEqual equal) : hash(hash), equal(equal) {}
+
+    ERef lookup(ERef e) const;
+    void insert(ERef e);
+    void remove(ERef e);
+    uint32_t size() const { return elems; }
+};
+
+class EnodeStore {
 
     Logic&         logic;
     EnodeAllocator ea;
-    Map<ERef, ERef, SignatureHash, SignatureEqual> sig_tab;
+    SignatureTable sig_tab;
     ERef           ERef_True;
     ERef           ERef_False;
     Map<PTRef,char,PTRefHash,Equal<PTRef> > dist_classes;
     uint32_t       dist_idx;
 
-    Map<PTRef,ERef,PTRefHash,Equal<PTRef> >    termToERef;
+    vec<ERef>      termToERef;                       // Indexed by the id of the term, ERef_Undef if the term has no enode
 
     vec<PTRef>     index_to_dist;                    // Table distinction index --> proper term
     vec<ERef>      termEnodes;
 
     ERef  addTerm(PTRef pt, bool ignoreChildren = false);
 
+    uint32_t termIndex(PTRef tr) const;
+
 public:
     EnodeStore(Logic& l);
 
@@ -98,23 +139,28 @@ public:
     void free(ERef er) { ea.free(er); }
 
 
-    bool         has(PTRef tr)         const { return termToERef.has(tr); }
-    ERef         getERef(PTRef tr)     const { return termToERef[tr]; }
+    bool         has(PTRef tr)         const { ERef er = ERef_Undef; return peekERef(tr, er); }
+    ERef         getERef(PTRef tr)     const { assert(has(tr)); return termToERef[termIndex(tr)]; }
     /**
      * Place into er the enode ref of tr if it exists in the store.  Otherwise do not change er.
      * @param tr the pterm ref to look for
      * @param er will contain the enode ref corresponding to tr, or be unchanged
      * @return true if tr is in the store, false if not.
      */
-    bool         peekERef(PTRef tr, ERef& er)  const { return termToERef.peek(tr, er); }
+    bool         peekERef(PTRef tr, ERef& er)  const {
+        uint32_t index = termIndex(tr);
+        if (index >= termToERef.size_() or termToERef[index] == ERef_Undef) { return false; }
+        er = termToERef[index];
+        return true;
+    }
     PTRef        getPTRef(ERef er)     const { return ea[er].getTerm(); }
 
     vec<PTRefERefPair> constructTerm(PTRef tr);
 
     Enode&       operator[] (ERef e)         { return ea[e]; }
     const Enode& operator[] (ERef e)   const { return ea[e]; }
-          Enode& operator[] (PTRef tr)       { return ea[termToERef[tr]]; }
-    const Enode& operator[] (PTRef tr) const { return ea[termToERef[tr]]; }
+          Enode& operator[] (PTRef tr)       { return ea[getERef(tr)]; }
+    const Enode& operator[] (PTRef tr) const { return ea[getERef(tr)]; }
 
     char getDistIndex(PTRef tr_d) const {
         assert(dist_classes.has(tr_d));
@@ -139,8 +185,7 @@ public:
     }
 
     inline ERef lookupSig(ERef e) const {
-        bool found = sig_tab.peek(e, e);
-        return found ? e : ERef_Undef;
+        return sig_tab.lookup(e);
     }
 
     inline void removeSig(ERef e) {
@@ -151,7 +196,7 @@ public:
 
     inline void insertSig(ERef e) {
         assert(not containsSig(e));
-        sig_tab.insert(e,e);
+        sig_tab.insert(e);
         assert(containsSig(e));
     }
 };
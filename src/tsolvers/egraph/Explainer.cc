@@ -99,6 +99,7 @@ vec<PtAsgn> Explainer::explain(opensmt::pair<ERef,ERef> nodePair) {
 #ifdef EXPLICIT_CONGRUENCE_EXPLANATIONS
     congruences.clear();
 #endif
+    usedCongruences.clear();
 
     DupChecker dupChecker(dcd);
     vec<PtAsgn> explanation;
@@ -130,7 +131,27 @@ vec<PtAsgn> Explainer::explain(opensmt::pair<ERef,ERef> nodePair) {
 //
 vec<PtAsgn> Explainer::explain(ERef x, ERef y)
 {
-    return explain({x, y});
+    auto key = y < x ? std::make_pair(y, x) : std::make_pair(x, y);
+    vec<PtAsgn> explanation;
+    auto it = explanationCache.find(key);
+    if (it != explanationCache.end()) {
+        it->second.explanation.copyTo(explanation);
+        it->second.congruences.copyTo(usedCongruences);
+        return explanation;
+    }
+    explanation = explain({x, y});
+    CachedExplanation & cached = explanationCache[key];
+    explanation.copyTo(cached.explanation);
+    usedCongruences.copyTo(cached.congruences);
+    explanationCacheTrail.push({key.first, key.second, exp_undo_stack.size()});
+    return explanation;
+}
+
+void Explainer::invalidateCachedExplanations() {
+    while (explanationCacheTrail.size() > 0 and explanationCacheTrail.last().stackSize > exp_undo_stack.size()) {
+        explanationCache.erase({explanationCacheTrail.last().x, explanationCacheTrail.last().y});
+        explanationCacheTrail.pop();
+    }
 }
 
 void Explainer::cleanup() {
@@ -207,6 +228,9 @@ PtAsgn Explainer::explainEdge(const ERef v, const ERef p, PendingQueue &exp_pend
         // we have therefore to compute the reasons
         assert(getEnode(v).getSymbol() == getEnode(p).getSymbol());
         enqueueArguments(v, p, exp_pending);
+        if (recordUsedCongruences) {
+            usedCongruences.push({v, p});
+        }
     }
     makeUnion(v, p);
     return expl;
@@ -306,6 +330,8 @@ void Explainer::removeExplanation() {
     assert( x != ERef_Undef );
     assert( y != ERef_Undef );
 
+    invalidateCachedExplanations();
+
     // We observe that we don't need to undo the rerooting
     // of the explanation trees, because it doesn't affect
     // correctness. We just have to reroot y on itself
@@ -333,5 +359,6 @@ PtAsgn InterpolatingExplainer::explainEdge(ERef from, ERef to, PendingQueue &exp
 vec<PtAsgn> InterpolatingExplainer::explain(ERef x, ERef y) {
     cgraph.reset(new CGraph());
     cgraph->setConf(getEnode(x).getTerm(), getEnode(y).getTerm());
-    return Explainer::explain(x,y);
+    // The cache is bypassed, the graph has to be built from the explanation
+    return Explainer::explain({x, y});
 }
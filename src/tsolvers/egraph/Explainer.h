@@ -7,7 +7,9 @@
 
 #include "EnodeStore.h"
 #include "UFInterpolator.h"
+#include <limits>
 #include <memory>
+#include <unordered_map>
 
 class Explainer {
 protected:
@@ -74,6 +76,29 @@ protected:
     int             time_stamp = 0;                   // Need for finding NCA
 
     vec<opensmt::pair<PTRef,PTRef>> congruences;
+
+    bool recordUsedCongruences = false;
+    vec<opensmt::pair<ERef,ERef>> usedCongruences;    // Congruence edges used by the last explanation
+
+    //
+    // Cache of computed explanations.  An explanation computed when exp_undo_stack had size n depends only on the
+    // first n entries of the stack, hence it stays valid until the stack shrinks below n.
+    //
+    struct ERefPairHash {
+        std::size_t operator()(std::pair<ERef,ERef> p) const { return std::hash<uint32_t>()(p.first.x) ^ (std::hash<uint32_t>()(p.second.x) << 1); }
+    };
+    struct CachedExplanation {
+        vec<PtAsgn> explanation;
+        vec<opensmt::pair<ERef,ERef>> congruences;
+    };
+    std::unordered_map<std::pair<ERef,ERef>, CachedExplanation, ERefPairHash> explanationCache;
+    struct CacheTrailEntry {
+        ERef x;
+        ERef y;
+        int stackSize; // Size of exp_undo_stack when the explanation of x = y was cached
+    };
+    vec<CacheTrailEntry> explanationCacheTrail;
+    void invalidateCachedExplanations();
 public:
     Explainer(EnodeStore & store) : store(store) {}
     virtual ~Explainer() = default;
@@ -82,6 +107,8 @@ public:
     void                removeExplanation   ();                          // Undoes the effect of storeExplanation
     virtual vec<PtAsgn> explain             (ERef, ERef);                // Return explanation of why the given two terms are equal
     const vec<opensmt::pair<PTRef,PTRef>> &getCongruences() const { return congruences; }
+    void                enableCongruenceRecording()       { recordUsedCongruences = true; }
+    const vec<opensmt::pair<ERef,ERef>> &getUsedCongruences() const { return usedCongruences; }
 };
 
 class InterpolatingExplainer : public Explainer {
@@ -93,7 +120,7 @@ public:
     InterpolatingExplainer(EnodeStore & store) : Explainer(store) {}
 
     virtual vec<PtAsgn> explain     (ERef, ERef) override;
-    std::unique_ptr<CGraph> getCGraph() { return std::move(cgraph); }
+    CGraph const * getCGraph() const { return cgraph.get(); }
 };
 
 #endif //OPENSMT_EXPLAINER_H
@@ -18,8 +18,9 @@ public:
     PTRef getInterpolant(const ipartitions_t& mask, UFInterpolator::ItpColorMap * labels, PartitionManager &pmanager)
     {
         InterpolatingExplainer * itp_explainer = static_cast<InterpolatingExplainer*>(explainer.get());
-        auto cgraph = itp_explainer->getCGraph();
-        return UFInterpolator(config, logic, *cgraph).getInterpolant(mask, labels, pmanager);
+        // The graph of the last conflict is copied, so that interpolants for several masks can be computed from it
+        CGraph cgraph(*itp_explainer->getCGraph());
+        return UFInterpolator(config, logic, cgraph).getInterpolant(mask, labels, pmanager);
     }
 };
 
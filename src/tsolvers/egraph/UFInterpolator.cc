@@ -32,6 +32,16 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //#define ITP_DEBUG
 //#define COLOR_DEBUG
 
+CGraph::CGraph(CGraph const & other) : conf1(other.conf1), conf2(other.conf2) {
+    for (CNode const * node : other.cnodes) {
+        addCNode(node->e)->color = node->color;
+    }
+    for (CEdge const * edge : other.cedges) {
+        addCEdge(edge->source->e, edge->target->e, edge->reason);
+        cedges.back()->color = edge->color;
+    }
+}
+
 CNode * CGraph::addCNode(PTRef e) {
     assert (e != PTRef_Undef);
     auto it = cnodes_store.find(e);
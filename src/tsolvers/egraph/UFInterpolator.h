@@ -86,6 +86,10 @@ class CGraph {
     void clear();
 
 public:
+    CGraph() = default;
+    CGraph(CGraph const &); // Deep copy, the interpolator modifies the graph it is given
+    CGraph & operator=(CGraph const &) = delete;
+
     std::vector<CNode *> const & getNodes() const { return cnodes; }
     std::vector<CEdge *> const & getEdges() const { return cedges; }
     bool hasNode(PTRef term) const { return cnodes_store.find(term) != cnodes_store.end(); }
@@ -652,6 +652,20 @@ void LASolver::getConflict(vec<PtAsgn> & conflict) {
     for (PtAsgn lit : explanation) {
         conflict.push(lit);
     }
+    if (conflict.size() > generalTSolverStats.max_conf_size)
+        generalTSolverStats.max_conf_size = conflict.size();
+    if (conflict.size() < generalTSolverStats.min_conf_size)
+        generalTSolverStats.min_conf_size = conflict.size();
+    generalTSolverStats.conflicts_sent ++;
+    generalTSolverStats.avg_conf_size += conflict.size();
+}
+
+void LASolver::collectStatistics(opensmt::Statistics & stats) const {
+    TSolver::collectStatistics(stats);
+    std::string const prefix = opensmt::Statistics::keyOf(name) + '.';
+    stats.addCounter(prefix + "vars", laVarStore.numVars());
+    stats.addCounter(prefix + "pivots", simplex.getStats().num_pivot_ops);
+    stats.addCounter(prefix + "bland-pivots", simplex.getStats().num_bland_ops);
 }
 
 void LASolver::fillTheoryFunctions(ModelBuilder & modelBuilder) const {
@@ -758,6 +772,10 @@ lbool LASolver::getPolaritySuggestion(PTRef ptref) const {
 
 TRes LASolver::check(bool complete) {
     bool rval = check_simplex(complete);
+    if (rval and resourceLimits and resourceLimits->exhausted()) {
+        // The simplex may have given up before reaching a feasible assignment
+        return TRes::UNKNOWN;
+    }
     if (complete && rval) {
         return checkIntegersAndSplit();
     }
@@ -807,10 +825,9 @@ void LASolver::printStatistics(std::ostream & out) {
     laSolverStats.printStatistics(out);
 }
 
-bool LASolver::shouldTryCutFromProof() const {
+bool LASolver::shouldTryCutFromProof() {
     if (this->config.produce_inter()) { return false; }
-    static unsigned long counter = 0;
-    return ++counter % 10 == 0;
+    return ++cutAttempts % 10 == 0;
 }
 
 namespace {
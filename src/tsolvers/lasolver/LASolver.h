@@ -100,6 +100,7 @@ public:
     virtual ~LASolver( );                                      // Destructor ;-)
 
     virtual void printStatistics(std::ostream &) override;
+    void collectStatistics(opensmt::Statistics & stats) const override;
 
     virtual void clearSolver() override; // Remove all problem specific data from the solver.  Should be called each time the solver is being used after a push or a pop in the incremental interface.
 
@@ -124,12 +125,18 @@ public:
     ArithLogic& getLogic() override;
     bool        isValid(PTRef tr) override;
 
+    void setResourceLimits(opensmt::ResourceLimits * limits) override {
+        TSolver::setResourceLimits(limits);
+        simplex.setResourceLimits(limits);
+    }
+
 
 private:
 
     Map<LVRef, bool, LVRefHash> int_vars_map; // stores problem variables for duplicate check
     vec<LVRef> int_vars;                      // stores the list of problem variables without duplicates
     double seed = 123;
+    unsigned long cutAttempts = 0; // Number of times a cut from proof could have been tried
 
     LABoundStore::BoundInfo addBound(PTRef leq_tr);
     void updateBound(PTRef leq_tr);
@@ -158,7 +165,7 @@ private:
     TRes checkIntegersAndSplit();
     bool isModelInteger (LVRef v) const;
     TRes cutFromProof();
-    bool shouldTryCutFromProof() const;
+    bool shouldTryCutFromProof();
 
     void getSuggestions( vec<PTRef>& dst, SolverId solver_id );                                   // find possible suggested atoms
     void getSimpleDeductions(LABoundRef);                   // find deductions from actual bounds position
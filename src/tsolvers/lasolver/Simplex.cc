@@ -35,6 +35,10 @@ Simplex::Explanation Simplex::checkSimplex() {
 
     // keep doing pivotAndUpdate until the SAT/UNSAT status is confirmed
     while (true) {
+        if (resourceLimits and resourceLimits->exhausted()) {
+            model->restoreAssignment();
+            return Explanation();
+        }
         repeats++;
         LVRef x = LVRef::Undef;
 
@@ -10,11 +10,12 @@
 #include "lasolver/LAVar.h"
 #include "LRAModel.h"
 #include "SMTConfig.h"
+#include "ResourceLimits.h"
 
 class SimplexStats {
 public:
-    int num_bland_ops;
-    int num_pivot_ops;
+    uint64_t num_bland_ops;
+    uint64_t num_pivot_ops;
     SimplexStats() : num_bland_ops(0), num_pivot_ops(0) {}
     void printStatistics(std::ostream& os)
     {
@@ -32,6 +33,7 @@ class Simplex {
 
     Tableau tableau;
     SimplexStats simplex_stats;
+    opensmt::ResourceLimits * resourceLimits = nullptr;
     void  pivot(LVRef basic, LVRef nonBasic);
     LVRef getBasicVarToFixByBland() const;
     LVRef getBasicVarToFixByShortestPoly() const;
@@ -66,10 +68,15 @@ public:
     Simplex(LABoundStore&bs) : model(new LRAModel(bs)), boundStore(bs) {}
     ~Simplex();
 
+    SimplexStats const & getStats() const { return simplex_stats; }
+
     void initModel() { model->init(); }
 
     void clear() { model->clear(); candidates.clear(); tableau.clear(); boundsActivated.clear(); }
+    // Returns the bounds in conflict, or no bounds if a feasible assignment was found or the resource limits were
+    // exhausted
     Explanation checkSimplex();
+    void setResourceLimits(opensmt::ResourceLimits * limits) { resourceLimits = limits; }
     void pushBacktrackPoint() { model->pushBacktrackPoint(); }
     void popBacktrackPoint()  { model->popBacktrackPoint(); }
     inline void finalizeBacktracking() {
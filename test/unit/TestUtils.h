@@ -0,0 +1,45 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef OPENSMT_TESTUTILS_H
+#define OPENSMT_TESTUTILS_H
+
+#include <Logic.h>
+#include <SMTConfig.h>
+
+#include <string>
+
+namespace opensmt::test {
+
+inline void setOption(SMTConfig & config, const char * name, int value) {
+    const char * msg = "ok";
+    config.setOption(name, SMTOption(value), msg);
+}
+
+// The variable saying that the pigeon sits in the hole
+inline PTRef pigeonIn(Logic & logic, int pigeon, int hole) {
+    return logic.mkBoolVar(("p" + std::to_string(pigeon) + "h" + std::to_string(hole)).c_str());
+}
+
+// Every pigeon sits in some hole and no two pigeons share a hole; unsatisfiable when there are more pigeons than holes
+inline vec<PTRef> pigeonhole(Logic & logic, int pigeons, int holes) {
+    vec<PTRef> constraints;
+    for (int p = 0; p < pigeons; ++p) {
+        vec<PTRef> someHole;
+        for (int h = 0; h < holes; ++h) { someHole.push(pigeonIn(logic, p, h)); }
+        constraints.push(logic.mkOr(std::move(someHole)));
+    }
+    for (int h = 0; h < holes; ++h) {
+        for (int p = 0; p < pigeons; ++p) {
+            for (int q = p + 1; q < pigeons; ++q) {
+                constraints.push(logic.mkNot(logic.mkAnd(pigeonIn(logic, p, h), pigeonIn(logic, q, h))));
+            }
+        }
+    }
+    return constraints;
+}
+
+}
+
+#endif // OPENSMT_TESTUTILS_H
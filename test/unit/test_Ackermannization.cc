@@ -0,0 +1,132 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include <Logic.h>
+#include <MainSolver.h>
+#include <SMTConfig.h>
+#include <Ackermanize.h>
+#include "TestUtils.h"
+
+using opensmt::test::setOption;
+
+class AckermannizationTest : public ::testing::Test {
+protected:
+    AckermannizationTest() : logic{opensmt::Logic_t::QF_UF} {
+        U = logic.declareUninterpretedSort("U");
+        f = logic.declareFun("f", U, {U});
+        g = logic.declareFun("g", U, {U, U});
+        x = logic.mkVar(U, "x");
+        y = logic.mkVar(U, "y");
+        z = logic.mkVar(U, "z");
+    }
+    PTRef f_(PTRef arg) { return logic.mkUninterpFun(f, {arg}); }
+    PTRef g_(PTRef arg1, PTRef arg2) { return logic.mkUninterpFun(g, {arg1, arg2}); }
+    int conjuncts(PTRef fla) { return logic.isAnd(fla) ? logic.getPterm(fla).size() : 1; }
+    uint64_t ackermannLemmas(MainSolver & solver) { return solver.getStatistics().find("uf-solver.ackermann-lemmas")->counter; }
+    Logic logic;
+    SMTConfig config;
+    SRef U;
+    SymRef f;
+    SymRef g;
+    PTRef x;
+    PTRef y;
+    PTRef z;
+};
+
+TEST_F(AckermannizationTest, test_EliminatesApplications) {
+    Ackermanize ackermanize(logic, 2, 8);
+    PTRef fla = logic.mkAnd(logic.mkEq(x, y), logic.mkNot(logic.mkEq(f_(x), f_(y))));
+    PTRef res = ackermanize.rewrite(fla);
+    EXPECT_TRUE(ackermanize.hasEliminatedFunctions());
+    std::vector<PTRef> toVisit{res};
+    while (not toVisit.empty()) {
+        PTRef term = toVisit.back();
+        toVisit.pop_back();
+        ASSERT_NE(logic.getSymRef(term), f);
+        for (PTRef child : logic.getPterm(term)) { toVisit.push_back(child); }
+    }
+}
+
+TEST_F(AckermannizationTest, test_KeepsSymbolsOverLimits) {
+    Ackermanize ackermanize(logic, 1, 8);
+    PTRef fla = logic.mkNot(logic.mkEq(g_(x, y), g_(y, x)));
+    EXPECT_EQ(ackermanize.rewrite(fla), fla);
+    EXPECT_FALSE(ackermanize.hasEliminatedFunctions());
+}
+
+TEST_F(AckermannizationTest, test_EmitsOnlyNewConstraints) {
+    Ackermanize ackermanize(logic, 2, 8);
+    // The disequality and the constraint between f(x) and f(y)
+    EXPECT_EQ(conjuncts(ackermanize.rewrite(logic.mkNot(logic.mkEq(f_(x), f_(y))), 0, 0)), 2);
+    // The equality and the constraints between f(z) and the earlier applications
+    EXPECT_EQ(conjuncts(ackermanize.rewrite(logic.mkEq(f_(z), x), 1, 1)), 3);
+    // Nothing new in the same frame
+    EXPECT_EQ(conjuncts(ackermanize.rewrite(logic.mkEq(f_(x), z), 1, 1)), 1);
+    // The frame has been popped and another one pushed, which needs the constraints of f(z) again
+    EXPECT_EQ(conjuncts(ackermanize.rewrite(logic.mkEq(f_(z), y), 1, 2)), 3);
+}
+
+TEST_F(AckermannizationTest, test_Unsat) {
+    setOption(config, SMTConfig::o_ackermannize, 1);
+    MainSolver solver(logic, config, "ackermann");
+    solver.insertFormula(logic.mkEq(x, y));
+    solver.insertFormula(logic.mkNot(logic.mkEq(g_(f_(x), z), g_(f_(y), z))));
+    EXPECT_EQ(solver.check(), s_False);
+}
+
+TEST_F(AckermannizationTest, test_ModelInterpretsEliminatedFunctions) {
+    setOption(config, SMTConfig::o_ackermannize, 1);
+    MainSolver solver(logic, config, "ackermann");
+    PTRef f_x = f_(x);
+    PTRef f_y = f_(y);
+    solver.insertFormula(logic.mkNot(logic.mkEq(f_x, f_y)));
+    solver.insertFormula(logic.mkEq(f_x, z));
+    ASSERT_EQ(solver.check(), s_True);
+    auto model = solver.getModel();
+    EXPECT_NE(model->evaluate(f_x), model->evaluate(f_y));
+    EXPECT_EQ(model->evaluate(f_x), model->evaluate(z));
+    EXPECT_NE(model->evaluate(x), model->evaluate(y));
+}
+
+TEST_F(AckermannizationTest, test_Incremental) {
+    setOption(config, SMTConfig::o_ackermannize, 1);
+    setOption(config, SMTConfig::o_ackermann_max_occurrences, 2);
+    MainSolver solver(logic, config, "ackermann");
+    solver.insertFormula(logic.mkNot(logic.mkEq(f_(x), f_(y))));
+    ASSERT_EQ(solver.check(), s_True);
+    solver.push();
+    // Pushes f over the occurrence limit
+    solver.insertFormula(logic.mkEq(f_(z), x));
+    solver.insertFormula(logic.mkEq(x, y));
+    EXPECT_EQ(solver.check(), s_False);
+    solver.pop();
+    ASSERT_EQ(solver.check(), s_True);
+    auto model = solver.getModel();
+    EXPECT_NE(model->evaluate(f_(x)), model->evaluate(f_(y)));
+}
+
+TEST_F(AckermannizationTest, test_DynamicAckermannLemmas) {
+    setOption(config, SMTConfig::o_dynamic_ackermann, 1);
+    MainSolver solver(logic, config, "ackermann");
+    PTRef a = logic.mkBoolVar("a");
+    solver.insertFormula(logic.mkOr(a, logic.mkEq(x, y)));
+    solver.insertFormula(logic.mkOr(logic.mkNot(a), logic.mkEq(x, z)));
+    solver.insertFormula(logic.mkEq(y, z));
+    solver.insertFormula(logic.mkNot(logic.mkEq(f_(x), f_(y))));
+    solver.insertFormula(logic.mkNot(logic.mkEq(f_(x), f_(z))));
+    EXPECT_EQ(solver.check(), s_False);
+    EXPECT_GT(ackermannLemmas(solver), 0);
+}
+
+TEST_F(AckermannizationTest, test_DynamicAckermannLemmasAreLazy) {
+    setOption(config, SMTConfig::o_dynamic_ackermann, 1);
+    MainSolver solver(logic, config, "ackermann");
+    // The congruences are never part of a conflict, so no lemma is needed
+    solver.insertFormula(logic.mkNot(logic.mkEq(f_(x), f_(y))));
+    solver.insertFormula(logic.mkNot(logic.mkEq(f_(y), f_(z))));
+    solver.insertFormula(logic.mkEq(g_(x, y), g_(y, z)));
+    EXPECT_EQ(solver.check(), s_True);
+    EXPECT_EQ(ackermannLemmas(solver), 0);
+}
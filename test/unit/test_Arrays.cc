@@ -38,3 +38,92 @@ TEST_F(ArraysTest, test_ReadOverWrite) {
     ASSERT_EQ(res, s_False);
 }
 
+TEST(ArraySolverTest, test_ReadOverWeakEqAfterBacktrack) {
+    Logic logic{opensmt::Logic_t::QF_AX};
+    SRef indexSort = logic.declareUninterpretedSort("Index");
+    SRef elementSort = logic.declareUninterpretedSort("Element");
+    SRef arraySort = logic.getArraySort(indexSort, elementSort);
+    PTRef a = logic.mkVar(arraySort, "a");
+    PTRef i = logic.mkVar(indexSort, "i");
+    PTRef j = logic.mkVar(indexSort, "j");
+    PTRef v = logic.mkVar(elementSort, "v");
+    PTRef store = logic.mkStore({a, i, v});
+    PTRef selectsDiffer = logic.mkNot(logic.mkEq(logic.mkSelect({store, j}), logic.mkSelect({a, j})));
+
+    SMTConfig config;
+    MainSolver solver(logic, config, "solver");
+    solver.insertFormula(selectsDiffer);
+    ASSERT_EQ(solver.check(), s_True);
+    solver.push();
+    solver.insertFormula(logic.mkNot(logic.mkEq(i, j)));
+    EXPECT_EQ(solver.check(), s_False);
+    solver.pop();
+    solver.push();
+    solver.insertFormula(logic.mkEq(i, j));
+    EXPECT_EQ(solver.check(), s_True);
+    solver.pop();
+    solver.insertFormula(logic.mkEq(v, logic.mkSelect({a, i})));
+    EXPECT_EQ(solver.check(), s_False);
+}
+
+TEST(ArraySolverTest, test_EqualArraysAfterBacktrack) {
+    Logic logic{opensmt::Logic_t::QF_AX};
+    SRef indexSort = logic.declareUninterpretedSort("Index");
+    SRef elementSort = logic.declareUninterpretedSort("Element");
+    SRef arraySort = logic.getArraySort(indexSort, elementSort);
+    PTRef a = logic.mkVar(arraySort, "a");
+    PTRef b = logic.mkVar(arraySort, "b");
+    PTRef c = logic.mkVar(arraySort, "c");
+    PTRef i = logic.mkVar(indexSort, "i");
+    PTRef j = logic.mkVar(indexSort, "j");
+    PTRef v = logic.mkVar(elementSort, "v");
+    PTRef store = logic.mkStore({a, i, v});
+    PTRef selectsDiffer = logic.mkNot(logic.mkEq(logic.mkSelect({store, j}), logic.mkSelect({b, j})));
+
+    SMTConfig config;
+    MainSolver solver(logic, config, "solver");
+    solver.insertFormula(selectsDiffer);
+    ASSERT_EQ(solver.check(), s_True);
+    solver.push();
+    solver.insertFormula(logic.mkEq(a, b));
+    solver.insertFormula(logic.mkNot(logic.mkEq(i, j)));
+    EXPECT_EQ(solver.check(), s_False);
+    solver.pop();
+    solver.push();
+    solver.insertFormula(logic.mkEq(a, b));
+    EXPECT_EQ(solver.check(), s_True);
+    solver.pop();
+    solver.insertFormula(logic.mkNot(logic.mkEq(i, j)));
+    EXPECT_EQ(solver.check(), s_True);
+    solver.insertFormula(logic.mkEq(b, c));
+    solver.insertFormula(logic.mkEq(c, a));
+    EXPECT_EQ(solver.check(), s_False);
+}
+
+TEST(ArraySolverTest, test_EqualStoreIndicesAfterBacktrack) {
+    Logic logic{opensmt::Logic_t::QF_AX};
+    SRef indexSort = logic.declareUninterpretedSort("Index");
+    SRef elementSort = logic.declareUninterpretedSort("Element");
+    SRef arraySort = logic.getArraySort(indexSort, elementSort);
+    PTRef a = logic.mkVar(arraySort, "a");
+    PTRef i = logic.mkVar(indexSort, "i");
+    PTRef j = logic.mkVar(indexSort, "j");
+    PTRef k = logic.mkVar(indexSort, "k");
+    PTRef v = logic.mkVar(elementSort, "v");
+    PTRef w = logic.mkVar(elementSort, "w");
+    PTRef store = logic.mkStore({logic.mkStore({a, i, v}), j, w});
+    PTRef selectsDiffer = logic.mkNot(logic.mkEq(logic.mkSelect({store, k}), logic.mkSelect({a, k})));
+
+    SMTConfig config;
+    MainSolver solver(logic, config, "solver");
+    solver.insertFormula(selectsDiffer);
+    solver.insertFormula(logic.mkNot(logic.mkEq(i, k)));
+    ASSERT_EQ(solver.check(), s_True);
+    solver.push();
+    solver.insertFormula(logic.mkEq(i, j));
+    EXPECT_EQ(solver.check(), s_False);
+    solver.pop();
+    EXPECT_EQ(solver.check(), s_True);
+    solver.insertFormula(logic.mkNot(logic.mkEq(j, k)));
+    EXPECT_EQ(solver.check(), s_False);
+}
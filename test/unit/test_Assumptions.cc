@@ -0,0 +1,112 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include <ArithLogic.h>
+#include <MainSolver.h>
+#include <OsmtApiException.h>
+#include <SMTConfig.h>
+#include "TestUtils.h"
+
+#include <algorithm>
+
+using opensmt::test::setOption;
+
+class AssumptionsTest : public ::testing::Test {
+protected:
+    AssumptionsTest() : logic{opensmt::Logic_t::QF_LRA} {
+        a = logic.mkBoolVar("a");
+        b = logic.mkBoolVar("b");
+        c = logic.mkBoolVar("c");
+        d = logic.mkBoolVar("d");
+        x = logic.mkRealVar("x");
+        y = logic.mkRealVar("y");
+    }
+    static bool contains(vec<PTRef> const & core, PTRef tr) {
+        return std::find(core.begin(), core.end(), tr) != core.end();
+    }
+    ArithLogic logic;
+    SMTConfig config;
+    PTRef a, b, c, d;
+    PTRef x, y;
+};
+
+TEST_F(AssumptionsTest, test_UnsatOnlyUnderAssumptions) {
+    MainSolver solver(logic, config, "assumptions");
+    solver.insertFormula(logic.mkImpl(a, logic.mkLeq(x, logic.getTerm_RealZero())));
+    solver.insertFormula(logic.mkImpl(b, logic.mkGeq(x, logic.getTerm_RealOne())));
+    solver.insertFormula(logic.mkOr(c, d));
+    EXPECT_EQ(solver.checkAssuming({a, b, c}), s_False);
+    auto const & core = solver.getUnsatCore();
+    EXPECT_EQ(core.size(), 2);
+    EXPECT_TRUE(contains(core, a));
+    EXPECT_TRUE(contains(core, b));
+    // Nothing has to be retracted
+    EXPECT_EQ(solver.checkAssuming({a, c}), s_True);
+    EXPECT_EQ(solver.check(), s_True);
+    EXPECT_EQ(solver.checkAssuming({logic.mkNot(c), logic.mkNot(d)}), s_False);
+    EXPECT_EQ(solver.getUnsatCore().size(), 2);
+    EXPECT_EQ(solver.checkAssuming({b, logic.mkNot(c)}), s_True);
+    auto model = solver.getModel();
+    EXPECT_EQ(model->evaluate(b), logic.getTerm_true());
+    EXPECT_EQ(model->evaluate(c), logic.getTerm_false());
+}
+
+TEST_F(AssumptionsTest, test_UnsatIndependentOfAssumptions) {
+    MainSolver solver(logic, config, "assumptions");
+    solver.insertFormula(logic.mkOr(a, b));
+    solver.push();
+    solver.insertFormula(logic.mkLt(x, y));
+    solver.insertFormula(logic.mkLt(y, x));
+    EXPECT_EQ(solver.checkAssuming({a}), s_False);
+    EXPECT_EQ(solver.getUnsatCore().size(), 0);
+    EXPECT_EQ(solver.check(), s_False);
+    solver.pop();
+    EXPECT_EQ(solver.checkAssuming({logic.mkNot(a)}), s_True);
+}
+
+TEST_F(AssumptionsTest, test_AssumptionsInFrames) {
+    MainSolver solver(logic, config, "assumptions");
+    solver.insertFormula(logic.mkImpl(a, b));
+    solver.push();
+    solver.insertFormula(logic.mkImpl(b, c));
+    EXPECT_EQ(solver.checkAssuming({a, logic.mkNot(c)}), s_False);
+    EXPECT_EQ(solver.getUnsatCore().size(), 2);
+    solver.pop();
+    EXPECT_EQ(solver.checkAssuming({a, logic.mkNot(c)}), s_True);
+    EXPECT_EQ(solver.checkAssuming({a, logic.mkNot(b)}), s_False);
+}
+
+TEST_F(AssumptionsTest, test_AssertedAssumption) {
+    MainSolver solver(logic, config, "assumptions");
+    solver.insertFormula(a);
+    solver.insertFormula(logic.mkEq(b, c));
+    EXPECT_EQ(solver.checkAssuming({logic.mkNot(a)}), s_False);
+    EXPECT_EQ(solver.checkAssuming({b, logic.mkNot(c)}), s_False);
+    EXPECT_EQ(solver.getUnsatCore().size(), 2);
+    EXPECT_EQ(solver.checkAssuming({b, c}), s_True);
+}
+
+TEST_F(AssumptionsTest, test_MinimizedCore) {
+    setOption(config, SMTConfig::o_minimize_unsat_cores, 1);
+    MainSolver solver(logic, config, "assumptions");
+    // Any of a, b, c forces x <= 0, and d forces x >= 1
+    solver.insertFormula(logic.mkImpl(logic.mkOr(logic.mkOr(a, b), c), logic.mkLeq(x, logic.getTerm_RealZero())));
+    solver.insertFormula(logic.mkImpl(d, logic.mkGeq(x, logic.getTerm_RealOne())));
+    EXPECT_EQ(solver.checkAssuming({a, b, c, d}), s_False);
+    auto const & core = solver.getUnsatCore();
+    ASSERT_EQ(core.size(), 2);
+    EXPECT_TRUE(contains(core, d));
+    EXPECT_EQ(solver.getStatus(), s_False);
+    EXPECT_EQ(solver.check(), s_True);
+}
+
+TEST_F(AssumptionsTest, test_InvalidAssumption) {
+    MainSolver solver(logic, config, "assumptions");
+    solver.insertFormula(logic.mkOr(a, b));
+    EXPECT_THROW(solver.checkAssuming({logic.mkAnd(a, b)}), OsmtApiException);
+    EXPECT_THROW(solver.checkAssuming({logic.mkLeq(x, y)}), OsmtApiException);
+    EXPECT_EQ(solver.check(), s_True);
+    EXPECT_THROW(solver.getUnsatCore(), OsmtApiException);
+}
@@ -0,0 +1,147 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include <Logic.h>
+#include <MainSolver.h>
+#include <SMTConfig.h>
+#include "TestUtils.h"
+
+using opensmt::test::setOption;
+
+class CnfizationTest : public ::testing::Test {
+protected:
+    CnfizationTest() : logic{opensmt::Logic_t::QF_UF} {
+        a = logic.mkBoolVar("a");
+        b = logic.mkBoolVar("b");
+        c = logic.mkBoolVar("c");
+        d = logic.mkBoolVar("d");
+        setOption(config, SMTConfig::o_cnf_polarity, 1);
+        // Keep the unit literals from simplifying the shared subformulas away
+        setOption(config, SMTConfig::o_do_substitutions, 0);
+    }
+    Logic logic;
+    SMTConfig config;
+    PTRef a;
+    PTRef b;
+    PTRef c;
+    PTRef d;
+};
+
+TEST_F(CnfizationTest, test_SharedSubformulaInBothPolarities) {
+    MainSolver solver(logic, config, "cnfization");
+    PTRef bc = logic.mkAnd(b, c);
+    solver.insertFormula(logic.mkOr(a, bc));
+    ASSERT_EQ(solver.check(), s_True);
+    // bc now occurs negatively as well, which needs the remaining direction of its definition
+    solver.insertFormula(logic.mkOr(d, logic.mkNot(bc)));
+    solver.insertFormula(b);
+    solver.insertFormula(c);
+    solver.insertFormula(logic.mkNot(d));
+    EXPECT_EQ(solver.check(), s_False);
+}
+
+TEST_F(CnfizationTest, test_PolaritiesInFrames) {
+    MainSolver solver(logic, config, "cnfization");
+    PTRef bc = logic.mkAnd(b, c);
+    PTRef xor_ab = logic.mkXor(a, b);
+    solver.insertFormula(logic.mkOr(d, bc));
+    solver.insertFormula(logic.mkImpl(xor_ab, c));
+    solver.push();
+    // bc was cnfized positively on the bottom level, the negative direction is added in this frame
+    solver.insertFormula(logic.mkOr(a, logic.mkNot(bc)));
+    solver.insertFormula(b);
+    solver.insertFormula(c);
+    solver.insertFormula(logic.mkNot(a));
+    EXPECT_EQ(solver.check(), s_False);
+    solver.pop();
+    solver.push();
+    solver.insertFormula(logic.mkNot(c));
+    solver.insertFormula(a);
+    EXPECT_EQ(solver.check(), s_True);
+    solver.insertFormula(logic.mkNot(b));
+    EXPECT_EQ(solver.check(), s_False);
+    solver.pop();
+    EXPECT_EQ(solver.check(), s_True);
+}
+
+TEST_F(CnfizationTest, test_ValuesOfConnectives) {
+    MainSolver solver(logic, config, "cnfization");
+    PTRef bc = logic.mkAnd(b, c);
+    PTRef cd = logic.mkOr(c, d);
+    solver.insertFormula(logic.mkOr(a, bc));
+    solver.insertFormula(logic.mkImpl(cd, a));
+    ASSERT_EQ(solver.check(), s_True);
+    auto model = solver.getModel();
+    auto toLbool = [&](PTRef val) { return val == logic.getTerm_true() ? l_True : l_False; };
+    for (PTRef tr : {a, b, c, d, bc, cd}) {
+        EXPECT_EQ(solver.getTermValue(tr), toLbool(model->evaluate(tr)));
+    }
+}
+
+TEST_F(CnfizationTest, test_ValuesOfDeepConnectivesAcrossModels) {
+    MainSolver solver(logic, config, "cnfization");
+    solver.insertFormula(logic.mkOr(a, logic.mkAnd(b, c)));
+    solver.insertFormula(logic.mkOr(c, d));
+    // Deep enough to overflow the stack if evaluated recursively
+    PTRef deep = a;
+    for (int i = 0; i < 100000; ++i) {
+        deep = logic.mkOr(logic.mkAnd(deep, b), c);
+    }
+    auto expected = [&]() {
+        if (solver.getTermValue(c) == l_True) { return l_True; }
+        return solver.getTermValue(a) && solver.getTermValue(b);
+    };
+    ASSERT_EQ(solver.check(), s_True);
+    EXPECT_EQ(solver.getTermValue(deep), expected());
+    // The values of the previous model are not reused
+    solver.insertFormula(solver.getTermValue(c) == l_True ? logic.mkNot(c) : c);
+    ASSERT_EQ(solver.check(), s_True);
+    EXPECT_EQ(solver.getTermValue(deep), expected());
+}
+
+TEST_F(CnfizationTest, test_GateElimination) {
+    setOption(config, SMTConfig::o_cnf_polarity, 0);
+    setOption(config, SMTConfig::o_incremental, 0);
+    MainSolver solver(logic, config, "cnfization");
+    vec<PTRef> assertions;
+    assertions.push(logic.mkOr(logic.mkAnd(a, b), logic.mkAnd(c, d)));
+    assertions.push(logic.mkOr(logic.mkNot(a), logic.mkAnd(b, logic.mkNot(c))));
+    assertions.push(logic.mkImpl(b, logic.mkNot(logic.mkOr(a, d))));
+    for (PTRef tr : assertions) {
+        solver.insertFormula(tr);
+    }
+    ASSERT_EQ(solver.check(), s_True);
+    EXPECT_GT(solver.getSMTSolver().gate_elims, 0);
+    auto model = solver.getModel();
+    for (PTRef tr : assertions) {
+        EXPECT_EQ(model->evaluate(tr), logic.getTerm_true());
+    }
+}
+
+TEST_F(CnfizationTest, test_EquivalentGateInputs) {
+    setOption(config, SMTConfig::o_cnf_polarity, 0);
+    setOption(config, SMTConfig::o_incremental, 0);
+    MainSolver solver(logic, config, "cnfization");
+    // a <-> b holds, so one of them is replaced by the other
+    solver.insertFormula(logic.mkEq(a, b));
+    solver.insertFormula(logic.mkOr(a, c));
+    solver.insertFormula(logic.mkOr(logic.mkNot(b), d));
+    solver.insertFormula(logic.mkNot(logic.mkAnd(c, d)));
+    ASSERT_EQ(solver.check(), s_True);
+    EXPECT_GT(solver.getSMTSolver().substituted_vars, 0);
+    auto model = solver.getModel();
+    EXPECT_EQ(model->evaluate(a), model->evaluate(b));
+    EXPECT_EQ(model->evaluate(logic.mkAnd(c, d)), logic.getTerm_false());
+}
+
+TEST_F(CnfizationTest, test_EquivalentGateInputsUnsat) {
+    setOption(config, SMTConfig::o_cnf_polarity, 0);
+    setOption(config, SMTConfig::o_incremental, 0);
+    MainSolver solver(logic, config, "cnfization");
+    solver.insertFormula(logic.mkXor(a, b));
+    solver.insertFormula(logic.mkOr(logic.mkAnd(a, c), logic.mkAnd(b, c)));
+    solver.insertFormula(logic.mkImpl(c, logic.mkEq(a, b)));
+    EXPECT_EQ(solver.check(), s_False);
+}
@@ -0,0 +1,248 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include <ArithLogic.h>
+#include <CubeAndConquer.h>
+#include <MainSolver.h>
+#include <SMTConfig.h>
+#include <TermTranslator.h>
+#include "TestUtils.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+using opensmt::test::pigeonhole;
+using opensmt::test::setOption;
+
+class CubeAndConquerTest : public ::testing::Test {
+protected:
+    CubeAndConquerTest() : logic{opensmt::Logic_t::QF_UFLRA} {
+        setOption(config, SMTConfig::o_sat_lookahead_split, 1);
+        setOption(config, SMTConfig::o_sat_split_num, 8);
+        setOption(config, SMTConfig::o_sat_split_threads, 3);
+    }
+    // Real variables x0 < x1 < ... < x(n-1) in [0, n), each one either at most i or at least i + 1 / 2
+    vec<PTRef> chain(int n) {
+        vec<PTRef> assertions;
+        for (int i = 0; i < n; ++i) {
+            x.push(logic.mkRealVar(("x" + std::to_string(i)).c_str()));
+            PTRef low = logic.mkLeq(x[i], logic.mkRealConst(i));
+            PTRef high = logic.mkGeq(x[i], logic.mkRealConst(FastRational(2 * i + 1, 2)));
+            assertions.push(logic.mkOr(low, high));
+            assertions.push(logic.mkGeq(x[i], logic.getTerm_RealZero()));
+            assertions.push(logic.mkLt(x[i], logic.mkRealConst(n)));
+            if (i > 0) { assertions.push(logic.mkLt(x[i - 1], x[i])); }
+        }
+        return assertions;
+    }
+    ArithLogic logic;
+    SMTConfig config;
+    opensmt::ResourceLimits limits;
+    vec<PTRef> x;
+};
+
+TEST_F(CubeAndConquerTest, test_Unsat) {
+    CubeAndConquer engine(logic, config, limits);
+    EXPECT_EQ(engine.solve(pigeonhole(logic, 6, 5)), s_False);
+    EXPECT_GT(engine.getCubeCount(), 1);
+    EXPECT_GT(engine.getSharedClauseCount(), 0);
+}
+
+TEST_F(CubeAndConquerTest, test_SatModel) {
+    vec<PTRef> assertions = chain(6);
+    // Only the last variable can be high
+    assertions.push(logic.mkGt(x[5], logic.mkRealConst(5)));
+    CubeAndConquer engine(logic, config, limits);
+    ASSERT_EQ(engine.solve(assertions), s_True);
+    EXPECT_GT(engine.getCubeCount(), 1);
+    auto model = engine.getModel();
+    for (PTRef tr : assertions) {
+        EXPECT_EQ(model->evaluate(tr), logic.getTerm_true());
+    }
+}
+
+TEST_F(CubeAndConquerTest, test_UninterpretedFunctions) {
+    SRef u = logic.declareUninterpretedSort("U");
+    PTRef a = logic.mkVar(u, "a");
+    PTRef b = logic.mkVar(u, "b");
+    SymRef f = logic.declareFun("f", logic.getSort_real(), {u});
+    vec<PTRef> assertions = chain(4);
+    PTRef fa = logic.mkUninterpFun(f, {a});
+    PTRef fb = logic.mkUninterpFun(f, {b});
+    assertions.push(logic.mkEq(fa, x[3]));
+    assertions.push(logic.mkEq(fb, logic.mkPlus(x[0], logic.getTerm_RealOne())));
+    assertions.push(logic.mkOr(logic.mkEq(a, b), logic.mkGeq(x[0], logic.getTerm_RealOne())));
+    CubeAndConquer engine(logic, config, limits);
+    ASSERT_EQ(engine.solve(assertions), s_True);
+    auto model = engine.getModel();
+    for (PTRef tr : assertions) {
+        EXPECT_EQ(model->evaluate(tr), logic.getTerm_true());
+    }
+}
+
+TEST_F(CubeAndConquerTest, test_MainSolverFrames) {
+    MainSolver solver(logic, config, "cube-and-conquer");
+    for (PTRef tr : chain(6)) {
+        solver.insertFormula(tr);
+    }
+    solver.push();
+    solver.insertFormula(logic.mkLt(x[5], x[0]));
+    EXPECT_EQ(solver.check(), s_False);
+    solver.pop();
+    solver.insertFormula(logic.mkGeq(x[2], logic.mkRealConst(FastRational(5, 2))));
+    ASSERT_EQ(solver.check(), s_True);
+    auto model = solver.getModel();
+    EXPECT_EQ(model->evaluate(logic.mkGeq(x[2], logic.mkRealConst(FastRational(5, 2)))), logic.getTerm_true());
+    EXPECT_EQ(model->evaluate(logic.mkLt(x[4], x[5])), logic.getTerm_true());
+}
+
+TEST_F(CubeAndConquerTest, test_TermTranslation) {
+    ArithLogic other{opensmt::Logic_t::QF_UFLRA};
+    SRef u = logic.declareUninterpretedSort("U");
+    SymRef g = logic.declareFun("g", u, {u, logic.getSort_real()});
+    PTRef a = logic.mkVar(u, "a");
+    PTRef y = logic.mkRealVar("y");
+    PTRef z = logic.mkRealVar("z");
+    PTRef gay = logic.mkUninterpFun(g, {a, y});
+    PTRef term = logic.mkAnd(logic.mkEq(gay, a), logic.mkLeq(logic.mkPlus(y, logic.mkTimes(logic.mkRealConst(3), z)),
+                                                           logic.mkRealConst(FastRational(7, 2))));
+    TermTranslator translator(logic, other);
+    PTRef translated = translator.translate(term);
+    EXPECT_EQ(other.printTerm(translated), logic.printTerm(term));
+    EXPECT_EQ(translator.translate(term), translated);
+    TermTranslator back(other, logic);
+    EXPECT_EQ(back.translate(translated), term);
+}
+
+TEST_F(CubeAndConquerTest, test_Interrupt) {
+    MainSolver solver(logic, config, "cube-and-conquer");
+    for (PTRef tr : pigeonhole(logic, 13, 12)) {
+        solver.insertFormula(tr);
+    }
+    std::thread interrupter([&solver]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        solver.interrupt();
+    });
+    EXPECT_EQ(solver.check(), s_Undef);
+    interrupter.join();
+    EXPECT_EQ(solver.getUnknownReason(), opensmt::UnknownReason::Interrupted);
+}
+
+class ScatterTest : public CubeAndConquerTest {
+protected:
+    ScatterTest() {
+        setOption(config, SMTConfig::o_sat_lookahead_split, 0);
+        setOption(config, SMTConfig::o_sat_scatter_split, 1);
+        setOption(config, SMTConfig::o_sat_split_threads, 4);
+    }
+};
+
+TEST_F(ScatterTest, test_Unsat) {
+    CubeAndConquer engine(logic, config, limits);
+    EXPECT_EQ(engine.solve(pigeonhole(logic, 8, 7)), s_False);
+    // The idle workers got their cubes by scattering
+    EXPECT_GT(engine.getCubeCount(), 1);
+}
+
+TEST_F(ScatterTest, test_StopAtConflicts) {
+    // A worker asked to scatter its cube keeps searching until it has had enough conflicts
+    SMTConfig workerConfig;
+    MainSolver solver(logic, workerConfig, "worker");
+    for (PTRef tr : pigeonhole(logic, 8, 7)) {
+        solver.insertFormula(tr);
+    }
+    SimpSMTSolver & smtSolver = solver.getSMTSolver();
+    smtSolver.stopAtConflicts = 100;
+    EXPECT_EQ(smtSolver.conflicts, 0);
+    EXPECT_EQ(solver.check(), s_Undef);
+    EXPECT_GE(smtSolver.conflicts, 100);
+    EXPECT_LT(smtSolver.conflicts, 200);
+}
+
+TEST_F(ScatterTest, test_SatModel) {
+    vec<PTRef> assertions = chain(6);
+    assertions.push(logic.mkGt(x[5], logic.mkRealConst(5)));
+    CubeAndConquer engine(logic, config, limits);
+    ASSERT_EQ(engine.solve(assertions), s_True);
+    auto model = engine.getModel();
+    for (PTRef tr : assertions) {
+        EXPECT_EQ(model->evaluate(tr), logic.getTerm_true());
+    }
+}
+
+TEST_F(ScatterTest, test_MainSolver) {
+    MainSolver solver(logic, config, "scatter");
+    for (PTRef tr : pigeonhole(logic, 7, 6)) {
+        solver.insertFormula(tr);
+    }
+    EXPECT_EQ(solver.check(), s_False);
+
+    MainSolver satSolver(logic, config, "scatter");
+    for (PTRef tr : chain(5)) {
+        satSolver.insertFormula(tr);
+    }
+    satSolver.insertFormula(logic.mkGeq(x[1], logic.mkRealConst(FastRational(3, 2))));
+    ASSERT_EQ(satSolver.check(), s_True);
+    auto model = satSolver.getModel();
+    EXPECT_EQ(model->evaluate(logic.mkGeq(x[1], logic.mkRealConst(FastRational(3, 2)))), logic.getTerm_true());
+}
+
+TEST_F(ScatterTest, test_Deterministic) {
+    setOption(config, SMTConfig::o_sat_split_sync_conflicts, 200);
+    CubeAndConquer first(logic, config, limits);
+    ASSERT_EQ(first.solve(pigeonhole(logic, 8, 7)), s_False);
+    EXPECT_GT(first.getRoundCount(), 1);
+    EXPECT_GT(first.getCubeCount(), 1);
+    for (int run = 0; run < 3; ++run) {
+        CubeAndConquer again(logic, config, limits);
+        ASSERT_EQ(again.solve(pigeonhole(logic, 8, 7)), s_False);
+        EXPECT_EQ(again.getRoundCount(), first.getRoundCount());
+        EXPECT_EQ(again.getCubeCount(), first.getCubeCount());
+        EXPECT_EQ(again.getSharedClauseCount(), first.getSharedClauseCount());
+    }
+}
+
+TEST_F(ScatterTest, test_DeterministicModel) {
+    setOption(config, SMTConfig::o_sat_split_sync_conflicts, 50);
+    vec<PTRef> assertions = chain(8);
+    for (int i = 0; i < 4; ++i) {
+        assertions.push(logic.mkOr(logic.mkGeq(x[i], logic.mkRealConst(FastRational(2 * i + 1, 2))),
+                                   logic.mkGeq(x[i + 4], logic.mkRealConst(FastRational(2 * i + 9, 2)))));
+    }
+    CubeAndConquer first(logic, config, limits);
+    ASSERT_EQ(first.solve(assertions), s_True);
+    auto model = first.getModel();
+    for (int run = 0; run < 3; ++run) {
+        CubeAndConquer again(logic, config, limits);
+        ASSERT_EQ(again.solve(assertions), s_True);
+        EXPECT_EQ(again.getCubeCount(), first.getCubeCount());
+        auto otherModel = again.getModel();
+        for (PTRef var : x) {
+            EXPECT_EQ(otherModel->evaluate(var), model->evaluate(var));
+        }
+    }
+}
+
+TEST_F(ScatterTest, test_TimeLimit) {
+    setOption(config, SMTConfig::o_time_limit, 200);
+    MainSolver solver(logic, config, "scatter");
+    for (PTRef tr : pigeonhole(logic, 13, 12)) {
+        solver.insertFormula(tr);
+    }
+    EXPECT_EQ(solver.check(), s_Undef);
+    EXPECT_EQ(solver.getUnknownReason(), opensmt::UnknownReason::TimeLimit);
+}
+
+TEST_F(ScatterTest, test_DeterministicTimeLimit) {
+    setOption(config, SMTConfig::o_sat_split_sync_conflicts, 200);
+    setOption(config, SMTConfig::o_time_limit, 200);
+    MainSolver solver(logic, config, "scatter");
+    for (PTRef tr : pigeonhole(logic, 13, 12)) {
+        solver.insertFormula(tr);
+    }
+    EXPECT_EQ(solver.check(), s_Undef);
+    EXPECT_EQ(solver.getUnknownReason(), opensmt::UnknownReason::TimeLimit);
+}
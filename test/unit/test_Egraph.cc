@@ -7,6 +7,9 @@
 #include <gtest/gtest.h>
 #include "Egraph.h"
 #include "TreeOps.h"
+#include "TestUtils.h"
+
+using opensmt::test::setOption;
 
 TEST(UseVector_test, testAdd){
     UseVector uv;
@@ -139,3 +142,42 @@ TEST_F(EgraphTest, test_IncrementalAddition) {
     ASSERT_TRUE(egraph.assertLit({eq3, l_True}));
     ASSERT_EQ(egraph.check(true), TRes::SAT);
 }
+
+TEST_F(EgraphTest, test_MinimizedExplanation) {
+    SRef sref = logic.declareUninterpretedSort("U");
+    PTRef a = logic.mkVar(sref, "a");
+    PTRef b = logic.mkVar(sref, "b");
+    SymRef f = logic.declareFun("f", sref, {sref});
+    SymRef g = logic.declareFun("g", sref, {sref, sref});
+    PTRef fa = logic.mkUninterpFun(f, {a});
+    PTRef fb = logic.mkUninterpFun(f, {b});
+    PTRef eqF = logic.mkEq(fa, fb);
+    PTRef eqArgs = logic.mkEq(a, b);
+    PTRef eqG = logic.mkEq(logic.mkUninterpFun(g, {a, fa}), logic.mkUninterpFun(g, {b, fb}));
+    // g(a, f(a)) = g(b, f(b)) is explained by both f(a) = f(b) and a = b, but the latter implies the former
+    vec<PtAsgn> const literals{{eqF, l_True}, {eqArgs, l_True}, {eqG, l_False}};
+    auto conflict = [&](vec<PtAsgn> const & lits, bool minimize) {
+        SMTConfig config;
+        setOption(config, SMTConfig::o_minimize_uf_explanations, minimize);
+        Egraph solver(config, logic);
+        for (PtAsgn lit : lits) { solver.declareAtom(lit.tr); }
+        vec<PtAsgn> expl;
+        for (PtAsgn lit : lits) {
+            solver.pushBacktrackPoint();
+            if (not solver.assertLit(lit)) {
+                solver.getConflict(expl);
+                break;
+            }
+        }
+        return expl;
+    };
+    vec<PtAsgn> plain = conflict(literals, false);
+    ASSERT_EQ(plain.size(), 3);
+    vec<PtAsgn> minimized = conflict(literals, true);
+    ASSERT_EQ(minimized.size(), 2);
+    for (PtAsgn lit : minimized) {
+        EXPECT_NE(lit.tr, eqF);
+    }
+    // The minimized literals are still in conflict on their own
+    EXPECT_EQ(conflict(minimized, false).size(), 2);
+}
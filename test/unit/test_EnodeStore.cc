@@ -99,4 +99,38 @@ TEST_F(EnodeStoreTest, testUFMixed) {
     ASSERT_TRUE(enodeStore.needsEnode(a));
     ASSERT_TRUE(enodeStore.needsEnode(mixed));
     ASSERT_TRUE(enodeStore.needsEnode(x));
-}
\ No newline at end of file
+}
+
+TEST_F(EnodeStoreTest, testSignatureTable) {
+    SRef ufsort = logic.declareUninterpretedSort("U");
+    SymRef f = logic.declareFun("f", ufsort, {ufsort});
+    EnodeStore enodeStore(logic);
+    vec<ERef> applications;
+    for (int i = 0; i < 100; ++i) {
+        PTRef var = logic.mkVar(ufsort, ("x" + std::to_string(i)).c_str());
+        PTRef app = logic.mkUninterpFun(f, {var});
+        enodeStore.constructTerm(var);
+        enodeStore.constructTerm(app);
+        applications.push(enodeStore.getERef(app));
+    }
+    for (ERef app : applications) {
+        ASSERT_FALSE(enodeStore.containsSig(app));
+        enodeStore.insertSig(app);
+    }
+    for (ERef app : applications) {
+        ASSERT_EQ(enodeStore.lookupSig(app), app);
+    }
+    // Remove and re-insert in LIFO order as done by merges and their undoing
+    for (int round = 0; round < 10; ++round) {
+        for (int i = applications.size() - 1; i >= 50; --i) {
+            enodeStore.removeSig(applications[i]);
+        }
+        for (int i = 50; i < applications.size(); ++i) {
+            ASSERT_FALSE(enodeStore.containsSig(applications[i]));
+            enodeStore.insertSig(applications[i]);
+        }
+    }
+    for (ERef app : applications) {
+        ASSERT_EQ(enodeStore.lookupSig(app), app);
+    }
+}
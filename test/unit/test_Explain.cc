@@ -70,4 +70,28 @@ TEST_F(UFExplainTest, test_UFExplain) {
         }
     }
 
-}
\ No newline at end of file
+}
+
+TEST_F(UFExplainTest, test_CachedExplanationInvalidatedOnBacktrack) {
+    PTRef eq1 = logic.mkEq(c2.tr, c1.tr);
+    PTRef eq2 = logic.mkEq(c1.tr, c0.tr);
+    PTRef eq3 = logic.mkEq(c2.tr, c0.tr);
+
+    Explainer explainer(store);
+    explainer.storeExplanation(c2.er, c1.er, {eq1, l_True});
+    explainer.storeExplanation(c1.er, c0.er, {eq2, l_True});
+    auto first = explainer.explain(c2.er, c0.er);
+    ASSERT_EQ(first.size(), 2);
+    auto cached = explainer.explain(c0.er, c2.er);
+    ASSERT_EQ(cached.size(), 2);
+    // Still valid after adding a new edge
+    explainer.storeExplanation(f_c1_c0.er, f_c2_c0.er, PtAsgn_Undef);
+    ASSERT_EQ(explainer.explain(c2.er, c0.er).size(), 2);
+    explainer.removeExplanation();
+    explainer.removeExplanation();
+    explainer.removeExplanation();
+    explainer.storeExplanation(c2.er, c0.er, {eq3, l_True});
+    auto afterBacktrack = explainer.explain(c2.er, c0.er);
+    ASSERT_EQ(afterBacktrack.size(), 1);
+    EXPECT_EQ(afterBacktrack[0].tr, eq3);
+}
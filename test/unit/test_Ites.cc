@@ -6,6 +6,8 @@
 #include <ArithLogic.h>
 #include <IteToSwitch.h>
 #include <IteHandler.h>
+#include <IteLifter.h>
+#include <MainSolver.h>
 #include <TreeOps.h>
 
 class LogicIteTest: public ::testing::Test {
@@ -41,6 +43,12 @@ public:
     static bool contains(const vec<PTRef>& trs, PTRef tr) {
         return std::any_of(trs.begin(), trs.end(), [tr](PTRef tr_in_vec) { return tr_in_vec == tr; });
     }
+    int countAuxVars(PTRef tr) {
+        auto vars = variables(logic, tr);
+        return std::count_if(vars.begin(), vars.end(), [this](PTRef var) {
+            return std::string(logic.getSymName(var)).compare(0, IteHandler::itePrefix.size(), IteHandler::itePrefix) == 0;
+        });
+    }
 };
 
 TEST_F(LogicIteTest, test_UFIte) {
@@ -294,4 +302,73 @@ TEST_F(LogicIteTest, test_IteHandler_Inverse) {
         std::cout << logic.pp(root) << std::endl;
         std::cout << logic.pp(rootWithItes) << std::endl;
     }
-}
\ No newline at end of file
+}
+
+TEST_F(IteManagerTest, test_IteLiftingIntoAtom) {
+    PTRef x = logic.mkVar(lrasort, "x");
+    PTRef c = logic.mkBoolVar("c");
+    PTRef fla = logic.mkLeq(x, logic.mkIte(c, logic.mkConst("1"), logic.mkConst("2")));
+    EXPECT_EQ(countAuxVars(IteHandler(logic, 0, false).rewrite(fla)), 1);
+    PTRef res = IteHandler(logic, 0, true).rewrite(fla);
+    EXPECT_EQ(countAuxVars(res), 0);
+    EXPECT_EQ(res, logic.mkAnd(logic.mkOr(logic.mkNot(c), logic.mkLeq(x, logic.mkConst("1"))),
+                               logic.mkOr(c, logic.mkLeq(x, logic.mkConst("2")))));
+}
+
+TEST_F(IteManagerTest, test_IteLiftingMergesSharedConditions) {
+    //  (<= 0 (+ w (ite c x y) (* 2 (ite c y (ite d x z)))))
+    PTRef x = logic.mkVar(lrasort, "x");
+    PTRef y = logic.mkVar(lrasort, "y");
+    PTRef z = logic.mkVar(lrasort, "z");
+    PTRef w = logic.mkVar(lrasort, "w");
+    PTRef c = logic.mkBoolVar("c");
+    PTRef d = logic.mkBoolVar("d");
+    PTRef ite1 = logic.mkIte(c, x, y);
+    PTRef ite2 = logic.mkIte(c, y, logic.mkIte(d, x, z));
+    PTRef fla = logic.mkLeq(logic.getTerm_RealZero(), logic.mkPlus(vec<PTRef>{w, ite1, logic.mkTimes(logic.mkConst("2"), ite2)}));
+    EXPECT_EQ(countAuxVars(IteHandler(logic, 0, false).rewrite(fla)), 2);
+    IteLifter lifter(logic);
+    PTRef res = lifter.lift(fla);
+    EXPECT_EQ(lifter.getMergedItes(), 1);
+    EXPECT_EQ(lifter.getLiftedAtoms(), 1);
+    EXPECT_EQ(countAuxVars(IteHandler(logic, 0, true).rewrite(fla)), 0);
+    // The condition c is split on only once
+    PTRef expected = logic.mkAnd(
+        logic.mkOr(logic.mkNot(c), logic.mkLeq(logic.getTerm_RealZero(), logic.mkPlus(vec<PTRef>{w, x, logic.mkTimes(logic.mkConst("2"), y)}))),
+        logic.mkOr(c, logic.mkAnd(
+            logic.mkOr(logic.mkNot(d), logic.mkLeq(logic.getTerm_RealZero(), logic.mkPlus(vec<PTRef>{w, y, logic.mkTimes(logic.mkConst("2"), x)}))),
+            logic.mkOr(d, logic.mkLeq(logic.getTerm_RealZero(), logic.mkPlus(vec<PTRef>{w, y, logic.mkTimes(logic.mkConst("2"), z)}))))));
+    EXPECT_EQ(res, expected);
+}
+
+TEST_F(IteManagerTest, test_IteLiftingKeepsSharedItes) {
+    PTRef x = logic.mkVar(lrasort, "x");
+    PTRef y = logic.mkVar(lrasort, "y");
+    PTRef c = logic.mkBoolVar("c");
+    PTRef ite = logic.mkIte(c, x, y);
+    PTRef fla = logic.mkAnd(logic.mkLeq(x, ite), logic.mkLeq(logic.mkPlus(ite, y), logic.mkConst("3")));
+    PTRef res = IteHandler(logic, 0, true).rewrite(fla);
+    EXPECT_EQ(countAuxVars(res), 1);
+}
+
+TEST_F(IteManagerTest, test_IteLiftingPreservesSatisfiability) {
+    PTRef x = logic.mkVar(lrasort, "x");
+    PTRef y = logic.mkVar(lrasort, "y");
+    PTRef z = logic.mkVar(lrasort, "z");
+    PTRef c = logic.mkBoolVar("c");
+    PTRef sum = logic.mkPlus(logic.mkIte(c, x, y), logic.mkIte(c, y, x));
+    SMTConfig config;
+    {
+        MainSolver solver(logic, config, "ite-lifting");
+        solver.insertFormula(logic.mkEq(z, sum));
+        solver.insertFormula(logic.mkNot(logic.mkEq(z, logic.mkPlus(x, y))));
+        EXPECT_EQ(solver.check(), s_False);
+    }
+    {
+        MainSolver solver(logic, config, "ite-lifting");
+        PTRef fla = logic.mkAnd({logic.mkLeq(sum, logic.mkConst("1")), logic.mkLt(y, logic.mkIte(c, x, logic.mkConst("-1"))), logic.mkLeq(logic.mkConst("3"), x)});
+        solver.insertFormula(fla);
+        ASSERT_EQ(solver.check(), s_True);
+        EXPECT_EQ(solver.getModel()->evaluate(fla), logic.getTerm_true());
+    }
+}
@@ -238,4 +238,15 @@ TEST_F(LIALogicMkTermsTest, test_ReverseAuxRewrite) {
         ASSERT_FALSE(hasAuxSymbols(termWithoutAux));
     }
 
-}
\ No newline at end of file
+}
+
+TEST_F(LIALogicMkTermsTest, test_NumeralInterning) {
+    EXPECT_EQ(logic.mkIntConst(42), logic.mkConst("42"));
+    EXPECT_EQ(logic.mkConst("-7"), logic.mkIntConst(-7));
+    EXPECT_EQ(logic.mkIntConst(0), logic.getTerm_IntZero());
+    FastRational big("123456789012345678901234567890");
+    PTRef bigConst = logic.mkIntConst(big);
+    EXPECT_EQ(logic.mkIntConst(big * 2 / 2), bigConst);
+    EXPECT_EQ(logic.getNumConst(bigConst), big);
+    EXPECT_EQ(logic.pp(bigConst), "123456789012345678901234567890");
+}
@@ -3,12 +3,18 @@
 //
 
 #include <gtest/gtest.h>
+#include <ArithLogic.h>
 #include <Logic.h>
+#include <MainSolver.h>
 #include <SMTConfig.h>
 #include <LAScore.h>
+#include "TestUtils.h"
 #include <cstdlib>
 #include <string>
 
+using opensmt::test::pigeonhole;
+using opensmt::test::setOption;
+
 class BestLitBufTestClassic: public ::testing::Test {
 public:
     BestLitBufTestClassic() {}
@@ -93,4 +99,128 @@ TEST_F(BestLitBufTestDeep, test_UnitLookahead) {
     buf.insert(l6,v6);
     ASSERT_TRUE(buf.getLit(0) == l4 || buf.getLit(1) == l4);
 
-}
\ No newline at end of file
+}
+
+TEST_F(BestLitBufTestClassic, test_AssignedLiteralIsReplaced) {
+    vec<lbool> assigns;
+    for (int i = 0; i < 4; i++)
+        assigns.push(l_Undef);
+
+    LABestLitBuf<LookaheadScoreClassic::ExVal> buf(1, assigns, false, 0);
+
+    LookaheadScoreClassic::ExVal good(3, 3, 1);
+    LookaheadScoreClassic::ExVal poor(1, 1, 1);
+    buf.insert(mkLit(0, true), good);
+    ASSERT_EQ(buf.getLit(), mkLit(0, true));
+    // The literal was assigned after a failed literal on the same round
+    assigns[0] = l_True;
+    ASSERT_EQ(buf.getLit(), lit_Undef);
+    // Its slot is reused only once the buffer is told about the assignment
+    buf.insert(mkLit(1, true), poor);
+    ASSERT_EQ(buf.getLit(), lit_Undef);
+    buf.evictAssigned();
+    buf.insert(mkLit(1, true), poor);
+    ASSERT_EQ(buf.getLit(), mkLit(1, true));
+}
+
+class LookaheadSolverTest : public ::testing::Test {
+protected:
+    LookaheadSolverTest() : logic{opensmt::Logic_t::QF_LRA} {
+        setOption(config, SMTConfig::o_sat_pure_lookahead, 1);
+        for (int i = 0; i < 4; ++i) {
+            x.push(logic.mkRealVar(("x" + std::to_string(i)).c_str()));
+            b.push(logic.mkBoolVar(("b" + std::to_string(i)).c_str()));
+        }
+    }
+    PTRef leq(FastRational const & c, PTRef t) { return logic.mkLeq(logic.mkRealConst(c), t); }
+    PTRef times(PTRef t, int c) { return logic.mkTimes(t, logic.mkRealConst(c)); }
+    // Every x_i is either below i or above i + 1, and x_0 < x_1 < ... < x_3 < 4, the Boolean b_i tells which
+    vec<PTRef> steps() {
+        vec<PTRef> assertions;
+        for (int i = 0; i < 4; ++i) {
+            assertions.push(logic.mkEq(b[i], logic.mkLeq(x[i], logic.mkRealConst(i))));
+            assertions.push(logic.mkOr(b[i], logic.mkGeq(x[i], logic.mkRealConst(i + 1))));
+            if (i > 0) { assertions.push(logic.mkLt(x[i - 1], x[i])); }
+        }
+        assertions.push(logic.mkLt(x[3], logic.mkRealConst(4)));
+        return assertions;
+    }
+    ArithLogic logic;
+    SMTConfig config;
+    vec<PTRef> x;
+    vec<PTRef> b;
+};
+
+TEST_F(LookaheadSolverTest, test_BooleanProbes) {
+    for (int boolProbes : {0, 1}) {
+        setOption(config, SMTConfig::o_lookahead_bool_probes, boolProbes);
+        MainSolver solver(logic, config, "lookahead");
+        vec<PTRef> assertions = steps();
+        // Only x_3 may be above its step
+        assertions.push(logic.mkOr(b[0], b[1]));
+        assertions.push(logic.mkOr(b[1], b[2]));
+        for (PTRef tr : assertions) {
+            solver.insertFormula(tr);
+        }
+        ASSERT_EQ(solver.check(), s_True);
+        auto model = solver.getModel();
+        for (PTRef tr : assertions) {
+            EXPECT_EQ(model->evaluate(tr), logic.getTerm_true());
+        }
+
+        MainSolver unsatSolver(logic, config, "lookahead");
+        for (PTRef tr : steps()) {
+            unsatSolver.insertFormula(tr);
+        }
+        unsatSolver.insertFormula(logic.mkNot(b[3]));
+        unsatSolver.insertFormula(logic.mkOr(logic.mkNot(b[0]), logic.mkNot(b[2])));
+        unsatSolver.insertFormula(logic.mkGeq(x[0], logic.mkRealConst(1)));
+        EXPECT_EQ(unsatSolver.check(), s_False);
+    }
+}
+
+TEST_F(LookaheadSolverTest, test_NonDecisionVariablesAssigned) {
+    // The lookahead used to loop forever once all decision variables were assigned, since the trail also had
+    // non-decision variables and so its length differed from the number of decision variables
+    setOption(config, SMTConfig::o_incremental, 0);
+    MainSolver solver(logic, config, "lookahead");
+    vec<PTRef> assertions;
+    PTRef a1 = leq(3, logic.mkPlus(times(x[1], -1), times(x[2], -2)));
+    PTRef a2 = leq(FastRational(-1, 2), times(x[2], -1));
+    PTRef a3 = leq(0, times(x[1], -1));
+    PTRef a4 = leq(1, x[3]);
+    PTRef a5 = leq(FastRational(1, 2), logic.mkPlus(times(x[0], -1), logic.mkTimes(x[1], logic.mkRealConst(FastRational(-1, 2)))));
+    PTRef a6 = leq(1, times(x[3], -1));
+    PTRef a7 = leq(-3, logic.mkPlus(times(x[0], -1), times(x[3], -1)));
+    auto no = [this](PTRef tr) { return logic.mkNot(tr); };
+    assertions.push(logic.mkAnd({no(a1), a2,
+                                      logic.mkOr({a2, logic.mkAnd(no(a3), a4), logic.mkOr({b[2], b[3], no(a5), no(a6)})}),
+                                      logic.mkAnd({no(a3), logic.mkOr({no(b[0]), no(b[3]), no(a7)}), logic.mkOr(no(a2), no(a4))})}));
+    assertions.push(logic.mkOr(logic.mkOr({a5, no(a2), a6, logic.mkOr(no(b[0]), a6)}),
+                                    no(logic.mkOr({a6, logic.mkAnd(a2, a7), logic.mkOr(no(b[2]), a2),
+                                                   logic.mkOr({b[0], no(b[2]), b[3], no(a4)})}))));
+    assertions.push(logic.mkOr(no(b[2]), no(logic.mkAnd({no(b[0]), a1, logic.mkAnd({no(b[1]), no(b[2]), a3})}))));
+    assertions.push(logic.mkOr({no(b[1]), a4, no(logic.mkOr(b[1], a1))}));
+    for (PTRef tr : assertions) {
+        solver.insertFormula(tr);
+    }
+    ASSERT_EQ(solver.check(), s_True);
+    auto model = solver.getModel();
+    for (PTRef tr : assertions) {
+        EXPECT_EQ(model->evaluate(tr), logic.getTerm_true());
+    }
+}
+
+TEST_F(LookaheadSolverTest, test_ProbesAreReused) {
+    // A pigeon in a hole implies that no other pigeon is there, so the tree lookahead probes the pigeons below the
+    // negation of each other and the loop later finds their results in the cache
+    MainSolver solver(logic, config, "lookahead");
+    for (PTRef tr : pigeonhole(logic, 4, 4)) {
+        solver.insertFormula(tr);
+    }
+    ASSERT_EQ(solver.check(), s_True);
+    opensmt::Statistics stats = solver.getStatistics();
+    ASSERT_NE(stats.find("sat.lookahead-reused-probes"), nullptr);
+    EXPECT_GT(stats.find("sat.lookahead-reused-probes")->counter, 0);
+    EXPECT_LT(stats.find("sat.lookahead-reused-probes")->counter, stats.find("sat.lookahead-probes")->counter);
+}
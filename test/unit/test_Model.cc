@@ -154,6 +154,20 @@ TEST_F(UFModelBuilderTest, test_functionModel) {
     ASSERT_TRUE(logic.isIte(templateFun.getBody()));
 }
 
+TEST_F(UFModelBuilderTest, test_addDefinitions) {
+    ModelBuilder mb(logic);
+    mb.addVarValue(x, v1);
+    mb.addVarValue(y, v1);
+    auto model = mb.build();
+    PTRef defaultValue = model->evaluate(f);
+    ModelBuilder definitionBuilder(logic);
+    PTRef value = defaultValue == v0 ? v1 : v0;
+    definitionBuilder.addToTheoryFunction(f_sym, {v1, v1}, value);
+    model->addDefinitions(definitionBuilder.buildDefinitions());
+    EXPECT_EQ(model->evaluate(f), value);
+    EXPECT_EQ(model->evaluate(x), v1);
+}
+
 class UFConstModelTest : public ::testing::Test {
 protected:
     UFConstModelTest() : logic(opensmt::Logic_t::QF_UF), ms(logic, c, "uf-solver") {
@@ -302,6 +316,44 @@ TEST_F(LAModelTest, test_distinctOperator) {
 
 }
 
+TEST_F(LAModelTest, test_batchEvaluation) {
+    auto model = getModel();
+    PTRef two = logic.mkRealConst(2);
+    PTRef sum = logic.mkPlus(x, z);
+    PTRef ite = logic.mkIte(b, y, sum);
+    vec<PTRef> terms {sum, logic.mkLeq(two, ite), logic.mkAnd(a, logic.mkEq(ite, two)), logic.mkRealDiv(ite, logic.mkRealConst(4))};
+    vec<PTRef> res = model->evaluate(opensmt::span<PTRef const>(terms.begin(), terms.size()));
+    ASSERT_EQ(res.size(), terms.size());
+    EXPECT_EQ(res[0], two);
+    EXPECT_EQ(res[1], tval);
+    EXPECT_EQ(res[2], tval);
+    EXPECT_EQ(res[3], logic.mkRealConst(FastRational(1, 2)));
+    for (int i = 0; i < terms.size(); ++i) {
+        EXPECT_EQ(model->evaluate(terms[i]), res[i]);
+    }
+}
+
+TEST_F(LAModelTest, test_deepTerm) {
+    auto model = getModel();
+    PTRef term = x;
+    for (int i = 0; i < 100000; ++i) {
+        term = logic.mkIte(logic.mkLeq(term, y), x, logic.mkPlus(term, z));
+    }
+    EXPECT_EQ(model->evaluate(term), logic.mkRealConst(100001));
+}
+
+TEST(LIAModelTest, test_intDivisionAndModulo) {
+    ArithLogic logic{opensmt::Logic_t::QF_LIA};
+    PTRef x = logic.mkIntVar("x");
+    Model model(logic, {std::make_pair(x, logic.mkIntConst(-7))});
+    PTRef three = logic.mkIntConst(3);
+    PTRef minusThree = logic.mkIntConst(-3);
+    EXPECT_EQ(model.evaluate(logic.mkIntDiv(x, three)), logic.mkIntConst(-3));
+    EXPECT_EQ(model.evaluate(logic.mkMod(x, three)), logic.mkIntConst(2));
+    EXPECT_EQ(model.evaluate(logic.mkIntDiv(x, minusThree)), logic.mkIntConst(3));
+    EXPECT_EQ(model.evaluate(logic.mkMod(x, minusThree)), logic.mkIntConst(2));
+}
+
 
 class ModelIntegrationTest : public ::testing::Test {
 protected:
@@ -0,0 +1,65 @@
+//
+// Partition masks
+//
+
+#include <gtest/gtest.h>
+#include <InterpolationUtils.h>
+
+using opensmt::PartitionMask;
+
+TEST(PartitionMaskTest, test_SetAndClearBits) {
+    PartitionMask mask;
+    EXPECT_TRUE(mask.none());
+    EXPECT_EQ(mask, 0);
+    opensmt::setbit(mask, 3);
+    opensmt::setbit(mask, 200);
+    EXPECT_TRUE(opensmt::tstbit(mask, 3));
+    EXPECT_TRUE(opensmt::tstbit(mask, 200));
+    EXPECT_FALSE(opensmt::tstbit(mask, 64));
+    EXPECT_NE(mask, 0);
+    opensmt::clrbit(mask, 200);
+    EXPECT_EQ(mask, 8);
+    opensmt::clrbit(mask, 3);
+    EXPECT_EQ(mask, 0);
+}
+
+TEST(PartitionMaskTest, test_Complement) {
+    PartitionMask mask = 1;
+    PartitionMask complement = ~mask;
+    EXPECT_FALSE(opensmt::tstbit(complement, 0));
+    EXPECT_TRUE(opensmt::tstbit(complement, 1));
+    EXPECT_TRUE(opensmt::tstbit(complement, 1000));
+    EXPECT_EQ(mask & complement, 0);
+    EXPECT_EQ(mask | complement, ~PartitionMask(0));
+    EXPECT_EQ(~complement, mask);
+}
+
+TEST(PartitionMaskTest, test_LargeMasks) {
+    PartitionMask a;
+    PartitionMask b;
+    for (unsigned i = 0; i < 300; i += 2) { opensmt::setbit(a, i); }
+    for (unsigned i = 150; i < 400; ++i) { opensmt::setbit(b, i); }
+    PartitionMask both = a & b;
+    for (unsigned i = 0; i < 400; ++i) {
+        EXPECT_EQ(opensmt::tstbit(both, i), i >= 150 and i < 300 and i % 2 == 0);
+    }
+    PartitionMask copy = a;
+    copy |= b;
+    EXPECT_EQ(copy, a | b);
+    EXPECT_EQ(copy ^ b, a & ~b);
+    PartitionMask moved = std::move(copy);
+    EXPECT_TRUE(opensmt::tstbit(moved, 399));
+}
+
+TEST(PartitionMaskTest, test_Locality) {
+    PartitionMask A_mask = 3;
+    PartitionMask inA = 2;
+    PartitionMask inB;
+    opensmt::setbit(inB, 130);
+    PartitionMask shared = inA | inB;
+    EXPECT_TRUE(opensmt::isAstrict(inA, A_mask));
+    EXPECT_TRUE(opensmt::isBstrict(inB, A_mask));
+    EXPECT_TRUE(opensmt::isAB(shared, A_mask));
+    EXPECT_TRUE(opensmt::isAB(~PartitionMask(0), A_mask));
+    EXPECT_FALSE(opensmt::isAlocal(PartitionMask(0), A_mask));
+}
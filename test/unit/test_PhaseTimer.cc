@@ -0,0 +1,158 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include <ArithLogic.h>
+#include <MainSolver.h>
+#include <PhaseTimer.h>
+#include <SMTConfig.h>
+#include <Statistics.h>
+
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+using opensmt::PhaseTimer;
+using opensmt::Statistics;
+
+namespace {
+void sleepMs(int ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+}
+
+TEST(PhaseTimerTest, test_NestedAttribution) {
+    PhaseTimer timer;
+    PhaseTimer::PhaseId outer = timer.getPhase("outer");
+    PhaseTimer::PhaseId inner = timer.getPhase("inner");
+    EXPECT_EQ(timer.getPhase("outer"), outer);
+    {
+        PhaseTimer::Scope outerScope(timer, outer);
+        sleepMs(10);
+        PhaseTimer::Scope innerScope(timer, inner);
+        sleepMs(20);
+    }
+    Statistics stats;
+    timer.collectStatistics(stats);
+    double outerSelf = stats.find("phases.outer")->seconds;
+    double outerTotal = stats.find("phases.outer-total")->seconds;
+    double innerTotal = stats.find("phases.inner-total")->seconds;
+    EXPECT_GE(innerTotal, 0.02);
+    EXPECT_GE(outerSelf, 0.01);
+    EXPECT_LT(outerSelf, outerTotal);
+    EXPECT_NEAR(outerSelf + innerTotal, outerTotal, 1e-6);
+    EXPECT_EQ(stats.find("phases.inner-calls")->counter, 1);
+}
+
+TEST(PhaseTimerTest, test_Recursion) {
+    PhaseTimer timer;
+    PhaseTimer::PhaseId phase = timer.getPhase("phase");
+    {
+        PhaseTimer::Scope outerScope(timer, phase);
+        PhaseTimer::Scope innerScope(timer, phase);
+        sleepMs(10);
+    }
+    Statistics stats;
+    timer.collectStatistics(stats);
+    // The nested call is counted, but its time only once
+    EXPECT_EQ(stats.find("phases.phase-calls")->counter, 2);
+    EXPECT_NEAR(stats.find("phases.phase")->seconds, stats.find("phases.phase-total")->seconds, 1e-6);
+}
+
+TEST(PhaseTimerTest, test_FinePhases) {
+    PhaseTimer timer;
+    PhaseTimer::PhaseId phase = timer.getPhase("fine");
+    { PhaseTimer::Scope scope(timer, phase, PhaseTimer::Detail::Fine); }
+    Statistics stats;
+    timer.collectStatistics(stats);
+    EXPECT_EQ(stats.find("phases.fine-calls"), nullptr);
+    timer.setDetailed(true);
+    { PhaseTimer::Scope scope(timer, phase, PhaseTimer::Detail::Fine); }
+    timer.collectStatistics(stats);
+    ASSERT_NE(stats.find("phases.fine-calls"), nullptr);
+    EXPECT_EQ(stats.find("phases.fine-calls")->counter, 1);
+}
+
+TEST(PhaseTimerTest, test_LastCheck) {
+    PhaseTimer timer;
+    PhaseTimer::PhaseId phase = timer.getPhase("phase");
+    std::stringstream report;
+    timer.setReportOut(&report);
+    for (int i = 0; i < 2; ++i) {
+        PhaseTimer::Check check(timer);
+        PhaseTimer::Scope scope(timer, phase);
+    }
+    // A check started within a check belongs to the outer one
+    {
+        PhaseTimer::Check check(timer);
+        PhaseTimer::Check nested(timer);
+        PhaseTimer::Scope scope(timer, timer.getPhase("late"));
+    }
+    Statistics all;
+    timer.collectStatistics(all);
+    EXPECT_EQ(all.find("phases.phase-calls")->counter, 2);
+    Statistics last;
+    timer.collectStatistics(last, PhaseTimer::Span::LastCheck);
+    EXPECT_EQ(last.find("phases.phase-calls"), nullptr);
+    EXPECT_EQ(last.find("phases.late-calls")->counter, 1);
+    EXPECT_NE(report.str().find("; Phase times of check 3\n"), std::string::npos);
+    EXPECT_EQ(report.str().find("; Phase times of check 4\n"), std::string::npos);
+}
+
+TEST(PhaseTimerTest, test_Trace) {
+    PhaseTimer timer;
+    std::stringstream trace;
+    timer.setTraceOut(&trace);
+    {
+        PhaseTimer::Scope scope(timer, timer.getPhase("traced"));
+        sleepMs(1);
+    }
+    // Too short to be traced
+    { PhaseTimer::Scope scope(timer, timer.getPhase("short")); }
+    timer.setTraceOut(nullptr);
+    std::string const events = trace.str();
+    EXPECT_EQ(events.front(), '[');
+    EXPECT_EQ(events.substr(events.size() - 3), "\n]\n");
+    EXPECT_NE(events.find("{\"name\": \"traced\", \"cat\": \"opensmt\", \"ph\": \"X\", \"ts\": "), std::string::npos);
+    EXPECT_EQ(events.find("short"), std::string::npos);
+}
+
+TEST(PhaseTimerTest, test_MainSolver) {
+    ArithLogic logic{opensmt::Logic_t::QF_LRA};
+    SMTConfig config;
+    const char * msg = "ok";
+    config.setOption(SMTConfig::o_time_phases, SMTOption(1), msg);
+    std::stringstream report;
+    config.getPhaseTimer().setReportOut(&report);
+    MainSolver solver(logic, config, "phases");
+    PTRef x = logic.mkRealVar("x");
+    PTRef y = logic.mkRealVar("y");
+    PTRef a = logic.mkBoolVar("a");
+    solver.insertFormula(logic.mkOr(a, logic.mkLeq(x, y)));
+    solver.insertFormula(logic.mkOr(logic.mkNot(a), logic.mkLeq(y, x)));
+    solver.insertFormula(logic.mkLt(logic.mkPlus(x, logic.getTerm_RealOne()), y));
+    EXPECT_EQ(solver.check(), s_True);
+    solver.insertFormula(logic.mkLt(y, logic.mkPlus(x, logic.getTerm_RealOne())));
+    EXPECT_EQ(solver.check(), s_False);
+    Statistics stats = solver.getStatistics();
+    for (char const * phase : {"phases.preprocess-calls", "phases.cnfize-calls", "phases.search-calls",
+                               "phases.propagate-calls", "phases.theory-la-solver-calls"}) {
+        ASSERT_NE(stats.find(phase), nullptr) << phase;
+        EXPECT_GT(stats.find(phase)->counter, 0) << phase;
+    }
+    EXPECT_EQ(stats.find("phases.search-calls")->counter, 2);
+    EXPECT_NE(report.str().find("; Phase times of check 2\n"), std::string::npos);
+}
+
+TEST(PhaseTimerTest, test_Options) {
+    SMTConfig config;
+    const char * msg = "ok";
+    EXPECT_TRUE(config.setOption(SMTConfig::o_time_phases, SMTOption(1), msg));
+    EXPECT_TRUE(config.getPhaseTimer().isDetailed());
+    // The solvers working for this one do not report their phases
+    SMTConfig workerConfig;
+    workerConfig.copyOptionsFrom(config);
+    EXPECT_FALSE(workerConfig.getPhaseTimer().isDetailed());
+
+    EXPECT_FALSE(config.setOption(SMTConfig::o_trace_out, SMTOption("/nonexistent/dir/trace.json"), msg));
+    EXPECT_STREQ(msg, "cannot open the trace file");
+}
@@ -5,6 +5,8 @@
 #include <gtest/gtest.h>
 #include <PG.h>
 
+#include <string>
+
 TEST(ProofTest, test_mergeClauses_PivotPresent_NoDuplicates) {
     std::vector<Lit> left { mkLit(0, true), mkLit(1,false) };
     std::vector<Lit> right { mkLit(1, true), mkLit(2,false) };
@@ -89,6 +91,38 @@ TEST(ProofTest, test_mergeClauses_PivotAfterFirstEnd) {
     EXPECT_EQ(res[2], mkLit(4,false));
 }
 
+TEST(ProofTest, test_DenseIdSet_IteratesInOrder) {
+    DenseIdSet<clauseid_t> ids;
+    EXPECT_TRUE(ids.empty());
+    EXPECT_TRUE(ids.insert(130));
+    EXPECT_TRUE(ids.insert(3));
+    EXPECT_TRUE(ids.insert(64));
+    EXPECT_FALSE(ids.insert(3));
+    EXPECT_TRUE(ids.erase(64));
+    EXPECT_FALSE(ids.erase(65));
+    EXPECT_EQ(ids.size(), 2);
+    EXPECT_TRUE(ids.contains(130));
+    EXPECT_FALSE(ids.contains(64));
+    std::vector<clauseid_t> elements(ids.begin(), ids.end());
+    EXPECT_EQ(elements, (std::vector<clauseid_t>{3, 130}));
+}
+
+TEST(ProofTest, test_ProofNodeArena_ReusesReleasedNodes) {
+    ProofNodeArena arena;
+    ProofNode * first = arena.allocate();
+    ProofNode * second = arena.allocate();
+    EXPECT_NE(first, second);
+    first->initClause(std::vector<Lit>{mkLit(1, false)});
+    first->addRes(7);
+    arena.release(first);
+    ProofNode * reused = arena.allocate();
+    EXPECT_EQ(reused, first);
+    EXPECT_FALSE(reused->hasClause());
+    EXPECT_EQ(reused->getNumResolvents(), 0);
+    EXPECT_EQ(reused->getAnt1(), nullptr);
+    EXPECT_NE(arena.allocate(), second);
+}
+
 // Reduction algorithms
 
 class ReductionTest : public ::testing::Test {
@@ -183,6 +217,166 @@ TEST_F(ReductionTest, test_recyclePivots) {
     EXPECT_TRUE(true);
 }
 
+TEST_F(ReductionTest, test_fillProofGraph_MultipleThreads) {
+    const char* msg = "ok";
+    config.setOption(SMTConfig::o_proof_fill_threads, SMTOption(4), msg);
+    CRef a_b = ca.alloc(vec<Lit>{a,b});
+    CRef nb_c = ca.alloc(vec<Lit>{~b,c});
+    CRef nb_nc = ca.alloc(vec<Lit>{~b,~c});
+    CRef na_c = ca.alloc(vec<Lit>{~a,c});
+    CRef nc_nd = ca.alloc(vec<Lit>{~c,~d});
+    CRef nc_d = ca.alloc(vec<Lit>{~c,d});
+    CRef na_d = ca.alloc(vec<Lit>{~a,d});
+    vec<CRef> clauses = {a_b,nb_c, nb_nc, na_c, nc_nd, nc_d, na_d};
+    for (CRef cr : clauses) {
+        partitionManager.addClauseClassMask(cr, 1);
+    }
+    for (CRef cr : clauses) {
+        proof.newOriginalClause(cr);
+    }
+    CRef a_c = ca.alloc(vec<Lit>{a,c}, {true, 0});
+    CRef nd = ca.alloc(vec<Lit>{~d}, {true, 0});
+
+    proof.beginChain(a_b);
+    proof.addResolutionStep(nb_c, var(b));
+    proof.endChain(a_c);
+
+    proof.beginChain(nb_nc);
+    proof.addResolutionStep(a_c, var(c));
+    proof.addResolutionStep(a_b, var(b));
+    proof.addResolutionStep(na_c, var(a));
+    proof.addResolutionStep(nc_nd, var(c));
+    proof.endChain(nd);
+
+    proof.beginChain(nc_d);
+    proof.addResolutionStep(a_c, var(c));
+    proof.addResolutionStep(na_d,var(a));
+    proof.addResolutionStep(nd, var(d));
+    proof.endChain(CRef_Undef);
+
+    ProofGraph pg(config, theory.getLogic(), termMapper, proof);
+    ASSERT_EQ(pg.numFillThreads(), 4);
+    // Too small to be worth any thread
+    EXPECT_EQ(pg.fillProofGraph(), 1);
+    pg.checkProof(true);
+    EXPECT_EQ(pg.getRoot()->getClauseSize(), 0);
+    pg.emptyProofGraph();
+}
+
+TEST_F(ReductionTest, test_fillProofGraph_SpawnsThreads) {
+    const char* msg = "ok";
+    config.setOption(SMTConfig::o_proof_fill_threads, SMTOption(4), msg);
+    // y_i is derived from x_i or y_i and from ~x_i or y_i, and ~y_0 or ... or ~y_(n-1) resolves with all of them
+    constexpr int n = 1024;
+    vec<Lit> negatedYs;
+    vec<CRef> derivedYs;
+    for (int i = 0; i < n; ++i) {
+        PTRef x_term = logic.mkBoolVar(("x" + std::to_string(i)).c_str());
+        PTRef y_term = logic.mkBoolVar(("y" + std::to_string(i)).c_str());
+        partitionManager.addIPartitions(x_term, 1);
+        partitionManager.addIPartitions(y_term, 1);
+        Lit x = termMapper.getOrCreateLit(x_term);
+        Lit y = termMapper.getOrCreateLit(y_term);
+        CRef x_y = ca.alloc(vec<Lit>{x, y});
+        CRef nx_y = ca.alloc(vec<Lit>{~x, y});
+        for (CRef cr : {x_y, nx_y}) {
+            partitionManager.addClauseClassMask(cr, 1);
+            proof.newOriginalClause(cr);
+        }
+        CRef derivedY = ca.alloc(vec<Lit>{y}, {true, 0});
+        proof.beginChain(x_y);
+        proof.addResolutionStep(nx_y, var(x));
+        proof.endChain(derivedY);
+        negatedYs.push(~y);
+        derivedYs.push(derivedY);
+    }
+    CRef allNegated = ca.alloc(negatedYs);
+    partitionManager.addClauseClassMask(allNegated, 1);
+    proof.newOriginalClause(allNegated);
+    proof.beginChain(allNegated);
+    for (int i = 0; i < n; ++i) {
+        proof.addResolutionStep(derivedYs[i], var(~negatedYs[i]));
+    }
+    proof.endChain(CRef_Undef);
+
+    ProofGraph pg(config, theory.getLogic(), termMapper, proof);
+    // The derivations of the y_i form one level of n nodes
+    EXPECT_EQ(pg.fillProofGraph(), 4);
+    pg.checkProof(true);
+    EXPECT_EQ(pg.getRoot()->getClauseSize(), 0);
+    pg.emptyProofGraph();
+}
+
+TEST_F(ReductionTest, test_reduceRegionsInParallel) {
+    const char* msg = "ok";
+    config.setOption(SMTConfig::o_proof_reduction_threads, SMTOption(4), msg);
+    // b_i or c_i is derived resolving twice on x_i, RecyclePivots derives b_i alone;
+    // ~b_0 or ... or ~b_(n-1) resolves with the derived clauses and with ~c_i
+    constexpr int n = 8;
+    vec<Lit> negatedBs;
+    vec<CRef> derived;
+    vec<CRef> negatedCs;
+    for (int i = 0; i < n; ++i) {
+        Lit lits[4];
+        for (int j = 0; j < 4; ++j) {
+            PTRef term = logic.mkBoolVar((std::string(1, "xabc"[j]) + std::to_string(i)).c_str());
+            partitionManager.addIPartitions(term, 1);
+            lits[j] = termMapper.getOrCreateLit(term);
+        }
+        Lit x = lits[0], a = lits[1], b = lits[2], c = lits[3];
+        CRef x_a = ca.alloc(vec<Lit>{x, a});
+        CRef nx_c = ca.alloc(vec<Lit>{~x, c});
+        CRef na_x = ca.alloc(vec<Lit>{~a, x});
+        CRef nx_b = ca.alloc(vec<Lit>{~x, b});
+        CRef nc = ca.alloc(vec<Lit>{~c});
+        for (CRef cr : {x_a, nx_c, na_x, nx_b, nc}) {
+            partitionManager.addClauseClassMask(cr, 1);
+            proof.newOriginalClause(cr);
+        }
+        CRef b_c = ca.alloc(vec<Lit>{b, c}, {true, 0});
+        proof.beginChain(x_a);
+        proof.addResolutionStep(nx_c, var(x));
+        proof.addResolutionStep(na_x, var(a));
+        proof.addResolutionStep(nx_b, var(x));
+        proof.endChain(b_c);
+        negatedBs.push(~b);
+        derived.push(b_c);
+        negatedCs.push(nc);
+    }
+    CRef allNegated = ca.alloc(negatedBs);
+    partitionManager.addClauseClassMask(allNegated, 1);
+    proof.newOriginalClause(allNegated);
+    proof.beginChain(allNegated);
+    for (int i = 0; i < n; ++i) {
+        proof.addResolutionStep(derived[i], var(~negatedBs[i]));
+        proof.addResolutionStep(negatedCs[i], var(ca[negatedCs[i]][0]));
+    }
+    proof.endChain(CRef_Undef);
+
+    auto countNodes = [](ProofGraph const & pg) {
+        unsigned count = 0;
+        for (clauseid_t id = 0; id < pg.getGraphSize(); ++id) { count += pg.getNode(id) != nullptr; }
+        return count;
+    };
+    ProofGraph whole(config, theory.getLogic(), termMapper, proof);
+    whole.fillProofGraph();
+    ASSERT_EQ(countNodes(whole), 10 * n + 1);
+    whole.recyclePivotsIter();
+    whole.checkProof(true);
+
+    ProofGraph pg(config, theory.getLogic(), termMapper, proof);
+    pg.fillProofGraph();
+    // The first two derivations share a region with the start of the last chain, the others have one each
+    EXPECT_EQ(pg.reduceRegionsInParallel(), n - 1);
+    pg.checkProof(true);
+    EXPECT_EQ(pg.getRoot()->getClauseSize(), 0);
+    // Each derivation loses its first step and ~x_i or c_i, the last chain loses the resolutions with ~c_i
+    EXPECT_EQ(countNodes(pg), 6 * n + 1);
+    EXPECT_EQ(countNodes(pg), countNodes(whole));
+    pg.emptyProofGraph();
+    whole.emptyProofGraph();
+}
+
 TEST_F(ReductionTest, test_recyclePivots_IdenticalAntecedents) {
     CRef a_d = ca.alloc(vec<Lit>{a,d});
     CRef b_nd = ca.alloc(vec<Lit>{b,~d});
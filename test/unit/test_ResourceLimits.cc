@@ -0,0 +1,137 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include <ArithLogic.h>
+#include <MainSolver.h>
+#include <ResourceLimits.h>
+#include <SMTConfig.h>
+#include "TestUtils.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using opensmt::test::pigeonhole;
+using opensmt::test::setOption;
+
+class ResourceLimitsTest : public ::testing::Test {
+protected:
+    ResourceLimitsTest() : logic{opensmt::Logic_t::QF_LRA} {}
+    void insertPigeonhole(MainSolver & solver, int holes) {
+        for (PTRef tr : pigeonhole(logic, holes + 1, holes)) {
+            solver.insertFormula(tr);
+        }
+    }
+    ArithLogic logic;
+    SMTConfig config;
+};
+
+TEST_F(ResourceLimitsTest, test_ConflictLimit) {
+    setOption(config, SMTConfig::o_conflict_limit, 10);
+    MainSolver solver(logic, config, "conflict limit");
+    insertPigeonhole(solver, 6);
+    EXPECT_EQ(solver.check(), s_Undef);
+    EXPECT_EQ(solver.getUnknownReason(), opensmt::UnknownReason::ConflictLimit);
+    // The next query gets a new budget
+    uint64_t conflicts = solver.getSMTSolver().conflicts;
+    EXPECT_EQ(solver.check(), s_Undef);
+    EXPECT_GT(solver.getSMTSolver().conflicts, conflicts);
+
+    setOption(config, SMTConfig::o_conflict_limit, 0);
+    EXPECT_EQ(solver.check(), s_False);
+    EXPECT_EQ(solver.getUnknownReason(), opensmt::UnknownReason::None);
+}
+
+TEST_F(ResourceLimitsTest, test_TimeLimit) {
+    setOption(config, SMTConfig::o_time_limit, 100);
+    MainSolver solver(logic, config, "time limit");
+    insertPigeonhole(solver, 12);
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(solver.check(), s_Undef);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(10));
+    EXPECT_EQ(solver.getUnknownReason(), opensmt::UnknownReason::TimeLimit);
+}
+
+TEST_F(ResourceLimitsTest, test_MemoryLimit) {
+    // The test process alone is resident in more than a megabyte
+    setOption(config, SMTConfig::o_memory_limit, 1);
+    MainSolver solver(logic, config, "memory limit");
+    insertPigeonhole(solver, 12);
+    EXPECT_EQ(solver.check(), s_Undef);
+    EXPECT_EQ(solver.getUnknownReason(), opensmt::UnknownReason::MemoryLimit);
+    // The limit is on the resident memory, which the reserved but untouched address space does not count towards
+    std::vector<char> reserved;
+    reserved.reserve(std::size_t{1} << 30);
+    setOption(config, SMTConfig::o_memory_limit, 512);
+    MainSolver small(logic, config, "memory limit");
+    insertPigeonhole(small, 5);
+    EXPECT_EQ(small.check(), s_False);
+    EXPECT_EQ(small.getUnknownReason(), opensmt::UnknownReason::None);
+}
+
+TEST_F(ResourceLimitsTest, test_Interrupt) {
+    MainSolver solver(logic, config, "interrupt");
+    insertPigeonhole(solver, 12);
+    std::thread interrupter([&solver]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        solver.interrupt();
+    });
+    EXPECT_EQ(solver.check(), s_Undef);
+    interrupter.join();
+    EXPECT_EQ(solver.getUnknownReason(), opensmt::UnknownReason::Interrupted);
+}
+
+TEST_F(ResourceLimitsTest, test_InterruptBeforeQuery) {
+    MainSolver solver(logic, config, "interrupt");
+    PTRef x = logic.mkRealVar("x");
+    solver.insertFormula(logic.mkLeq(x, logic.getTerm_RealOne()));
+    // The interrupt came before the check started and ends it
+    solver.interrupt();
+    EXPECT_EQ(solver.check(), s_Undef);
+    EXPECT_EQ(solver.getUnknownReason(), opensmt::UnknownReason::Interrupted);
+    // That query gave up on it, the next one runs
+    EXPECT_EQ(solver.check(), s_True);
+    solver.insertFormula(logic.mkGeq(x, logic.mkRealConst(2)));
+    EXPECT_EQ(solver.check(), s_False);
+}
+
+TEST_F(ResourceLimitsTest, test_InterruptGivenUpOnce) {
+    opensmt::ResourceLimits limits;
+    limits.startQuery(0, 0);
+    limits.interrupt();
+    EXPECT_TRUE(limits.exhausted());
+    // The interrupt of the last query does not end the next one, an interrupt in between does
+    limits.startQuery(0, 0);
+    EXPECT_FALSE(limits.exhausted());
+    limits.startQuery(0, 0);
+    limits.interrupt();
+    limits.startQuery(0, 0);
+    EXPECT_TRUE(limits.exhausted());
+    EXPECT_EQ(limits.getReason(), opensmt::UnknownReason::Interrupted);
+}
+
+TEST_F(ResourceLimitsTest, test_Parent) {
+    opensmt::ResourceLimits parent;
+    opensmt::ResourceLimits child;
+    child.setParent(&parent);
+    parent.startQuery(0, 0);
+    child.startQuery(0, 0);
+    EXPECT_FALSE(child.exhausted());
+    parent.interrupt();
+    EXPECT_TRUE(child.exhausted());
+    EXPECT_EQ(child.getReason(), opensmt::UnknownReason::Interrupted);
+    EXPECT_TRUE(parent.exhausted());
+    // The deadline of the parent bounds the child
+    parent.startQuery(1, 0);
+    child.startQuery(0, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    bool exhausted = false;
+    for (int i = 0; i < 1000 and not exhausted; ++i) {
+        exhausted = child.exhausted();
+    }
+    EXPECT_TRUE(exhausted);
+    EXPECT_EQ(child.getReason(), opensmt::UnknownReason::TimeLimit);
+}
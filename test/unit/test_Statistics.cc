@@ -0,0 +1,91 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include <ArithLogic.h>
+#include <MainSolver.h>
+#include <SMTConfig.h>
+#include <Statistics.h>
+
+#include <sstream>
+
+using opensmt::Histogram;
+using opensmt::Statistics;
+
+TEST(HistogramTest, test_Buckets) {
+    Histogram h;
+    h.add(0);
+    h.add(1);
+    h.add(2);
+    h.add(3);
+    h.add(4);
+    h.add(UINT64_MAX);
+    EXPECT_EQ(h.getCount(), 6);
+    EXPECT_EQ(h.getMax(), UINT64_MAX);
+    EXPECT_EQ(h.getBuckets()[0], 1);
+    EXPECT_EQ(h.getBuckets()[1], 1);
+    EXPECT_EQ(h.getBuckets()[2], 2);
+    EXPECT_EQ(h.getBuckets()[3], 1);
+    EXPECT_EQ(h.getBuckets()[64], 1);
+    EXPECT_EQ(h.usedBuckets(), 65);
+}
+
+TEST(StatisticsTest, test_Accumulate) {
+    Statistics stats;
+    stats.addCounter("sat.conflicts", 3);
+    stats.addTime("solver.query-time", 0.5);
+    stats.addCounter("sat.conflicts", 4);
+    Statistics other;
+    other.addCounter("sat.conflicts", 1);
+    other.addCounter("sat.decisions", 2);
+    stats.add(other);
+    ASSERT_NE(stats.find("sat.conflicts"), nullptr);
+    EXPECT_EQ(stats.find("sat.conflicts")->counter, 8);
+    EXPECT_EQ(stats.find("sat.decisions")->counter, 2);
+    EXPECT_EQ(stats.find("sat.restarts"), nullptr);
+    EXPECT_EQ(stats.getEntries().size(), 3);
+}
+
+TEST(StatisticsTest, test_Print) {
+    Statistics stats;
+    stats.addCounter("sat.conflicts", 10);
+    stats.addTime("solver.query-time", 0.25);
+    Histogram h;
+    h.add(1);
+    h.add(3);
+    stats.addHistogram("sat.learnt-size", h);
+    std::stringstream json;
+    stats.printJson(json);
+    EXPECT_EQ(json.str(), "{\"sat\": {\"conflicts\": 10, \"learnt-size\": {\"count\": 2, \"total\": 4, \"max\": 3, "
+                          "\"buckets\": [0, 1, 1]}}, \"solver\": {\"query-time\": 0.250000}}");
+    std::stringstream smtlib;
+    stats.printSmtLib(smtlib);
+    EXPECT_EQ(smtlib.str(), "(:sat.conflicts 10\n :solver.query-time 0.250\n :sat.learnt-size (0 1 1))");
+}
+
+TEST(StatisticsTest, test_KeyOf) {
+    EXPECT_EQ(Statistics::keyOf("LA Solver"), "la-solver");
+}
+
+TEST(StatisticsTest, test_MainSolver) {
+    ArithLogic logic{opensmt::Logic_t::QF_LRA};
+    SMTConfig config;
+    MainSolver solver(logic, config, "statistics");
+    PTRef x = logic.mkRealVar("x");
+    PTRef y = logic.mkRealVar("y");
+    PTRef a = logic.mkBoolVar("a");
+    solver.insertFormula(logic.mkOr(a, logic.mkLeq(x, y)));
+    solver.insertFormula(logic.mkOr(logic.mkNot(a), logic.mkLeq(y, x)));
+    solver.insertFormula(logic.mkLt(logic.mkPlus(x, logic.getTerm_RealOne()), y));
+    solver.insertFormula(logic.mkLt(y, logic.mkPlus(x, logic.getTerm_RealOne())));
+    EXPECT_EQ(solver.check(), s_False);
+    Statistics stats = solver.getStatistics();
+    ASSERT_NE(stats.find("solver.checks"), nullptr);
+    EXPECT_EQ(stats.find("solver.checks")->counter, 1);
+    ASSERT_NE(stats.find("sat.conflicts"), nullptr);
+    ASSERT_NE(stats.find("sat.learnt-size"), nullptr);
+    EXPECT_EQ(stats.find("sat.learnt-size")->kind, Statistics::Kind::Histogram);
+    ASSERT_NE(stats.find("la-solver.pivots"), nullptr);
+    ASSERT_NE(stats.find("la-solver.unsat-calls"), nullptr);
+}
@@ -138,3 +138,132 @@ TEST_F(UFLRASubstitutionsRegression, test_NoProblematicSubstitutions) {
     EXPECT_FALSE(map.has(b));
     EXPECT_FALSE(map.has(c));
 }
+
+TEST(LRASubstitutions, test_GaussianElimination) {
+    ArithLogic logic{opensmt::Logic_t::QF_LRA};
+    PTRef x = logic.mkRealVar("x");
+    PTRef y = logic.mkRealVar("y");
+    PTRef z = logic.mkRealVar("z");
+    // Every variable occurs in several equalities, none of them is solved by a single equality
+    vec<PTRef> equalities;
+    equalities.push(logic.mkEq(logic.mkPlus(vec<PTRef>{x, y, z}), logic.getTerm_RealOne()));
+    equalities.push(logic.mkEq(x, y));
+    equalities.push(logic.mkEq(logic.mkPlus(y, logic.mkTimes(logic.mkRealConst(2), z)), logic.mkRealConst(3)));
+    Logic::SubstMap substMap;
+    logic.arithmeticElimination(equalities, substMap);
+    ASSERT_EQ(substMap.getSize(), 3);
+    logic.substitutionsTransitiveClosure(substMap);
+    EXPECT_EQ(substMap[x], logic.mkRealConst(FastRational(-1, 3)));
+    EXPECT_EQ(substMap[y], logic.mkRealConst(FastRational(-1, 3)));
+    EXPECT_EQ(substMap[z], logic.mkRealConst(FastRational(5, 3)));
+}
+
+TEST(LRASubstitutions, test_GaussianEliminationBanded) {
+    ArithLogic logic{opensmt::Logic_t::QF_LRA};
+    // x_(i-1) + x_i + x_(i+1) = 3i, cut off at both ends; the only solution is x_i = i
+    constexpr int n = 2001;
+    vec<PTRef> x;
+    for (int i = 0; i < n; ++i) { x.push(logic.mkRealVar(("x" + std::to_string(i)).c_str())); }
+    vec<PTRef> equalities;
+    for (int i = 0; i < n; ++i) {
+        vec<PTRef> args;
+        int sum = 0;
+        for (int j = std::max(0, i - 1); j <= std::min(n - 1, i + 1); ++j) {
+            args.push(x[j]);
+            sum += j;
+        }
+        equalities.push(logic.mkEq(logic.mkPlus(std::move(args)), logic.mkRealConst(sum)));
+    }
+    Logic::SubstMap substMap;
+    logic.arithmeticElimination(equalities, substMap);
+    ASSERT_EQ(substMap.getSize(), n);
+    logic.substitutionsTransitiveClosure(substMap);
+    for (int i = 0; i < n; ++i) {
+        EXPECT_EQ(substMap[x[i]], logic.mkRealConst(i));
+    }
+}
+
+TEST_F(LIASubstitutionsRegression, test_GaussianEliminationUnitPivot) {
+    auto const osmt = getLIAOsmt();
+    auto & lialogic = osmt->getLIALogic();
+    PTRef x = lialogic.mkIntVar("x");
+    PTRef y = lialogic.mkIntVar("y");
+    PTRef z = lialogic.mkIntVar("z");
+    PTRef two = lialogic.mkIntConst(2);
+    PTRef three = lialogic.mkIntConst(3);
+    // x + 2y + 3z = 0 and 4x + 2y + 3z = 0; only x has a unit coefficient
+    PTRef eq1 = lialogic.mkEq(lialogic.mkPlus(vec<PTRef>{x, lialogic.mkTimes(two, y), lialogic.mkTimes(three, z)}), lialogic.getTerm_IntZero());
+    PTRef eq2 = lialogic.mkEq(lialogic.mkPlus(vec<PTRef>{lialogic.mkTimes(lialogic.mkIntConst(4), x), lialogic.mkTimes(two, y), lialogic.mkTimes(three, z)}), lialogic.getTerm_IntZero());
+    Logic::SubstMap substMap;
+    lialogic.arithmeticElimination({eq1, eq2}, substMap);
+    ASSERT_TRUE(substMap.has(x));
+    PTRef value = substMap[x];
+    ASSERT_TRUE(lialogic.isPlus(value));
+    for (PTRef factor : lialogic.getPterm(value)) {
+        auto [var, c] = lialogic.splitTermToVarAndConst(factor);
+        EXPECT_TRUE(lialogic.getNumConst(c).isInteger());
+    }
+}
+
+TEST(LRASubstitutions, test_SubstitutionsInFrames) {
+    ArithLogic logic{opensmt::Logic_t::QF_LRA};
+    SMTConfig config;
+    MainSolver solver(logic, config, "frames");
+    // Every frame defines the next variable by the previous one, like an unrolling step of bounded model checking
+    vec<PTRef> x;
+    x.push(logic.mkRealVar("x0"));
+    solver.insertFormula(logic.mkEq(x[0], logic.getTerm_RealZero()));
+    for (int i = 1; i <= 10; ++i) {
+        x.push(logic.mkRealVar(("x" + std::to_string(i)).c_str()));
+        solver.push();
+        solver.insertFormula(logic.mkEq(x[i], logic.mkPlus(x[i - 1], logic.getTerm_RealOne())));
+        EXPECT_EQ(solver.check(), s_True);
+    }
+    auto model = solver.getModel();
+    EXPECT_EQ(model->evaluate(x[10]), logic.mkRealConst(10));
+    solver.push();
+    solver.insertFormula(logic.mkLt(x[10], logic.mkRealConst(10)));
+    EXPECT_EQ(solver.check(), s_False);
+    solver.pop();
+    solver.pop();
+    // x10 is free again, but the substitutions of the frames below still hold
+    solver.push();
+    solver.insertFormula(logic.mkEq(x[10], logic.mkTimes(logic.mkRealConst(2), x[9])));
+    ASSERT_EQ(solver.check(), s_True);
+    model = solver.getModel();
+    EXPECT_EQ(model->evaluate(x[9]), logic.mkRealConst(9));
+    EXPECT_EQ(model->evaluate(x[10]), logic.mkRealConst(18));
+    solver.push();
+    solver.insertFormula(logic.mkGt(x[5], x[9]));
+    EXPECT_EQ(solver.check(), s_False);
+}
+
+TEST(UFSubstitutions, test_EqTransitivityInFrames) {
+    Logic logic{opensmt::Logic_t::QF_UF};
+    SMTConfig config;
+    MainSolver solver(logic, config, "frames");
+    SRef U = logic.declareUninterpretedSort("U");
+    PTRef x = logic.mkVar(U, "x");
+    PTRef y = logic.mkVar(U, "y");
+    PTRef w = logic.mkVar(U, "w");
+    PTRef z = logic.mkVar(U, "z");
+    auto diamond = [&](PTRef from, PTRef to) {
+        return logic.mkOr(logic.mkAnd(logic.mkEq(from, w), logic.mkEq(w, to)),
+                          logic.mkAnd(logic.mkEq(from, y), logic.mkEq(y, to)));
+    };
+    // The transitivity learnt from the diamond of the bottom frame holds in the frames above, which are simplified alone
+    solver.insertFormula(diamond(x, z));
+    ASSERT_EQ(solver.check(), s_True);
+    solver.push();
+    solver.insertFormula(logic.mkNot(logic.mkEq(x, z)));
+    EXPECT_EQ(solver.check(), s_False);
+    solver.pop();
+    solver.push();
+    // A diamond of a new frame over the terms of the frames below
+    PTRef v = logic.mkVar(U, "v");
+    solver.insertFormula(diamond(z, v));
+    solver.insertFormula(logic.mkNot(logic.mkEq(x, v)));
+    EXPECT_EQ(solver.check(), s_False);
+    solver.pop();
+    EXPECT_EQ(solver.check(), s_True);
+}
@@ -0,0 +1,83 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include <Logic.h>
+#include <MainSolver.h>
+#include <SMTConfig.h>
+#include <Symmetry.h>
+#include "TestUtils.h"
+
+#include <string>
+
+using opensmt::test::pigeonhole;
+using opensmt::test::setOption;
+
+class SymmetryTest : public ::testing::Test {
+protected:
+    SymmetryTest() : logic{opensmt::Logic_t::QF_UF} {}
+    Logic logic;
+    SMTConfig config;
+};
+
+TEST_F(SymmetryTest, test_SwapOfBooleans) {
+    PTRef a = logic.mkBoolVar("a");
+    PTRef b = logic.mkBoolVar("b");
+    symmetry::Detector detector(logic, logic.mkOr(a, b));
+    detector.findSBPs();
+    EXPECT_EQ(detector.getNumberOfGenerators(), 1u);
+    EXPECT_EQ(detector.getSBPs(), logic.mkImpl(a, b));
+}
+
+TEST_F(SymmetryTest, test_NoSymmetry) {
+    PTRef a = logic.mkBoolVar("a");
+    PTRef b = logic.mkBoolVar("b");
+    symmetry::Detector detector(logic, logic.mkOr(a, logic.mkNot(b)));
+    detector.findSBPs();
+    EXPECT_EQ(detector.getNumberOfGenerators(), 0u);
+    EXPECT_EQ(detector.getSBPs(), logic.getTerm_true());
+}
+
+TEST_F(SymmetryTest, test_PigeonHole) {
+    setOption(config, SMTConfig::o_sat_remove_symmetries, 1);
+    MainSolver solver(logic, config, "symmetry");
+    solver.insertFormula(logic.mkAnd(pigeonhole(logic, 5, 4)));
+    EXPECT_EQ(solver.check(), s_False);
+}
+
+TEST_F(SymmetryTest, test_ModelSatisfiesOriginalFormula) {
+    setOption(config, SMTConfig::o_sat_remove_symmetries, 1);
+    MainSolver solver(logic, config, "symmetry");
+    PTRef fla = logic.mkAnd(pigeonhole(logic, 3, 3));
+    solver.insertFormula(fla);
+    ASSERT_EQ(solver.check(), s_True);
+    EXPECT_EQ(solver.getModel()->evaluate(fla), logic.getTerm_true());
+}
+
+TEST_F(SymmetryTest, test_AssertionAfterSymmetryBreaking) {
+    setOption(config, SMTConfig::o_sat_remove_symmetries, 1);
+    MainSolver solver(logic, config, "symmetry");
+    PTRef a = logic.mkBoolVar("a");
+    PTRef b = logic.mkBoolVar("b");
+    solver.insertFormula(logic.mkOr(a, b));
+    ASSERT_EQ(solver.check(), s_True);
+    // Only models with a false or b true satisfy the predicate of the swap of a and b
+    solver.insertFormula(logic.mkNot(b));
+    ASSERT_EQ(solver.check(), s_True);
+    EXPECT_EQ(solver.getModel()->evaluate(a), logic.getTerm_true());
+}
+
+TEST_F(SymmetryTest, test_PushAfterSymmetryBreaking) {
+    setOption(config, SMTConfig::o_sat_remove_symmetries, 1);
+    MainSolver solver(logic, config, "symmetry");
+    PTRef a = logic.mkBoolVar("a");
+    PTRef b = logic.mkBoolVar("b");
+    solver.insertFormula(logic.mkOr(a, b));
+    ASSERT_EQ(solver.check(), s_True);
+    solver.push();
+    solver.insertFormula(logic.mkNot(b));
+    EXPECT_EQ(solver.check(), s_True);
+    solver.pop();
+    EXPECT_EQ(solver.check(), s_True);
+}
@@ -3,6 +3,7 @@
 //
 
 #include <gtest/gtest.h>
+#include <FrameSubstitutions.h>
 #include <Logic.h>
 #include <Substitutor.h>
 
@@ -200,3 +201,33 @@ TEST(SubstitutionTransitiveClosure, test_twoStepSubstitution) {
     ASSERT_EQ(substitutions[a], d);
 }
 
+//========================== TEST for the substitutions of push frames ================================================
+TEST(FrameSubstitutionsTest, test_ClosedAndUndone) {
+    Logic logic{opensmt::Logic_t::QF_UF};
+    PTRef a = logic.mkBoolVar("a");
+    PTRef b = logic.mkBoolVar("b");
+    PTRef c = logic.mkBoolVar("c");
+    FrameSubstitutions store;
+    store.startLevel(0);
+    Logic::SubstMap first;
+    first.insert(a, logic.mkOr(b, c));
+    store.add(logic, first);
+    store.startLevel(1);
+    Logic::SubstMap second;
+    second.insert(b, logic.getTerm_false());
+    store.add(logic, second);
+    // The target of a is rewritten with the substitution of the frame above
+    ASSERT_EQ(store.getSubstitutions().getSize(), 2);
+    EXPECT_EQ(store.getSubstitutions()[a], c);
+    EXPECT_EQ(store.apply(logic, logic.mkAnd(a, b)), logic.getTerm_false());
+    // Simplifying a new frame at level 1 drops the substitutions of the popped one
+    store.startLevel(1);
+    ASSERT_EQ(store.getSubstitutions().getSize(), 1);
+    EXPECT_EQ(store.getSubstitutions()[a], logic.mkOr(b, c));
+    Logic::SubstMap third;
+    third.insert(c, logic.getTerm_true());
+    store.add(logic, third);
+    EXPECT_EQ(store.getSubstitutions()[a], logic.getTerm_true());
+    store.startLevel(0);
+    EXPECT_EQ(store.getSubstitutions().getSize(), 0);
+}
@@ -498,4 +498,69 @@ TEST_F(UFInterpolationTest, test_DistinctInB){
     ASSERT_EQ(itp, logic.mkNot(logic.mkEq(x1,x3)));
 }
 
+TEST_F(UFInterpolationTest, test_StreamingInterpolants){
+    /*
+     * A = { x1 = f(z1), f(z2) = x2, z1 = z2 }
+     * B = { y1 = x1, x2 = y2, not(y1 = y2) }
+     * Interpolants computed directly from the derivations must match the ones computed on the proof graph
+     */
+    PTRef eqA1 = logic.mkEq(x1, logic.mkUninterpFun(f, {z1}));
+    PTRef eqA2 = logic.mkEq(logic.mkUninterpFun(f, {z2}), x2);
+    PTRef eqA3 = logic.mkEq(z1, z2);
+    PTRef eqB1 = logic.mkEq(y1, x1);
+    PTRef eqB2 = logic.mkEq(x2, y2);
+    PTRef dis = logic.mkNot(logic.mkEq(y1, y2));
+    const char* msg = "ok";
+    config.setOption(SMTConfig::o_produce_inter, SMTOption(true), msg);
+    MainSolver solver(logic, config, "ufinterpolator");
+    solver.insertFormula(logic.mkAnd({eqA1, eqA2, eqA3}));
+    solver.insertFormula(logic.mkAnd({eqB1, eqB2, dis}));
+    auto res = solver.check();
+    ASSERT_EQ(res, s_False);
+    ipartitions_t mask = 1;
+    vec<PTRef> graphInterpolants;
+    solver.getInterpolationContext()->getSingleInterpolant(graphInterpolants, mask);
+    config.setOption(SMTConfig::o_streaming_inter, SMTOption(true), msg);
+    vec<PTRef> streamedInterpolants;
+    solver.getInterpolationContext()->getSingleInterpolant(streamedInterpolants, mask);
+    EXPECT_TRUE(verifyInterpolant(streamedInterpolants[0], solver.getPartitionManager(), mask));
+    EXPECT_EQ(streamedInterpolants[0], graphInterpolants[0]);
+}
 
+TEST_F(UFInterpolationTest, test_BatchedInterpolants){
+    /*
+     * Partitions { x = y }, { y = z1 }, { not(z1 = x) }
+     * Interpolants computed together for all masks must match the ones computed one by one
+     */
+    PTRef eq1 = logic.mkEq(x,y);
+    PTRef eq2 = logic.mkEq(y,z1);
+    PTRef eq3 = logic.mkEq(z1,x);
+    const char* msg = "ok";
+    config.setOption(SMTConfig::o_produce_inter, SMTOption(true), msg);
+    MainSolver solver(logic, config, "ufinterpolator");
+    solver.insertFormula(eq1);
+    solver.insertFormula(eq2);
+    solver.insertFormula(logic.mkNot(eq3));
+    auto res = solver.check();
+    ASSERT_EQ(res, s_False);
+    auto itpCtx = solver.getInterpolationContext();
+    std::vector<ipartitions_t> masks{1, 3};
+    vec<PTRef> batched;
+    EXPECT_TRUE(itpCtx->getPathInterpolants(batched, masks));
+    ASSERT_EQ(batched.size(), 2);
+    for (std::size_t i = 0; i < masks.size(); ++i) {
+        vec<PTRef> single;
+        itpCtx->getSingleInterpolant(single, masks[i]);
+        EXPECT_EQ(batched[i], single[0]);
+        EXPECT_TRUE(verifyInterpolant(batched[i], solver.getPartitionManager(), masks[i]));
+    }
+    std::vector<vec<int>> partitions(2);
+    partitions[0].push(0);
+    partitions[1].push(0);
+    partitions[1].push(1);
+    vec<PTRef> fromPartitions;
+    itpCtx->getInterpolants(partitions, fromPartitions);
+    ASSERT_EQ(fromPartitions.size(), 2);
+    EXPECT_EQ(fromPartitions[0], batched[0]);
+    EXPECT_EQ(fromPartitions[1], batched[1]);
+}